@@ -54,18 +54,6 @@ static void EchoTxRx (std::string context, const Ptr< const Packet > packet, con
         }
     }
 }
-static double readPathloss() {
-    double pathLoss = 0.0;
-    std::ifstream inFile("/home/user/ns-3.35/contrib/leo/examples/pathloss.txt");
-    if (inFile.is_open()) {
-        inFile >> pathLoss;
-        inFile.close();
-        // std::cout << "debug: pathLoss: " << pathLoss << std::endl;
-    } else {
-        printf("[!]Could not open pathloss.txt file\n");
-    }
-    return pathLoss;
-}
 void connect () {
     Config::Connect ("/NodeList/*/$ns3::TcpL4Protocol/SocketList/*/Tx", MakeCallback (&EchoTxRx));
     Config::Connect ("/NodeList/*/$ns3::TcpL4Protocol/SocketList/*/Rx", MakeCallback (&EchoTxRx));
@@ -180,6 +168,8 @@ int main (int argc, char *argv[])
     Ptr<LeoPropagationLossModel> propagationLossModel = DynamicCast<LeoPropagationLossModel>(channel->GetPropagationLoss());
 
     if (propagationLossModel != nullptr) {
+        // path loss of the 16 element array, steered with the best beam of the codebook
+        propagationLossModel->SetAttribute("Beamforming", BooleanValue(true));
         // Get configured values from the device
         double txPowerDbm = 105.9; // Tx power
         double noisePowerDbm = -110.0; // Noise power
@@ -200,7 +190,7 @@ int main (int argc, char *argv[])
         // printf("\n====== w/o bf - Results ======\n");
         printf("\n====== w/  bf - Results ======\n");
         printf("Q1: Euclidean Dis: %.6f m\n", euclidean_dis);
-        printf("Q2: PathLoss: %.6f dBm\n", readPathloss());
+        printf("Q2: PathLoss: %.6f dBm\n", propagationLossModel->GetPathLoss(pos_tx, pos_sat));
         printf("Q3: RxPower: %.6f dBm\n", rxPowerDbm);
         printf("Q4: SNR: %.6f dB\n", snrDb);
         printf("Q5: DataRate: %.6f Mbps\n", shannonCapacity / 1e6);
@@ -112,7 +112,7 @@ int main (int argc, char *argv[])
   cmd.AddValue("islRate", "ns3::MockNetDevice::DataRate");
   cmd.AddValue("constellation", "LEO constellation link settings name", constellation);
   cmd.AddValue("interval", "Echo interval", interval);
-  cmd.AddValue("routing", "Routing protocol", routingProto);
+  cmd.AddValue("routing", "Routing protocol (aodv or static)", routingProto);
   cmd.AddValue("islEnabled", "Enable inter-satellite links", islEnabled);
   cmd.AddValue("traceDrops", "Enable tracing of PHY and MAC drops", traceDrops);
   cmd.AddValue("traceTxRx", "Enable tracing of PHY and MAC transmits", traceTxRx);
@@ -164,7 +164,15 @@ int main (int argc, char *argv[])
     aodv.Set ("TtlThreshold", UintegerValue (ttlThresh));
     aodv.Set ("NetDiameter", UintegerValue (2*ttlThresh));
     }
-  stack.SetRoutingHelper (aodv);
+  LeoStaticRoutingHelper staticRouting;
+  if (routingProto == "static")
+    {
+      stack.SetRoutingHelper (staticRouting);
+    }
+  else
+    {
+      stack.SetRoutingHelper (aodv);
+    }
 
   // Install internet stack on nodes
   stack.Install (satellites);
@@ -184,6 +192,11 @@ int main (int argc, char *argv[])
       ipv4.Assign (islNet);
     }
 
+  if (routingProto == "static")
+    {
+      staticRouting.Install (satellites, stations);
+    }
+
   Ptr<Node> client = users.Get (0);
   Ptr<Node> server = users.Get (1);
 
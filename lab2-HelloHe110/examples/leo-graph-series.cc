@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LeoGraphSeries");
+
+/*
+ * Writes a network graph of the ground stations and satellites for every
+ * step of a time window, e.g. with the link budget of lab 3:
+ *
+ *   ./waf --run "leo-graph-series --orbitFile=contrib/leo/data/orbits/telesat.csv
+ *     --posFile=contrib/leo/examples/network.pos --duration=3600 --step=1"
+ *
+ * writes network.graph with one graph after the other and network.bin with
+ * the same graphs in the binary format. With --split every graph gets its
+ * own text file, network.0.graph, network.1.graph and so on, which the
+ * assignment programs of lab 3 to 5 read as they are.
+ */
+int main (int argc, char *argv[])
+{
+  CommandLine cmd;
+  std::string orbitFile;
+  std::string groundFile;
+  std::string posFile;
+  uint32_t latGws = 4;
+  uint32_t lonGws = 5;
+  double start = 0;
+  double duration = 100;
+  double step = 1;
+  uint32_t threads = 0;
+  std::string output = "network";
+  std::string format = "both";
+  bool split = false;
+  cmd.AddValue("orbitFile", "CSV file with orbit parameters", orbitFile);
+  cmd.AddValue("groundFile", "CSV file with ground station locations", groundFile);
+  cmd.AddValue("posFile", "network.pos file to take the link budget from", posFile);
+  cmd.AddValue("latGws", "Latitudal rows of gateways, without groundFile", latGws);
+  cmd.AddValue("lonGws", "Longitudinal rows of gateways, without groundFile", lonGws);
+  cmd.AddValue("start", "First step in seconds", start);
+  cmd.AddValue("duration", "Length of the time window in seconds", duration);
+  cmd.AddValue("step", "Interval between two graphs in seconds", step);
+  cmd.AddValue("threads", "Number of threads, 0 for one per core", threads);
+  cmd.AddValue("output", "Prefix of the output files", output);
+  cmd.AddValue("format", "Output format: text, binary or both", format);
+  cmd.AddValue("split", "Write every graph into its own text file", split);
+  cmd.Parse (argc, argv);
+
+  LeoOrbitNodeHelper orbit;
+  NodeContainer satellites;
+  if (!orbitFile.empty ()) satellites = orbit.Install (orbitFile);
+  else satellites = orbit.Install ({ LeoOrbit (1200, 20, 5, 5) });
+
+  LeoGndNodeHelper ground;
+  NodeContainer stations;
+  if (!groundFile.empty ()) stations = ground.Install (groundFile);
+  else stations = ground.Install (latGws, lonGws);
+
+  LeoGraphHelper graphs;
+  graphs.SetThreads (threads);
+  if (!posFile.empty ())
+    {
+      NS_ABORT_MSG_UNLESS (graphs.ReadLinkBudget (posFile), "Unable to read " << posFile);
+    }
+
+  bool text = format == "text" || format == "both";
+  bool binary = format == "binary" || format == "both";
+  NS_ABORT_MSG_UNLESS (text || binary, "Unknown format " << format);
+
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now ();
+  uint32_t written = 0;
+  if (split)
+    {
+      // binary graphs still go into one file
+      std::ofstream bin;
+      if (binary)
+        {
+          bin.open (output + ".bin", std::ios::binary);
+          LeoGraphHelper::WriteBinaryHeader (bin);
+        }
+      for (Time t = Seconds (start); t <= Seconds (start + duration); t += Seconds (step), written++)
+        {
+          LeoGraph graph = graphs.Compute (stations, satellites, t);
+          if (text)
+            {
+              std::ostringstream name;
+              name << output << "." << written << ".graph";
+              std::ofstream out (name.str ());
+              LeoGraphHelper::WriteText (out, graph);
+            }
+          if (binary)
+            {
+              LeoGraphHelper::WriteBinary (bin, graph);
+            }
+        }
+    }
+  else
+    {
+      std::ofstream out;
+      std::ofstream bin;
+      if (text)
+        {
+          out.open (output + ".graph");
+        }
+      if (binary)
+        {
+          bin.open (output + ".bin", std::ios::binary);
+        }
+      written = graphs.Write (stations, satellites, Seconds (start), Seconds (start + duration), Seconds (step),
+                              text ? &out : 0, binary ? &bin : 0);
+    }
+  double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - begin).count ();
+
+  std::cout << "Wrote " << written << " graphs of " << stations.GetN () << " ground stations and "
+            << satellites.GetN () << " satellites in " << seconds << " s" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/leo-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/udp-server.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LeoMpiExample");
+
+static void
+EchoRx (std::string context, Ptr<const Packet> packet)
+{
+  SeqTsHeader seqTs;
+  Ptr<Packet> p = packet->Copy ();
+  p->RemoveHeader (seqTs);
+  std::cout << Simulator::Now () << ":" << context << ":" << seqTs.GetSeq () << ":" << Simulator::Now () - seqTs.GetTs () << std::endl;
+}
+
+/*
+ * Runs the delay tracing scenario distributed over MPI ranks, e.g.
+ *
+ *   mpirun -np 4 ./waf --run leo-mpi
+ *
+ * The satellites are partitioned by orbital plane and the ground stations by
+ * longitude. The output is the same as with a single process.
+ */
+int main (int argc, char *argv[])
+{
+  GlobalValue::Bind ("SimulatorImplementationType",
+                     StringValue ("ns3::DistributedSimulatorImpl"));
+  MpiInterface::Enable (&argc, &argv);
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  uint32_t systemCount = MpiInterface::GetSize ();
+
+  CommandLine cmd;
+  LeoLatLong source (51.399, 10.536);
+  LeoLatLong destination (40.76, -73.96);
+  std::string constellation = "TelesatGateway";
+  uint32_t latGws = 20;
+  uint32_t lonGws = 20;
+  double interval = 1;
+  double duration = 100;
+  cmd.AddValue("duration", "Duration of the simulation in seconds", duration);
+  cmd.AddValue("source", "Traffic source", source);
+  cmd.AddValue("destination", "Traffic destination", destination);
+  cmd.AddValue("constellation", "LEO constellation link settings name", constellation);
+  cmd.AddValue("interval", "Echo interval", interval);
+  cmd.AddValue("latGws", "Latitudal rows of gateways", latGws);
+  cmd.AddValue("lonGws", "Longitudinal rows of gateways", lonGws);
+  cmd.Parse (argc, argv);
+
+  LeoOrbitNodeHelper orbit;
+  orbit.SetNumPartitions (systemCount);
+  NodeContainer satellites = orbit.Install ({ LeoOrbit (1200, 20, 32, 16),
+                                              LeoOrbit (1180, 30, 12, 10) });
+
+  LeoGndNodeHelper ground;
+  ground.SetNumPartitions (systemCount);
+  NodeContainer stations = ground.Install (latGws, lonGws);
+
+  NodeContainer users = ground.Install (source, destination);
+  stations.Add (users);
+
+  LeoChannelHelper utCh;
+  utCh.SetConstellation (constellation);
+  NetDeviceContainer utNet = utCh.Install (satellites, stations);
+
+  // routes are computed from the geometry on every rank, so there is no
+  // routing traffic between the ranks
+  LeoStaticRoutingHelper staticRouting;
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (staticRouting);
+  stack.Install (satellites);
+  stack.Install (stations);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.0.0");
+  ipv4.Assign (utNet);
+
+  IslHelper islCh;
+  NetDeviceContainer islNet = islCh.Install (satellites);
+  ipv4.SetBase ("10.2.0.0", "255.255.0.0");
+  ipv4.Assign (islNet);
+
+  staticRouting.Install (satellites, stations);
+
+  LeoMpiHelper mpi;
+  Time lookAhead = mpi.Install (satellites, stations, Seconds (duration));
+  if (systemId == 0)
+    {
+      std::cerr << "RANKS=" << systemCount << ",LOOKAHEAD=" << lookAhead << std::endl;
+    }
+
+  Ptr<Node> client = users.Get (0);
+  Ptr<Node> server = users.Get (1);
+  Address remote = server->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
+
+  // applications only run on the rank that owns their node
+  if (server->GetSystemId () == systemId)
+    {
+      UdpServerHelper echoServer (9);
+      echoServer.Install (server);
+      Config::Connect ("/NodeList/*/ApplicationList/*/$ns3::UdpServer/Rx",
+                       MakeCallback (&EchoRx));
+    }
+  if (client->GetSystemId () == systemId)
+    {
+      UdpClientHelper echoClient (remote, 9);
+      echoClient.SetAttribute ("MaxPackets", UintegerValue (duration / interval));
+      echoClient.SetAttribute ("Interval", TimeValue (Seconds (interval)));
+      echoClient.SetAttribute ("PacketSize", UintegerValue (1024));
+      echoClient.Install (client);
+    }
+
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  MpiInterface::Disable ();
+
+  return 0;
+}
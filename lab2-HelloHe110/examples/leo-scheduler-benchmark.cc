@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <iomanip>
+#include <sstream>
+
+#include "ns3/core-module.h"
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LeoSchedulerBenchmark");
+
+/// Number of events run so far
+static uint64_t g_events = 0;
+/// State of the generator of the delays
+static uint64_t g_state = 1;
+
+/// Cheap generator, so that the benchmark measures the scheduler
+static uint32_t
+Random (uint32_t max)
+{
+  g_state = g_state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (g_state >> 33) % max;
+}
+
+static void
+Receive (void)
+{
+  g_events++;
+}
+
+static void
+Transmit (uint32_t fanout, Time interval)
+{
+  g_events++;
+  // a reception at every device in reach, a few milliseconds ahead
+  Time delay = MicroSeconds (2000 + Random (18000));
+  for (uint32_t i = 0; i < fanout; i++)
+    {
+      Simulator::Schedule (delay + NanoSeconds (Random (1000)), &Receive);
+    }
+  Simulator::Schedule (interval + MicroSeconds (Random (1000)), &Transmit, fanout, interval);
+}
+
+static void
+Tick (Time period)
+{
+  g_events++;
+  Simulator::Schedule (period, &Tick, period);
+}
+
+/*
+ * Compares the events per second of the schedulers with the event mix of a
+ * LEO simulation: transmissions reaching many devices after a few
+ * milliseconds and periodic updates of each node, e.g.
+ *
+ *   ./waf --run "leo-scheduler-benchmark --transmitters=1000 --fanout=50"
+ */
+int main (int argc, char *argv[])
+{
+  CommandLine cmd;
+  uint32_t transmitters = 500;
+  uint32_t fanout = 40;
+  uint32_t nodes = 2000;
+  double interval = 0.01;
+  double duration = 5;
+  std::string schedulers = "ns3::MapScheduler,ns3::HeapScheduler,ns3::CalendarScheduler,ns3::LeoCalendarScheduler";
+  cmd.AddValue("transmitters", "Number of devices transmitting", transmitters);
+  cmd.AddValue("fanout", "Number of devices reached by a transmission", fanout);
+  cmd.AddValue("nodes", "Number of nodes with periodic updates", nodes);
+  cmd.AddValue("interval", "Interval between transmissions of a device in seconds", interval);
+  cmd.AddValue("duration", "Duration of the simulation in seconds", duration);
+  cmd.AddValue("schedulers", "Comma separated types of the schedulers to compare", schedulers);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (24) << "scheduler"
+            << std::setw (12) << "events"
+            << std::setw (12) << "wall (s)"
+            << std::setw (14) << "events/s" << std::endl;
+
+  std::istringstream types (schedulers);
+  std::string type;
+  while (std::getline (types, type, ','))
+    {
+      g_events = 0;
+      g_state = 1;
+
+      LeoSchedulerHelper scheduler;
+      scheduler.SetScheduler (type);
+      scheduler.Install ();
+
+      for (uint32_t i = 0; i < transmitters; i++)
+        {
+          Simulator::Schedule (MicroSeconds (Random (static_cast<uint32_t> (1000000 * interval))),
+                               &Transmit, fanout, Seconds (interval));
+        }
+      for (uint32_t i = 0; i < nodes; i++)
+        {
+          Simulator::Schedule (MicroSeconds (Random (1000000)), &Tick, Seconds (1));
+        }
+      Simulator::Stop (Seconds (duration));
+
+      SystemWallClockMs clock;
+      clock.Start ();
+      Simulator::Run ();
+      double wall = clock.End () / 1000.0;
+      Simulator::Destroy ();
+
+      std::cout << std::setw (24) << type
+                << std::setw (12) << g_events
+                << std::setw (12) << wall
+                << std::setw (14) << (wall > 0 ? g_events / wall : 0) << std::endl;
+    }
+
+  return 0;
+}
@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <sstream>
+#include <unistd.h>
+
+#include "ns3/core-module.h"
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LeoSweep");
+
+/**
+ * \brief Split a string
+ * \param list the string
+ * \param separator the separator
+ * \return the parts, without empty ones
+ */
+static std::vector<std::string>
+Split (const std::string &list, char separator)
+{
+  std::vector<std::string> parts;
+  std::istringstream in (list);
+  std::string part;
+  while (std::getline (in, part, separator))
+    {
+      if (!part.empty ())
+        {
+          parts.push_back (part);
+        }
+    }
+  return parts;
+}
+
+/*
+ * Runs a program for every combination of parameter values, e.g. lab 4 with
+ * both assignments and two constellations, three times each:
+ *
+ *   ./waf --run "leo-sweep --program=build/contrib/leo/examples/ns3.35-leo-lab4-debug
+ *     --params=inputFile=network.greedy.out,network.ortools.out;constellation=TelesatGateway,StarlinkGateway
+ *     --replications=3 --output=sweep.tsv"
+ *
+ * With an orbit and a ground station file the positions and contacts of the
+ * constellation are predicted once and shared with all runs, whose contact
+ * plans pick them up through the Ephemeris attribute. The runs have to
+ * create the same satellites first and then the same ground stations.
+ */
+int main (int argc, char *argv[])
+{
+  CommandLine cmd;
+  std::string program;
+  std::string params;
+  std::string args;
+  uint32_t replications = 1;
+  uint32_t workers = 0;
+  std::string output = "sweep.tsv";
+  std::string orbitFile;
+  std::string groundFile;
+  double duration = 100;
+  double step = 1;
+  cmd.AddValue("program", "Path to the executable to run", program);
+  cmd.AddValue("params", "Parameters to sweep over, e.g. a=1,2;b=x,y", params);
+  cmd.AddValue("args", "Space separated arguments passed to every run", args);
+  cmd.AddValue("replications", "Number of replications of every combination", replications);
+  cmd.AddValue("workers", "Number of runs at the same time, 0 for one per core", workers);
+  cmd.AddValue("output", "Results file", output);
+  cmd.AddValue("orbitFile", "Orbits of the constellation to precompute", orbitFile);
+  cmd.AddValue("groundFile", "Ground stations of the constellation to precompute", groundFile);
+  cmd.AddValue("duration", "Duration of the runs in seconds", duration);
+  cmd.AddValue("step", "Sampling interval of the precomputed positions in seconds", step);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (program.empty (), "No program given");
+
+  LeoSweepHelper sweep;
+  sweep.SetProgram (program);
+  sweep.SetReplications (replications);
+  sweep.SetWorkers (workers);
+  for (const std::string &arg : Split (args, ' '))
+    {
+      sweep.AddArgument (arg);
+    }
+  for (const std::string &param : Split (params, ';'))
+    {
+      std::size_t equals = param.find ('=');
+      NS_ABORT_MSG_IF (equals == std::string::npos, "Parameter " << param << " has no values");
+      sweep.AddParameter (param.substr (0, equals), Split (param.substr (equals + 1), ','));
+    }
+
+  std::ostringstream name;
+  name << "/leo-sweep-" << getpid ();
+  if (!orbitFile.empty ())
+    {
+      LeoOrbitNodeHelper orbit;
+      NodeContainer satellites = orbit.Install (orbitFile);
+      NodeContainer stations;
+      if (!groundFile.empty ())
+        {
+          LeoGndNodeHelper ground;
+          stations = ground.Install (groundFile);
+        }
+
+      Ptr<LeoContactPlan> plan = CreateObject<LeoContactPlan> ();
+      plan->Compute (satellites, stations, Seconds (0), Seconds (duration));
+      Ptr<LeoEphemeris> ephemeris = CreateObject<LeoEphemeris> ();
+      ephemeris->Compute (NodeContainer (satellites, stations), Seconds (0), Seconds (duration), Seconds (step));
+      ephemeris->SetContacts (plan, Seconds (0), Seconds (duration));
+      NS_ABORT_MSG_UNLESS (ephemeris->Share (name.str ()), "Unable to share the ephemeris");
+      sweep.AddArgument ("--ns3::LeoContactPlan::Ephemeris=" + name.str ());
+      std::cout << "Shared " << plan->GetNContacts () << " contacts of " << satellites.GetN ()
+                << " satellites and " << stations.GetN () << " ground stations as " << name.str () << std::endl;
+    }
+
+  std::cout << "Running " << sweep.GetNRuns () << " runs" << std::endl;
+  double throughput = sweep.Run (output);
+  std::cout << "Throughput: " << throughput << " runs per hour" << std::endl;
+
+  if (!orbitFile.empty ())
+    {
+      LeoEphemeris::Unlink (name.str ());
+    }
+  Simulator::Destroy ();
+  return 0;
+}
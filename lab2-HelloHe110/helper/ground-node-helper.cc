@@ -16,6 +16,7 @@
  * Author: Tim Schubert <ns-3-leo@timschubert.net>
  */
 
+#include <algorithm>
 #include <fstream>
 
 #include "math.h"
@@ -36,6 +37,7 @@ namespace ns3
 NS_LOG_COMPONENT_DEFINE ("LeoGndNodeHelper");
 
 LeoGndNodeHelper::LeoGndNodeHelper ()
+  : m_numPartitions (1)
 {
   m_gndNodeFactory.SetTypeId ("ns3::Node");
 }
@@ -50,6 +52,34 @@ LeoGndNodeHelper::SetAttribute (string name, const AttributeValue &value)
   m_gndNodeFactory.Set (name, value);
 }
 
+void
+LeoGndNodeHelper::SetNumPartitions (uint32_t numPartitions)
+{
+  NS_ASSERT_MSG (numPartitions > 0, "Need at least one partition");
+  m_numPartitions = numPartitions;
+}
+
+Ptr<Node>
+LeoGndNodeHelper::CreateNode (const Vector &pos) const
+{
+  Ptr<Node> node;
+  if (m_numPartitions > 1)
+    {
+      // the system id can only be given to the constructor
+      double lon = atan2 (pos.y, pos.x) + M_PI;
+      uint32_t systemId = std::min<uint32_t> (lon / (2 * M_PI) * m_numPartitions, m_numPartitions - 1);
+      node = CreateObject<Node> (systemId);
+    }
+  else
+    {
+      node = m_gndNodeFactory.Create<Node> ();
+    }
+  Ptr<ConstantPositionMobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+  mob->SetPosition (pos);
+  node->AggregateObject (mob);
+  return node;
+}
+
 NodeContainer
 LeoGndNodeHelper::Install (const std::string &file)
 {
@@ -61,12 +91,8 @@ LeoGndNodeHelper::Install (const std::string &file)
   LeoLatLong loc;
   while ((stream >> loc))
     {
-      Ptr<ConstantPositionMobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
       Vector pos = GetEarthPosition (loc);
-      mob->SetPosition (pos);
-      Ptr<Node> node = m_gndNodeFactory.Create<Node> ();
-      node->AggregateObject (mob);
-      nodes.Add (node);
+      nodes.Add (CreateNode (pos));
       NS_LOG_INFO ("Added ground node at " << pos);
     }
   stream.close ();
@@ -79,18 +105,19 @@ LeoGndNodeHelper::Install (const std::string &file)
 NodeContainer
 LeoGndNodeHelper::Install (uint32_t latNodes, uint32_t lonNodes)
 {
+  // positions are needed before the nodes are created to know their
+  // system ids
+  ObjectFactory allocatorFactory;
+  allocatorFactory.SetTypeId ("ns3::LeoPolarPositionAllocator");
+  allocatorFactory.Set ("LatNum", UintegerValue (latNodes));
+  allocatorFactory.Set ("LonNum", UintegerValue (lonNodes));
+  Ptr<PositionAllocator> allocator = allocatorFactory.Create<PositionAllocator> ();
+
   NodeContainer nodes;
   for (uint64_t i = 0; i < lonNodes * latNodes; i++)
     {
-      nodes.Add (m_gndNodeFactory.Create<Node> ());
+      nodes.Add (CreateNode (allocator->GetNext ()));
     }
-  MobilityHelper mobility;
-  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
-  mobility.SetPositionAllocator ("ns3::LeoPolarPositionAllocator",
-  				 "LatNum", UintegerValue (latNodes),
-  				 "LonNum", UintegerValue (lonNodes));
-
-  mobility.Install (nodes);
 
   return nodes;
 }
@@ -118,11 +145,7 @@ LeoGndNodeHelper::Install (const LeoLatLong &location1,
   for (const LeoLatLong &loc : { location1, location2 })
     {
       Vector pos = GetEarthPosition (loc);
-      Ptr<ConstantPositionMobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
-      mob->SetPosition (pos);
-      Ptr<Node> node = m_gndNodeFactory.Create<Node> ();
-      node->AggregateObject (mob);
-      nodes.Add (node);
+      nodes.Add (CreateNode (pos));
       NS_LOG_INFO ("Added ground node at " << pos);
     }
 
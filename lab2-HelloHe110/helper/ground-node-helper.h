@@ -80,9 +80,27 @@ public:
    */
   void SetAttribute (std::string name, const AttributeValue &value);
 
+  /**
+   * \brief Spread the nodes over system ids for distributed simulations
+   *
+   * The earth is cut into slices of equal longitude, one per system id.
+   *
+   * \param numPartitions number of system ids, usually the number of MPI ranks
+   */
+  void SetNumPartitions (uint32_t numPartitions);
+
 private:
   /// Fatory for nodes
   ObjectFactory m_gndNodeFactory;
+  /// Number of system ids to spread the nodes over
+  uint32_t m_numPartitions;
+
+  /**
+   * \brief Create a node at a position
+   * \param pos position of the node
+   * \return the node with a constant position mobility model
+   */
+  Ptr<Node> CreateNode (const Vector &pos) const;
 
   /// Convert the latitude and longitude to a position on a sphere
   static Vector3D GetEarthPosition (const LeoLatLong &loc);
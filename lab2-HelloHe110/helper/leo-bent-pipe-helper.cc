@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include "ns3/log.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/leo-bent-pipe-forwarder.h"
+#include "ns3/leo-mock-channel.h"
+
+#include "leo-bent-pipe-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoBentPipeHelper");
+
+void
+LeoBentPipeHelper::Install (const NodeContainer &satellites) const
+{
+  NS_LOG_FUNCTION (this << satellites.GetN ());
+
+  for (NodeContainer::Iterator it = satellites.Begin (); it != satellites.End (); ++it)
+    {
+      Ptr<LeoBentPipeForwarder> forwarder = CreateObject<LeoBentPipeForwarder> ();
+      for (uint32_t i = 0; i < (*it)->GetNDevices (); i++)
+        {
+          Ptr<MockNetDevice> device = DynamicCast<MockNetDevice> ((*it)->GetDevice (i));
+          if (device)
+            {
+              forwarder->AddDevice (device);
+            }
+        }
+      (*it)->AggregateObject (forwarder);
+    }
+}
+
+void
+LeoBentPipeHelper::PopulateArpCache (const NodeContainer &stations) const
+{
+  NS_LOG_FUNCTION (this << stations.GetN ());
+
+  // address and interface of each station on the ground channel
+  std::vector<std::pair<Ipv4Address, Address> > addresses;
+  std::vector<Ptr<Ipv4Interface> > interfaces;
+  for (NodeContainer::Iterator it = stations.Begin (); it != stations.End (); ++it)
+    {
+      Ptr<Ipv4L3Protocol> ipv4 = (*it)->GetObject<Ipv4L3Protocol> ();
+      NS_ASSERT_MSG (ipv4, "Node " << (*it)->GetId () << " has no IP stack");
+      for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+        {
+          Ptr<NetDevice> device = ipv4->GetNetDevice (i);
+          if (ipv4->GetNAddresses (i) == 0 || !DynamicCast<LeoMockChannel> (device->GetChannel ()))
+            {
+              continue;
+            }
+          addresses.push_back (std::make_pair (ipv4->GetAddress (i, 0).GetLocal (), device->GetAddress ()));
+          interfaces.push_back (ipv4->GetInterface (i));
+          break;
+        }
+    }
+
+  for (std::size_t i = 0; i < interfaces.size (); i++)
+    {
+      Ptr<ArpCache> cache = interfaces[i]->GetArpCache ();
+      for (std::size_t j = 0; j < addresses.size (); j++)
+        {
+          if (i == j)
+            {
+              continue;
+            }
+          ArpCache::Entry *entry = cache->Lookup (addresses[j].first);
+          if (entry == 0)
+            {
+              entry = cache->Add (addresses[j].first);
+            }
+          entry->SetMacAddress (addresses[j].second);
+          entry->MarkPermanent ();
+        }
+    }
+}
+
+}; /* namespace ns3 */
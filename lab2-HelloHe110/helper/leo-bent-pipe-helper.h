@@ -0,0 +1,61 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_BENT_PIPE_HELPER_H
+#define LEO_BENT_PIPE_HELPER_H
+
+#include "ns3/node-container.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declares LeoBentPipeHelper
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Turns satellites into transparent layer 2 relays
+ *
+ * The satellites do not need an IP stack. The ground stations share one
+ * subnet on the ground channel and address each other directly, the
+ * satellites forward their frames. LeoStaticRoutingHelper::Install fills
+ * the forwarding tables.
+ */
+class LeoBentPipeHelper
+{
+public:
+  /**
+   * \brief Install a LeoBentPipeForwarder on each satellite, covering all of
+   * its devices
+   * \param satellites the satellites
+   */
+  void Install (const NodeContainer &satellites) const;
+
+  /**
+   * \brief Make the ground stations know the MAC addresses of each other,
+   * since no satellite relays their ARP requests
+   * \param stations the ground stations
+   */
+  void PopulateArpCache (const NodeContainer &stations) const;
+};
+
+}; /* namespace ns3 */
+
+#endif /* LEO_BENT_PIPE_HELPER_H */
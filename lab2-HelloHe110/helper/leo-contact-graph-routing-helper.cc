@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/leo-contact-graph-routing.h"
+
+#include "leo-contact-graph-routing-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoContactGraphRoutingHelper");
+
+LeoContactGraphRoutingHelper::LeoContactGraphRoutingHelper ()
+{
+  m_agentFactory.SetTypeId ("ns3::LeoContactGraphRouting");
+  m_plan = CreateObject<LeoContactPlan> ();
+}
+
+LeoContactGraphRoutingHelper::~LeoContactGraphRoutingHelper ()
+{
+}
+
+LeoContactGraphRoutingHelper*
+LeoContactGraphRoutingHelper::Copy (void) const
+{
+  return new LeoContactGraphRoutingHelper (*this);
+}
+
+Ptr<Ipv4RoutingProtocol>
+LeoContactGraphRoutingHelper::Create (Ptr<Node> node) const
+{
+  Ptr<LeoContactGraphRouting> agent = m_agentFactory.Create<LeoContactGraphRouting> ();
+  agent->SetContactPlan (m_plan);
+  return agent;
+}
+
+void
+LeoContactGraphRoutingHelper::ComputeContactPlan (const NodeContainer &satellites,
+                                                  const NodeContainer &stations,
+                                                  Time stop)
+{
+  NS_LOG_FUNCTION (this << stop);
+
+  m_plan->Clear ();
+  m_plan->Compute (satellites, stations, Simulator::Now (), stop);
+}
+
+Ptr<LeoContactPlan>
+LeoContactGraphRoutingHelper::GetContactPlan (void) const
+{
+  return m_plan;
+}
+
+void
+LeoContactGraphRoutingHelper::SetContactPlanAttribute (std::string name, const AttributeValue &value)
+{
+  m_plan->SetAttribute (name, value);
+}
+
+void
+LeoContactGraphRoutingHelper::Set (std::string name, const AttributeValue &value)
+{
+  m_agentFactory.Set (name, value);
+}
+
+}; /* namespace ns3 */
@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_CONTACT_GRAPH_ROUTING_HELPER_H
+#define LEO_CONTACT_GRAPH_ROUTING_HELPER_H
+
+#include "ns3/object-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/leo-contact-plan.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declares LeoContactGraphRoutingHelper
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Installs LeoContactGraphRouting with a contact plan shared by all
+ * nodes
+ */
+class LeoContactGraphRoutingHelper : public Ipv4RoutingHelper
+{
+public:
+  /// constructor
+  LeoContactGraphRoutingHelper ();
+  /// destructor
+  virtual ~LeoContactGraphRoutingHelper ();
+
+  /**
+   * \returns pointer to clone of this LeoContactGraphRoutingHelper
+   *
+   * This method is mainly for internal use by the other helpers;
+   * clients are expected to free the dynamic memory allocated by this method
+   */
+  LeoContactGraphRoutingHelper* Copy (void) const;
+
+  /**
+   * \param node the node on which the routing protocol will run
+   * \returns a newly-created routing protocol
+   */
+  virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+
+  /**
+   * \brief Predict the contacts of a constellation
+   * \param satellites the satellites
+   * \param stations the ground stations
+   * \param stop end of the planning window, which starts now
+   */
+  void ComputeContactPlan (const NodeContainer &satellites, const NodeContainer &stations,
+                           Time stop);
+
+  /**
+   * \brief Get the contact plan shared by the routing protocols
+   * \return the contact plan
+   */
+  Ptr<LeoContactPlan> GetContactPlan (void) const;
+
+  /**
+   * \brief Set an attribute of the contact plan
+   * \param name name of the attribute
+   * \param value value of the attribute
+   */
+  void SetContactPlanAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * \brief Set an attribute of each routing protocol
+   * \param name name of the attribute
+   * \param value value of the attribute
+   */
+  void Set (std::string name, const AttributeValue &value);
+
+private:
+  /// Factory for the routing protocols
+  ObjectFactory m_agentFactory;
+  /// Contact plan shared by all routing protocols
+  Ptr<LeoContactPlan> m_plan;
+};
+
+}; /* namespace ns3 */
+
+#endif /* LEO_CONTACT_GRAPH_ROUTING_HELPER_H */
@@ -0,0 +1,326 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/node.h"
+#include "ns3/mobility-model.h"
+#include "ns3/leo-circular-orbit-mobility-model.h"
+
+#include "leo-graph-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoGraphHelper");
+
+/// Identifies the binary format
+static const char LEO_GRAPH_MAGIC[4] = { 'L', 'E', 'O', 'G' };
+/// Version of the binary format
+static const uint32_t LEO_GRAPH_VERSION = 1;
+/// Number of steps evaluated at once
+static const uint32_t LEO_GRAPH_BLOCK = 64;
+
+LeoGraphHelper::LeoGraphHelper ()
+  : m_txPower (105.9),
+    m_noisePower (-110.0),
+    m_bandwidth (2e6),
+    m_rxThreshold (-60.0),
+    m_threads (0)
+{
+  m_model = CreateObject<LeoPropagationLossModel> ();
+  m_model->SetAttribute ("Beamforming", BooleanValue (true));
+}
+
+void
+LeoGraphHelper::SetLinkBudget (double txPower, double noisePower, double bandwidth, double rxThreshold)
+{
+  m_txPower = txPower;
+  m_noisePower = noisePower;
+  m_bandwidth = bandwidth;
+  m_rxThreshold = rxThreshold;
+}
+
+bool
+LeoGraphHelper::ReadLinkBudget (std::string file)
+{
+  std::ifstream in (file);
+  double txPower, noisePower, frequency, bandwidth, rxThreshold;
+  if (!(in >> txPower >> noisePower >> frequency >> bandwidth >> rxThreshold))
+    {
+      NS_LOG_WARN ("Could not read the link budget from " << file);
+      return false;
+    }
+  SetLinkBudget (txPower, noisePower, bandwidth, rxThreshold);
+  m_model->SetAttribute ("Frequency", DoubleValue (frequency));
+  return true;
+}
+
+void
+LeoGraphHelper::SetPropagationLoss (Ptr<LeoPropagationLossModel> model)
+{
+  m_model = model;
+}
+
+void
+LeoGraphHelper::SetThreads (uint32_t threads)
+{
+  m_threads = threads;
+}
+
+double
+LeoGraphHelper::GetRate (const Vector &station, const Vector &satellite) const
+{
+  double rxPower = m_model->CalcRxPowerAt (m_txPower, station, satellite);
+  if (rxPower < m_rxThreshold)
+    {
+      return 0.0;
+    }
+  double snr = pow (10.0, (rxPower - m_noisePower) / 10.0);
+  return m_bandwidth * log2 (1 + snr) / 1e3;
+}
+
+std::vector<Vector>
+LeoGraphHelper::GetPositions (const NodeContainer &nodes, Time t)
+{
+  std::vector<Vector> positions;
+  positions.reserve (nodes.GetN ());
+  for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+    {
+      Ptr<MobilityModel> mobility = (*it)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility, "Node " << (*it)->GetId () << " has no mobility model");
+      Ptr<LeoCircularOrbitMobilityModel> orbit = DynamicCast<LeoCircularOrbitMobilityModel> (mobility);
+      positions.push_back (orbit ? orbit->GetPositionAt (t) : mobility->GetPosition ());
+    }
+  return positions;
+}
+
+void
+LeoGraphHelper::Compute (const std::vector<std::vector<Vector> > &stations,
+                         const std::vector<std::vector<Vector> > &satellites,
+                         std::vector<LeoGraph> &graphs) const
+{
+  // one job per step and station, so that the links come out in order
+  uint32_t nStations = graphs.empty () ? 0 : graphs[0].nStations;
+  std::size_t n = graphs.size () * nStations;
+  std::vector<std::vector<LeoGraphLink> > links (n);
+  std::atomic<std::size_t> next (0);
+  auto work = [&] ()
+  {
+    for (std::size_t job = next++; job < n; job = next++)
+      {
+        std::size_t k = job / nStations;
+        uint32_t station = job % nStations;
+        const Vector &position = stations[k][station];
+        for (uint32_t satellite = 0; satellite < satellites[k].size (); satellite++)
+          {
+            double rate = GetRate (position, satellites[k][satellite]);
+            if (rate > 0)
+              {
+                LeoGraphLink link;
+                link.station = station;
+                link.satellite = satellite;
+                link.rate = rate;
+                links[job].push_back (link);
+              }
+          }
+      }
+  };
+
+  uint32_t threads = m_threads > 0 ? m_threads : std::max (1u, std::thread::hardware_concurrency ());
+  threads = std::min<std::size_t> (threads, std::max<std::size_t> (n, 1));
+  std::vector<std::thread> workers;
+  for (uint32_t i = 1; i < threads; i++)
+    {
+      workers.push_back (std::thread (work));
+    }
+  work ();
+  for (std::thread &worker : workers)
+    {
+      worker.join ();
+    }
+
+  for (std::size_t k = 0; k < graphs.size (); k++)
+    {
+      graphs[k].links.clear ();
+      for (uint32_t station = 0; station < nStations; station++)
+        {
+          const std::vector<LeoGraphLink> &l = links[k * nStations + station];
+          graphs[k].links.insert (graphs[k].links.end (), l.begin (), l.end ());
+        }
+    }
+}
+
+LeoGraph
+LeoGraphHelper::Compute (const NodeContainer &stations, const NodeContainer &satellites, Time t) const
+{
+  NS_LOG_FUNCTION (this << stations.GetN () << satellites.GetN () << t);
+
+  std::vector<LeoGraph> graphs (1);
+  graphs[0].time = t;
+  graphs[0].nStations = stations.GetN ();
+  graphs[0].nSatellites = satellites.GetN ();
+  Compute (std::vector<std::vector<Vector> > (1, GetPositions (stations, t)),
+           std::vector<std::vector<Vector> > (1, GetPositions (satellites, t)),
+           graphs);
+  return graphs[0];
+}
+
+uint32_t
+LeoGraphHelper::Write (const NodeContainer &stations, const NodeContainer &satellites,
+                       Time start, Time stop, Time step,
+                       std::ostream *text, std::ostream *binary) const
+{
+  NS_LOG_FUNCTION (this << stations.GetN () << satellites.GetN () << start << stop << step);
+  NS_ASSERT_MSG (step.IsStrictlyPositive (), "Step must be positive");
+
+  if (binary)
+    {
+      WriteBinaryHeader (*binary);
+    }
+
+  uint32_t written = 0;
+  Time t = start;
+  while (t <= stop)
+    {
+      // positions are taken on this thread, the pairs are evaluated in parallel
+      std::vector<LeoGraph> graphs;
+      std::vector<std::vector<Vector> > stationPositions;
+      std::vector<std::vector<Vector> > satellitePositions;
+      for (; t <= stop && graphs.size () < LEO_GRAPH_BLOCK; t += step)
+        {
+          LeoGraph graph;
+          graph.time = t;
+          graph.nStations = stations.GetN ();
+          graph.nSatellites = satellites.GetN ();
+          graphs.push_back (graph);
+          stationPositions.push_back (GetPositions (stations, t));
+          satellitePositions.push_back (GetPositions (satellites, t));
+        }
+      Compute (stationPositions, satellitePositions, graphs);
+
+      for (const LeoGraph &graph : graphs)
+        {
+          if (text)
+            {
+              WriteText (*text, graph);
+            }
+          if (binary)
+            {
+              WriteBinary (*binary, graph);
+            }
+        }
+      written += graphs.size ();
+      NS_LOG_INFO ("Wrote " << written << " graphs up to " << graphs.back ().time);
+    }
+  return written;
+}
+
+void
+LeoGraphHelper::WriteText (std::ostream &out, const LeoGraph &graph)
+{
+  char line[64];
+  snprintf (line, sizeof (line), "%u %u %zu\n", graph.nStations, graph.nSatellites, graph.links.size ());
+  out << line;
+  for (const LeoGraphLink &link : graph.links)
+    {
+      snprintf (line, sizeof (line), "%u %u %.6f\n", link.station, link.satellite, link.rate);
+      out << line;
+    }
+}
+
+void
+LeoGraphHelper::WriteBinaryHeader (std::ostream &out)
+{
+  out.write (LEO_GRAPH_MAGIC, sizeof (LEO_GRAPH_MAGIC));
+  out.write (reinterpret_cast<const char *> (&LEO_GRAPH_VERSION), sizeof (LEO_GRAPH_VERSION));
+}
+
+void
+LeoGraphHelper::WriteBinary (std::ostream &out, const LeoGraph &graph)
+{
+  double time = graph.time.GetSeconds ();
+  uint32_t counts[3] = { graph.nStations, graph.nSatellites, static_cast<uint32_t> (graph.links.size ()) };
+  out.write (reinterpret_cast<const char *> (&time), sizeof (time));
+  out.write (reinterpret_cast<const char *> (counts), sizeof (counts));
+
+  /// Layout of a link in the binary format
+  struct Record
+  {
+    uint32_t station;
+    uint32_t satellite;
+    float rate;
+  };
+  std::vector<Record> records (graph.links.size ());
+  for (std::size_t i = 0; i < graph.links.size (); i++)
+    {
+      records[i].station = graph.links[i].station;
+      records[i].satellite = graph.links[i].satellite;
+      records[i].rate = graph.links[i].rate;
+    }
+  out.write (reinterpret_cast<const char *> (records.data ()), records.size () * sizeof (Record));
+}
+
+bool
+LeoGraphHelper::ReadBinaryHeader (std::istream &in)
+{
+  char magic[sizeof (LEO_GRAPH_MAGIC)];
+  uint32_t version;
+  in.read (magic, sizeof (magic));
+  in.read (reinterpret_cast<char *> (&version), sizeof (version));
+  return in && memcmp (magic, LEO_GRAPH_MAGIC, sizeof (magic)) == 0 && version == LEO_GRAPH_VERSION;
+}
+
+bool
+LeoGraphHelper::ReadBinary (std::istream &in, LeoGraph &graph)
+{
+  double time;
+  uint32_t counts[3];
+  in.read (reinterpret_cast<char *> (&time), sizeof (time));
+  in.read (reinterpret_cast<char *> (counts), sizeof (counts));
+  if (!in)
+    {
+      return false;
+    }
+  graph.time = Seconds (time);
+  graph.nStations = counts[0];
+  graph.nSatellites = counts[1];
+  graph.links.resize (counts[2]);
+  for (LeoGraphLink &link : graph.links)
+    {
+      uint32_t ids[2];
+      float rate;
+      in.read (reinterpret_cast<char *> (ids), sizeof (ids));
+      in.read (reinterpret_cast<char *> (&rate), sizeof (rate));
+      link.station = ids[0];
+      link.satellite = ids[1];
+      link.rate = rate;
+    }
+  return static_cast<bool> (in);
+}
+
+}; /* namespace ns3 */
@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_GRAPH_HELPER_H
+#define LEO_GRAPH_HELPER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/node-container.h"
+
+#include "ns3/leo-propagation-loss-model.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declares LeoGraphHelper
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief A link from a ground station to a satellite
+ */
+struct LeoGraphLink
+{
+  /// Index of the ground station
+  uint32_t station;
+  /// Index of the satellite
+  uint32_t satellite;
+  /// Data rate in kbit/s
+  double rate;
+};
+
+/**
+ * \ingroup leo
+ * \brief The links between ground stations and satellites at a point in time
+ */
+struct LeoGraph
+{
+  /// Point in time
+  Time time;
+  /// Number of ground stations
+  uint32_t nStations;
+  /// Number of satellites
+  uint32_t nSatellites;
+  /// Links, ordered by station and satellite
+  std::vector<LeoGraphLink> links;
+};
+
+/**
+ * \ingroup leo
+ * \brief Derives the network graphs of the assignment labs from the
+ * mobility of the nodes
+ *
+ * At every step the ground stations transmit to every satellite at TxPower
+ * through a LeoPropagationLossModel, by default one with beamforming. Pairs
+ * received above the threshold become links, their rate is the Shannon
+ * capacity of the bandwidth at the SNR over the noise power. The pairs of
+ * a number of steps are evaluated on several threads at once, the graphs
+ * are written in order.
+ *
+ * The text format is the one of network.graph, a line with the number of
+ * stations, satellites and links followed by a line per link with the
+ * station, the satellite and the rate in kbit/s. The binary format starts
+ * with the magic LEOG and a version, followed by each graph as its time in
+ * seconds (double), the three counts (uint32) and the links (uint32,
+ * uint32, float), all in host byte order.
+ */
+class LeoGraphHelper
+{
+public:
+  /// constructor
+  LeoGraphHelper ();
+
+  /**
+   * \brief Set the link budget
+   * \param txPower transmit power of the ground stations in dBm
+   * \param noisePower noise power in dBm
+   * \param bandwidth bandwidth in Hz
+   * \param rxThreshold minimum receive power of a link in dBm
+   */
+  void SetLinkBudget (double txPower, double noisePower, double bandwidth, double rxThreshold);
+
+  /**
+   * \brief Read the link budget from the first line of a network.pos file
+   *
+   * The line holds the transmit power, the noise power, the frequency, the
+   * bandwidth and the receive threshold. The frequency is set on the
+   * propagation loss model.
+   *
+   * \param file path of the file
+   * \return true if the file could be read
+   */
+  bool ReadLinkBudget (std::string file);
+
+  /**
+   * \brief Set the propagation loss model
+   * \param model the model
+   */
+  void SetPropagationLoss (Ptr<LeoPropagationLossModel> model);
+
+  /**
+   * \brief Set the number of threads
+   * \param threads number of threads, 0 for one per core
+   */
+  void SetThreads (uint32_t threads);
+
+  /**
+   * \brief Get the rate of a link
+   * \param station position of the ground station
+   * \param satellite position of the satellite
+   * \return rate in kbit/s, 0 if the satellite is not reachable
+   */
+  double GetRate (const Vector &station, const Vector &satellite) const;
+
+  /**
+   * \brief Compute the graph of a point in time
+   * \param stations the ground stations
+   * \param satellites the satellites
+   * \param t point in time
+   * \return the graph
+   */
+  LeoGraph Compute (const NodeContainer &stations, const NodeContainer &satellites, Time t) const;
+
+  /**
+   * \brief Compute and write the graphs of a time window
+   * \param stations the ground stations
+   * \param satellites the satellites
+   * \param start first step
+   * \param stop last step
+   * \param step interval between two graphs
+   * \param text stream for the text format, may be 0
+   * \param binary stream for the binary format, may be 0
+   * \return number of graphs
+   */
+  uint32_t Write (const NodeContainer &stations, const NodeContainer &satellites,
+                  Time start, Time stop, Time step,
+                  std::ostream *text, std::ostream *binary) const;
+
+  /**
+   * \brief Write a graph in the text format
+   * \param out the stream
+   * \param graph the graph
+   */
+  static void WriteText (std::ostream &out, const LeoGraph &graph);
+
+  /**
+   * \brief Write the beginning of the binary format
+   * \param out the stream
+   */
+  static void WriteBinaryHeader (std::ostream &out);
+
+  /**
+   * \brief Write a graph in the binary format
+   * \param out the stream
+   * \param graph the graph
+   */
+  static void WriteBinary (std::ostream &out, const LeoGraph &graph);
+
+  /**
+   * \brief Read the beginning of the binary format
+   * \param in the stream
+   * \return true if the stream is in the binary format
+   */
+  static bool ReadBinaryHeader (std::istream &in);
+
+  /**
+   * \brief Read the next graph in the binary format
+   * \param in the stream
+   * \param [out] graph the graph
+   * \return false at the end of the stream
+   */
+  static bool ReadBinary (std::istream &in, LeoGraph &graph);
+
+private:
+  /**
+   * \brief Compute the graphs of several points in time
+   * \param stations positions of the ground stations by time
+   * \param satellites positions of the satellites by time
+   * \param graphs the graphs, with their time and counts set
+   */
+  void Compute (const std::vector<std::vector<Vector> > &stations,
+                const std::vector<std::vector<Vector> > &satellites,
+                std::vector<LeoGraph> &graphs) const;
+
+  /**
+   * \brief Get the positions of nodes
+   * \param nodes the nodes
+   * \param t point in time
+   * \return the positions
+   */
+  static std::vector<Vector> GetPositions (const NodeContainer &nodes, Time t);
+
+  /// Transmit power in dBm
+  double m_txPower;
+  /// Noise power in dBm
+  double m_noisePower;
+  /// Bandwidth in Hz
+  double m_bandwidth;
+  /// Receive threshold in dBm
+  double m_rxThreshold;
+  /// Number of threads
+  uint32_t m_threads;
+  /// Link budget
+  Ptr<LeoPropagationLossModel> m_model;
+};
+
+}; /* namespace ns3 */
+
+#endif /* LEO_GRAPH_HELPER_H */
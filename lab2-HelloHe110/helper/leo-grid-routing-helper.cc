@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/leo-grid-routing.h"
+
+#include "leo-grid-routing-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoGridRoutingHelper");
+
+LeoGridRoutingHelper::LeoGridRoutingHelper ()
+{
+  m_agentFactory.SetTypeId ("ns3::LeoGridRouting");
+}
+
+LeoGridRoutingHelper::~LeoGridRoutingHelper ()
+{
+}
+
+LeoGridRoutingHelper*
+LeoGridRoutingHelper::Copy (void) const
+{
+  return new LeoGridRoutingHelper (*this);
+}
+
+Ptr<Ipv4RoutingProtocol>
+LeoGridRoutingHelper::Create (Ptr<Node> node) const
+{
+  return m_agentFactory.Create<LeoGridRouting> ();
+}
+
+void
+LeoGridRoutingHelper::SetConstellation (const NodeContainer &satellites, const LeoOrbit &orbit,
+                                        const NodeContainer &stations)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_ASSERT_MSG (satellites.GetN () == (uint32_t) orbit.planes * orbit.sats,
+                 "Satellites do not match the orbit definition");
+
+  m_agentFactory.Set ("NumOrbits", UintegerValue (orbit.planes));
+  m_agentFactory.Set ("NumSatellites", UintegerValue (orbit.sats));
+  m_agentFactory.Set ("FirstSatellite", UintegerValue (satellites.Get (0)->GetId ()));
+  m_agentFactory.Set ("NumStations", UintegerValue (stations.GetN ()));
+  if (stations.GetN () > 0)
+    {
+      m_agentFactory.Set ("FirstStation", UintegerValue (stations.Get (0)->GetId ()));
+    }
+}
+
+void
+LeoGridRoutingHelper::Set (std::string name, const AttributeValue &value)
+{
+  m_agentFactory.Set (name, value);
+}
+
+}; /* namespace ns3 */
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_GRID_ROUTING_HELPER_H
+#define LEO_GRID_ROUTING_HELPER_H
+
+#include "ns3/object-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/leo-orbit.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declares LeoGridRoutingHelper
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Installs LeoGridRouting on the satellites and ground stations of a
+ * constellation
+ */
+class LeoGridRoutingHelper : public Ipv4RoutingHelper
+{
+public:
+  /// constructor
+  LeoGridRoutingHelper ();
+  /// destructor
+  virtual ~LeoGridRoutingHelper ();
+
+  /**
+   * \returns pointer to clone of this LeoGridRoutingHelper
+   *
+   * This method is mainly for internal use by the other helpers;
+   * clients are expected to free the dynamic memory allocated by this method
+   */
+  LeoGridRoutingHelper* Copy (void) const;
+
+  /**
+   * \param node the node on which the routing protocol will run
+   * \returns a newly-created routing protocol
+   */
+  virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+
+  /**
+   * \brief Describe the constellation to route on
+   * \param satellites satellites as returned by LeoOrbitNodeHelper::Install
+   * \param orbit orbit definition used to install the satellites
+   * \param stations ground stations
+   */
+  void SetConstellation (const NodeContainer &satellites, const LeoOrbit &orbit,
+                         const NodeContainer &stations);
+
+  /**
+   * \brief Set an attribute of each routing protocol
+   * \param name name of the attribute
+   * \param value value of the attribute
+   */
+  void Set (std::string name, const AttributeValue &value);
+
+private:
+  /// Factory for the routing protocols
+  ObjectFactory m_agentFactory;
+};
+
+}; /* namespace ns3 */
+
+#endif /* LEO_GRID_ROUTING_HELPER_H */
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/simulator.h"
+#include "ns3/mobility-model.h"
+#include "ns3/mpi-interface.h"
+#ifdef NS3_MPI
+#include "ns3/distributed-simulator-impl.h"
+#endif
+#include "ns3/leo-circular-orbit-mobility-model.h"
+#include "ns3/leo-propagation-loss-model.h"
+#include "ns3/isl-mock-channel.h"
+
+#include "leo-mpi-helper.h"
+
+/// Upper bound of the speed at which two satellites in LEO approach in m/s
+#define LEO_MAX_APPROACH_SPEED 16000.0
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoMpiHelper");
+
+LeoMpiHelper::LeoMpiHelper ()
+  : m_step (Seconds (1))
+{
+}
+
+void
+LeoMpiHelper::SetStep (Time step)
+{
+  NS_ASSERT_MSG (step.IsStrictlyPositive (), "Step must be positive");
+  m_step = step;
+}
+
+Time
+LeoMpiHelper::CalculateLookAhead (const NodeContainer &satellites, const NodeContainer &stations,
+                                  Time stop) const
+{
+  NS_LOG_FUNCTION (this << satellites.GetN () << stations.GetN () << stop);
+
+  std::vector<Ptr<Node> > nodes (satellites.Begin (), satellites.End ());
+  uint32_t numSatellites = nodes.size ();
+  nodes.insert (nodes.end (), stations.Begin (), stations.End ());
+
+  // only satellites with an ISL device reach each other
+  std::vector<bool> isl (numSatellites, false);
+  for (uint32_t i = 0; i < numSatellites; i++)
+    {
+      for (uint32_t j = 0; j < nodes[i]->GetNDevices (); j++)
+        {
+          if (DynamicCast<IslMockChannel> (nodes[i]->GetDevice (j)->GetChannel ()))
+            {
+              isl[i] = true;
+            }
+        }
+    }
+
+  std::vector<Time> times;
+  for (Time t = Simulator::Now (); t < stop; t += m_step)
+    {
+      times.push_back (t);
+    }
+  times.push_back (stop);
+
+  double minDistance = std::numeric_limits<double>::infinity ();
+  std::vector<Vector> positions (nodes.size ());
+  for (const Time &t : times)
+    {
+      for (uint32_t i = 0; i < nodes.size (); i++)
+        {
+          Ptr<MobilityModel> mobility = nodes[i]->GetObject<MobilityModel> ();
+          Ptr<LeoCircularOrbitMobilityModel> orbit = DynamicCast<LeoCircularOrbitMobilityModel> (mobility);
+          positions[i] = orbit ? orbit->GetPositionAt (t) : mobility->GetPosition ();
+        }
+      // ground stations only talk to satellites
+      for (uint32_t i = 0; i < numSatellites; i++)
+        {
+          for (uint32_t j = i + 1; j < nodes.size (); j++)
+            {
+              if (nodes[i]->GetSystemId () == nodes[j]->GetSystemId ()
+                  || (j < numSatellites && !(isl[i] && isl[j])))
+                {
+                  continue;
+                }
+              minDistance = std::min (minDistance, CalculateDistance (positions[i], positions[j]));
+            }
+        }
+    }
+
+  if (minDistance == std::numeric_limits<double>::infinity ())
+    {
+      return Time::Max ();
+    }
+
+  double bound = minDistance - LEO_MAX_APPROACH_SPEED * m_step.GetSeconds () / 2;
+  NS_ABORT_MSG_IF (bound <= 0, "Nodes of different ranks come as close as " << minDistance
+                   << " m, use fewer partitions or a smaller step");
+  Time lookAhead = Seconds (bound / LEO_SPEED_OF_LIGHT_IN_AIR);
+  NS_LOG_INFO ("Lookahead is " << lookAhead << " for a minimum distance of " << minDistance << " m");
+  return lookAhead;
+}
+
+Time
+LeoMpiHelper::Install (const NodeContainer &satellites, const NodeContainer &stations,
+                       Time stop) const
+{
+  NS_LOG_FUNCTION (this << stop);
+
+  Time lookAhead = CalculateLookAhead (satellites, stations, stop);
+  if (!MpiInterface::IsEnabled ())
+    {
+      return lookAhead;
+    }
+
+#ifdef NS3_MPI
+  Ptr<DistributedSimulatorImpl> impl = DynamicCast<DistributedSimulatorImpl> (Simulator::GetImplementation ());
+  NS_ABORT_MSG_UNLESS (impl, "LeoMpiHelper needs ns3::DistributedSimulatorImpl");
+  impl->BoundLookAhead (lookAhead);
+#endif
+
+  return lookAhead;
+}
+
+}; /* namespace ns3 */
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_MPI_HELPER_H
+#define LEO_MPI_HELPER_H
+
+#include "ns3/nstime.h"
+#include "ns3/node-container.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declares LeoMpiHelper
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Prepares a distributed simulation of a constellation
+ *
+ * The satellites and ground stations have to be spread over the ranks when
+ * they are created, see LeoOrbitNodeHelper::SetNumPartitions and
+ * LeoGndNodeHelper::SetNumPartitions. Frames to nodes of other ranks are
+ * then sent over MPI by the channels.
+ *
+ * The ranks may only run ahead of each other by less than the shortest
+ * propagation delay between them. The mock channels are not point to point,
+ * so the distributed simulator can not find that delay on its own. This
+ * helper predicts the distance between all nodes of different ranks that
+ * can reach each other and bounds the lookahead of the simulator.
+ */
+class LeoMpiHelper
+{
+public:
+  /// constructor
+  LeoMpiHelper ();
+
+  /**
+   * \brief Set the sampling interval of the distance prediction
+   * \param step sampling interval
+   */
+  void SetStep (Time step);
+
+  /**
+   * \brief Predict the shortest propagation delay between ranks
+   *
+   * The distance is sampled every step and reduced by how far two
+   * satellites can approach each other within half a step, so that it is a
+   * lower bound for the whole window.
+   *
+   * \param satellites the satellites
+   * \param stations the ground stations
+   * \param stop end of the simulation
+   * \return the lookahead, or the maximum time if no two ranks are linked
+   */
+  Time CalculateLookAhead (const NodeContainer &satellites, const NodeContainer &stations,
+                           Time stop) const;
+
+  /**
+   * \brief Bound the lookahead of the distributed simulator
+   * \param satellites the satellites
+   * \param stations the ground stations
+   * \param stop end of the simulation
+   * \return the lookahead
+   */
+  Time Install (const NodeContainer &satellites, const NodeContainer &stations,
+                Time stop) const;
+
+private:
+  /// Sampling interval of the distance prediction
+  Time m_step;
+};
+
+}; /* namespace ns3 */
+
+#endif /* LEO_MPI_HELPER_H */
@@ -35,6 +35,7 @@ namespace ns3
 NS_LOG_COMPONENT_DEFINE ("LeoOrbitNodeHelper");
 
 LeoOrbitNodeHelper::LeoOrbitNodeHelper ()
+  : m_numPartitions (1)
 {
   m_nodeFactory.SetTypeId ("ns3::Node");
 }
@@ -49,6 +50,13 @@ LeoOrbitNodeHelper::SetAttribute (string name, const AttributeValue &value)
   m_nodeFactory.Set (name, value);
 }
 
+void
+LeoOrbitNodeHelper::SetNumPartitions (uint32_t numPartitions)
+{
+  NS_ASSERT_MSG (numPartitions > 0, "Need at least one partition");
+  m_numPartitions = numPartitions;
+}
+
 NodeContainer
 LeoOrbitNodeHelper::Install (const LeoOrbit &orbit)
 {
@@ -62,8 +70,12 @@ LeoOrbitNodeHelper::Install (const LeoOrbit &orbit)
   			     "Altitude", DoubleValue (orbit.alt),
   			     "Inclination", DoubleValue (orbit.inc));
 
+  // the allocator fills one plane after the other
   NodeContainer c;
-  c.Create (orbit.sats*orbit.planes);
+  for (uint32_t plane = 0; plane < (uint32_t) orbit.planes; plane++)
+    {
+      c.Create (orbit.sats, plane * m_numPartitions / orbit.planes);
+    }
   mobility.Install (c);
 
   return c;
@@ -80,9 +80,22 @@ public:
    */
   void SetAttribute (std::string name, const AttributeValue &value);
 
+  /**
+   * Spread the satellites over system ids for distributed simulations
+   *
+   * Each orbital plane goes to one system id, neighboring planes to the
+   * same one as far as possible, so most inter-satellite links stay within a
+   * rank.
+   *
+   * \param numPartitions number of system ids, usually the number of MPI ranks
+   */
+  void SetNumPartitions (uint32_t numPartitions);
+
 private:
   /// Factory for nodes
   ObjectFactory m_nodeFactory;
+  /// Number of system ids to spread the planes over
+  uint32_t m_numPartitions;
 };
 
 }; // namespace ns3
@@ -0,0 +1,54 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include "leo-scheduler-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSchedulerHelper");
+
+LeoSchedulerHelper::LeoSchedulerHelper ()
+{
+  m_factory.SetTypeId ("ns3::LeoCalendarScheduler");
+}
+
+void
+LeoSchedulerHelper::SetScheduler (std::string type)
+{
+  NS_LOG_FUNCTION (this << type);
+  m_factory.SetTypeId (type);
+}
+
+void
+LeoSchedulerHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  NS_LOG_FUNCTION (this << name);
+  m_factory.Set (name, value);
+}
+
+void
+LeoSchedulerHelper::Install (void) const
+{
+  NS_LOG_FUNCTION (this << m_factory.GetTypeId ().GetName ());
+  Simulator::SetScheduler (m_factory);
+}
+
+}; /* namespace ns3 */
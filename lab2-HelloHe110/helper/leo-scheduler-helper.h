@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_SCHEDULER_HELPER_H
+#define LEO_SCHEDULER_HELPER_H
+
+#include <string>
+
+#include "ns3/object-factory.h"
+#include "ns3/attribute.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declares LeoSchedulerHelper
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Selects the event scheduler of the simulator
+ *
+ * Uses LeoCalendarScheduler by default. The stock schedulers of ns-3 can be
+ * selected as well, for example to compare them.
+ */
+class LeoSchedulerHelper
+{
+public:
+  /// constructor
+  LeoSchedulerHelper ();
+
+  /**
+   * \brief Set the type of the scheduler
+   * \param type name of the type, e.g. ns3::MapScheduler
+   */
+  void SetScheduler (std::string type);
+
+  /**
+   * \brief Set an attribute of the scheduler
+   * \param name name of the attribute
+   * \param value value of the attribute
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * \brief Make the simulator use the scheduler
+   *
+   * Events that have already been scheduled are moved to the new scheduler.
+   */
+  void Install (void) const;
+
+private:
+  /// Factory of the scheduler
+  ObjectFactory m_factory;
+};
+
+}; /* namespace ns3 */
+
+#endif /* LEO_SCHEDULER_HELPER_H */
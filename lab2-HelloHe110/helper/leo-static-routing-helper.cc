@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include "ns3/log.h"
+#include "ns3/ipv4-static-routing.h"
+
+#include "leo-static-routing-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoStaticRoutingHelper");
+
+LeoStaticRoutingHelper::LeoStaticRoutingHelper ()
+{
+  m_managerFactory.SetTypeId ("ns3::LeoStaticRouteManager");
+}
+
+LeoStaticRoutingHelper::~LeoStaticRoutingHelper ()
+{
+}
+
+LeoStaticRoutingHelper*
+LeoStaticRoutingHelper::Copy (void) const
+{
+  return new LeoStaticRoutingHelper (*this);
+}
+
+Ptr<Ipv4RoutingProtocol>
+LeoStaticRoutingHelper::Create (Ptr<Node> node) const
+{
+  return CreateObject<Ipv4StaticRouting> ();
+}
+
+Ptr<LeoStaticRouteManager>
+LeoStaticRoutingHelper::Install (const NodeContainer &satellites,
+                                 const NodeContainer &stations)
+{
+  NS_LOG_FUNCTION (this << satellites.GetN () << stations.GetN ());
+
+  Ptr<LeoStaticRouteManager> manager = m_managerFactory.Create<LeoStaticRouteManager> ();
+  manager->SetNodes (satellites, stations);
+  manager->Start ();
+  return manager;
+}
+
+void
+LeoStaticRoutingHelper::SetRouteManagerAttribute (std::string name, const AttributeValue &value)
+{
+  m_managerFactory.Set (name, value);
+}
+
+}; /* namespace ns3 */
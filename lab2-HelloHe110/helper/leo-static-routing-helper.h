@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_STATIC_ROUTING_HELPER_H
+#define LEO_STATIC_ROUTING_HELPER_H
+
+#include "ns3/object-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/leo-static-route-manager.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declares LeoStaticRoutingHelper
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Installs Ipv4StaticRouting and fills it with routes computed from
+ * the geometry of the constellation instead of discovering them
+ *
+ * Use it with InternetStackHelper::SetRoutingHelper like any other routing
+ * helper and call Install once the addresses are assigned.
+ */
+class LeoStaticRoutingHelper : public Ipv4RoutingHelper
+{
+public:
+  /// constructor
+  LeoStaticRoutingHelper ();
+  /// destructor
+  virtual ~LeoStaticRoutingHelper ();
+
+  /**
+   * \returns pointer to clone of this LeoStaticRoutingHelper
+   *
+   * This method is mainly for internal use by the other helpers;
+   * clients are expected to free the dynamic memory allocated by this method
+   */
+  LeoStaticRoutingHelper* Copy (void) const;
+
+  /**
+   * \param node the node on which the routing protocol will run
+   * \returns a newly-created routing protocol
+   */
+  virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+
+  /**
+   * \brief Compute the routes between satellites and ground stations and
+   * keep them up to date
+   * \param satellites the satellites
+   * \param stations the ground stations
+   * \return the route manager
+   */
+  Ptr<LeoStaticRouteManager> Install (const NodeContainer &satellites,
+                                      const NodeContainer &stations);
+
+  /**
+   * \brief Set an attribute of the route managers created by Install
+   * \param name name of the attribute
+   * \param value value of the attribute
+   */
+  void SetRouteManagerAttribute (std::string name, const AttributeValue &value);
+
+private:
+  /// Factory for the route managers
+  ObjectFactory m_managerFactory;
+};
+
+}; /* namespace ns3 */
+
+#endif /* LEO_STATIC_ROUTING_HELPER_H */
@@ -0,0 +1,259 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <sched.h>
+#endif
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+#include "leo-sweep-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSweepHelper");
+
+LeoSweepHelper::LeoSweepHelper ()
+  : m_replications (1),
+    m_workers (0)
+{
+}
+
+void
+LeoSweepHelper::SetProgram (std::string program)
+{
+  m_program = program;
+}
+
+void
+LeoSweepHelper::AddParameter (std::string name, const std::vector<std::string> &values)
+{
+  NS_ASSERT_MSG (!values.empty (), "Parameter " << name << " has no values");
+  m_names.push_back (name);
+  m_values.push_back (values);
+}
+
+void
+LeoSweepHelper::AddArgument (std::string argument)
+{
+  m_arguments.push_back (argument);
+}
+
+void
+LeoSweepHelper::SetReplications (uint32_t replications)
+{
+  NS_ASSERT_MSG (replications > 0, "At least one replication is needed");
+  m_replications = replications;
+}
+
+void
+LeoSweepHelper::SetWorkers (uint32_t workers)
+{
+  m_workers = workers;
+}
+
+uint32_t
+LeoSweepHelper::GetNRuns (void) const
+{
+  uint32_t runs = m_replications;
+  for (const std::vector<std::string> &values : m_values)
+    {
+      runs *= values.size ();
+    }
+  return runs;
+}
+
+std::vector<uint32_t>
+LeoSweepHelper::GetCombination (uint32_t run, uint32_t &replication) const
+{
+  // the first parameter changes slowest, the replication fastest
+  replication = run % m_replications;
+  run /= m_replications;
+  std::vector<uint32_t> combination (m_values.size ());
+  for (std::size_t i = m_values.size (); i > 0; i--)
+    {
+      combination[i - 1] = run % m_values[i - 1].size ();
+      run /= m_values[i - 1].size ();
+    }
+  return combination;
+}
+
+std::vector<std::string>
+LeoSweepHelper::GetArguments (uint32_t run) const
+{
+  uint32_t replication;
+  std::vector<uint32_t> combination = GetCombination (run, replication);
+  std::vector<std::string> arguments = m_arguments;
+  for (std::size_t i = 0; i < m_names.size (); i++)
+    {
+      arguments.push_back ("--" + m_names[i] + "=" + m_values[i][combination[i]]);
+    }
+  std::ostringstream rngRun;
+  rngRun << "--RngRun=" << replication + 1;
+  arguments.push_back (rngRun.str ());
+  return arguments;
+}
+
+double
+LeoSweepHelper::Run (std::string output) const
+{
+  NS_LOG_FUNCTION (this << m_program << output);
+
+  uint32_t cores = std::max (1u, std::thread::hardware_concurrency ());
+  uint32_t workers = m_workers > 0 ? m_workers : cores;
+  uint32_t runs = GetNRuns ();
+
+  /// A run in progress
+  struct Slot
+  {
+    pid_t pid;
+    uint32_t run;
+    std::string file;
+    std::chrono::steady_clock::time_point start;
+  };
+  std::vector<Slot> slots (workers);
+  for (Slot &slot : slots)
+    {
+      slot.pid = 0;
+    }
+  std::vector<std::string> rows (runs);
+
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now ();
+  uint32_t next = 0;
+  uint32_t done = 0;
+  while (done < runs)
+    {
+      for (uint32_t i = 0; i < workers && next < runs; i++)
+        {
+          if (slots[i].pid != 0)
+            {
+              continue;
+            }
+          char file[] = "/tmp/leo-sweep-XXXXXX";
+          int fd = mkstemp (file);
+          NS_ABORT_MSG_IF (fd < 0, "Unable to create a file for the output of a run");
+
+          std::vector<std::string> arguments = GetArguments (next);
+          std::vector<char *> argv;
+          argv.push_back (const_cast<char *> (m_program.c_str ()));
+          for (const std::string &argument : arguments)
+            {
+              argv.push_back (const_cast<char *> (argument.c_str ()));
+            }
+          argv.push_back (0);
+
+          pid_t pid = fork ();
+          NS_ABORT_MSG_IF (pid < 0, "Unable to start a run");
+          if (pid == 0)
+            {
+#ifdef __linux__
+              cpu_set_t cpus;
+              CPU_ZERO (&cpus);
+              CPU_SET (i % cores, &cpus);
+              sched_setaffinity (0, sizeof (cpus), &cpus);
+#endif
+              dup2 (fd, STDOUT_FILENO);
+              close (fd);
+              execv (m_program.c_str (), argv.data ());
+              _exit (127);
+            }
+          close (fd);
+          NS_LOG_INFO ("Started run " << next << " as process " << pid);
+          slots[i].pid = pid;
+          slots[i].run = next;
+          slots[i].file = file;
+          slots[i].start = std::chrono::steady_clock::now ();
+          next++;
+        }
+
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          NS_ABORT_MSG_IF (errno != EINTR, "Lost track of the runs");
+          continue;
+        }
+      std::vector<Slot>::iterator slot = std::find_if (slots.begin (), slots.end (),
+                                                        [pid] (const Slot &s) { return s.pid == pid; });
+      if (slot == slots.end ())
+        {
+          continue;
+        }
+      double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - slot->start).count ();
+      int code = WIFEXITED (status) ? WEXITSTATUS (status) : 128 + WTERMSIG (status);
+      NS_LOG_INFO ("Run " << slot->run << " exited with " << code << " after " << seconds << " s");
+
+      uint32_t replication;
+      std::vector<uint32_t> combination = GetCombination (slot->run, replication);
+      std::ostringstream prefix;
+      for (std::size_t i = 0; i < m_names.size (); i++)
+        {
+          prefix << m_values[i][combination[i]] << "\t";
+        }
+      prefix << replication << "\t" << code << "\t" << seconds << "\t";
+
+      std::ostringstream row;
+      std::ifstream in (slot->file.c_str ());
+      std::string line;
+      bool empty = true;
+      while (std::getline (in, line))
+        {
+          std::replace (line.begin (), line.end (), '\t', ' ');
+          row << prefix.str () << line << "\n";
+          empty = false;
+        }
+      if (empty)
+        {
+          row << prefix.str () << "\n";
+        }
+      rows[slot->run] = row.str ();
+      unlink (slot->file.c_str ());
+      slot->pid = 0;
+      done++;
+    }
+  double elapsed = std::chrono::duration<double> (std::chrono::steady_clock::now () - begin).count ();
+
+  std::ofstream out (output.c_str ());
+  for (const std::string &name : m_names)
+    {
+      out << name << "\t";
+    }
+  out << "replication\tstatus\tseconds\toutput\n";
+  for (const std::string &row : rows)
+    {
+      out << row;
+    }
+
+  return elapsed > 0 ? runs * 3600.0 / elapsed : 0;
+}
+
+}; /* namespace ns3 */
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_SWEEP_HELPER_H
+#define LEO_SWEEP_HELPER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup leo
+ * Declares LeoSweepHelper
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Runs a program for every combination of command line values
+ *
+ * Every combination of the parameter values is run for a number of
+ * replications, each with its own RngRun. The runs are independent
+ * processes, of which up to one per worker run at the same time, each
+ * pinned to its own core where the platform supports it.
+ *
+ * The standard output of every run is collected into a single tab separated
+ * file with one row per output line, preceded by the parameter values, the
+ * replication, the exit status and the wall clock time of the run.
+ */
+class LeoSweepHelper
+{
+public:
+  /// constructor
+  LeoSweepHelper ();
+
+  /**
+   * \brief Set the program to run
+   * \param program path to the executable
+   */
+  void SetProgram (std::string program);
+
+  /**
+   * \brief Add a parameter to sweep over
+   * \param name name of the command line value, without dashes
+   * \param values the values to run with
+   */
+  void AddParameter (std::string name, const std::vector<std::string> &values);
+
+  /**
+   * \brief Add an argument that is passed to every run
+   * \param argument the argument, e.g. --duration=100
+   */
+  void AddArgument (std::string argument);
+
+  /**
+   * \brief Set the number of replications of every combination
+   * \param replications number of replications
+   */
+  void SetReplications (uint32_t replications);
+
+  /**
+   * \brief Set the number of runs at the same time
+   * \param workers number of workers, 0 for one per core
+   */
+  void SetWorkers (uint32_t workers);
+
+  /**
+   * \brief Get the number of runs
+   * \return the number of combinations times the replications
+   */
+  uint32_t GetNRuns (void) const;
+
+  /**
+   * \brief Get the command line of a run
+   * \param run index of the run
+   * \return the arguments, without the program
+   */
+  std::vector<std::string> GetArguments (uint32_t run) const;
+
+  /**
+   * \brief Run all combinations
+   * \param output path of the results file
+   * \return the throughput in runs per hour
+   */
+  double Run (std::string output) const;
+
+private:
+  /**
+   * \brief Get the index of the value of each parameter of a run
+   * \param run index of the run
+   * \param [out] replication the replication of the run
+   * \return the index of the value of each parameter
+   */
+  std::vector<uint32_t> GetCombination (uint32_t run, uint32_t &replication) const;
+
+  /// Program to run
+  std::string m_program;
+  /// Names of the parameters
+  std::vector<std::string> m_names;
+  /// Values of each parameter
+  std::vector<std::vector<std::string> > m_values;
+  /// Arguments of every run
+  std::vector<std::string> m_arguments;
+  /// Number of replications
+  uint32_t m_replications;
+  /// Number of runs at the same time
+  uint32_t m_workers;
+};
+
+}; /* namespace ns3 */
+
+#endif /* LEO_SWEEP_HELPER_H */
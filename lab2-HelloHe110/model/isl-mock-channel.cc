@@ -75,12 +75,14 @@ IslMockChannel::TransmitStart (
     if (Mac48Address::ConvertFrom (destAddr).IsBroadcast () || Mac48Address::ConvertFrom (destAddr).IsBroadcast ())
       // try to deliver to every node in LOS
       {
+        std::vector<Ptr<MockNetDevice> > devices;
+        devices.reserve (GetNDevices ());
         for (size_t i = 0; i < GetNDevices (); i ++)
           {
             if (i == srcId) continue;
-            dst = StaticCast<MockNetDevice> (GetDevice (i));
-            Deliver (p, src, dst, txTime);
+            devices.push_back (StaticCast<MockNetDevice> (GetDevice (i)));
           }
+        DeliverAll (p, src, devices, txTime);
         return true;
       }
     else
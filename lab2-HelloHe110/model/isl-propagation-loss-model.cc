@@ -50,10 +50,14 @@ IslPropagationLossModel::~IslPropagationLossModel ()
 
 bool
 IslPropagationLossModel::GetLos (Ptr<MobilityModel> moda, Ptr<MobilityModel> modb)
+{
+  return GetLos (moda->GetPosition (), modb->GetPosition ());
+}
+
+bool
+IslPropagationLossModel::GetLos (const Vector &apos, const Vector &bpos)
 {
   // origin of LOS
-  Vector3D apos = moda->GetPosition ();
-  Vector3D bpos = modb->GetPosition ();
 
   // select upper satellite as origin
   Vector oc = apos.GetLength () > bpos.GetLength () ? apos : bpos;
@@ -70,7 +74,7 @@ IslPropagationLossModel::GetLos (Ptr<MobilityModel> moda, Ptr<MobilityModel> mod
   double c = (oc.x*oc.x + oc.y*oc.y + oc.z*oc.z) - (LEO_EARTH_RAD*LEO_EARTH_RAD);
   double discriminant = b*b - 4*a*c;
 
-  NS_LOG_DEBUG ("a_pos="<<moda->GetPosition ()<<";b_pos"<<modb->GetPosition ()
+  NS_LOG_DEBUG ("a_pos="<<apos<<";b_pos"<<bpos
   		<<";u="<<u
   		<<";a="<<a
   		<<";b="<<b
@@ -102,6 +106,12 @@ IslPropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                         Ptr<MobilityModel> b) const
 {
   NS_LOG_FUNCTION (this << txPowerDbm << a << b);
+  return CalcRxPowerAt (txPowerDbm, a->GetPosition (), b->GetPosition ());
+}
+
+double
+IslPropagationLossModel::CalcRxPowerAt (double txPowerDbm, const Vector &a, const Vector &b) const
+{
   if (!GetLos (a, b))
     {
       return -1000.0;
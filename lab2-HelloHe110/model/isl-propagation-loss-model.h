@@ -62,6 +62,27 @@ public:
    * \return true iff there is a line-of-sight between the points
    */
   static bool GetLos (Ptr<MobilityModel> a, Ptr<MobilityModel> b);
+
+  /**
+   * \brief Check if there is a direc line-of-sight between the two positions
+   * \param a first position
+   * \param b second position
+   * \return true iff there is a line-of-sight between the positions
+   */
+  static bool GetLos (const Vector &a, const Vector &b);
+
+  /**
+   * \brief Calculate the Rx Power between two positions
+   *
+   * Does not touch the model at all, so it may be called from several
+   * threads at once.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a position of the source
+   * \param b position of the destination
+   * \returns the reception power after adding/multiplying propagation loss (in dBm)
+   */
+  double CalcRxPowerAt (double txPowerDbm, const Vector &a, const Vector &b) const;
 private:
   /**
    * Returns the Rx Power taking into account only the particular
@@ -0,0 +1,271 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <math.h>
+#include <algorithm>
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+
+#include "leo-array-gain.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoArrayGain");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoArrayGain);
+
+TypeId
+LeoArrayGain::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoArrayGain")
+    .SetParent<Object> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<LeoArrayGain> ()
+    .AddAttribute ("Antennas",
+                   "Number of elements of the array",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&LeoArrayGain::SetAntennas),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Spacing",
+                   "Distance between two elements in wavelengths",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&LeoArrayGain::SetSpacing),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("BeamStep",
+                   "Angle between two beams of the codebook in degrees",
+                   DoubleValue (5.0),
+                   MakeDoubleAccessor (&LeoArrayGain::SetBeamStep),
+                   MakeDoubleChecker<double> (0.01, 180.0))
+    .AddAttribute ("MaxBeamAngle",
+                   "Direction of the last beam of the codebook in degrees",
+                   DoubleValue (90.0),
+                   MakeDoubleAccessor (&LeoArrayGain::SetMaxBeamAngle),
+                   MakeDoubleChecker<double> (0.0, 180.0))
+    .AddAttribute ("Resolution",
+                   "Number of angles between 0 and 180 degrees the gains are tabulated at",
+                   UintegerValue (1800),
+                   MakeUintegerAccessor (&LeoArrayGain::SetResolution),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+LeoArrayGain::LeoArrayGain ()
+  : m_antennas (16),
+    m_spacing (0.5),
+    m_beamStep (5.0),
+    m_maxBeamAngle (90.0),
+    m_resolution (1800),
+    m_constructed (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoArrayGain::~LeoArrayGain ()
+{
+}
+
+void
+LeoArrayGain::NotifyConstructionCompleted (void)
+{
+  Object::NotifyConstructionCompleted ();
+  m_constructed = true;
+  Update ();
+}
+
+void
+LeoArrayGain::SetAntennas (uint32_t antennas)
+{
+  m_antennas = antennas;
+  Update ();
+}
+
+void
+LeoArrayGain::SetSpacing (double spacing)
+{
+  m_spacing = spacing;
+  Update ();
+}
+
+void
+LeoArrayGain::SetBeamStep (double step)
+{
+  m_beamStep = step;
+  Update ();
+}
+
+void
+LeoArrayGain::SetMaxBeamAngle (double angle)
+{
+  m_maxBeamAngle = angle;
+  Update ();
+}
+
+void
+LeoArrayGain::SetResolution (uint32_t resolution)
+{
+  m_resolution = resolution;
+  Update ();
+}
+
+void
+LeoArrayGain::Update (void)
+{
+  if (!m_constructed)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_antennas << m_spacing << m_beamStep << m_maxBeamAngle << m_resolution);
+
+  m_beams.clear ();
+  for (uint32_t i = 0; i * m_beamStep <= m_maxBeamAngle + 1e-9; i++)
+    {
+      m_beams.push_back (i * m_beamStep);
+    }
+
+  // phase difference between neighboring elements towards every angle
+  uint32_t nAngles = m_resolution + 1;
+  std::vector<double> psi (nAngles);
+  for (uint32_t k = 0; k < nAngles; k++)
+    {
+      psi[k] = 2 * M_PI * m_spacing * cos (k * M_PI / m_resolution);
+    }
+
+  // uniform weights steered to the beam, the array factor
+  // sum_n exp (j (n - (N - 1) / 2) (psi - psi0)) is real since the element
+  // positions are symmetric around the center of the array
+  m_gains.assign (m_beams.size () * nAngles, 0.0);
+  std::vector<double> x (nAngles);
+  for (std::size_t b = 0; b < m_beams.size (); b++)
+    {
+      double psi0 = 2 * M_PI * m_spacing * cos (m_beams[b] * M_PI / 180.0);
+      for (uint32_t k = 0; k < nAngles; k++)
+        {
+          x[k] = psi[k] - psi0;
+        }
+      double *gains = &m_gains[b * nAngles];
+      for (uint32_t n = 0; n < m_antennas; n++)
+        {
+          double m = n - (m_antennas - 1) / 2.0;
+          for (uint32_t k = 0; k < nAngles; k++)
+            {
+              gains[k] += cos (m * x[k]);
+            }
+        }
+      for (uint32_t k = 0; k < nAngles; k++)
+        {
+          gains[k] *= gains[k];
+        }
+    }
+
+  m_best.assign (nAngles, 0.0);
+  m_bestBeam.assign (nAngles, 0);
+  for (std::size_t b = 0; b < m_beams.size (); b++)
+    {
+      const double *gains = &m_gains[b * nAngles];
+      for (uint32_t k = 0; k < nAngles; k++)
+        {
+          if (gains[k] > m_best[k])
+            {
+              m_best[k] = gains[k];
+              m_bestBeam[k] = b;
+            }
+        }
+    }
+}
+
+double
+LeoArrayGain::Interpolate (const double *table, double angle) const
+{
+  double position = std::min (180.0, std::max (0.0, angle)) * m_resolution / 180.0;
+  uint32_t k = static_cast<uint32_t> (position);
+  if (k >= m_resolution)
+    {
+      return table[m_resolution];
+    }
+  double fraction = position - k;
+  return table[k] + fraction * (table[k + 1] - table[k]);
+}
+
+uint32_t
+LeoArrayGain::GetNBeams (void) const
+{
+  return m_beams.size ();
+}
+
+double
+LeoArrayGain::GetBeamDirection (uint32_t beam) const
+{
+  NS_ASSERT_MSG (beam < m_beams.size (), "No beam " << beam);
+  return m_beams[beam];
+}
+
+double
+LeoArrayGain::GetGain (uint32_t beam, double angle) const
+{
+  NS_ASSERT_MSG (beam < m_beams.size (), "No beam " << beam);
+  return Interpolate (&m_gains[beam * (m_resolution + 1)], angle);
+}
+
+double
+LeoArrayGain::GetGain (double angle) const
+{
+  return Interpolate (m_best.data (), angle);
+}
+
+void
+LeoArrayGain::GetGains (const std::vector<double> &angles, std::vector<double> &gains) const
+{
+  gains.resize (angles.size ());
+  const double *best = m_best.data ();
+  for (std::size_t i = 0; i < angles.size (); i++)
+    {
+      gains[i] = Interpolate (best, angles[i]);
+    }
+}
+
+uint32_t
+LeoArrayGain::GetBestBeam (double angle) const
+{
+  double position = std::min (180.0, std::max (0.0, angle)) * m_resolution / 180.0;
+  return m_bestBeam[static_cast<uint32_t> (position + 0.5)];
+}
+
+double
+LeoArrayGain::GetLinkAngle (const Vector &tx, const Vector &rx)
+{
+  Vector d = rx - tx;
+  double length = d.GetLength () * tx.GetLength ();
+  if (length == 0)
+    {
+      return 0.0;
+    }
+  // towards the earth for satellites, away from it for ground stations
+  double c = fabs (d.x * tx.x + d.y * tx.y + d.z * tx.z) / length;
+  return acos (std::min (1.0, c)) * 180.0 / M_PI;
+}
+
+double
+LeoArrayGain::GetLinkGain (const Vector &tx, const Vector &rx) const
+{
+  return GetGain (GetLinkAngle (tx, rx));
+}
+
+};
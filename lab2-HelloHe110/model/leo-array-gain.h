@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_ARRAY_GAIN_H
+#define LEO_ARRAY_GAIN_H
+
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/vector.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of LeoArrayGain
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Transmit gain of a uniform linear array with a codebook of beams
+ *
+ * The array has Antennas elements with uniform weights at Spacing
+ * wavelengths. Its axis is the line through the transmitter and the center
+ * of the earth, so that the angle of a link is its angle to the nadir of a
+ * satellite or to the zenith of a ground station. The codebook steers the
+ * array to every BeamStep degrees up to MaxBeamAngle, and every link uses
+ * the beam with the highest gain towards the receiver.
+ *
+ * The gains of all beams are tabulated at Resolution angles between 0 and
+ * 180 degrees when the attributes change, and looked up with linear
+ * interpolation afterwards. The lookups only read the tables, so they may be
+ * done from several threads at once.
+ */
+class LeoArrayGain : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// constructor
+  LeoArrayGain ();
+  /// destructor
+  virtual ~LeoArrayGain ();
+
+  /**
+   * \brief Get the number of beams of the codebook
+   * \return number of beams
+   */
+  uint32_t GetNBeams (void) const;
+
+  /**
+   * \brief Get the direction a beam is steered to
+   * \param beam index of the beam
+   * \return angle to the array axis in degrees
+   */
+  double GetBeamDirection (uint32_t beam) const;
+
+  /**
+   * \brief Get the gain of a beam
+   * \param beam index of the beam
+   * \param angle angle to the array axis in degrees
+   * \return linear gain
+   */
+  double GetGain (uint32_t beam, double angle) const;
+
+  /**
+   * \brief Get the gain of the best beam
+   * \param angle angle to the array axis in degrees
+   * \return linear gain
+   */
+  double GetGain (double angle) const;
+
+  /**
+   * \brief Get the gains of the best beams for many angles at once
+   * \param [in] angles angles to the array axis in degrees
+   * \param [out] gains linear gains
+   */
+  void GetGains (const std::vector<double> &angles, std::vector<double> &gains) const;
+
+  /**
+   * \brief Get the beam with the highest gain
+   * \param angle angle to the array axis in degrees
+   * \return index of the beam
+   */
+  uint32_t GetBestBeam (double angle) const;
+
+  /**
+   * \brief Get the angle of a link to the array axis of the transmitter
+   * \param tx position of the transmitter
+   * \param rx position of the receiver
+   * \return angle in degrees, between 0 and 90
+   */
+  static double GetLinkAngle (const Vector &tx, const Vector &rx);
+
+  /**
+   * \brief Get the gain of the best beam towards a receiver
+   * \param tx position of the transmitter
+   * \param rx position of the receiver
+   * \return linear gain
+   */
+  double GetLinkGain (const Vector &tx, const Vector &rx) const;
+
+protected:
+  virtual void NotifyConstructionCompleted (void);
+
+private:
+  /**
+   * \brief Set the number of elements
+   * \param antennas number of elements
+   */
+  void SetAntennas (uint32_t antennas);
+
+  /**
+   * \brief Set the element spacing
+   * \param spacing spacing in wavelengths
+   */
+  void SetSpacing (double spacing);
+
+  /**
+   * \brief Set the angle between two beams of the codebook
+   * \param step angle in degrees
+   */
+  void SetBeamStep (double step);
+
+  /**
+   * \brief Set the direction of the last beam of the codebook
+   * \param angle angle in degrees
+   */
+  void SetMaxBeamAngle (double angle);
+
+  /**
+   * \brief Set the number of tabulated angles
+   * \param resolution number of angles between 0 and 180 degrees
+   */
+  void SetResolution (uint32_t resolution);
+
+  /**
+   * \brief Tabulate the gains of all beams
+   */
+  void Update (void);
+
+  /**
+   * \brief Look up a table
+   * \param table gains by angle
+   * \param angle angle in degrees
+   * \return interpolated gain
+   */
+  double Interpolate (const double *table, double angle) const;
+
+  /// Number of elements
+  uint32_t m_antennas;
+  /// Element spacing in wavelengths
+  double m_spacing;
+  /// Angle between two beams in degrees
+  double m_beamStep;
+  /// Direction of the last beam in degrees
+  double m_maxBeamAngle;
+  /// Number of tabulated angles
+  uint32_t m_resolution;
+  /// Whether the attributes have been set, tables are only built afterwards
+  bool m_constructed;
+
+  /// Directions of the beams in degrees
+  std::vector<double> m_beams;
+  /// Gains by beam and angle
+  std::vector<double> m_gains;
+  /// Gain of the best beam by angle
+  std::vector<double> m_best;
+  /// Best beam by angle
+  std::vector<uint32_t> m_bestBeam;
+};
+
+};
+
+#endif /* LEO_ARRAY_GAIN_H */
@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/trace-source-accessor.h"
+
+#include "leo-mock-net-device.h"
+#include "leo-bent-pipe-forwarder.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoBentPipeForwarder");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoBentPipeForwarder);
+
+TypeId
+LeoBentPipeForwarder::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoBentPipeForwarder")
+    .SetParent<Object> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<LeoBentPipeForwarder> ()
+    .AddTraceSource ("Forward",
+                     "A frame has been forwarded to the next hop",
+                     MakeTraceSourceAccessor (&LeoBentPipeForwarder::m_forwardTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("Drop",
+                     "A frame has been dropped because there is no route for it",
+                     MakeTraceSourceAccessor (&LeoBentPipeForwarder::m_dropTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+LeoBentPipeForwarder::LeoBentPipeForwarder ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoBentPipeForwarder::~LeoBentPipeForwarder ()
+{
+}
+
+void
+LeoBentPipeForwarder::DoDispose (void)
+{
+  m_routes.clear ();
+  m_uplinks.clear ();
+  m_groundDevice = 0;
+  Object::DoDispose ();
+}
+
+uint64_t
+LeoBentPipeForwarder::GetKey (Mac48Address address)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  uint64_t key = 0;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return key;
+}
+
+void
+LeoBentPipeForwarder::AddDevice (Ptr<MockNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+
+  if (DynamicCast<LeoMockNetDevice> (device))
+    {
+      m_groundDevice = device;
+    }
+  device->SetForwardCallback (MakeCallback (&LeoBentPipeForwarder::Forward, this));
+}
+
+void
+LeoBentPipeForwarder::AddRoute (Mac48Address dest, Ptr<MockNetDevice> device, Mac48Address nextHop)
+{
+  NS_LOG_FUNCTION (this << dest << device << nextHop);
+
+  Route &route = m_routes[GetKey (dest)];
+  route.device = device;
+  route.nextHop = nextHop;
+}
+
+void
+LeoBentPipeForwarder::RemoveRoute (Mac48Address dest)
+{
+  NS_LOG_FUNCTION (this << dest);
+  m_routes.erase (GetKey (dest));
+}
+
+void
+LeoBentPipeForwarder::AddUplink (Mac48Address source, Mac48Address dest)
+{
+  NS_LOG_FUNCTION (this << source << dest);
+  m_uplinks.insert (std::make_pair (GetKey (source), GetKey (dest)));
+}
+
+void
+LeoBentPipeForwarder::RemoveUplink (Mac48Address source, Mac48Address dest)
+{
+  NS_LOG_FUNCTION (this << source << dest);
+  m_uplinks.erase (std::make_pair (GetKey (source), GetKey (dest)));
+}
+
+uint32_t
+LeoBentPipeForwarder::GetNRoutes (void) const
+{
+  return m_routes.size ();
+}
+
+bool
+LeoBentPipeForwarder::Lookup (Mac48Address dest, Ptr<MockNetDevice> &device, Mac48Address &nextHop) const
+{
+  std::unordered_map<uint64_t, Route>::const_iterator it = m_routes.find (GetKey (dest));
+  if (it == m_routes.end ())
+    {
+      return false;
+    }
+  device = it->second.device;
+  nextHop = it->second.nextHop;
+  return true;
+}
+
+void
+LeoBentPipeForwarder::Forward (Ptr<MockNetDevice> device, Ptr<Packet> frame, const EthernetHeader &header)
+{
+  NS_LOG_FUNCTION (this << device << frame);
+
+  uint64_t dest = GetKey (header.GetDestination ());
+
+  // the other satellites above the ground station see the frame too
+  if (device == m_groundDevice
+      && m_uplinks.find (std::make_pair (GetKey (header.GetSource ()), dest)) == m_uplinks.end ())
+    {
+      return;
+    }
+
+  std::unordered_map<uint64_t, Route>::const_iterator it = m_routes.find (dest);
+  if (it == m_routes.end ())
+    {
+      NS_LOG_LOGIC ("No route to " << header.GetDestination ());
+      m_dropTrace (frame);
+      return;
+    }
+
+  m_forwardTrace (frame);
+  it->second.device->SendFrame (frame, it->second.nextHop);
+}
+
+};
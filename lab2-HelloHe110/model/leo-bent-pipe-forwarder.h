@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_BENT_PIPE_FORWARDER_H
+#define LEO_BENT_PIPE_FORWARDER_H
+
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+#include "ns3/object.h"
+#include "ns3/mac48-address.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/traced-callback.h"
+
+#include "mock-net-device.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of LeoBentPipeForwarder
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Forwards frames between the devices of a satellite at layer 2
+ *
+ * A transparent satellite does not need an IP stack. Frames for other
+ * devices are looked up by their destination MAC address and sent on to the
+ * next hop unchanged, so each hop costs one lookup and one transmission.
+ *
+ * Every satellite above a ground station receives its uplink frames. Only
+ * the satellite that has an uplink entry for the source and destination of a
+ * frame forwards it, the others ignore it.
+ */
+class LeoBentPipeForwarder : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// constructor
+  LeoBentPipeForwarder ();
+  /// destructor
+  virtual ~LeoBentPipeForwarder ();
+
+  /**
+   * \brief Forward the frames received by a device
+   * \param device a device of the satellite
+   */
+  void AddDevice (Ptr<MockNetDevice> device);
+
+  /**
+   * \brief Set the next hop towards a device
+   * \param dest address of the destination device
+   * \param device the output device
+   * \param nextHop address of the next device on the channel of the output
+   * device
+   */
+  void AddRoute (Mac48Address dest, Ptr<MockNetDevice> device, Mac48Address nextHop);
+
+  /**
+   * \brief Remove the route towards a device
+   * \param dest address of the destination device
+   */
+  void RemoveRoute (Mac48Address dest);
+
+  /**
+   * \brief Accept frames from a ground station for a destination
+   * \param source address of the ground station device
+   * \param dest address of the destination device
+   */
+  void AddUplink (Mac48Address source, Mac48Address dest);
+
+  /**
+   * \brief Stop accepting frames from a ground station for a destination
+   * \param source address of the ground station device
+   * \param dest address of the destination device
+   */
+  void RemoveUplink (Mac48Address source, Mac48Address dest);
+
+  /**
+   * \brief Get the number of routes
+   * \return number of routes
+   */
+  uint32_t GetNRoutes (void) const;
+
+  /**
+   * \brief Get the next hop towards a device
+   * \param [in] dest address of the destination device
+   * \param [out] device the output device
+   * \param [out] nextHop address of the next device
+   * \return true if there is a route
+   */
+  bool Lookup (Mac48Address dest, Ptr<MockNetDevice> &device, Mac48Address &nextHop) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Next hop of a route
+  struct Route
+  {
+    /// Output device
+    Ptr<MockNetDevice> device;
+    /// Address of the next device
+    Mac48Address nextHop;
+  };
+
+  /**
+   * \brief Forward a frame received by one of the devices
+   * \param device the receiving device
+   * \param frame the frame including header and trailer
+   * \param header the Ethernet header of the frame
+   */
+  void Forward (Ptr<MockNetDevice> device, Ptr<Packet> frame, const EthernetHeader &header);
+
+  /**
+   * \brief Get the key of an address
+   * \param address the address
+   * \return the address as integer
+   */
+  static uint64_t GetKey (Mac48Address address);
+
+  /// Routes by destination address
+  std::unordered_map<uint64_t, Route> m_routes;
+  /// Source and destination addresses of the accepted uplink frames
+  std::set<std::pair<uint64_t, uint64_t> > m_uplinks;
+  /// Device on the ground channel
+  Ptr<MockNetDevice> m_groundDevice;
+
+  /// Trace of forwarded frames
+  TracedCallback<Ptr<const Packet> > m_forwardTrace;
+  /// Trace of frames without a route
+  TracedCallback<Ptr<const Packet> > m_dropTrace;
+};
+
+};
+
+#endif /* LEO_BENT_PIPE_FORWARDER_H */
@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <algorithm>
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/uinteger.h"
+
+#include "leo-calendar-scheduler.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoCalendarScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoCalendarScheduler);
+
+TypeId
+LeoCalendarScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoCalendarScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<LeoCalendarScheduler> ()
+    .AddAttribute ("BucketWidth",
+                   "Time covered by a slot of the calendar",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&LeoCalendarScheduler::m_width),
+                   MakeTimeChecker (Time (1)))
+    .AddAttribute ("Buckets",
+                   "Number of slots of the calendar, rounded up to a power of two",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&LeoCalendarScheduler::m_nBuckets),
+                   MakeUintegerChecker<uint32_t> (1, 1 << 24))
+  ;
+  return tid;
+}
+
+LeoCalendarScheduler::LeoCalendarScheduler ()
+  : m_width (MilliSeconds (1)),
+    m_nBuckets (4096),
+    m_widthTicks (0),
+    m_slot (0),
+    m_nCalendar (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoCalendarScheduler::~LeoCalendarScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+LeoCalendarScheduler::IsLater (const Event &a, const Event &b)
+{
+  return b < a;
+}
+
+uint64_t
+LeoCalendarScheduler::GetSlot (uint64_t ts) const
+{
+  return ts / m_widthTicks;
+}
+
+void
+LeoCalendarScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+
+  if (m_buckets.empty ())
+    {
+      // the attributes are known by now
+      m_widthTicks = std::max<int64_t> (1, m_width.GetTimeStep ());
+      uint32_t n = 1;
+      while (n < m_nBuckets)
+        {
+          n <<= 1;
+        }
+      m_nBuckets = n;
+      m_buckets.resize (m_nBuckets);
+    }
+
+  uint64_t slot = GetSlot (ev.key.m_ts);
+  if (IsEmpty ())
+    {
+      m_slot = slot;
+    }
+  else if (slot < m_slot)
+    {
+      // PeekNext moved past this slot, events of the slots that no longer fit
+      // into the calendar go back to the overflow heap
+      for (uint64_t s = std::max (slot + m_nBuckets, m_slot); s < m_slot + m_nBuckets; s++)
+        {
+          Heap &bucket = m_buckets[s & (m_nBuckets - 1)];
+          for (const Event &moved : bucket)
+            {
+              m_overflow.push_back (moved);
+              std::push_heap (m_overflow.begin (), m_overflow.end (), &LeoCalendarScheduler::IsLater);
+            }
+          m_nCalendar -= bucket.size ();
+          bucket.clear ();
+        }
+      m_slot = slot;
+    }
+
+  if (slot < m_slot + m_nBuckets)
+    {
+      Heap &bucket = m_buckets[slot & (m_nBuckets - 1)];
+      bucket.push_back (ev);
+      std::push_heap (bucket.begin (), bucket.end (), &LeoCalendarScheduler::IsLater);
+      m_nCalendar++;
+    }
+  else
+    {
+      m_overflow.push_back (ev);
+      std::push_heap (m_overflow.begin (), m_overflow.end (), &LeoCalendarScheduler::IsLater);
+    }
+}
+
+bool
+LeoCalendarScheduler::IsEmpty (void) const
+{
+  return m_nCalendar == 0 && m_overflow.empty ();
+}
+
+void
+LeoCalendarScheduler::Refill (void) const
+{
+  while (!m_overflow.empty ()
+         && GetSlot (m_overflow.front ().key.m_ts) < m_slot + m_nBuckets)
+    {
+      std::pop_heap (m_overflow.begin (), m_overflow.end (), &LeoCalendarScheduler::IsLater);
+      const Event &ev = m_overflow.back ();
+      Heap &bucket = m_buckets[GetSlot (ev.key.m_ts) & (m_nBuckets - 1)];
+      bucket.push_back (ev);
+      std::push_heap (bucket.begin (), bucket.end (), &LeoCalendarScheduler::IsLater);
+      m_overflow.pop_back ();
+      m_nCalendar++;
+    }
+}
+
+void
+LeoCalendarScheduler::Advance (void) const
+{
+  if (m_nCalendar == 0)
+    {
+      if (!m_overflow.empty ())
+        {
+          m_slot = GetSlot (m_overflow.front ().key.m_ts);
+          Refill ();
+        }
+      return;
+    }
+
+  // all events in the calendar are earlier than those in the overflow heap
+  uint64_t slot = m_slot;
+  while (m_buckets[m_slot & (m_nBuckets - 1)].empty ())
+    {
+      m_slot++;
+    }
+  if (m_slot != slot)
+    {
+      Refill ();
+    }
+}
+
+Scheduler::Event
+LeoCalendarScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+
+  Advance ();
+  return m_buckets[m_slot & (m_nBuckets - 1)].front ();
+}
+
+Scheduler::Event
+LeoCalendarScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+
+  Advance ();
+  Heap &bucket = m_buckets[m_slot & (m_nBuckets - 1)];
+  std::pop_heap (bucket.begin (), bucket.end (), &LeoCalendarScheduler::IsLater);
+  Event ev = bucket.back ();
+  bucket.pop_back ();
+  m_nCalendar--;
+  return ev;
+}
+
+bool
+LeoCalendarScheduler::RemoveFrom (Heap &heap, const Event &ev)
+{
+  for (std::size_t i = 0; i < heap.size (); i++)
+    {
+      if (heap[i].key.m_uid == ev.key.m_uid)
+        {
+          heap[i] = heap.back ();
+          heap.pop_back ();
+          std::make_heap (heap.begin (), heap.end (), &LeoCalendarScheduler::IsLater);
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+LeoCalendarScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+
+  uint64_t slot = GetSlot (ev.key.m_ts);
+  if (slot >= m_slot && slot < m_slot + m_nBuckets
+      && RemoveFrom (m_buckets[slot & (m_nBuckets - 1)], ev))
+    {
+      m_nCalendar--;
+      return;
+    }
+  bool found = RemoveFrom (m_overflow, ev);
+  NS_ASSERT_MSG (found, "Event " << ev.key.m_uid << " is not scheduled");
+  (void) found;
+}
+
+};
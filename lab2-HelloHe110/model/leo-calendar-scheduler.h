@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_CALENDAR_SCHEDULER_H
+#define LEO_CALENDAR_SCHEDULER_H
+
+#include <vector>
+
+#include "ns3/scheduler.h"
+#include "ns3/nstime.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of LeoCalendarScheduler
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief An event scheduler tuned to the events of LEO simulations
+ *
+ * LEO simulations schedule bursts of receptions a few milliseconds ahead,
+ * one for each device a transmission reaches, and periodic events such as
+ * routing updates. The scheduler is a calendar of Buckets slots that are
+ * BucketWidth wide each. Every slot holds the events of a single interval
+ * in a small binary heap, so bursts do not degrade to linear insertion.
+ * Events beyond the end of the calendar are kept in an overflow heap and
+ * moved into the calendar as it advances.
+ *
+ * Events are stored by value and the storage of the slots is kept between
+ * events, so inserting and removing events does not allocate once the
+ * simulation has warmed up.
+ */
+class LeoCalendarScheduler : public Scheduler
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// constructor
+  LeoCalendarScheduler ();
+  /// destructor
+  virtual ~LeoCalendarScheduler ();
+
+  // Inherited from Scheduler
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+private:
+  /// A binary heap of events, the earliest event at the front
+  typedef std::vector<Event> Heap;
+
+  /**
+   * \brief Compare events for a heap with the earliest event at the front
+   * \param a first event
+   * \param b second event
+   * \return true if a is later than b
+   */
+  static bool IsLater (const Event &a, const Event &b);
+
+  /**
+   * \brief Get the slot of a point in time
+   * \param ts timestamp in time steps
+   * \return the slot
+   */
+  uint64_t GetSlot (uint64_t ts) const;
+
+  /**
+   * \brief Move the calendar to the slot of the next event
+   *
+   * Does not change the order of the events, so it is fine to call it from
+   * PeekNext.
+   */
+  void Advance (void) const;
+
+  /**
+   * \brief Move events of the overflow heap that fit into the calendar
+   */
+  void Refill (void) const;
+
+  /**
+   * \brief Remove an event from a heap
+   * \param heap the heap
+   * \param ev the event
+   * \return true if the event has been found
+   */
+  static bool RemoveFrom (Heap &heap, const Event &ev);
+
+  /// Width of a slot
+  Time m_width;
+  /// Number of slots, a power of two
+  uint32_t m_nBuckets;
+
+  /// Width of a slot in time steps
+  mutable uint64_t m_widthTicks;
+  /// Slots of the calendar
+  mutable std::vector<Heap> m_buckets;
+  /// Events beyond the calendar
+  mutable Heap m_overflow;
+  /// Slot of the earliest event in the calendar
+  mutable uint64_t m_slot;
+  /// Number of events in the calendar
+  mutable uint32_t m_nCalendar;
+};
+
+};
+
+#endif /* LEO_CALENDAR_SCHEDULER_H */
@@ -100,14 +100,14 @@ LeoCircularOrbitMobilityModel::DoGetVelocity () const
 {
   Vector3D pos = DoGetPosition ();
   pos = Vector3D (pos.x / pos.GetLength (), pos.y / pos.GetLength (), pos.z / pos.GetLength ());
-  Vector3D heading = CrossProduct (PlaneNorm (), pos);
+  Vector3D heading = CrossProduct (PlaneNorm (Simulator::Now ()), pos);
   return Product (GetSpeed (), heading);
 }
 
 Vector3D
-LeoCircularOrbitMobilityModel::PlaneNorm () const
+LeoCircularOrbitMobilityModel::PlaneNorm (Time t) const
 {
-  double lat = CalcLatitude ();
+  double lat = CalcLatitude (t);
   return Vector3D (sin (-m_inclination) * cos (lat),
   		   sin (-m_inclination) * sin (lat),
   		   cos (m_inclination));
@@ -128,9 +128,9 @@ LeoCircularOrbitMobilityModel::GetProgress (Time t) const
 }
 
 Vector3D
-LeoCircularOrbitMobilityModel::RotatePlane (double a, const Vector3D &x) const
+LeoCircularOrbitMobilityModel::RotatePlane (double a, const Vector3D &x, Time t) const
 {
-  Vector3D n = PlaneNorm ();
+  Vector3D n = PlaneNorm (t);
 
   return Product (DotProduct (n, x), n)
     + Product (cos (a), CrossProduct (CrossProduct (n, x), n))
@@ -138,21 +138,27 @@ LeoCircularOrbitMobilityModel::RotatePlane (double a, const Vector3D &x) const
 }
 
 double
-LeoCircularOrbitMobilityModel::CalcLatitude () const
+LeoCircularOrbitMobilityModel::CalcLatitude (Time t) const
 {
-  return m_longitude + ((Simulator::Now ().GetDouble () / Hours (24).GetDouble ()) * 2 * M_PI);
+  return m_longitude + ((t.GetDouble () / Hours (24).GetDouble ()) * 2 * M_PI);
 }
 
 Vector
 LeoCircularOrbitMobilityModel::CalcPosition (Time t) const
 {
-  double lat = CalcLatitude ();
+  double lat = CalcLatitude (t);
   // account for orbit latitude and earth rotation offset
   Vector3D x = Product (m_orbitHeight*1000, Vector3D (cos (m_inclination) * cos (lat),
   			       cos (m_inclination) * sin (lat),
   			       sin (m_inclination)));
 
-  return RotatePlane (GetProgress (t), x);
+  return RotatePlane (GetProgress (t), x, t);
+}
+
+Vector
+LeoCircularOrbitMobilityModel::GetPositionAt (Time t) const
+{
+  return CalcPosition (t);
 }
 
 Vector LeoCircularOrbitMobilityModel::Update ()
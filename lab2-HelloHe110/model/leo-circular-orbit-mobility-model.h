@@ -86,6 +86,17 @@ public:
    */
   void SetInclination (double incl);
 
+  /**
+   * \brief Predict the position at a point in time
+   *
+   * Unlike GetPosition this does not depend on the current simulation time
+   * and is not rounded to the precision, so it can be used to plan ahead.
+   *
+   * \param t a point in time
+   * \return the position at time t
+   */
+  Vector GetPositionAt (Time t) const;
+
 private:
 
   /**
@@ -133,8 +144,9 @@ private:
 
   /**
    * \brief Get the normal vector of the orbital plane
+   * \param t a point in time
    */
-  Vector3D PlaneNorm () const;
+  Vector3D PlaneNorm (Time t) const;
 
   /**
    * \brief Gets the distance the satellite has progressed from its original
@@ -149,9 +161,10 @@ private:
    * \brief Advances a satellite by a degrees inside the orbital plane
    * \param a angle by which to rotate
    * \param x vector to rotate
+   * \param t a point in time
    * \return rotated vector
    */
-  Vector3D RotatePlane (double a, const Vector3D &x) const;
+  Vector3D RotatePlane (double a, const Vector3D &x, Time t) const;
 
   /**
    * \brief Calculate the position at time t
@@ -164,9 +177,10 @@ private:
    * \brief Calc the latitude depending on simulation time inside ITRF coordinate
    * system
    *
+   * \param t a point in time
    * \return latitude
    */
-  double CalcLatitude () const;
+  double CalcLatitude (Time t) const;
 
   /**
    * \brief Update the internal position of the mobility model
@@ -0,0 +1,437 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <iomanip>
+#include <sstream>
+
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+
+#include "leo-contact-graph-routing.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoContactGraphRouting");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoContactGraphRouting);
+
+TypeId
+LeoContactGraphRouting::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoContactGraphRouting")
+    .SetParent<Ipv4RoutingProtocol> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<LeoContactGraphRouting> ()
+    .AddAttribute ("ContactPlan",
+                   "The contacts to route over",
+                   PointerValue (),
+                   MakePointerAccessor (&LeoContactGraphRouting::SetContactPlan,
+                                        &LeoContactGraphRouting::GetContactPlan),
+                   MakePointerChecker<LeoContactPlan> ())
+    .AddAttribute ("MaxRoutes",
+                   "Maximum number of routes cached per destination",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&LeoContactGraphRouting::m_maxRoutes),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxHoldTime",
+                   "Maximum time a packet is held for a contact to start",
+                   TimeValue (Seconds (60)),
+                   MakeTimeAccessor (&LeoContactGraphRouting::m_maxHoldTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxHeld",
+                   "Maximum number of packets held at a time",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&LeoContactGraphRouting::m_maxHeld),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+LeoContactGraphRouting::LeoContactGraphRouting ()
+  : m_held (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoContactGraphRouting::~LeoContactGraphRouting ()
+{
+}
+
+void
+LeoContactGraphRouting::DoDispose (void)
+{
+  m_ipv4 = 0;
+  m_lo = 0;
+  m_plan = 0;
+  m_routes.clear ();
+  m_gateways.clear ();
+  Ipv4RoutingProtocol::DoDispose ();
+}
+
+Ptr<LeoContactPlan>
+LeoContactGraphRouting::GetContactPlan (void) const
+{
+  return m_plan;
+}
+
+void
+LeoContactGraphRouting::SetContactPlan (Ptr<LeoContactPlan> plan)
+{
+  m_plan = plan;
+  m_routes.clear ();
+}
+
+void
+LeoContactGraphRouting::Flush (void)
+{
+  m_routes.clear ();
+  m_gateways.clear ();
+}
+
+bool
+LeoContactGraphRouting::Lookup (Ipv4Address dest, LeoContactRoute &route)
+{
+  NS_LOG_FUNCTION (this << dest);
+
+  uint32_t destNode;
+  if (!m_plan || !m_plan->GetNodeForAddress (dest, destNode))
+    {
+      NS_LOG_LOGIC ("Address " << dest << " is not in the contact plan");
+      return false;
+    }
+
+  Time now = Simulator::Now ();
+  std::list<LeoContactRoute> &routes = m_routes[destNode];
+  for (std::list<LeoContactRoute>::iterator it = routes.begin (); it != routes.end (); )
+    {
+      if (it->expires <= now)
+        {
+          it = routes.erase (it);
+        }
+      else
+        {
+          it++;
+        }
+    }
+
+  if (routes.empty ())
+    {
+      // the first route is the best one, the others avoid the contacts
+      // that limit the earlier ones and take over when those end
+      uint32_t self = m_ipv4->GetObject<Node> ()->GetId ();
+      std::vector<LeoContact> excluded;
+      LeoContactRoute candidate;
+      while (routes.size () < m_maxRoutes
+             && m_plan->FindRoute (self, destNode, now, candidate, excluded))
+        {
+          routes.push_back (candidate);
+          excluded.push_back (candidate.limit);
+        }
+      NS_LOG_LOGIC ("Computed " << routes.size () << " routes to node " << destNode);
+    }
+
+  if (routes.empty ())
+    {
+      return false;
+    }
+
+  std::list<LeoContactRoute>::const_iterator best = routes.begin ();
+  for (std::list<LeoContactRoute>::const_iterator it = routes.begin (); it != routes.end (); it++)
+    {
+      if (it->arrival < best->arrival)
+        {
+          best = it;
+        }
+    }
+  route = *best;
+  return true;
+}
+
+bool
+LeoContactGraphRouting::FindGateway (uint32_t neighbor, Ipv4Address &gateway, uint32_t &interface)
+{
+  std::map<uint32_t, std::pair<Ipv4Address, uint32_t> >::const_iterator cached = m_gateways.find (neighbor);
+  if (cached != m_gateways.end ())
+    {
+      gateway = cached->second.first;
+      interface = cached->second.second;
+      return true;
+    }
+
+  Ptr<Ipv4> remote = NodeList::GetNode (neighbor)->GetObject<Ipv4> ();
+  if (!remote)
+    {
+      return false;
+    }
+
+  for (uint32_t i = 0; i < m_ipv4->GetNInterfaces (); i++)
+    {
+      if (m_ipv4->GetNetDevice (i) == m_lo)
+        {
+          continue;
+        }
+      for (uint32_t j = 0; j < m_ipv4->GetNAddresses (i); j++)
+        {
+          Ipv4InterfaceAddress local = m_ipv4->GetAddress (i, j);
+          for (uint32_t k = 0; k < remote->GetNInterfaces (); k++)
+            {
+              for (uint32_t l = 0; l < remote->GetNAddresses (k); l++)
+                {
+                  Ipv4Address address = remote->GetAddress (k, l).GetLocal ();
+                  if (!address.IsLocalhost ()
+                      && address.CombineMask (local.GetMask ()) == local.GetLocal ().CombineMask (local.GetMask ()))
+                    {
+                      gateway = address;
+                      interface = i;
+                      m_gateways[neighbor] = std::make_pair (gateway, interface);
+                      return true;
+                    }
+                }
+            }
+        }
+    }
+
+  return false;
+}
+
+Ptr<Ipv4Route>
+LeoContactGraphRouting::MakeRoute (Ipv4Address dest, Ipv4Address gateway, uint32_t interface) const
+{
+  Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+  rtentry->SetDestination (dest);
+  rtentry->SetGateway (gateway);
+  rtentry->SetSource (m_ipv4->GetAddress (interface, 0).GetLocal ());
+  rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interface));
+  return rtentry;
+}
+
+Ptr<Ipv4Route>
+LeoContactGraphRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
+                                     Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
+{
+  NS_LOG_FUNCTION (this << header << oif);
+
+  Ipv4Address dest = header.GetDestination ();
+  LeoContactRoute route;
+  Ipv4Address gateway;
+  uint32_t interface;
+
+  if (dest.IsMulticast () || dest.IsBroadcast ()
+      || !Lookup (dest, route) || !FindGateway (route.nextHop, gateway, interface))
+    {
+      NS_LOG_LOGIC ("No route to " << dest);
+      sockerr = Socket::ERROR_NOROUTETOHOST;
+      return 0;
+    }
+
+  if (oif && m_ipv4->GetNetDevice (interface) != oif)
+    {
+      NS_LOG_LOGIC ("Route to " << dest << " does not use the requested device");
+      sockerr = Socket::ERROR_NOROUTETOHOST;
+      return 0;
+    }
+
+  sockerr = Socket::ERROR_NOTERROR;
+  Ptr<Ipv4Route> rtentry = MakeRoute (dest, gateway, interface);
+  if (p && route.start > Simulator::Now ())
+    {
+      // loop the packet back so that RouteInput can hold it until the
+      // contact starts, the source address is the one it will leave with
+      NS_LOG_LOGIC ("Next contact to " << route.nextHop << " starts at " << route.start << ", holding");
+      rtentry->SetGateway (Ipv4Address::GetLoopback ());
+      rtentry->SetOutputDevice (m_lo);
+    }
+  return rtentry;
+}
+
+bool
+LeoContactGraphRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
+                                    Ptr<const NetDevice> idev, UnicastForwardCallback ucb,
+                                    MulticastForwardCallback mcb, LocalDeliverCallback lcb,
+                                    ErrorCallback ecb)
+{
+  NS_LOG_FUNCTION (this << p << header << idev);
+
+  NS_ASSERT (m_ipv4->GetInterfaceForDevice (idev) >= 0);
+  uint32_t iif = m_ipv4->GetInterfaceForDevice (idev);
+  Ipv4Address dest = header.GetDestination ();
+
+  if (m_ipv4->IsDestinationAddress (dest, iif))
+    {
+      if (!lcb.IsNull ())
+        {
+          NS_LOG_LOGIC ("Local delivery to " << dest);
+          lcb (p, header, iif);
+          return true;
+        }
+      return false;
+    }
+
+  if (dest.IsMulticast () || dest.IsBroadcast ())
+    {
+      return false;
+    }
+
+  // locally generated packets that wait for a contact
+  if (idev == m_lo)
+    {
+      return Forward (p, header, ucb, ecb);
+    }
+
+  if (m_ipv4->IsForwarding (iif) == false)
+    {
+      NS_LOG_LOGIC ("Forwarding disabled for this interface");
+      ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+      return true;
+    }
+
+  return Forward (p, header, ucb, ecb);
+}
+
+bool
+LeoContactGraphRouting::Forward (Ptr<const Packet> p, const Ipv4Header &header,
+                                 UnicastForwardCallback ucb, ErrorCallback ecb)
+{
+  Ipv4Address dest = header.GetDestination ();
+  LeoContactRoute route;
+  Ipv4Address gateway;
+  uint32_t interface;
+  if (!Lookup (dest, route) || !FindGateway (route.nextHop, gateway, interface))
+    {
+      NS_LOG_LOGIC ("No route to " << dest);
+      return false;
+    }
+
+  Time wait = route.start - Simulator::Now ();
+  if (wait <= Time (0))
+    {
+      ucb (MakeRoute (dest, gateway, interface), p, header);
+      return true;
+    }
+
+  if (wait > m_maxHoldTime || m_held >= m_maxHeld)
+    {
+      NS_LOG_LOGIC ("Cannot hold packet for " << wait << ", dropping");
+      ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+      return true;
+    }
+
+  NS_LOG_LOGIC ("Holding packet for " << wait << " until the contact to " << route.nextHop << " starts");
+  m_held++;
+  Simulator::Schedule (wait, &LeoContactGraphRouting::SendHeld, this, p, header, ucb, ecb);
+  return true;
+}
+
+void
+LeoContactGraphRouting::SendHeld (Ptr<const Packet> p, Ipv4Header header,
+                                  UnicastForwardCallback ucb, ErrorCallback ecb)
+{
+  NS_LOG_FUNCTION (this << p << header);
+
+  m_held--;
+  if (!Forward (p, header, ucb, ecb))
+    {
+      ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+    }
+}
+
+void
+LeoContactGraphRouting::NotifyInterfaceUp (uint32_t interface)
+{
+  Flush ();
+}
+
+void
+LeoContactGraphRouting::NotifyInterfaceDown (uint32_t interface)
+{
+  Flush ();
+}
+
+void
+LeoContactGraphRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+  Flush ();
+}
+
+void
+LeoContactGraphRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+  Flush ();
+}
+
+void
+LeoContactGraphRouting::SetIpv4 (Ptr<Ipv4> ipv4)
+{
+  NS_LOG_FUNCTION (this << ipv4);
+  NS_ASSERT (ipv4 != 0);
+  NS_ASSERT (m_ipv4 == 0);
+
+  m_ipv4 = ipv4;
+  // the loopback interface is set up before the routing protocol
+  NS_ASSERT (m_ipv4->GetNInterfaces () == 1
+             && m_ipv4->GetAddress (0, 0).GetLocal () == Ipv4Address::GetLoopback ());
+  m_lo = m_ipv4->GetNetDevice (0);
+}
+
+void
+LeoContactGraphRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
+{
+  std::ostream* os = stream->GetStream ();
+  std::ios oldState (nullptr);
+  oldState.copyfmt (*os);
+
+  *os << "Node: " << m_ipv4->GetObject<Node> ()->GetId ()
+      << ", Time: " << Now ().As (unit)
+      << ", Local time: " << m_ipv4->GetObject<Node> ()->GetLocalTime ().As (unit)
+      << ", LeoContactGraphRouting" << std::endl;
+
+  *os << "Contacts: " << (m_plan ? m_plan->GetNContacts () : 0)
+      << ", held packets: " << m_held << std::endl;
+  *os << std::setiosflags (std::ios::left);
+  *os << std::setw (12) << "Destination"
+      << std::setw (10) << "NextHop"
+      << std::setw (6) << "Hops"
+      << std::setw (16) << "Start"
+      << std::setw (16) << "Arrival"
+      << "Expires" << std::endl;
+  for (std::map<uint32_t, std::list<LeoContactRoute> >::const_iterator it = m_routes.begin (); it != m_routes.end (); it++)
+    {
+      for (const LeoContactRoute &route : it->second)
+        {
+          std::ostringstream start, arrival, expires;
+          start << route.start.As (unit);
+          arrival << route.arrival.As (unit);
+          expires << route.expires.As (unit);
+          *os << std::setw (12) << it->first
+              << std::setw (10) << route.nextHop
+              << std::setw (6) << route.hops
+              << std::setw (16) << start.str ()
+              << std::setw (16) << arrival.str ()
+              << expires.str () << std::endl;
+        }
+    }
+  *os << std::endl;
+
+  (*os).copyfmt (oldState);
+}
+
+}; /* namespace ns3 */
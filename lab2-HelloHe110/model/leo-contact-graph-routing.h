@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_CONTACT_GRAPH_ROUTING_H
+#define LEO_CONTACT_GRAPH_ROUTING_H
+
+#include <list>
+#include <map>
+
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4.h"
+
+#include "leo-contact-plan.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of LeoContactGraphRouting
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Contact graph routing over predicted satellite and ground links
+ *
+ * Every node computes the earliest-arrival route to the destination from a
+ * shared LeoContactPlan and forwards to the first hop of that route. Routes
+ * are cached per destination until one of their contacts ends, up to
+ * MaxRoutes of them.
+ *
+ * If the first contact of the best route has not started yet, the packet is
+ * held until it starts instead of being dropped, as long as that is within
+ * MaxHoldTime. Locally generated packets are held by routing them through the
+ * loopback device first, like AODV does while it discovers a route.
+ */
+class LeoContactGraphRouting : public Ipv4RoutingProtocol
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// constructor
+  LeoContactGraphRouting ();
+  /// destructor
+  virtual ~LeoContactGraphRouting ();
+
+  // Inherited from Ipv4RoutingProtocol
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
+                                      Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+  virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
+                           Ptr<const NetDevice> idev, UnicastForwardCallback ucb,
+                           MulticastForwardCallback mcb, LocalDeliverCallback lcb,
+                           ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+
+  /**
+   * \brief Get the contact plan
+   * \return the contact plan
+   */
+  Ptr<LeoContactPlan> GetContactPlan (void) const;
+
+  /**
+   * \brief Set the contact plan
+   * \param plan the contact plan
+   */
+  void SetContactPlan (Ptr<LeoContactPlan> plan);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Get the best route to a destination, from the cache if possible
+   * \param [in] dest destination address
+   * \param [out] route the route
+   * \return true if the destination can be reached
+   */
+  bool Lookup (Ipv4Address dest, LeoContactRoute &route);
+
+  /**
+   * \brief Find the address and the interface to reach a neighbor over
+   * \param [in] neighbor node id of the neighbor
+   * \param [out] gateway address of the neighbor
+   * \param [out] interface the output interface
+   * \return true if the neighbor shares a subnet with this node
+   */
+  bool FindGateway (uint32_t neighbor, Ipv4Address &gateway, uint32_t &interface);
+
+  /**
+   * \brief Build a route
+   * \param dest destination address
+   * \param gateway next hop address
+   * \param interface output interface
+   * \return the route
+   */
+  Ptr<Ipv4Route> MakeRoute (Ipv4Address dest, Ipv4Address gateway, uint32_t interface) const;
+
+  /**
+   * \brief Forward a packet or hold it until its next contact starts
+   * \param p the packet
+   * \param header its IP header
+   * \param ucb callback to forward the packet
+   * \param ecb callback to report errors
+   * \return false if there is no route
+   */
+  bool Forward (Ptr<const Packet> p, const Ipv4Header &header,
+                UnicastForwardCallback ucb, ErrorCallback ecb);
+
+  /**
+   * \brief Forward a held packet when its contact has started
+   * \param p the packet
+   * \param header its IP header
+   * \param ucb callback to forward the packet
+   * \param ecb callback to report errors
+   */
+  void SendHeld (Ptr<const Packet> p, Ipv4Header header,
+                 UnicastForwardCallback ucb, ErrorCallback ecb);
+
+  /**
+   * \brief Drop all cached routes and gateways
+   */
+  void Flush (void);
+
+  /// Contacts of all nodes
+  Ptr<LeoContactPlan> m_plan;
+  /// Maximum number of cached routes per destination
+  uint32_t m_maxRoutes;
+  /// Maximum time to hold a packet for a contact
+  Time m_maxHoldTime;
+  /// Maximum number of held packets
+  uint32_t m_maxHeld;
+
+  /// IP stack of this node
+  Ptr<Ipv4> m_ipv4;
+  /// Loopback device, used to hold locally generated packets
+  Ptr<NetDevice> m_lo;
+  /// Cached routes by node id of the destination, best first
+  std::map<uint32_t, std::list<LeoContactRoute> > m_routes;
+  /// Address and interface of each neighbor
+  std::map<uint32_t, std::pair<Ipv4Address, uint32_t> > m_gateways;
+  /// Number of held packets
+  uint32_t m_held;
+};
+
+};
+
+#endif /* LEO_CONTACT_GRAPH_ROUTING_H */
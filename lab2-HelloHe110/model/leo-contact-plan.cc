@@ -0,0 +1,388 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <queue>
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/ipv4.h"
+#include "ns3/mobility-model.h"
+
+#include "leo-circular-orbit-mobility-model.h"
+#include "leo-propagation-loss-model.h"
+#include "leo-ephemeris.h"
+#include "leo-contact-plan.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoContactPlan");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoContactPlan);
+
+TypeId
+LeoContactPlan::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoContactPlan")
+    .SetParent<Object> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<LeoContactPlan> ()
+    .AddAttribute ("Step",
+                   "Sampling interval of the contact prediction",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&LeoContactPlan::m_step),
+                   MakeTimeChecker (MilliSeconds (1)))
+    .AddAttribute ("ElevationAngle",
+                   "Minimum elevation of a satellite seen from a ground station in degrees",
+                   DoubleValue (40.0),
+                   MakeDoubleAccessor (&LeoContactPlan::m_elevationAngle),
+                   MakeDoubleChecker<double> (0.0, 90.0))
+    .AddAttribute ("IslRange",
+                   "Maximum length of an inter-satellite link in m, 0 for no limit",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&LeoContactPlan::m_islRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Ephemeris",
+                   "Name of a shared LeoEphemeris to take positions and contacts from",
+                   StringValue (""),
+                   MakeStringAccessor (&LeoContactPlan::m_ephemerisName),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+LeoContactPlan::LeoContactPlan ()
+  : m_nContacts (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoContactPlan::~LeoContactPlan ()
+{
+}
+
+Vector
+LeoContactPlan::GetPositionAt (uint32_t node, Time t) const
+{
+  if (m_ephemeris && m_ephemeris->HasNode (node) && m_ephemeris->Covers (t))
+    {
+      return m_ephemeris->GetPosition (node, t);
+    }
+  Ptr<MobilityModel> mobility = NodeList::GetNode (node)->GetObject<MobilityModel> ();
+  NS_ASSERT_MSG (mobility, "Node " << node << " has no mobility model");
+  Ptr<LeoCircularOrbitMobilityModel> orbit = DynamicCast<LeoCircularOrbitMobilityModel> (mobility);
+  if (orbit)
+    {
+      return orbit->GetPositionAt (t);
+    }
+  return mobility->GetPosition ();
+}
+
+bool
+LeoContactPlan::IsVisible (const Vector &a, const Vector &b, bool satellite,
+                           double elevationAngle, double islRange)
+{
+  Vector d = b - a;
+  double length = d.GetLength ();
+  if (length == 0)
+    {
+      return true;
+    }
+
+  if (!satellite)
+    {
+      // a is the ground station, elevation is the angle between the line of
+      // sight and the local horizon
+      double up = (d.x * a.x + d.y * a.y + d.z * a.z) / (length * a.GetLength ());
+      return up >= sin (elevationAngle * M_PI / 180.0);
+    }
+
+  if (islRange > 0 && length > islRange)
+    {
+      return false;
+    }
+
+  // the earth blocks the link if the segment comes closer to its center
+  // than its radius
+  double t = -(a.x * d.x + a.y * d.y + a.z * d.z) / (length * length);
+  t = std::min (1.0, std::max (0.0, t));
+  Vector closest (a.x + t * d.x, a.y + t * d.y, a.z + t * d.z);
+  return closest.GetLength () > LEO_EARTH_RAD_KM * 1000;
+}
+
+void
+LeoContactPlan::Compute (const NodeContainer &satellites, const NodeContainer &stations,
+                         Time start, Time stop)
+{
+  NS_LOG_FUNCTION (this << satellites.GetN () << stations.GetN () << start << stop);
+
+  if (!m_ephemeris && !m_ephemerisName.empty ())
+    {
+      Ptr<LeoEphemeris> ephemeris = CreateObject<LeoEphemeris> ();
+      if (ephemeris->Open (m_ephemerisName))
+        {
+          m_ephemeris = ephemeris;
+        }
+    }
+  if (m_ephemeris && m_ephemeris->HasContacts (NodeContainer (satellites, stations), start, stop))
+    {
+      m_ephemeris->GetContacts (this);
+      NS_LOG_INFO ("Loaded " << m_nContacts << " precomputed contacts");
+      return;
+    }
+
+  std::vector<uint32_t> nodes;
+  for (NodeContainer::Iterator it = satellites.Begin (); it != satellites.End (); ++it)
+    {
+      nodes.push_back ((*it)->GetId ());
+    }
+  uint32_t numSatellites = nodes.size ();
+  for (NodeContainer::Iterator it = stations.Begin (); it != stations.End (); ++it)
+    {
+      nodes.push_back ((*it)->GetId ());
+    }
+
+  // positions of all nodes at all sampling points, stations are sampled too
+  // in case they move
+  std::vector<Time> times;
+  for (Time t = start; t < stop; t += m_step)
+    {
+      times.push_back (t);
+    }
+  times.push_back (stop);
+  std::vector<std::vector<Vector> > positions (times.size ());
+  for (std::size_t k = 0; k < times.size (); k++)
+    {
+      for (uint32_t node : nodes)
+        {
+          positions[k].push_back (GetPositionAt (node, times[k]));
+        }
+    }
+
+  for (uint32_t i = 0; i < numSatellites; i++)
+    {
+      for (uint32_t j = i + 1; j < nodes.size (); j++)
+        {
+          bool satellite = j < numSatellites;
+          bool up = false;
+          LeoContact contact;
+          for (std::size_t k = 0; k < times.size (); k++)
+            {
+              // stations come first so that the elevation is seen from them
+              bool visible = satellite ?
+                IsVisible (positions[k][i], positions[k][j], true, m_elevationAngle, m_islRange) :
+                IsVisible (positions[k][j], positions[k][i], false, m_elevationAngle, m_islRange);
+              if (visible && !up)
+                {
+                  double distance = CalculateDistance (positions[k][i], positions[k][j]);
+                  contact.start = times[k];
+                  contact.delay = Seconds (distance / LEO_SPEED_OF_LIGHT_IN_AIR);
+                }
+              if (up && (!visible || k + 1 == times.size ()))
+                {
+                  contact.end = times[k];
+                  contact.from = nodes[i];
+                  contact.to = nodes[j];
+                  AddContact (contact);
+                  std::swap (contact.from, contact.to);
+                  AddContact (contact);
+                }
+              up = visible;
+            }
+        }
+    }
+
+  NS_LOG_INFO ("Predicted " << m_nContacts << " contacts between " << start << " and " << stop);
+}
+
+void
+LeoContactPlan::SetEphemeris (Ptr<LeoEphemeris> ephemeris)
+{
+  m_ephemeris = ephemeris;
+}
+
+void
+LeoContactPlan::AddContact (const LeoContact &contact)
+{
+  NS_LOG_FUNCTION (this << contact.from << contact.to << contact.start << contact.end);
+
+  if (m_contacts.size () <= std::max (contact.from, contact.to))
+    {
+      m_contacts.resize (std::max (contact.from, contact.to) + 1);
+    }
+
+  std::vector<LeoContact> &contacts = m_contacts[contact.from];
+  std::vector<LeoContact>::iterator it = std::upper_bound (contacts.begin (), contacts.end (), contact,
+                                                           [] (const LeoContact &a, const LeoContact &b) { return a.start < b.start; });
+  contacts.insert (it, contact);
+  m_nContacts++;
+}
+
+void
+LeoContactPlan::Clear (void)
+{
+  m_contacts.clear ();
+  m_nContacts = 0;
+}
+
+uint32_t
+LeoContactPlan::GetNContacts (void) const
+{
+  return m_nContacts;
+}
+
+const std::vector<LeoContact> &
+LeoContactPlan::GetContacts (uint32_t from) const
+{
+  static const std::vector<LeoContact> none;
+  return from < m_contacts.size () ? m_contacts[from] : none;
+}
+
+bool
+LeoContactPlan::FindRoute (uint32_t source, uint32_t dest, Time now, LeoContactRoute &route,
+                           const std::vector<LeoContact> &excluded) const
+{
+  NS_LOG_FUNCTION (this << source << dest << now);
+
+  uint32_t numNodes = m_contacts.size ();
+  if (source == dest || source >= numNodes || dest >= numNodes)
+    {
+      return false;
+    }
+
+  Time never = Time::Max ();
+  std::vector<Time> arrival (numNodes, never);
+  std::vector<const LeoContact *> predecessor (numNodes, 0);
+
+  typedef std::pair<Time, uint32_t> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+  arrival[source] = now;
+  queue.push (Entry (now, source));
+
+  while (!queue.empty ())
+    {
+      Entry entry = queue.top ();
+      queue.pop ();
+      uint32_t node = entry.second;
+      if (entry.first != arrival[node])
+        {
+          continue;
+        }
+      if (node == dest)
+        {
+          break;
+        }
+      for (const LeoContact &contact : m_contacts[node])
+        {
+          // nothing starting later can beat the best arrival so far
+          if (contact.start >= arrival[dest])
+            {
+              break;
+            }
+          if (contact.end <= entry.first || IsExcluded (contact, excluded))
+            {
+              continue;
+            }
+          Time depart = std::max (entry.first, contact.start);
+          Time reached = depart + contact.delay;
+          if (reached < arrival[contact.to])
+            {
+              arrival[contact.to] = reached;
+              predecessor[contact.to] = &contact;
+              queue.push (Entry (reached, contact.to));
+            }
+        }
+    }
+
+  if (arrival[dest] == never)
+    {
+      return false;
+    }
+
+  route.arrival = arrival[dest];
+  route.expires = never;
+  route.hops = 0;
+  const LeoContact *first = 0;
+  for (uint32_t node = dest; node != source; node = predecessor[node]->from)
+    {
+      first = predecessor[node];
+      if (first->end < route.expires)
+        {
+          route.expires = first->end;
+          route.limit = *first;
+        }
+      route.hops++;
+    }
+  route.nextHop = first->to;
+  route.start = std::max (now, first->start);
+  return true;
+}
+
+bool
+LeoContactPlan::IsExcluded (const LeoContact &contact, const std::vector<LeoContact> &excluded)
+{
+  for (const LeoContact &other : excluded)
+    {
+      if (other.from == contact.from && other.to == contact.to && other.start == contact.start)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+LeoContactPlan::GetNodeForAddress (Ipv4Address address, uint32_t &node)
+{
+  if (m_addresses.empty ())
+    {
+      for (NodeList::Iterator it = NodeList::Begin (); it != NodeList::End (); ++it)
+        {
+          Ptr<Ipv4> ipv4 = (*it)->GetObject<Ipv4> ();
+          if (!ipv4)
+            {
+              continue;
+            }
+          for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+            {
+              for (uint32_t j = 0; j < ipv4->GetNAddresses (i); j++)
+                {
+                  Ipv4Address local = ipv4->GetAddress (i, j).GetLocal ();
+                  if (!local.IsLocalhost ())
+                    {
+                      m_addresses[local] = (*it)->GetId ();
+                    }
+                }
+            }
+        }
+    }
+
+  std::map<Ipv4Address, uint32_t>::const_iterator it = m_addresses.find (address);
+  if (it == m_addresses.end ())
+    {
+      return false;
+    }
+  node = it->second;
+  return true;
+}
+
+};
@@ -0,0 +1,229 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_CONTACT_PLAN_H
+#define LEO_CONTACT_PLAN_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/node-container.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of LeoContactPlan
+ */
+
+namespace ns3 {
+
+class LeoEphemeris;
+
+/**
+ * \ingroup leo
+ * \brief A directed, time-limited opportunity to transmit from one node to
+ * another
+ */
+struct LeoContact
+{
+  /// Node id of the transmitter
+  uint32_t from;
+  /// Node id of the receiver
+  uint32_t to;
+  /// Time at which the link comes up
+  Time start;
+  /// Time at which the link goes down
+  Time end;
+  /// One-way propagation delay over the link
+  Time delay;
+};
+
+/**
+ * \ingroup leo
+ * \brief A route through the contact plan
+ */
+struct LeoContactRoute
+{
+  /// Node id of the next hop
+  uint32_t nextHop;
+  /// Time at which the first contact comes up
+  Time start;
+  /// Earliest time at which the destination is reached
+  Time arrival;
+  /// Time after which one of the contacts of the route has ended
+  Time expires;
+  /// Number of contacts on the route
+  uint32_t hops;
+  /// The contact of the route that ends first
+  LeoContact limit;
+};
+
+/**
+ * \ingroup leo
+ * \brief Predicted contacts between satellites and ground stations
+ *
+ * Contacts are derived by sampling the positions of the nodes over a time
+ * window. Satellites using LeoCircularOrbitMobilityModel are predicted
+ * ahead, all other nodes are assumed to stand still. A ground station and a
+ * satellite are in contact while the satellite is above the elevation angle
+ * of the station, two satellites while the earth does not block the line of
+ * sight between them and they are closer than the ISL range.
+ *
+ * The plan is shared by all LeoContactGraphRouting instances of a
+ * simulation and also maps addresses to nodes.
+ *
+ * With a LeoEphemeris, e.g. one shared by a parameter sweep through the
+ * Ephemeris attribute, the positions are taken from its table, and its
+ * contacts are used as they are if it has been computed for the same nodes
+ * and window.
+ */
+class LeoContactPlan : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// constructor
+  LeoContactPlan ();
+  /// destructor
+  virtual ~LeoContactPlan ();
+
+  /**
+   * \brief Derive the contacts from the mobility of the nodes
+   * \param satellites the satellites
+   * \param stations the ground stations
+   * \param start begin of the planning window
+   * \param stop end of the planning window
+   */
+  void Compute (const NodeContainer &satellites, const NodeContainer &stations,
+                Time start, Time stop);
+
+  /**
+   * \brief Add a contact to the plan
+   * \param contact the contact
+   */
+  void AddContact (const LeoContact &contact);
+
+  /**
+   * \brief Remove all contacts
+   */
+  void Clear (void);
+
+  /**
+   * \brief Get the number of contacts
+   * \return number of contacts
+   */
+  uint32_t GetNContacts (void) const;
+
+  /**
+   * \brief Get the contacts starting at a node
+   * \param from node id of the transmitter
+   * \return the contacts, ordered by start time
+   */
+  const std::vector<LeoContact> &GetContacts (uint32_t from) const;
+
+  /**
+   * \brief Find the route with the earliest arrival time
+   *
+   * Runs Dijkstra's algorithm with the arrival time at each node as label.
+   * Since contacts are FIFO a later arrival at a node never leads to an
+   * earlier arrival at the destination.
+   *
+   * \param [in] source node id of the source
+   * \param [in] dest node id of the destination
+   * \param [in] now the time at which the data is at the source
+   * \param [out] route the route
+   * \param [in] excluded contacts that must not be used
+   * \return true if the destination can be reached within the plan
+   */
+  bool FindRoute (uint32_t source, uint32_t dest, Time now, LeoContactRoute &route,
+                  const std::vector<LeoContact> &excluded = std::vector<LeoContact> ()) const;
+
+  /**
+   * \brief Find the node an address is assigned to
+   * \param [in] address the address
+   * \param [out] node the node id
+   * \return true if the address is assigned to a node
+   */
+  bool GetNodeForAddress (Ipv4Address address, uint32_t &node);
+
+  /**
+   * \brief Use precomputed positions and contacts
+   * \param ephemeris the ephemeris
+   */
+  void SetEphemeris (Ptr<LeoEphemeris> ephemeris);
+
+  /**
+   * \brief Check whether two nodes can communicate
+   * \param a position of the first node, the ground station if any
+   * \param b position of the second node
+   * \param satellite whether both nodes are satellites
+   * \param elevationAngle minimum elevation seen from a ground station in degrees
+   * \param islRange maximum length of an inter-satellite link in m, 0 for no limit
+   * \return true if there is a link
+   */
+  static bool IsVisible (const Vector &a, const Vector &b, bool satellite,
+                         double elevationAngle, double islRange);
+
+private:
+  /**
+   * \brief Get the position of a node
+   * \param node node id
+   * \param t point in time
+   * \return the predicted position
+   */
+  Vector GetPositionAt (uint32_t node, Time t) const;
+
+  /**
+   * \brief Check whether a contact is in a list
+   * \param contact the contact
+   * \param excluded the list
+   * \return true if a contact with the same nodes and start is in the list
+   */
+  static bool IsExcluded (const LeoContact &contact, const std::vector<LeoContact> &excluded);
+
+  /// Sampling interval of the contact prediction
+  Time m_step;
+  /// Minimum elevation of a satellite above a ground station in degrees
+  double m_elevationAngle;
+  /// Maximum length of an inter-satellite link in m
+  double m_islRange;
+  /// Name of a shared LeoEphemeris
+  std::string m_ephemerisName;
+  /// Precomputed positions and contacts
+  Ptr<LeoEphemeris> m_ephemeris;
+
+  /// Contacts by node id of the transmitter
+  std::vector<std::vector<LeoContact> > m_contacts;
+  /// Number of contacts
+  uint32_t m_nContacts;
+  /// Addresses of all nodes
+  std::map<Ipv4Address, uint32_t> m_addresses;
+};
+
+};
+
+#endif /* LEO_CONTACT_PLAN_H */
@@ -0,0 +1,361 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <math.h>
+#include <string.h>
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/mobility-model.h"
+
+#include "leo-circular-orbit-mobility-model.h"
+#include "leo-ephemeris.h"
+
+/// Identifies a table of LeoEphemeris and its version
+#define LEO_EPHEMERIS_MAGIC 0x4c454f4550480001ULL
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoEphemeris");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoEphemeris);
+
+/**
+ * \brief Round up to a multiple of eight bytes
+ * \param n number of bytes
+ * \return the rounded number
+ */
+static std::size_t
+Align (std::size_t n)
+{
+  return (n + 7) & ~static_cast<std::size_t> (7);
+}
+
+TypeId
+LeoEphemeris::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoEphemeris")
+    .SetParent<Object> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<LeoEphemeris> ()
+  ;
+  return tid;
+}
+
+LeoEphemeris::LeoEphemeris ()
+  : m_header (0),
+    m_nodes (0),
+    m_positions (0),
+    m_contacts (0),
+    m_size (0),
+    m_map (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoEphemeris::~LeoEphemeris ()
+{
+  Close ();
+}
+
+void
+LeoEphemeris::DoDispose (void)
+{
+  Close ();
+  m_data.clear ();
+  Object::DoDispose ();
+}
+
+void
+LeoEphemeris::Close (void)
+{
+  if (m_map != 0)
+    {
+      munmap (m_map, m_size);
+      m_map = 0;
+    }
+  m_header = 0;
+  m_nodes = 0;
+  m_positions = 0;
+  m_contacts = 0;
+  m_size = 0;
+  m_index.clear ();
+}
+
+bool
+LeoEphemeris::Load (const uint8_t *base, std::size_t size)
+{
+  if (size < sizeof (Header))
+    {
+      return false;
+    }
+  const Header *header = reinterpret_cast<const Header *> (base);
+  if (header->magic != LEO_EPHEMERIS_MAGIC || header->resolution != Time::GetResolution ())
+    {
+      NS_LOG_WARN ("Table has been written by another version or with another time resolution");
+      return false;
+    }
+  std::size_t positions = Align (sizeof (Header) + sizeof (uint32_t) * header->nNodes);
+  std::size_t contacts = positions + sizeof (Vector) * header->nNodes * header->nSamples;
+  if (size < contacts + sizeof (Contact) * header->nContacts)
+    {
+      return false;
+    }
+
+  m_header = header;
+  m_nodes = reinterpret_cast<const uint32_t *> (base + sizeof (Header));
+  m_positions = reinterpret_cast<const Vector *> (base + positions);
+  m_contacts = reinterpret_cast<const Contact *> (base + contacts);
+  m_size = size;
+  m_index.clear ();
+  for (uint32_t i = 0; i < header->nNodes; i++)
+    {
+      m_index[m_nodes[i]] = i;
+    }
+  return true;
+}
+
+void
+LeoEphemeris::Compute (const NodeContainer &nodes, Time start, Time stop, Time step)
+{
+  NS_LOG_FUNCTION (this << nodes.GetN () << start << stop << step);
+  NS_ASSERT_MSG (step.IsStrictlyPositive (), "Step must be positive");
+
+  Header header;
+  memset (&header, 0, sizeof (header));
+  header.magic = LEO_EPHEMERIS_MAGIC;
+  header.resolution = Time::GetResolution ();
+  header.nNodes = nodes.GetN ();
+  header.nSamples = static_cast<uint32_t> (ceil ((stop - start).GetDouble () / step.GetDouble ())) + 1;
+  header.start = start.GetTimeStep ();
+  header.step = step.GetTimeStep ();
+
+  std::size_t positions = Align (sizeof (Header) + sizeof (uint32_t) * header.nNodes);
+  std::vector<uint8_t> data (positions + sizeof (Vector) * header.nNodes * header.nSamples);
+  memcpy (data.data (), &header, sizeof (header));
+  uint32_t *ids = reinterpret_cast<uint32_t *> (data.data () + sizeof (Header));
+  Vector *table = reinterpret_cast<Vector *> (data.data () + positions);
+  for (uint32_t i = 0; i < header.nNodes; i++)
+    {
+      ids[i] = nodes.Get (i)->GetId ();
+      Ptr<MobilityModel> mobility = nodes.Get (i)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility, "Node " << ids[i] << " has no mobility model");
+      Ptr<LeoCircularOrbitMobilityModel> orbit = DynamicCast<LeoCircularOrbitMobilityModel> (mobility);
+      for (uint32_t k = 0; k < header.nSamples; k++)
+        {
+          table[k * header.nNodes + i] = orbit ?
+            orbit->GetPositionAt (TimeStep (header.start + header.step * k)) :
+            mobility->GetPosition ();
+        }
+    }
+
+  Close ();
+  m_data.swap (data);
+  Load (m_data.data (), m_data.size ());
+}
+
+void
+LeoEphemeris::SetContacts (Ptr<LeoContactPlan> plan, Time start, Time stop)
+{
+  NS_LOG_FUNCTION (this << plan << start << stop);
+  NS_ASSERT_MSG (m_header, "Compute the positions first");
+
+  std::vector<Contact> contacts;
+  for (uint32_t i = 0; i < m_header->nNodes; i++)
+    {
+      for (const LeoContact &contact : plan->GetContacts (m_nodes[i]))
+        {
+          Contact c;
+          c.from = contact.from;
+          c.to = contact.to;
+          c.start = contact.start.GetTimeStep ();
+          c.end = contact.end.GetTimeStep ();
+          c.delay = contact.delay.GetTimeStep ();
+          contacts.push_back (c);
+        }
+    }
+
+  std::size_t offset = reinterpret_cast<const uint8_t *> (m_contacts) - reinterpret_cast<const uint8_t *> (m_header);
+  std::vector<uint8_t> data (offset + sizeof (Contact) * contacts.size ());
+  memcpy (data.data (), m_header, offset);
+  memcpy (data.data () + offset, contacts.data (), sizeof (Contact) * contacts.size ());
+  Header *header = reinterpret_cast<Header *> (data.data ());
+  header->nContacts = contacts.size ();
+  header->contactStart = start.GetTimeStep ();
+  header->contactStop = stop.GetTimeStep ();
+
+  Close ();
+  m_data.swap (data);
+  Load (m_data.data (), m_data.size ());
+}
+
+bool
+LeoEphemeris::Share (std::string name) const
+{
+  NS_LOG_FUNCTION (this << name);
+  NS_ASSERT_MSG (m_header, "Compute the positions first");
+
+  int fd = shm_open (name.c_str (), O_CREAT | O_RDWR, 0600);
+  if (fd < 0)
+    {
+      NS_LOG_ERROR ("Unable to create shared memory " << name);
+      return false;
+    }
+  if (ftruncate (fd, m_size) != 0)
+    {
+      NS_LOG_ERROR ("Unable to resize shared memory " << name);
+      close (fd);
+      return false;
+    }
+  void *map = mmap (0, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    {
+      NS_LOG_ERROR ("Unable to map shared memory " << name);
+      return false;
+    }
+  memcpy (map, m_header, m_size);
+  munmap (map, m_size);
+  return true;
+}
+
+bool
+LeoEphemeris::Open (std::string name)
+{
+  NS_LOG_FUNCTION (this << name);
+
+  int fd = shm_open (name.c_str (), O_RDONLY, 0);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("Unable to open shared memory " << name);
+      return false;
+    }
+  struct stat info;
+  if (fstat (fd, &info) != 0 || info.st_size == 0)
+    {
+      close (fd);
+      return false;
+    }
+  void *map = mmap (0, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Unable to map shared memory " << name);
+      return false;
+    }
+
+  Close ();
+  m_data.clear ();
+  m_map = map;
+  m_size = info.st_size;
+  if (!Load (static_cast<const uint8_t *> (map), info.st_size))
+    {
+      munmap (map, info.st_size);
+      m_map = 0;
+      Close ();
+      return false;
+    }
+  return true;
+}
+
+void
+LeoEphemeris::Unlink (std::string name)
+{
+  shm_unlink (name.c_str ());
+}
+
+bool
+LeoEphemeris::HasNode (uint32_t node) const
+{
+  return m_index.find (node) != m_index.end ();
+}
+
+bool
+LeoEphemeris::Covers (Time t) const
+{
+  if (m_header == 0)
+    {
+      return false;
+    }
+  int64_t ts = t.GetTimeStep ();
+  return ts >= m_header->start
+    && ts <= m_header->start + m_header->step * (m_header->nSamples - 1);
+}
+
+Vector
+LeoEphemeris::GetPosition (uint32_t node, Time t) const
+{
+  std::map<uint32_t, uint32_t>::const_iterator it = m_index.find (node);
+  NS_ASSERT_MSG (it != m_index.end (), "Node " << node << " has not been sampled");
+
+  double s = static_cast<double> (t.GetTimeStep () - m_header->start) / m_header->step;
+  s = std::min (std::max (s, 0.0), static_cast<double> (m_header->nSamples - 1));
+  uint32_t k = static_cast<uint32_t> (s);
+  const Vector &a = m_positions[k * m_header->nNodes + it->second];
+  if (k + 1 >= m_header->nSamples)
+    {
+      return a;
+    }
+  const Vector &b = m_positions[(k + 1) * m_header->nNodes + it->second];
+  double f = s - k;
+  return Vector (a.x + f * (b.x - a.x), a.y + f * (b.y - a.y), a.z + f * (b.z - a.z));
+}
+
+bool
+LeoEphemeris::HasContacts (const NodeContainer &nodes, Time start, Time stop) const
+{
+  if (m_header == 0 || m_header->contactStop <= m_header->contactStart
+      || nodes.GetN () != m_header->nNodes)
+    {
+      return false;
+    }
+  for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+    {
+      if (!HasNode ((*it)->GetId ()))
+        {
+          return false;
+        }
+    }
+  return m_header->contactStart <= start.GetTimeStep ()
+    && stop.GetTimeStep () <= m_header->contactStop;
+}
+
+void
+LeoEphemeris::GetContacts (Ptr<LeoContactPlan> plan) const
+{
+  NS_LOG_FUNCTION (this << plan);
+
+  for (uint32_t i = 0; i < m_header->nContacts; i++)
+    {
+      LeoContact contact;
+      contact.from = m_contacts[i].from;
+      contact.to = m_contacts[i].to;
+      contact.start = TimeStep (m_contacts[i].start);
+      contact.end = TimeStep (m_contacts[i].end);
+      contact.delay = TimeStep (m_contacts[i].delay);
+      plan->AddContact (contact);
+    }
+}
+
+};
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_EPHEMERIS_H
+#define LEO_EPHEMERIS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/node-container.h"
+
+#include "leo-contact-plan.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of LeoEphemeris
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Sampled positions of nodes and their contacts, shareable between
+ * processes
+ *
+ * The positions are sampled at a fixed step and interpolated linearly in
+ * between. For a satellite in LEO sampled every second the interpolation is
+ * off by about a meter.
+ *
+ * The table can be put into a POSIX shared memory segment with Share and
+ * mapped read-only by other processes with Open, so that runs of a
+ * parameter sweep do not have to predict the same constellation again.
+ * Nodes are identified by their node ids, so all processes have to create
+ * the nodes in the same order, and they have to use the same time
+ * resolution.
+ */
+class LeoEphemeris : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// constructor
+  LeoEphemeris ();
+  /// destructor
+  virtual ~LeoEphemeris ();
+
+  /**
+   * \brief Sample the positions of nodes
+   *
+   * Drops the contacts.
+   *
+   * \param nodes the nodes
+   * \param start first sample
+   * \param stop last sample
+   * \param step sampling interval
+   */
+  void Compute (const NodeContainer &nodes, Time start, Time stop, Time step);
+
+  /**
+   * \brief Store the contacts of a plan
+   * \param plan the contact plan
+   * \param start begin of the window the plan was computed for
+   * \param stop end of the window the plan was computed for
+   */
+  void SetContacts (Ptr<LeoContactPlan> plan, Time start, Time stop);
+
+  /**
+   * \brief Put the table into a shared memory segment
+   * \param name name of the segment, starting with a slash
+   * \return true on success
+   */
+  bool Share (std::string name) const;
+
+  /**
+   * \brief Map a shared memory segment created by Share
+   * \param name name of the segment
+   * \return true on success
+   */
+  bool Open (std::string name);
+
+  /**
+   * \brief Remove a shared memory segment, processes that have it open keep
+   * their mapping
+   * \param name name of the segment
+   */
+  static void Unlink (std::string name);
+
+  /**
+   * \brief Check whether the positions of a node are known
+   * \param node node id
+   * \return true if the node has been sampled
+   */
+  bool HasNode (uint32_t node) const;
+
+  /**
+   * \brief Check whether a point in time is within the sampled window
+   * \param t point in time
+   * \return true if t is between the first and the last sample
+   */
+  bool Covers (Time t) const;
+
+  /**
+   * \brief Get the position of a node
+   * \param node node id
+   * \param t point in time, within the sampled window
+   * \return the interpolated position
+   */
+  Vector GetPosition (uint32_t node, Time t) const;
+
+  /**
+   * \brief Check whether the contacts of a window are known
+   * \param nodes the nodes of the contact plan
+   * \param start begin of the window
+   * \param stop end of the window
+   * \return true if the contacts were computed for exactly these nodes and
+   * the window covers the given one
+   */
+  bool HasContacts (const NodeContainer &nodes, Time start, Time stop) const;
+
+  /**
+   * \brief Add the stored contacts to a plan
+   * \param plan the contact plan
+   */
+  void GetContacts (Ptr<LeoContactPlan> plan) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Layout of the beginning of the table
+  struct Header
+  {
+    /// Identifies the table and its version
+    uint64_t magic;
+    /// Time resolution of the process that wrote the table
+    int32_t resolution;
+    /// Number of nodes
+    uint32_t nNodes;
+    /// Number of samples
+    uint32_t nSamples;
+    /// Number of contacts
+    uint32_t nContacts;
+    /// First sample in time steps
+    int64_t start;
+    /// Sampling interval in time steps
+    int64_t step;
+    /// Begin of the contact window in time steps
+    int64_t contactStart;
+    /// End of the contact window in time steps
+    int64_t contactStop;
+  };
+
+  /// Layout of a contact in the table
+  struct Contact
+  {
+    /// Node id of the transmitter
+    uint32_t from;
+    /// Node id of the receiver
+    uint32_t to;
+    /// Begin in time steps
+    int64_t start;
+    /// End in time steps
+    int64_t end;
+    /// Delay in time steps
+    int64_t delay;
+  };
+
+  /**
+   * \brief Point the accessors at a table
+   * \param base the table
+   * \param size size of the table
+   * \return true if the table is valid
+   */
+  bool Load (const uint8_t *base, std::size_t size);
+
+  /// Release the mapped segment
+  void Close (void);
+
+  /// Header of the table
+  const Header *m_header;
+  /// Node ids of the table
+  const uint32_t *m_nodes;
+  /// Positions of the table, by sample and node
+  const Vector *m_positions;
+  /// Contacts of the table
+  const Contact *m_contacts;
+  /// Index of each node in the table
+  std::map<uint32_t, uint32_t> m_index;
+
+  /// Table of this process
+  std::vector<uint8_t> m_data;
+  /// Size of the table
+  std::size_t m_size;
+  /// Mapped segment, if the table is shared
+  void *m_map;
+};
+
+};
+
+#endif /* LEO_EPHEMERIS_H */
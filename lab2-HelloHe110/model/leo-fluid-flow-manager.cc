@@ -0,0 +1,494 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/mobility-model.h"
+
+#include "leo-contact-plan.h"
+#include "leo-mock-net-device.h"
+#include "isl-mock-channel.h"
+#include "leo-fluid-flow-manager.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoFluidFlowManager");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoFluidFlowManager);
+
+TypeId
+LeoFluidFlowManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoFluidFlowManager")
+    .SetParent<Object> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<LeoFluidFlowManager> ()
+    .AddAttribute ("Interval",
+                   "Interval between checks of the hops and the data rates",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&LeoFluidFlowManager::m_interval),
+                   MakeTimeChecker (MilliSeconds (1)))
+    .AddAttribute ("ElevationAngle",
+                   "Minimum elevation of a satellite seen from a ground station in degrees",
+                   DoubleValue (40.0),
+                   MakeDoubleAccessor (&LeoFluidFlowManager::m_elevationAngle),
+                   MakeDoubleChecker<double> (0.0, 90.0))
+    .AddAttribute ("IslRange",
+                   "Maximum length of an inter-satellite link in m, 0 for no limit",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&LeoFluidFlowManager::m_islRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Efficiency",
+                   "Fraction of the data rate of a device that carries payload",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&LeoFluidFlowManager::m_efficiency),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddTraceSource ("Completed",
+                     "A fluid flow has transferred all of its bytes",
+                     MakeTraceSourceAccessor (&LeoFluidFlowManager::m_completed),
+                     "ns3::LeoFluidFlowManager::CompletedCallback")
+  ;
+  return tid;
+}
+
+LeoFluidFlowManager::LeoFluidFlowManager ()
+  : m_nextId (0),
+    m_nComputations (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoFluidFlowManager::~LeoFluidFlowManager ()
+{
+}
+
+void
+LeoFluidFlowManager::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_completion.Cancel ();
+  m_check.Cancel ();
+  m_flows.clear ();
+  Object::DoDispose ();
+}
+
+Ptr<MockNetDevice>
+LeoFluidFlowManager::FindDevice (Ptr<Node> from, Ptr<Node> to)
+{
+  for (uint32_t i = 0; i < from->GetNDevices (); i++)
+    {
+      Ptr<MockNetDevice> dev = DynamicCast<MockNetDevice> (from->GetDevice (i));
+      if (dev == 0 || dev->GetChannel () == 0)
+        {
+          continue;
+        }
+      Ptr<Channel> channel = dev->GetChannel ();
+      for (std::size_t j = 0; j < channel->GetNDevices (); j++)
+        {
+          Ptr<NetDevice> peer = channel->GetDevice (j);
+          if (peer->GetNode () != to)
+            {
+              continue;
+            }
+          // the LEO channel does not connect devices of the same type
+          Ptr<LeoMockNetDevice> a = DynamicCast<LeoMockNetDevice> (dev);
+          Ptr<LeoMockNetDevice> b = DynamicCast<LeoMockNetDevice> (peer);
+          if (a != 0 && b != 0 && a->GetDeviceType () == b->GetDeviceType ())
+            {
+              continue;
+            }
+          return dev;
+        }
+    }
+  return 0;
+}
+
+LeoFluidFlowManager::Flow
+LeoFluidFlowManager::MakeFlow (const NodeContainer &path) const
+{
+  NS_ABORT_MSG_IF (path.GetN () < 2, "A flow needs a source and a sink");
+
+  Flow flow;
+  flow.nodes.assign (path.Begin (), path.End ());
+  for (uint32_t i = 0; i + 1 < path.GetN (); i++)
+    {
+      Ptr<MockNetDevice> dev = FindDevice (path.Get (i), path.Get (i + 1));
+      NS_ABORT_MSG_IF (dev == 0, "Node " << path.Get (i)->GetId ()
+                       << " shares no channel with node " << path.Get (i + 1)->GetId ());
+      flow.devices.push_back (dev);
+    }
+  flow.bytes = 0;
+  flow.remaining = 0;
+  flow.rate = 0;
+  flow.finish = Time::Max ();
+  flow.active = false;
+  flow.packet = false;
+  return flow;
+}
+
+uint32_t
+LeoFluidFlowManager::AddFlow (Ptr<Node> source, Ptr<Node> sink, uint64_t bytes, Time start)
+{
+  NodeContainer path (source, sink);
+  return AddFlow (path, bytes, start);
+}
+
+uint32_t
+LeoFluidFlowManager::AddFlow (const NodeContainer &path, uint64_t bytes, Time start)
+{
+  NS_LOG_FUNCTION (this << path.GetN () << bytes << start);
+
+  Flow flow = MakeFlow (path);
+  flow.bytes = bytes;
+  flow.remaining = bytes;
+  uint32_t id = m_nextId++;
+  m_flows[id] = flow;
+
+  if (start.IsStrictlyPositive ())
+    {
+      Simulator::Schedule (start, &LeoFluidFlowManager::Start, this, id);
+    }
+  else
+    {
+      Start (id);
+    }
+  return id;
+}
+
+uint32_t
+LeoFluidFlowManager::AddPacketFlow (const NodeContainer &path)
+{
+  NS_LOG_FUNCTION (this << path.GetN ());
+
+  Flow flow = MakeFlow (path);
+  flow.packet = true;
+  uint32_t id = m_nextId++;
+  m_flows[id] = flow;
+  Start (id);
+  return id;
+}
+
+void
+LeoFluidFlowManager::RemoveFlow (uint32_t id)
+{
+  NS_LOG_FUNCTION (this << id);
+
+  if (m_flows.erase (id))
+    {
+      Compute ();
+    }
+}
+
+void
+LeoFluidFlowManager::Start (uint32_t id)
+{
+  NS_LOG_FUNCTION (this << id);
+
+  std::map<uint32_t, Flow>::iterator it = m_flows.find (id);
+  if (it == m_flows.end ())
+    {
+      return;
+    }
+  it->second.active = true;
+  it->second.start = Simulator::Now ();
+  Compute ();
+}
+
+bool
+LeoFluidFlowManager::IsUp (const Flow &flow, uint32_t hop) const
+{
+  Ptr<MobilityModel> a = flow.nodes[hop]->GetObject<MobilityModel> ();
+  Ptr<MobilityModel> b = flow.nodes[hop + 1]->GetObject<MobilityModel> ();
+  if (a == 0 || b == 0)
+    {
+      return true;
+    }
+
+  Ptr<MockNetDevice> dev = flow.devices[hop];
+  if (DynamicCast<IslMockChannel> (dev->GetChannel ()))
+    {
+      return LeoContactPlan::IsVisible (a->GetPosition (), b->GetPosition (), true,
+                                        m_elevationAngle, m_islRange);
+    }
+  Ptr<LeoMockNetDevice> leo = DynamicCast<LeoMockNetDevice> (dev);
+  if (leo == 0)
+    {
+      return true;
+    }
+  // the elevation is seen from the ground station
+  if (leo->GetDeviceType () == LeoMockNetDevice::GND)
+    {
+      return LeoContactPlan::IsVisible (a->GetPosition (), b->GetPosition (), false,
+                                        m_elevationAngle, m_islRange);
+    }
+  return LeoContactPlan::IsVisible (b->GetPosition (), a->GetPosition (), false,
+                                    m_elevationAngle, m_islRange);
+}
+
+std::vector<double>
+LeoFluidFlowManager::GetCapacities (void) const
+{
+  std::vector<double> capacities;
+  for (const std::pair<const uint32_t, Flow> &entry : m_flows)
+    {
+      const Flow &flow = entry.second;
+      if (!flow.active || flow.finish != Time::Max ())
+        {
+          continue;
+        }
+      for (uint32_t hop = 0; hop < flow.devices.size (); hop++)
+        {
+          capacities.push_back (IsUp (flow, hop) ?
+                                flow.devices[hop]->GetDataRate ().GetBitRate () / 8.0 * m_efficiency :
+                                0.0);
+        }
+    }
+  return capacities;
+}
+
+void
+LeoFluidFlowManager::Advance (void)
+{
+  double elapsed = (Simulator::Now () - m_lastAdvance).GetSeconds ();
+  for (std::pair<const uint32_t, Flow> &entry : m_flows)
+    {
+      Flow &flow = entry.second;
+      if (flow.active && !flow.packet && flow.finish == Time::Max ())
+        {
+          flow.remaining = std::max (0.0, flow.remaining - flow.rate * elapsed);
+        }
+    }
+  m_lastAdvance = Simulator::Now ();
+}
+
+void
+LeoFluidFlowManager::Compute (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Advance ();
+  m_nComputations++;
+
+  std::vector<uint32_t> completed;
+  std::vector<uint32_t> running;
+  for (std::pair<const uint32_t, Flow> &entry : m_flows)
+    {
+      Flow &flow = entry.second;
+      if (!flow.active || flow.finish != Time::Max ())
+        {
+          continue;
+        }
+      // what is left after rounding the completion to a nanosecond
+      if (!flow.packet && flow.remaining <= flow.rate * 1e-9 + 1e-6)
+        {
+          flow.remaining = 0;
+          flow.rate = 0;
+          flow.finish = Simulator::Now ();
+          completed.push_back (entry.first);
+          continue;
+        }
+      flow.rate = 0;
+      bool up = true;
+      for (uint32_t hop = 0; hop < flow.devices.size (); hop++)
+        {
+          up = up && IsUp (flow, hop);
+        }
+      if (up)
+        {
+          running.push_back (entry.first);
+        }
+    }
+
+  // max-min fair rates by progressive filling: the device with the smallest
+  // share fixes the rates of its flows, whose rates are then taken from the
+  // other devices on their paths
+  std::map<MockNetDevice *, double> capacity;
+  std::map<MockNetDevice *, uint32_t> users;
+  for (uint32_t id : running)
+    {
+      for (Ptr<MockNetDevice> dev : m_flows[id].devices)
+        {
+          capacity[PeekPointer (dev)] = dev->GetDataRate ().GetBitRate () / 8.0 * m_efficiency;
+          users[PeekPointer (dev)]++;
+        }
+    }
+  while (!running.empty ())
+    {
+      MockNetDevice *bottleneck = 0;
+      double share = std::numeric_limits<double>::infinity ();
+      for (const std::pair<MockNetDevice * const, uint32_t> &user : users)
+        {
+          if (user.second > 0 && capacity[user.first] / user.second < share)
+            {
+              bottleneck = user.first;
+              share = capacity[user.first] / user.second;
+            }
+        }
+
+      std::vector<uint32_t> rest;
+      for (uint32_t id : running)
+        {
+          Flow &flow = m_flows[id];
+          if (std::find (flow.devices.begin (), flow.devices.end (), bottleneck) == flow.devices.end ())
+            {
+              rest.push_back (id);
+              continue;
+            }
+          flow.rate = std::max (0.0, share);
+          for (Ptr<MockNetDevice> dev : flow.devices)
+            {
+              capacity[PeekPointer (dev)] -= flow.rate;
+              users[PeekPointer (dev)]--;
+            }
+        }
+      running.swap (rest);
+    }
+
+  m_completion.Cancel ();
+  double next = std::numeric_limits<double>::infinity ();
+  bool pending = false;
+  for (const std::pair<const uint32_t, Flow> &entry : m_flows)
+    {
+      const Flow &flow = entry.second;
+      if (!flow.active || flow.finish != Time::Max ())
+        {
+          continue;
+        }
+      pending = true;
+      if (!flow.packet && flow.rate > 0)
+        {
+          next = std::min (next, flow.remaining / flow.rate);
+        }
+    }
+  if (next < std::numeric_limits<double>::infinity ())
+    {
+      m_completion = Simulator::Schedule (Seconds (next), &LeoFluidFlowManager::Compute, this);
+    }
+  if (pending && !m_check.IsRunning ())
+    {
+      m_check = Simulator::Schedule (m_interval, &LeoFluidFlowManager::Check, this);
+    }
+  m_capacities = GetCapacities ();
+
+  // last, since the trace may add flows
+  for (uint32_t id : completed)
+    {
+      std::map<uint32_t, Flow>::const_iterator it = m_flows.find (id);
+      if (it == m_flows.end ())
+        {
+          continue;
+        }
+      const Flow &flow = it->second;
+      NS_LOG_INFO ("Flow " << id << " completed after " << flow.finish - flow.start);
+      m_completed (id, flow.nodes.front ()->GetId (), flow.nodes.back ()->GetId (),
+                   flow.start, flow.finish);
+    }
+}
+
+void
+LeoFluidFlowManager::Check (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Update ();
+  bool pending = false;
+  for (const std::pair<const uint32_t, Flow> &entry : m_flows)
+    {
+      pending = pending || (entry.second.active && entry.second.finish == Time::Max ());
+    }
+  if (pending && !m_check.IsRunning ())
+    {
+      m_check = Simulator::Schedule (m_interval, &LeoFluidFlowManager::Check, this);
+    }
+}
+
+void
+LeoFluidFlowManager::Update (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (GetCapacities () != m_capacities)
+    {
+      Compute ();
+    }
+}
+
+bool
+LeoFluidFlowManager::IsFinished (uint32_t id) const
+{
+  return GetFinishTime (id) != Time::Max ();
+}
+
+Time
+LeoFluidFlowManager::GetStartTime (uint32_t id) const
+{
+  std::map<uint32_t, Flow>::const_iterator it = m_flows.find (id);
+  NS_ASSERT_MSG (it != m_flows.end (), "Unknown flow " << id);
+  return it->second.start;
+}
+
+Time
+LeoFluidFlowManager::GetFinishTime (uint32_t id) const
+{
+  std::map<uint32_t, Flow>::const_iterator it = m_flows.find (id);
+  NS_ASSERT_MSG (it != m_flows.end (), "Unknown flow " << id);
+  return it->second.finish;
+}
+
+double
+LeoFluidFlowManager::GetRate (uint32_t id) const
+{
+  std::map<uint32_t, Flow>::const_iterator it = m_flows.find (id);
+  NS_ASSERT_MSG (it != m_flows.end (), "Unknown flow " << id);
+  return it->second.rate;
+}
+
+uint64_t
+LeoFluidFlowManager::GetTotalRx (Ptr<Node> sink) const
+{
+  double elapsed = (Simulator::Now () - m_lastAdvance).GetSeconds ();
+  double total = 0;
+  for (const std::pair<const uint32_t, Flow> &entry : m_flows)
+    {
+      const Flow &flow = entry.second;
+      if (flow.packet || !flow.active || flow.nodes.back () != sink)
+        {
+          continue;
+        }
+      double remaining = flow.remaining;
+      if (flow.finish == Time::Max ())
+        {
+          remaining = std::max (0.0, remaining - flow.rate * elapsed);
+        }
+      total += flow.bytes - remaining;
+    }
+  return static_cast<uint64_t> (total + 0.5);
+}
+
+uint32_t
+LeoFluidFlowManager::GetNComputations (void) const
+{
+  return m_nComputations;
+}
+
+};
@@ -0,0 +1,280 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_FLUID_FLOW_MANAGER_H
+#define LEO_FLUID_FLOW_MANAGER_H
+
+#include <map>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/node-container.h"
+#include "ns3/traced-callback.h"
+
+#include "mock-net-device.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of LeoFluidFlowManager
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Simulates bulk transfers as fluid flows instead of packets
+ *
+ * A flow sends a number of bytes along a path of nodes. Each hop uses the
+ * MockNetDevice of the sending node that shares a channel with the next
+ * node, and the data rate of that device is shared max-min fairly between
+ * all flows that use it. A hop is usable while a ground station sees the
+ * satellite above ElevationAngle, or while two satellites have line of
+ * sight within IslRange.
+ *
+ * The rates are only recomputed when a flow starts or ends, or when the
+ * visibility of a hop or the data rate of a device has changed. Both are
+ * checked every Interval while there are flows, and Update forces a check
+ * after changing data rates.
+ *
+ * Packet level flows can be registered with AddPacketFlow. They take their
+ * share of the devices on their path until they are removed, so that fluid
+ * and packet level flows can be mixed.
+ *
+ * The completion time of a flow leaves out connection setup, slow start,
+ * headers and acknowledgements. For a TCP transfer of B bytes at rate R
+ * with round trip time T and segment size S, the packet level transfer
+ * takes at most about T * (1.5 + log2 (R * T / S)) longer, plus the
+ * header overhead B / R * (1 / Efficiency - 1) if Efficiency is left at 1.
+ * Visibility changes are detected up to Interval late.
+ */
+class LeoFluidFlowManager : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// constructor
+  LeoFluidFlowManager ();
+  /// destructor
+  virtual ~LeoFluidFlowManager ();
+
+  /**
+   * \brief Add a transfer between two nodes that share a channel
+   * \param source the sending node
+   * \param sink the receiving node
+   * \param bytes number of bytes to transfer
+   * \param start time at which the transfer starts, relative to now
+   * \return the id of the flow
+   */
+  uint32_t AddFlow (Ptr<Node> source, Ptr<Node> sink, uint64_t bytes, Time start = Seconds (0));
+
+  /**
+   * \brief Add a transfer along a path
+   * \param path the nodes of the path, source first
+   * \param bytes number of bytes to transfer
+   * \param start time at which the transfer starts, relative to now
+   * \return the id of the flow
+   */
+  uint32_t AddFlow (const NodeContainer &path, uint64_t bytes, Time start = Seconds (0));
+
+  /**
+   * \brief Register a packet level flow that shares the devices of a path
+   * \param path the nodes of the path, source first
+   * \return the id of the flow
+   */
+  uint32_t AddPacketFlow (const NodeContainer &path);
+
+  /**
+   * \brief Remove a flow, e.g. a packet level flow that has completed
+   * \param id the id of the flow
+   */
+  void RemoveFlow (uint32_t id);
+
+  /**
+   * \brief Recompute the rates if a hop or a data rate has changed
+   */
+  void Update (void);
+
+  /**
+   * \brief Check whether a flow has transferred all of its bytes
+   * \param id the id of the flow
+   * \return true if the flow has completed
+   */
+  bool IsFinished (uint32_t id) const;
+
+  /**
+   * \brief Get the time at which a flow started
+   * \param id the id of the flow
+   * \return the start time
+   */
+  Time GetStartTime (uint32_t id) const;
+
+  /**
+   * \brief Get the time at which a flow completed
+   * \param id the id of the flow
+   * \return the completion time, or the maximum time if it has not completed
+   */
+  Time GetFinishTime (uint32_t id) const;
+
+  /**
+   * \brief Get the current rate of a flow
+   * \param id the id of the flow
+   * \return the rate in bytes per second
+   */
+  double GetRate (uint32_t id) const;
+
+  /**
+   * \brief Get the number of bytes received by a node so far, like
+   * PacketSink::GetTotalRx
+   * \param sink the receiving node
+   * \return the number of bytes of all fluid flows that end at the node
+   */
+  uint64_t GetTotalRx (Ptr<Node> sink) const;
+
+  /**
+   * \brief Get the number of times the rates have been computed
+   * \return number of computations
+   */
+  uint32_t GetNComputations (void) const;
+
+  /**
+   * TracedCallback signature for completed flows.
+   *
+   * \param [in] id the id of the flow
+   * \param [in] source the node id of the source
+   * \param [in] sink the node id of the sink
+   * \param [in] start the time at which the flow started
+   * \param [in] finish the time at which the flow completed
+   */
+  typedef void (* CompletedCallback)
+    (uint32_t id, uint32_t source, uint32_t sink, Time start, Time finish);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// State of a flow
+  struct Flow
+  {
+    /// Nodes of the path, source first
+    std::vector<Ptr<Node> > nodes;
+    /// Sending device of each hop
+    std::vector<Ptr<MockNetDevice> > devices;
+    /// Number of bytes to transfer
+    uint64_t bytes;
+    /// Number of bytes left
+    double remaining;
+    /// Current rate in bytes per second
+    double rate;
+    /// Time at which the flow started
+    Time start;
+    /// Time at which the flow completed
+    Time finish;
+    /// Whether the flow has started
+    bool active;
+    /// Whether the flow is simulated on packet level
+    bool packet;
+  };
+
+  /**
+   * \brief Find the path and the devices of a flow
+   * \param path the nodes of the path
+   * \return the flow, not yet started
+   */
+  Flow MakeFlow (const NodeContainer &path) const;
+
+  /**
+   * \brief Find the device of a node that shares a channel with another node
+   * \param from the sending node
+   * \param to the receiving node
+   * \return the device of the sending node
+   */
+  static Ptr<MockNetDevice> FindDevice (Ptr<Node> from, Ptr<Node> to);
+
+  /**
+   * \brief Check whether a hop of a flow can be used
+   * \param flow the flow
+   * \param hop index of the hop
+   * \return true if the nodes of the hop see each other
+   */
+  bool IsUp (const Flow &flow, uint32_t hop) const;
+
+  /**
+   * \brief Start a flow
+   * \param id the id of the flow
+   */
+  void Start (uint32_t id);
+
+  /**
+   * \brief Subtract the bytes transferred since the last call
+   */
+  void Advance (void);
+
+  /**
+   * \brief Complete flows, recompute the rates and schedule the next completion
+   */
+  void Compute (void);
+
+  /**
+   * \brief Check the hops and data rates and schedule the next check
+   */
+  void Check (void);
+
+  /**
+   * \brief Get the state the rates depend on
+   * \return the data rate of each hop of each active flow, 0 if it is down
+   */
+  std::vector<double> GetCapacities (void) const;
+
+  /// Interval between checks of the hops and data rates
+  Time m_interval;
+  /// Minimum elevation of a satellite above a ground station in degrees
+  double m_elevationAngle;
+  /// Maximum length of an inter-satellite link in m
+  double m_islRange;
+  /// Fraction of the data rate that carries payload
+  double m_efficiency;
+
+  /// All flows by id
+  std::map<uint32_t, Flow> m_flows;
+  /// Id of the next flow
+  uint32_t m_nextId;
+  /// Time up to which the remaining bytes are up to date
+  Time m_lastAdvance;
+  /// Capacities at the last computation
+  std::vector<double> m_capacities;
+  /// Next completion of a flow
+  EventId m_completion;
+  /// Next check of the hops and data rates
+  EventId m_check;
+  /// Number of computations
+  uint32_t m_nComputations;
+
+  /// Trace of completed flows
+  TracedCallback<uint32_t, uint32_t, uint32_t, Time, Time> m_completed;
+};
+
+};
+
+#endif /* LEO_FLUID_FLOW_MANAGER_H */
@@ -0,0 +1,489 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <math.h>
+#include <limits>
+
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/mobility-model.h"
+#include "ns3/simulator.h"
+
+#include "leo-grid-routing.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoGridRouting");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoGridRouting);
+
+TypeId
+LeoGridRouting::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoGridRouting")
+    .SetParent<Ipv4RoutingProtocol> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<LeoGridRouting> ()
+    .AddAttribute ("NumOrbits",
+                   "The number of orbital planes",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&LeoGridRouting::m_numOrbits),
+                   MakeUintegerChecker<uint16_t> (1))
+    .AddAttribute ("NumSatellites",
+                   "The number of satellites per plane",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&LeoGridRouting::m_numSatellites),
+                   MakeUintegerChecker<uint16_t> (1))
+    .AddAttribute ("FirstSatellite",
+                   "Node id of the first satellite of the orbit",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&LeoGridRouting::m_firstSatellite),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("FirstStation",
+                   "Node id of the first ground station",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&LeoGridRouting::m_firstStation),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("NumStations",
+                   "The number of ground stations",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&LeoGridRouting::m_numStations),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("CrossSeam",
+                   "Whether there are ISLs between the last and the first plane",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&LeoGridRouting::m_crossSeam),
+                   MakeBooleanChecker ())
+    .AddAttribute ("IslNetwork",
+                   "Network address of the ISL channel",
+                   Ipv4AddressValue ("10.2.0.0"),
+                   MakeIpv4AddressAccessor (&LeoGridRouting::m_islNetwork),
+                   MakeIpv4AddressChecker ())
+    .AddAttribute ("IslMask",
+                   "Network mask of the ISL channel",
+                   Ipv4MaskValue ("255.255.0.0"),
+                   MakeIpv4MaskAccessor (&LeoGridRouting::m_islMask),
+                   MakeIpv4MaskChecker ())
+    .AddAttribute ("UtNetwork",
+                   "Network address of the ground channel",
+                   Ipv4AddressValue ("10.1.0.0"),
+                   MakeIpv4AddressAccessor (&LeoGridRouting::m_utNetwork),
+                   MakeIpv4AddressChecker ())
+    .AddAttribute ("UtMask",
+                   "Network mask of the ground channel",
+                   Ipv4MaskValue ("255.255.0.0"),
+                   MakeIpv4MaskAccessor (&LeoGridRouting::m_utMask),
+                   MakeIpv4MaskChecker ())
+  ;
+  return tid;
+}
+
+LeoGridRouting::LeoGridRouting ()
+  : m_index (0),
+    m_type (UNKNOWN),
+    m_islInterface (-1),
+    m_utInterface (-1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoGridRouting::~LeoGridRouting ()
+{
+}
+
+void
+LeoGridRouting::DoDispose (void)
+{
+  m_ipv4 = 0;
+  Ipv4RoutingProtocol::DoDispose ();
+}
+
+uint32_t
+LeoGridRouting::GetNextHop (uint32_t from, uint32_t to) const
+{
+  if (from == to)
+    {
+      return from;
+    }
+
+  uint32_t planes = m_numOrbits;
+  uint32_t slots = m_numSatellites;
+  uint32_t fromPlane = from / slots;
+  uint32_t fromSlot = from % slots;
+  uint32_t toPlane = to / slots;
+  uint32_t toSlot = to % slots;
+
+  // move across planes first, the slot is kept by the inter-plane links
+  if (fromPlane != toPlane)
+    {
+      uint32_t forward = (toPlane + planes - fromPlane) % planes;
+      bool east = m_crossSeam ? forward <= planes - forward : toPlane > fromPlane;
+      uint32_t plane = east ? (fromPlane + 1) % planes : (fromPlane + planes - 1) % planes;
+      return plane * slots + fromSlot;
+    }
+
+  uint32_t forward = (toSlot + slots - fromSlot) % slots;
+  uint32_t slot = forward <= slots - forward ? (fromSlot + 1) % slots : (fromSlot + slots - 1) % slots;
+  return fromPlane * slots + slot;
+}
+
+uint32_t
+LeoGridRouting::GetHopCount (uint32_t from, uint32_t to) const
+{
+  uint32_t planes = m_numOrbits;
+  uint32_t slots = m_numSatellites;
+  uint32_t fromPlane = from / slots;
+  uint32_t toPlane = to / slots;
+
+  uint32_t planeHops;
+  if (m_crossSeam)
+    {
+      uint32_t forward = (toPlane + planes - fromPlane) % planes;
+      planeHops = std::min (forward, planes - forward);
+    }
+  else
+    {
+      planeHops = toPlane > fromPlane ? toPlane - fromPlane : fromPlane - toPlane;
+    }
+
+  uint32_t forward = (to % slots + slots - from % slots) % slots;
+  return planeHops + std::min (forward, slots - forward);
+}
+
+uint32_t
+LeoGridRouting::GetNearestSatellite (const Vector &position) const
+{
+  NS_LOG_FUNCTION (this << position);
+
+  uint32_t slots = m_numSatellites;
+  uint32_t nearest = 0;
+  double nearestDistance = std::numeric_limits<double>::max ();
+
+  for (uint32_t plane = 0; plane < m_numOrbits; plane++)
+    {
+      // slot 0 of the plane and its heading span the orbital plane and all
+      // other satellites of the plane follow at multiples of 2 pi / slots
+      Ptr<MobilityModel> reference = NodeList::GetNode (m_firstSatellite + plane * slots)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (reference, "Satellite has no mobility model");
+      Vector u = reference->GetPosition ();
+      Vector v = reference->GetVelocity ();
+      double x = (position.x * u.x + position.y * u.y + position.z * u.z) / u.GetLength ();
+      double y = (position.x * v.x + position.y * v.y + position.z * v.z) / v.GetLength ();
+
+      int64_t slot = llround (atan2 (y, x) * slots / (2 * M_PI));
+      slot = ((slot % (int64_t) slots) + slots) % slots;
+
+      uint32_t candidate = plane * slots + slot;
+      Ptr<MobilityModel> mobility = NodeList::GetNode (m_firstSatellite + candidate)->GetObject<MobilityModel> ();
+      double distance = CalculateDistance (position, mobility->GetPosition ());
+      if (distance < nearestDistance)
+        {
+          nearestDistance = distance;
+          nearest = candidate;
+        }
+    }
+
+  return nearest;
+}
+
+LeoGridRouting::AddressType
+LeoGridRouting::Classify (Ipv4Address address, uint32_t &index) const
+{
+  uint32_t numSatellites = (uint32_t) m_numOrbits * m_numSatellites;
+
+  if (address.CombineMask (m_islMask) == m_islNetwork)
+    {
+      index = address.Get () - m_islNetwork.Get () - 1;
+      return index < numSatellites ? SATELLITE : UNKNOWN;
+    }
+
+  if (address.CombineMask (m_utMask) == m_utNetwork)
+    {
+      index = address.Get () - m_utNetwork.Get () - 1;
+      if (index < numSatellites)
+        {
+          return SATELLITE;
+        }
+      index -= numSatellites;
+      return index < m_numStations ? STATION : UNKNOWN;
+    }
+
+  return UNKNOWN;
+}
+
+bool
+LeoGridRouting::Lookup (Ipv4Address dest, Ipv4Address &gateway, uint32_t &interface) const
+{
+  NS_LOG_FUNCTION (this << dest);
+
+  uint32_t destIndex;
+  AddressType destType = Classify (dest, destIndex);
+  if (destType == UNKNOWN)
+    {
+      NS_LOG_LOGIC ("Address " << dest << " is not part of the constellation");
+      return false;
+    }
+
+  uint32_t numSatellites = (uint32_t) m_numOrbits * m_numSatellites;
+
+  if (m_type == STATION)
+    {
+      if (m_utInterface < 0)
+        {
+          return false;
+        }
+      Ptr<MobilityModel> mobility = m_ipv4->GetObject<Node> ()->GetObject<MobilityModel> ();
+      uint32_t satellite = GetNearestSatellite (mobility->GetPosition ());
+      gateway = Ipv4Address (m_utNetwork.Get () + satellite + 1);
+      interface = m_utInterface;
+      return true;
+    }
+
+  if (m_type != SATELLITE)
+    {
+      return false;
+    }
+
+  uint32_t target = destIndex;
+  if (destType == STATION)
+    {
+      Ptr<MobilityModel> mobility = NodeList::GetNode (m_firstStation + destIndex)->GetObject<MobilityModel> ();
+      target = GetNearestSatellite (mobility->GetPosition ());
+      if (target == m_index)
+        {
+          // down link to the station
+          gateway = Ipv4Address (m_utNetwork.Get () + numSatellites + destIndex + 1);
+          interface = m_utInterface;
+          return m_utInterface >= 0;
+        }
+    }
+
+  if (target == m_index || m_islInterface < 0)
+    {
+      return false;
+    }
+
+  uint32_t next = GetNextHop (m_index, target);
+  NS_LOG_LOGIC ("Satellite " << m_index << " forwards to " << next << " towards " << target);
+  gateway = Ipv4Address (m_islNetwork.Get () + next + 1);
+  interface = m_islInterface;
+  return true;
+}
+
+Ptr<Ipv4Route>
+LeoGridRouting::MakeRoute (Ipv4Address dest, Ipv4Address gateway, uint32_t interface) const
+{
+  Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+  rtentry->SetDestination (dest);
+  rtentry->SetGateway (gateway);
+  rtentry->SetSource (m_ipv4->GetAddress (interface, 0).GetLocal ());
+  rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interface));
+  return rtentry;
+}
+
+Ptr<Ipv4Route>
+LeoGridRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
+                             Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
+{
+  NS_LOG_FUNCTION (this << header << oif);
+
+  Ipv4Address dest = header.GetDestination ();
+  Ipv4Address gateway;
+  uint32_t interface;
+
+  if (dest.IsMulticast () || dest.IsBroadcast () || !Lookup (dest, gateway, interface))
+    {
+      NS_LOG_LOGIC ("No route to " << dest);
+      sockerr = Socket::ERROR_NOROUTETOHOST;
+      return 0;
+    }
+
+  if (oif && m_ipv4->GetNetDevice (interface) != oif)
+    {
+      NS_LOG_LOGIC ("Route to " << dest << " does not use the requested device");
+      sockerr = Socket::ERROR_NOROUTETOHOST;
+      return 0;
+    }
+
+  sockerr = Socket::ERROR_NOTERROR;
+  return MakeRoute (dest, gateway, interface);
+}
+
+bool
+LeoGridRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
+                            Ptr<const NetDevice> idev, UnicastForwardCallback ucb,
+                            MulticastForwardCallback mcb, LocalDeliverCallback lcb,
+                            ErrorCallback ecb)
+{
+  NS_LOG_FUNCTION (this << p << header << idev);
+
+  NS_ASSERT (m_ipv4->GetInterfaceForDevice (idev) >= 0);
+  uint32_t iif = m_ipv4->GetInterfaceForDevice (idev);
+  Ipv4Address dest = header.GetDestination ();
+
+  if (m_ipv4->IsDestinationAddress (dest, iif))
+    {
+      if (!lcb.IsNull ())
+        {
+          NS_LOG_LOGIC ("Local delivery to " << dest);
+          lcb (p, header, iif);
+          return true;
+        }
+      return false;
+    }
+
+  if (dest.IsMulticast () || dest.IsBroadcast ())
+    {
+      return false;
+    }
+
+  if (m_ipv4->IsForwarding (iif) == false)
+    {
+      NS_LOG_LOGIC ("Forwarding disabled for this interface");
+      ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+      return true;
+    }
+
+  Ipv4Address gateway;
+  uint32_t interface;
+  if (!Lookup (dest, gateway, interface))
+    {
+      NS_LOG_LOGIC ("No route to " << dest);
+      return false;
+    }
+
+  ucb (MakeRoute (dest, gateway, interface), p, header);
+  return true;
+}
+
+void
+LeoGridRouting::FindInterfaces (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_islInterface = -1;
+  m_utInterface = -1;
+  for (uint32_t i = 0; i < m_ipv4->GetNInterfaces (); i++)
+    {
+      for (uint32_t j = 0; j < m_ipv4->GetNAddresses (i); j++)
+        {
+          Ipv4Address local = m_ipv4->GetAddress (i, j).GetLocal ();
+          if (local.CombineMask (m_islMask) == m_islNetwork)
+            {
+              m_islInterface = i;
+            }
+          else if (local.CombineMask (m_utMask) == m_utNetwork)
+            {
+              m_utInterface = i;
+            }
+        }
+    }
+
+  m_type = UNKNOWN;
+  Ptr<Node> node = m_ipv4->GetObject<Node> ();
+  if (!node)
+    {
+      return;
+    }
+  uint32_t id = node->GetId ();
+  if (id >= m_firstSatellite && id - m_firstSatellite < (uint32_t) m_numOrbits * m_numSatellites)
+    {
+      m_type = SATELLITE;
+      m_index = id - m_firstSatellite;
+    }
+  else if (id >= m_firstStation && id - m_firstStation < m_numStations)
+    {
+      m_type = STATION;
+      m_index = id - m_firstStation;
+    }
+}
+
+void
+LeoGridRouting::NotifyInterfaceUp (uint32_t interface)
+{
+  FindInterfaces ();
+}
+
+void
+LeoGridRouting::NotifyInterfaceDown (uint32_t interface)
+{
+  FindInterfaces ();
+}
+
+void
+LeoGridRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+  FindInterfaces ();
+}
+
+void
+LeoGridRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+  FindInterfaces ();
+}
+
+void
+LeoGridRouting::SetIpv4 (Ptr<Ipv4> ipv4)
+{
+  NS_LOG_FUNCTION (this << ipv4);
+  NS_ASSERT (ipv4 != 0);
+  NS_ASSERT (m_ipv4 == 0);
+
+  m_ipv4 = ipv4;
+  FindInterfaces ();
+}
+
+void
+LeoGridRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
+{
+  std::ostream* os = stream->GetStream ();
+  std::ios oldState (nullptr);
+  oldState.copyfmt (*os);
+
+  *os << "Node: " << m_ipv4->GetObject<Node> ()->GetId ()
+      << ", Time: " << Now ().As (unit)
+      << ", Local time: " << m_ipv4->GetObject<Node> ()->GetLocalTime ().As (unit)
+      << ", LeoGridRouting" << std::endl;
+
+  switch (m_type)
+    {
+    case SATELLITE:
+      *os << "Satellite " << m_index
+          << " (plane " << m_index / m_numSatellites
+          << ", slot " << m_index % m_numSatellites << ")";
+      break;
+    case STATION:
+      *os << "Ground station " << m_index;
+      break;
+    default:
+      *os << "Not part of the constellation";
+      break;
+    }
+  *os << ", ISL interface: " << m_islInterface
+      << ", ground interface: " << m_utInterface << std::endl;
+  *os << "Routes are computed on demand from the " << m_numOrbits << "x" << m_numSatellites
+      << " +Grid" << (m_crossSeam ? "" : " without cross-seam links") << std::endl << std::endl;
+
+  (*os).copyfmt (oldState);
+}
+
+}; /* namespace ns3 */
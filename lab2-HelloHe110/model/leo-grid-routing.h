@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_GRID_ROUTING_H
+#define LEO_GRID_ROUTING_H
+
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4.h"
+#include "ns3/vector.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of LeoGridRouting
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Stateless +Grid routing for constellations built by
+ * LeoOrbitNodeHelper
+ *
+ * Satellite k of an orbit is placed in plane k / NumSatellites at slot
+ * k % NumSatellites, and on a +Grid ISL topology every satellite is linked to
+ * the two neighbors in its plane and the satellites with the same slot in the
+ * neighboring planes. The minimum-hop next hop is then a modular function of
+ * the (plane, slot) pairs of the current and the destination satellite, so
+ * no path tables or graph searches are needed.
+ *
+ * Destination nodes are identified by address arithmetic: satellite k has
+ * address IslNetwork + k + 1 on the ISL channel and UtNetwork + k + 1 on the
+ * ground channel, ground station g has UtNetwork + NumOrbits * NumSatellites +
+ * g + 1. This is what Ipv4AddressHelper assigns to the containers returned by
+ * IslHelper::Install and LeoChannelHelper::Install. Traffic to a ground
+ * station leaves the constellation at the satellite closest to it, which is
+ * found from the positions of one satellite per plane.
+ *
+ * The only per-node state are the indices of the node and of its ISL and
+ * ground interfaces.
+ */
+class LeoGridRouting : public Ipv4RoutingProtocol
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// constructor
+  LeoGridRouting ();
+  /// destructor
+  virtual ~LeoGridRouting ();
+
+  // Inherited from Ipv4RoutingProtocol
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header,
+                                      Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+  virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header,
+                           Ptr<const NetDevice> idev, UnicastForwardCallback ucb,
+                           MulticastForwardCallback mcb, LocalDeliverCallback lcb,
+                           ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+
+  /**
+   * \brief Get the next satellite on a minimum-hop +Grid path
+   * \param from index of the current satellite
+   * \param to index of the destination satellite
+   * \return index of the neighbor to forward to, or from if from == to
+   */
+  uint32_t GetNextHop (uint32_t from, uint32_t to) const;
+
+  /**
+   * \brief Get the length of a minimum-hop +Grid path
+   * \param from index of the source satellite
+   * \param to index of the destination satellite
+   * \return number of ISL hops
+   */
+  uint32_t GetHopCount (uint32_t from, uint32_t to) const;
+
+  /**
+   * \brief Find the satellite closest to a position
+   *
+   * For every plane the slot closest to the projection of the position onto
+   * the orbital plane is computed, so the cost is linear in the number of
+   * planes only.
+   *
+   * \param position position in cartesian coordinates
+   * \return index of the closest satellite
+   */
+  uint32_t GetNearestSatellite (const Vector &position) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Role of an address in the constellation
+  enum AddressType
+  {
+    SATELLITE,
+    STATION,
+    UNKNOWN
+  };
+
+  /**
+   * \brief Map an address to a satellite or ground station index
+   * \param [in] address the address
+   * \param [out] index the index of the satellite or station
+   * \return the role of the node holding the address
+   */
+  AddressType Classify (Ipv4Address address, uint32_t &index) const;
+
+  /**
+   * \brief Find the next hop towards a destination
+   * \param [in] dest destination address
+   * \param [out] gateway address of the next hop
+   * \param [out] interface the output interface
+   * \return true if a route exists
+   */
+  bool Lookup (Ipv4Address dest, Ipv4Address &gateway, uint32_t &interface) const;
+
+  /**
+   * \brief Build a route
+   * \param dest destination address
+   * \param gateway next hop address
+   * \param interface output interface
+   * \return the route
+   */
+  Ptr<Ipv4Route> MakeRoute (Ipv4Address dest, Ipv4Address gateway, uint32_t interface) const;
+
+  /**
+   * \brief Find the interfaces on the ISL and ground networks
+   */
+  void FindInterfaces (void);
+
+  /// Number of orbital planes
+  uint16_t m_numOrbits;
+  /// Number of satellites per plane
+  uint16_t m_numSatellites;
+  /// Node id of the first satellite
+  uint32_t m_firstSatellite;
+  /// Node id of the first ground station
+  uint32_t m_firstStation;
+  /// Number of ground stations
+  uint32_t m_numStations;
+  /// Whether ISLs exist between the last and the first plane
+  bool m_crossSeam;
+  /// Network of the ISL channel
+  Ipv4Address m_islNetwork;
+  /// Mask of the ISL channel
+  Ipv4Mask m_islMask;
+  /// Network of the ground channel
+  Ipv4Address m_utNetwork;
+  /// Mask of the ground channel
+  Ipv4Mask m_utMask;
+
+  /// IP stack of this node
+  Ptr<Ipv4> m_ipv4;
+  /// Index of this node in the constellation
+  uint32_t m_index;
+  /// Role of this node
+  AddressType m_type;
+  /// Interface on the ISL channel
+  int32_t m_islInterface;
+  /// Interface on the ground channel
+  int32_t m_utInterface;
+};
+
+};
+
+#endif /* LEO_GRID_ROUTING_H */
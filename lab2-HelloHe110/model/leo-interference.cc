@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <algorithm>
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+#include "leo-interference.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoInterference");
+
+LeoInterference::LeoInterference ()
+  : m_power (0.0),
+    m_base (0)
+{
+}
+
+void
+LeoInterference::Add (Time start, Time end, double power)
+{
+  NS_LOG_FUNCTION (this << start << end << power);
+  NS_ASSERT_MSG (start >= m_base, "Signal arrives in the past");
+
+  m_changes[start] += power;
+  m_changes[end] -= power;
+  m_pending.insert (start);
+}
+
+double
+LeoInterference::GetAveragePower (Time start, Time end) const
+{
+  NS_ASSERT_MSG (start >= m_base, "Signal has already been released");
+
+  // total power at the arrival of the first bit
+  double power = m_power;
+  std::map<Time, double>::const_iterator it = m_changes.begin ();
+  for (; it != m_changes.end () && it->first <= start; ++it)
+    {
+      power += it->second;
+    }
+  if (end <= start)
+    {
+      return std::max (0.0, power);
+    }
+
+  // energy until the arrival of the last bit
+  double energy = 0.0;
+  Time t = start;
+  for (; it != m_changes.end () && it->first < end; ++it)
+    {
+      energy += power * (it->first - t).GetSeconds ();
+      power += it->second;
+      t = it->first;
+    }
+  energy += power * (end - t).GetSeconds ();
+  return std::max (0.0, energy / (end - start).GetSeconds ());
+}
+
+void
+LeoInterference::Release (Time start, Time now)
+{
+  NS_LOG_FUNCTION (this << start << now);
+
+  std::multiset<Time>::iterator pending = m_pending.find (start);
+  if (pending != m_pending.end ())
+    {
+      m_pending.erase (pending);
+    }
+
+  Time base = m_pending.empty () ? now : std::min (now, *m_pending.begin ());
+  std::map<Time, double>::iterator it = m_changes.begin ();
+  for (; it != m_changes.end () && it->first < base; ++it)
+    {
+      m_power += it->second;
+    }
+  m_changes.erase (m_changes.begin (), it);
+  m_base = std::max (m_base, base);
+  if (m_changes.empty ())
+    {
+      // no signal left, drop the rounding errors of the sum
+      m_power = 0.0;
+    }
+}
+
+std::size_t
+LeoInterference::GetNChanges (void) const
+{
+  return m_changes.size ();
+}
+
+};
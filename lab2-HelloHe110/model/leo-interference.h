@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_INTERFERENCE_H
+#define LEO_INTERFERENCE_H
+
+#include <map>
+#include <set>
+
+#include "ns3/nstime.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of LeoInterference
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief The signals arriving at a receiver over time
+ *
+ * Every signal adds its power when its first bit arrives and removes it
+ * after its last bit, both kept as changes of the total power. The total
+ * power before the oldest reception that has not been evaluated yet is
+ * folded into a single sum, so only the changes during the receptions in
+ * progress are kept.
+ */
+class LeoInterference
+{
+public:
+  /// constructor
+  LeoInterference ();
+
+  /**
+   * \brief Add a signal
+   * \param start arrival of the first bit, not before now
+   * \param end arrival of the last bit
+   * \param power power at the receiver in W
+   */
+  void Add (Time start, Time end, double power);
+
+  /**
+   * \brief Get the average total power of all signals
+   * \param start begin of the interval, the start of a signal that has not
+   * been released yet
+   * \param end end of the interval
+   * \return the power in W, including the signal received in the interval
+   */
+  double GetAveragePower (Time start, Time end) const;
+
+  /**
+   * \brief Release a signal once its reception has been evaluated
+   * \param start arrival of the first bit of the signal
+   * \param now the current time
+   */
+  void Release (Time start, Time now);
+
+  /**
+   * \brief Get the number of changes of the total power that are kept
+   * \return number of changes
+   */
+  std::size_t GetNChanges (void) const;
+
+private:
+  /// Total power before m_base in W
+  double m_power;
+  /// Time up to which the changes have been folded into m_power
+  Time m_base;
+  /// Changes of the total power in W at or after m_base
+  std::map<Time, double> m_changes;
+  /// Arrivals of the signals that have not been released yet
+  std::multiset<Time> m_pending;
+};
+
+};
+
+#endif /* LEO_INTERFERENCE_H */
@@ -95,16 +95,15 @@ LeoMockChannel::TransmitStart (Ptr<const Packet> p,
       return false;
     }
 
-  // make sure to return false if packet has been delivered to *no* device
-  bool result = false;
+  std::vector<Ptr<MockNetDevice> > devices;
+  devices.reserve (dests->size ());
   for (DeviceIndex::iterator it = dests->begin (); it != dests->end(); it ++)
     {
-      if (Deliver (p, srcDev, it->second, txTime))
-      	{
-      	  result = true;
-      	}
+      devices.push_back (it->second);
     }
-  return result;
+
+  // make sure to return false if packet has been delivered to *no* device
+  return DeliverAll (p, srcDev, devices, txTime);
 }
 
 int32_t
@@ -21,6 +21,7 @@
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 
 #include "leo-propagation-loss-model.h"
 
@@ -58,6 +59,17 @@ LeoPropagationLossModel::GetTypeId (void)
                    DoubleValue (0.0),
                    MakeDoubleAccessor (&LeoPropagationLossModel::m_linkMargin),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("Beamforming",
+                   "Derive the path loss from the distance and the gain of the best beam of a LeoArrayGain instead of using FreeSpacePathLoss",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LeoPropagationLossModel::SetBeamforming,
+                                        &LeoPropagationLossModel::GetBeamforming),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Frequency",
+                   "Carrier frequency in Hz, used with Beamforming",
+                   DoubleValue (24e9),
+                   MakeDoubleAccessor (&LeoPropagationLossModel::m_frequency),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
@@ -77,10 +89,10 @@ LeoPropagationLossModel::SetElevationAngle (double angle)
 }
 
 double
-LeoPropagationLossModel::GetCutoffDistance (const Ptr<MobilityModel> sat) const
+LeoPropagationLossModel::GetCutoffDistance (const Vector &sat) const
 {
   double angle = m_elevationAngle;
-  double hs = sat->GetPosition ().GetLength ();
+  double hs = sat.GetLength ();
 
   double a = 1 + tan (angle) * tan (angle);
   double b = 2.0 * tan (angle) * hs;
@@ -116,12 +128,18 @@ LeoPropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                         Ptr<MobilityModel> a,
                                         Ptr<MobilityModel> b) const
 {
-  Ptr<MobilityModel> sat = a->GetPosition ().GetLength () > b->GetPosition ().GetLength () ? a : b;
-  double distance = a->GetDistanceFrom (b);
+  return CalcRxPowerAt (txPowerDbm, a->GetPosition (), b->GetPosition ());
+}
+
+double
+LeoPropagationLossModel::CalcRxPowerAt (double txPowerDbm, const Vector &a, const Vector &b) const
+{
+  const Vector &sat = a.GetLength () > b.GetLength () ? a : b;
+  double distance = CalculateDistance (a, b);
   double cutOff = GetCutoffDistance (sat);
   if (distance > cutOff)
     {
-      NS_LOG_DEBUG ("LEO DROP distance: a=" << a->GetPosition () << " b=" << b->GetPosition ()<<" dist=" << distance<<" cutoff="<<cutOff);
+      NS_LOG_DEBUG ("LEO DROP distance: a=" << a << " b=" << b <<" dist=" << distance<<" cutoff="<<cutOff);
 
       return -1000.0;
     }
@@ -129,25 +147,56 @@ LeoPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   // txPowerDbm includes tx antenna gain and losses
   // receiver loss and gain added at net device
   // P_{RX} = P_{TX} + G_{TX} - L_{TX} - L_{FS} - L_M + G_{RX} - L_{RX}
-  // Read precalculated pathloss from file
-  double pathLoss = 0.0;
-  {
-    std::ifstream inFile("/home/user/ns-3.35/contrib/leo/examples/pathloss.txt");
-    if (inFile.is_open()) {
-      inFile >> pathLoss;
-      inFile.close();
-      // std::cout << "debug: pathLoss: " << pathLoss << std::endl;
-    } else {
-      NS_LOG_WARN ("Could not open pathloss.txt file");
-    }
-  }
-  double rxc = txPowerDbm - m_atmosphericLoss - pathLoss - m_linkMargin;
-  // double rxc = txPowerDbm - m_atmosphericLoss - m_freeSpacePathLoss - m_linkMargin;
-  NS_LOG_DEBUG ("LEO TRANSMIT distance: a=" << a->GetPosition () << " b=" << b->GetPosition ()<<" dist=" << distance <<" cutoff="<<cutOff<< "rxc=" << rxc);
+  double rxc = txPowerDbm - m_atmosphericLoss - GetPathLoss (a, b) - m_linkMargin;
+  NS_LOG_DEBUG ("LEO TRANSMIT distance: a=" << a << " b=" << b <<" dist=" << distance <<" cutoff="<<cutOff<< "rxc=" << rxc);
 
   return rxc;
 }
 
+double
+LeoPropagationLossModel::GetPathLoss (const Vector &a, const Vector &b) const
+{
+  if (!m_arrayGain)
+    {
+      return m_freeSpacePathLoss;
+    }
+  // Friis with the gain of the transmit array and a single receive antenna
+  double distance = CalculateDistance (a, b);
+  double fspl = 20 * log10 (4 * M_PI * distance * m_frequency / LEO_SPEED_OF_LIGHT);
+  return fspl - 10 * log10 (m_arrayGain->GetLinkGain (a, b));
+}
+
+void
+LeoPropagationLossModel::SetBeamforming (bool enabled)
+{
+  if (!enabled)
+    {
+      m_arrayGain = 0;
+    }
+  else if (!m_arrayGain)
+    {
+      m_arrayGain = CreateObject<LeoArrayGain> ();
+    }
+}
+
+bool
+LeoPropagationLossModel::GetBeamforming (void) const
+{
+  return m_arrayGain != 0;
+}
+
+void
+LeoPropagationLossModel::SetArrayGain (Ptr<LeoArrayGain> arrayGain)
+{
+  m_arrayGain = arrayGain;
+}
+
+Ptr<LeoArrayGain>
+LeoPropagationLossModel::GetArrayGain (void) const
+{
+  return m_arrayGain;
+}
+
 int64_t
 LeoPropagationLossModel::DoAssignStreams (int64_t stream)
 {
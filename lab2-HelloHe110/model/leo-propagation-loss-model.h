@@ -23,8 +23,11 @@
 #include <ns3/propagation-loss-model.h>
 #include <fstream>
 
+#include "leo-array-gain.h"
+
 #define LEO_PROP_EARTH_RAD 6.37101e6
 #define LEO_SPEED_OF_LIGHT_IN_AIR 299702458
+#define LEO_SPEED_OF_LIGHT 299792458
 
 /**
  * \file
@@ -38,6 +41,10 @@ namespace ns3 {
  * \ingroup leo
  * \brief Propagation loss model for transmissions between satellites and
  * gateways
+ *
+ * By default the path loss is the constant FreeSpacePathLoss. With
+ * Beamforming it follows the distance of the link and the gain of the best
+ * beam of the transmit array towards the receiver, see LeoArrayGain.
  */
 class LeoPropagationLossModel : public PropagationLossModel
 {
@@ -63,6 +70,40 @@ public:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
 
+  /**
+   * \brief Calculate the Rx Power between two positions
+   *
+   * Only reads the attributes of the model, so it may be called from
+   * several threads at once.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a position of the source
+   * \param b position of the destination
+   * \returns the reception power after adding/multiplying propagation loss (in dBm)
+   */
+  double CalcRxPowerAt (double txPowerDbm, const Vector &a, const Vector &b) const;
+
+  /**
+   * \brief Get the path loss between two positions, including the gain of
+   * the transmit array
+   * \param a position of the source
+   * \param b position of the destination
+   * \returns the path loss in dB
+   */
+  double GetPathLoss (const Vector &a, const Vector &b) const;
+
+  /**
+   * \brief Set the transmit array, enables beamforming
+   * \param arrayGain the array, 0 to use FreeSpacePathLoss
+   */
+  void SetArrayGain (Ptr<LeoArrayGain> arrayGain);
+
+  /**
+   * \brief Get the transmit array
+   * \return the array, 0 if beamforming is disabled
+   */
+  Ptr<LeoArrayGain> GetArrayGain (void) const;
+
 private:
 
   /**
@@ -85,6 +126,16 @@ private:
    */
   double m_linkMargin;
 
+  /**
+   * Carrier frequency
+   */
+  double m_frequency;
+
+  /**
+   * Transmit array, if beamforming is enabled
+   */
+  Ptr<LeoArrayGain> m_arrayGain;
+
   virtual int64_t DoAssignStreams (int64_t stream);
 
   /**
@@ -99,12 +150,24 @@ private:
    */
   double GetElevationAngle () const;
 
+  /**
+   * \brief Enable or disable beamforming
+   * \param enabled whether to use a LeoArrayGain
+   */
+  void SetBeamforming (bool enabled);
+
+  /**
+   * \brief Check whether beamforming is enabled
+   * \return true if a LeoArrayGain is used
+   */
+  bool GetBeamforming (void) const;
+
   /**
    * \brief Get the maximum communication distance for satellite
-   * \param sat satellite
+   * \param sat position of the satellite
    * \return distance
    */
-  double GetCutoffDistance (const Ptr<MobilityModel> sat) const;
+  double GetCutoffDistance (const Vector &sat) const;
 };
 
 }
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <math.h>
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/packet.h"
+
+#include "leo-sinr-error-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoSinrErrorModel");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoSinrTag);
+
+TypeId
+LeoSinrTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSinrTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<LeoSinrTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+LeoSinrTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+LeoSinrTag::LeoSinrTag ()
+  : m_sinr (0.0)
+{
+}
+
+LeoSinrTag::LeoSinrTag (double sinr)
+  : m_sinr (sinr)
+{
+}
+
+uint32_t
+LeoSinrTag::GetSerializedSize (void) const
+{
+  return sizeof (double);
+}
+
+void
+LeoSinrTag::Serialize (TagBuffer i) const
+{
+  i.WriteDouble (m_sinr);
+}
+
+void
+LeoSinrTag::Deserialize (TagBuffer i)
+{
+  m_sinr = i.ReadDouble ();
+}
+
+void
+LeoSinrTag::Print (std::ostream &os) const
+{
+  os << "sinr=" << m_sinr << "dB";
+}
+
+double
+LeoSinrTag::GetSinr (void) const
+{
+  return m_sinr;
+}
+
+void
+LeoSinrTag::SetSinr (double sinr)
+{
+  m_sinr = sinr;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (LeoSinrErrorModel);
+
+TypeId
+LeoSinrErrorModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoSinrErrorModel")
+    .SetParent<ErrorModel> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<LeoSinrErrorModel> ()
+    .AddAttribute ("MinSinr",
+                   "SINR in dB below which packets are always corrupt",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&LeoSinrErrorModel::m_minSinr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("BitErrors",
+                   "Apply the bit error rate of uncoded BPSK above MinSinr",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LeoSinrErrorModel::m_bitErrors),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RanVar",
+                   "The decision variable attached to this error model.",
+                   StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=1.0]"),
+                   MakePointerAccessor (&LeoSinrErrorModel::m_ranvar),
+                   MakePointerChecker<RandomVariableStream> ())
+  ;
+  return tid;
+}
+
+LeoSinrErrorModel::LeoSinrErrorModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoSinrErrorModel::~LeoSinrErrorModel ()
+{
+}
+
+double
+LeoSinrErrorModel::GetPacketErrorRate (double sinr, uint32_t size) const
+{
+  if (sinr < m_minSinr)
+    {
+      return 1.0;
+    }
+  if (!m_bitErrors)
+    {
+      return 0.0;
+    }
+  double ber = 0.5 * erfc (sqrt (pow (10.0, sinr / 10.0)));
+  return 1.0 - pow (1.0 - ber, 8.0 * size);
+}
+
+int64_t
+LeoSinrErrorModel::AssignStreams (int64_t stream)
+{
+  m_ranvar->SetStream (stream);
+  return 1;
+}
+
+bool
+LeoSinrErrorModel::DoCorrupt (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  LeoSinrTag tag;
+  if (!p->PeekPacketTag (tag))
+    {
+      return false;
+    }
+
+  double per = GetPacketErrorRate (tag.GetSinr (), p->GetSize ());
+  if (per >= 1.0)
+    {
+      return true;
+    }
+  return per > 0.0 && m_ranvar->GetValue () < per;
+}
+
+void
+LeoSinrErrorModel::DoReset (void)
+{
+}
+
+};
@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_SINR_ERROR_MODEL_H
+#define LEO_SINR_ERROR_MODEL_H
+
+#include "ns3/tag.h"
+#include "ns3/error-model.h"
+#include "ns3/random-variable-stream.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of LeoSinrTag and LeoSinrErrorModel
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief The SINR a packet has been received with
+ *
+ * Added by MockChannel to the packets it hands to a receiver when it tracks
+ * interference.
+ */
+class LeoSinrTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  /// constructor
+  LeoSinrTag ();
+  /**
+   * \brief constructor
+   * \param sinr SINR in dB
+   */
+  LeoSinrTag (double sinr);
+
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+  /**
+   * \brief Get the SINR
+   * \return SINR in dB
+   */
+  double GetSinr (void) const;
+
+  /**
+   * \brief Set the SINR
+   * \param sinr SINR in dB
+   */
+  void SetSinr (double sinr);
+
+private:
+  /// SINR in dB
+  double m_sinr;
+};
+
+/**
+ * \ingroup leo
+ * \brief Drops packets depending on the SINR they have been received with
+ *
+ * Packets below MinSinr are always corrupt. Above it, the packet error rate
+ * of uncoded BPSK at the SINR of the packet is applied if BitErrors is set.
+ * Packets without a LeoSinrTag are never corrupt.
+ */
+class LeoSinrErrorModel : public ErrorModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// constructor
+  LeoSinrErrorModel ();
+  /// destructor
+  virtual ~LeoSinrErrorModel ();
+
+  /**
+   * \brief Get the packet error rate
+   * \param sinr SINR in dB
+   * \param size size of the packet in bytes
+   * \return probability that the packet is corrupt
+   */
+  double GetPacketErrorRate (double sinr, uint32_t size) const;
+
+  /**
+   * \brief Assign a fixed random variable stream number
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned
+   */
+  int64_t AssignStreams (int64_t stream);
+
+private:
+  virtual bool DoCorrupt (Ptr<Packet> p);
+  virtual void DoReset (void);
+
+  /// Minimum SINR in dB
+  double m_minSinr;
+  /// Whether bit errors are applied above the minimum SINR
+  bool m_bitErrors;
+  /// Decides about bit errors
+  Ptr<RandomVariableStream> m_ranvar;
+};
+
+};
+
+#endif /* LEO_SINR_ERROR_MODEL_H */
@@ -0,0 +1,409 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/mobility-model.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-static-routing-helper.h"
+
+#include "isl-mock-channel.h"
+#include "leo-mock-channel.h"
+#include "leo-contact-plan.h"
+#include "leo-static-route-manager.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeoStaticRouteManager");
+
+NS_OBJECT_ENSURE_REGISTERED (LeoStaticRouteManager);
+
+const uint32_t LeoStaticRouteManager::NONE = std::numeric_limits<uint32_t>::max ();
+
+TypeId
+LeoStaticRouteManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LeoStaticRouteManager")
+    .SetParent<Object> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<LeoStaticRouteManager> ()
+    .AddAttribute ("Interval",
+                   "How often the links are re-evaluated, 0 to compute the routes only once",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&LeoStaticRouteManager::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("OnChangeOnly",
+                   "Recompute the routes only if a link came up or went down",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&LeoStaticRouteManager::m_onChangeOnly),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ElevationAngle",
+                   "Minimum elevation of a satellite seen from a ground station in degrees",
+                   DoubleValue (40.0),
+                   MakeDoubleAccessor (&LeoStaticRouteManager::m_elevationAngle),
+                   MakeDoubleChecker<double> (0.0, 90.0))
+    .AddAttribute ("IslRange",
+                   "Maximum length of an inter-satellite link in m, 0 for no limit",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&LeoStaticRouteManager::m_islRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Metric",
+                   "Metric of the installed routes",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&LeoStaticRouteManager::m_metric),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+LeoStaticRouteManager::LeoStaticRouteManager ()
+  : m_numSatellites (0),
+    m_changes (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LeoStaticRouteManager::~LeoStaticRouteManager ()
+{
+}
+
+void
+LeoStaticRouteManager::DoDispose (void)
+{
+  m_event.Cancel ();
+  m_nodes.clear ();
+  m_utDevice.clear ();
+  m_islDevice.clear ();
+  m_forwarders.clear ();
+  Object::DoDispose ();
+}
+
+void
+LeoStaticRouteManager::SetNodes (const NodeContainer &satellites, const NodeContainer &stations)
+{
+  NS_LOG_FUNCTION (this << satellites.GetN () << stations.GetN ());
+
+  m_nodes.clear ();
+  m_nodes.insert (m_nodes.end (), satellites.Begin (), satellites.End ());
+  m_numSatellites = m_nodes.size ();
+  m_nodes.insert (m_nodes.end (), stations.Begin (), stations.End ());
+
+  m_links.clear ();
+  m_nextHop.assign (m_nodes.size (), std::vector<uint32_t> (stations.GetN (), NONE));
+}
+
+void
+LeoStaticRouteManager::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // the interfaces are known once the addresses are assigned
+  m_utDevice.assign (m_nodes.size (), 0);
+  m_islDevice.assign (m_nodes.size (), 0);
+  m_utInterface.assign (m_nodes.size (), -1);
+  m_islInterface.assign (m_nodes.size (), -1);
+  m_forwarders.assign (m_nodes.size (), 0);
+  for (uint32_t i = 0; i < m_nodes.size (); i++)
+    {
+      Ptr<Ipv4> ipv4 = m_nodes[i]->GetObject<Ipv4> ();
+      m_forwarders[i] = m_nodes[i]->GetObject<LeoBentPipeForwarder> ();
+      NS_ASSERT_MSG (ipv4 || (m_forwarders[i] && i < m_numSatellites),
+                     "Node " << m_nodes[i]->GetId () << " has neither an IP stack nor a bent pipe");
+      for (uint32_t j = 0; j < m_nodes[i]->GetNDevices (); j++)
+        {
+          Ptr<MockNetDevice> device = DynamicCast<MockNetDevice> (m_nodes[i]->GetDevice (j));
+          if (!device || !device->GetChannel ())
+            {
+              continue;
+            }
+          int32_t interface = -1;
+          if (!m_forwarders[i])
+            {
+              interface = ipv4->GetInterfaceForDevice (device);
+              if (interface < 0 || ipv4->GetNAddresses (interface) == 0)
+                {
+                  continue;
+                }
+            }
+          if (DynamicCast<LeoMockChannel> (device->GetChannel ()))
+            {
+              m_utDevice[i] = device;
+              m_utInterface[i] = interface;
+            }
+          else if (DynamicCast<IslMockChannel> (device->GetChannel ()))
+            {
+              m_islDevice[i] = device;
+              m_islInterface[i] = interface;
+            }
+        }
+    }
+
+  m_event.Cancel ();
+  m_links.clear ();
+  Update ();
+}
+
+void
+LeoStaticRouteManager::Update (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<std::vector<uint32_t> > links = FindLinks ();
+  if (!m_onChangeOnly || links != m_links)
+    {
+      m_links = links;
+      ComputeRoutes ();
+    }
+
+  if (m_interval > Time (0))
+    {
+      m_event = Simulator::Schedule (m_interval, &LeoStaticRouteManager::Update, this);
+    }
+}
+
+std::vector<std::vector<uint32_t> >
+LeoStaticRouteManager::FindLinks (void) const
+{
+  std::vector<Vector> positions;
+  for (const Ptr<Node> &node : m_nodes)
+    {
+      Ptr<MobilityModel> mobility = node->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility, "Node " << node->GetId () << " has no mobility model");
+      positions.push_back (mobility->GetPosition ());
+    }
+
+  std::vector<std::vector<uint32_t> > links (m_nodes.size ());
+  for (uint32_t i = 0; i < m_numSatellites; i++)
+    {
+      for (uint32_t j = i + 1; j < m_nodes.size (); j++)
+        {
+          bool visible;
+          if (j < m_numSatellites)
+            {
+              visible = m_islDevice[i] && m_islDevice[j]
+                && LeoContactPlan::IsVisible (positions[i], positions[j], true, m_elevationAngle, m_islRange);
+            }
+          else
+            {
+              visible = m_utDevice[i] && m_utDevice[j]
+                && LeoContactPlan::IsVisible (positions[j], positions[i], false, m_elevationAngle, m_islRange);
+            }
+          if (visible)
+            {
+              links[i].push_back (j);
+              links[j].push_back (i);
+            }
+        }
+    }
+  return links;
+}
+
+void
+LeoStaticRouteManager::ComputeRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<Vector> positions;
+  for (const Ptr<Node> &node : m_nodes)
+    {
+      positions.push_back (node->GetObject<MobilityModel> ()->GetPosition ());
+    }
+
+  // links are symmetric, so the shortest path tree grown from a station
+  // gives the next hop of every node towards it
+  uint32_t numNodes = m_nodes.size ();
+  std::vector<double> distance (numNodes);
+  std::vector<uint32_t> parent (numNodes);
+  typedef std::pair<double, uint32_t> Entry;
+  for (uint32_t station = m_numSatellites; station < numNodes; station++)
+    {
+      distance.assign (numNodes, std::numeric_limits<double>::infinity ());
+      parent.assign (numNodes, NONE);
+      std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+      distance[station] = 0;
+      queue.push (Entry (0, station));
+      while (!queue.empty ())
+        {
+          Entry entry = queue.top ();
+          queue.pop ();
+          uint32_t node = entry.second;
+          if (entry.first > distance[node])
+            {
+              continue;
+            }
+          // other ground stations do not relay
+          if (node >= m_numSatellites && node != station)
+            {
+              continue;
+            }
+          for (uint32_t next : m_links[node])
+            {
+              double d = entry.first + CalculateDistance (positions[node], positions[next]);
+              if (d < distance[next])
+                {
+                  distance[next] = d;
+                  parent[next] = node;
+                  queue.push (Entry (d, next));
+                }
+            }
+        }
+
+      for (uint32_t node = 0; node < numNodes; node++)
+        {
+          if (node != station)
+            {
+              SetRoute (node, station, parent[node]);
+            }
+        }
+    }
+}
+
+void
+LeoStaticRouteManager::SetRoute (uint32_t node, uint32_t station, uint32_t next)
+{
+  uint32_t &installed = m_nextHop[node][station - m_numSatellites];
+  if (installed == next)
+    {
+      return;
+    }
+  uint32_t previous = installed;
+  installed = next;
+  m_changes++;
+
+  NS_LOG_LOGIC ("Node " << m_nodes[node]->GetId () << " reaches " << m_nodes[station]->GetId ()
+                << " via " << (next == NONE ? "nothing" : std::to_string (m_nodes[next]->GetId ())));
+
+  // ground station links are on the ground channel, all others on the ISL
+  bool ground = node >= m_numSatellites || next >= m_numSatellites;
+  Mac48Address stationAddress = Mac48Address::ConvertFrom (m_utDevice[station]->GetAddress ());
+
+  // transparent satellites forward the frames for the ground station device
+  Ptr<LeoBentPipeForwarder> forwarder = m_forwarders[node];
+  if (forwarder)
+    {
+      if (next == NONE)
+        {
+          forwarder->RemoveRoute (stationAddress);
+          return;
+        }
+      Ptr<MockNetDevice> nextDevice = ground ? m_utDevice[next] : m_islDevice[next];
+      forwarder->AddRoute (stationAddress, ground ? m_utDevice[node] : m_islDevice[node],
+                           Mac48Address::ConvertFrom (nextDevice->GetAddress ()));
+      return;
+    }
+
+  // ground stations reach each other on-link through a transparent
+  // satellite, which only has to know where to pick up their frames
+  bool previousPipe = previous != NONE && m_forwarders[previous];
+  bool nextPipe = next != NONE && m_forwarders[next];
+  if (previousPipe || nextPipe)
+    {
+      Mac48Address source = Mac48Address::ConvertFrom (m_utDevice[node]->GetAddress ());
+      if (previousPipe)
+        {
+          m_forwarders[previous]->RemoveUplink (source, stationAddress);
+        }
+      if (nextPipe)
+        {
+          m_forwarders[next]->AddUplink (source, stationAddress);
+        }
+      return;
+    }
+
+  Ipv4StaticRoutingHelper helper;
+  Ptr<Ipv4> ipv4 = m_nodes[node]->GetObject<Ipv4> ();
+  Ptr<Ipv4StaticRouting> routing = helper.GetStaticRouting (ipv4);
+  NS_ASSERT_MSG (routing, "Node " << m_nodes[node]->GetId () << " has no static routing");
+
+  Ptr<Ipv4> stationIpv4 = m_nodes[station]->GetObject<Ipv4> ();
+  int32_t stationInterface = m_utInterface[station];
+  std::vector<Ipv4Address> addresses;
+  for (uint32_t i = 0; i < stationIpv4->GetNAddresses (stationInterface); i++)
+    {
+      addresses.push_back (stationIpv4->GetAddress (stationInterface, i).GetLocal ());
+    }
+
+  if (previous != NONE)
+    {
+      for (uint32_t i = routing->GetNRoutes (); i-- > 0; )
+        {
+          Ipv4RoutingTableEntry route = routing->GetRoute (i);
+          if (route.IsHost () && routing->GetMetric (i) == m_metric
+              && std::find (addresses.begin (), addresses.end (), route.GetDest ()) != addresses.end ())
+            {
+              routing->RemoveRoute (i);
+            }
+        }
+    }
+
+  if (next == NONE)
+    {
+      return;
+    }
+
+  int32_t interface = ground ? m_utInterface[node] : m_islInterface[node];
+  int32_t nextInterface = ground ? m_utInterface[next] : m_islInterface[next];
+  Ptr<Ipv4> nextIpv4 = m_nodes[next]->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (nextIpv4, "Node " << m_nodes[next]->GetId () << " has no IP stack");
+  Ipv4Address gateway = nextIpv4->GetAddress (nextInterface, 0).GetLocal ();
+  for (const Ipv4Address &address : addresses)
+    {
+      routing->AddHostRouteTo (address, gateway, interface, m_metric);
+    }
+}
+
+uint32_t
+LeoStaticRouteManager::GetNextHop (uint32_t node, uint32_t station) const
+{
+  uint32_t from = m_nodes.size ();
+  uint32_t to = m_nodes.size ();
+  for (uint32_t i = 0; i < m_nodes.size (); i++)
+    {
+      if (m_nodes[i]->GetId () == node)
+        {
+          from = i;
+        }
+      if (m_nodes[i]->GetId () == station)
+        {
+          to = i;
+        }
+    }
+  if (from == m_nodes.size () || to < m_numSatellites || to == m_nodes.size ()
+      || m_nextHop[from][to - m_numSatellites] == NONE)
+    {
+      return node;
+    }
+  return m_nodes[m_nextHop[from][to - m_numSatellites]]->GetId ();
+}
+
+uint64_t
+LeoStaticRouteManager::GetNChanges (void) const
+{
+  return m_changes;
+}
+
+};
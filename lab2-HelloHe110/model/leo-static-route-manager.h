@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef LEO_STATIC_ROUTE_MANAGER_H
+#define LEO_STATIC_ROUTE_MANAGER_H
+
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/node-container.h"
+
+#include "mock-net-device.h"
+#include "leo-bent-pipe-forwarder.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of LeoStaticRouteManager
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Computes routes to the ground stations from the geometry of the
+ * constellation and installs them into Ipv4StaticRouting
+ *
+ * The links are the ground station to satellite pairs above the elevation
+ * angle and the satellite pairs with line of sight on the ISL channel. Every
+ * node gets a host route to every ground station address along the shortest
+ * path by distance. The links are re-evaluated every Interval and only the
+ * routes whose next hop changed are replaced, so there is no control traffic
+ * at all.
+ *
+ * Satellites with a LeoBentPipeForwarder instead of an IP stack get layer 2
+ * routes to the ground station devices, and the ground stations reach each
+ * other on-link through them.
+ */
+class LeoStaticRouteManager : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// constructor
+  LeoStaticRouteManager ();
+  /// destructor
+  virtual ~LeoStaticRouteManager ();
+
+  /**
+   * \brief Set the nodes to route between
+   * \param satellites the satellites
+   * \param stations the ground stations, which are the destinations
+   */
+  void SetNodes (const NodeContainer &satellites, const NodeContainer &stations);
+
+  /**
+   * \brief Install the routes and keep them up to date
+   */
+  void Start (void);
+
+  /**
+   * \brief Re-evaluate the links and update the routes if needed
+   */
+  void Update (void);
+
+  /**
+   * \brief Get the next hop of a node towards a ground station
+   * \param node node id
+   * \param station node id of the ground station
+   * \return node id of the next hop, or node if there is no route
+   */
+  uint32_t GetNextHop (uint32_t node, uint32_t station) const;
+
+  /**
+   * \brief Get the number of route changes installed so far
+   * \return the number of changed host routes
+   */
+  uint64_t GetNChanges (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Find the links between the nodes at the current time
+   * \return neighbors of each node, by local index
+   */
+  std::vector<std::vector<uint32_t> > FindLinks (void) const;
+
+  /**
+   * \brief Compute the shortest paths to every station and replace the
+   * routes that changed
+   */
+  void ComputeRoutes (void);
+
+  /**
+   * \brief Replace the routes of a node towards a station
+   * \param node local index of the node
+   * \param station local index of the station
+   * \param next local index of the new next hop, NONE for no route
+   */
+  void SetRoute (uint32_t node, uint32_t station, uint32_t next);
+
+  /// Marker for a missing next hop
+  static const uint32_t NONE;
+
+  /// How often the links are re-evaluated
+  Time m_interval;
+  /// Whether routes are recomputed only if the links changed
+  bool m_onChangeOnly;
+  /// Minimum elevation of a satellite above a ground station in degrees
+  double m_elevationAngle;
+  /// Maximum length of an inter-satellite link in m
+  double m_islRange;
+  /// Metric of the installed routes, to tell them apart from others
+  uint32_t m_metric;
+
+  /// Satellites followed by ground stations
+  std::vector<Ptr<Node> > m_nodes;
+  /// Number of satellites at the front of m_nodes
+  uint32_t m_numSatellites;
+  /// Device on the ground channel, if any
+  std::vector<Ptr<MockNetDevice> > m_utDevice;
+  /// Device on the ISL channel, if any
+  std::vector<Ptr<MockNetDevice> > m_islDevice;
+  /// Index of the interface on the ground channel, -1 if none
+  std::vector<int32_t> m_utInterface;
+  /// Index of the interface on the ISL channel, -1 if none
+  std::vector<int32_t> m_islInterface;
+  /// Layer 2 forwarder of transparent satellites
+  std::vector<Ptr<LeoBentPipeForwarder> > m_forwarders;
+  /// Links found by the last update
+  std::vector<std::vector<uint32_t> > m_links;
+  /// Installed next hop of each node towards each station
+  std::vector<std::vector<uint32_t> > m_nextHop;
+  /// Number of changed host routes
+  uint64_t m_changes;
+  /// Next update
+  EventId m_event;
+};
+
+};
+
+#endif /* LEO_STATIC_ROUTE_MANAGER_H */
@@ -16,18 +16,173 @@
  * Author: Tim Schubert <ns-3-leo@timschubert.net>
  */
 
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 #include <ns3/trace-source-accessor.h>
 #include <ns3/packet.h>
 #include <ns3/simulator.h>
 #include <ns3/log.h>
 #include <ns3/pointer.h>
 #include <ns3/enum.h>
+#include <ns3/uinteger.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#ifdef NS3_MPI
+#include <ns3/mpi-interface.h>
+#include "mock-mpi-header.h"
+#endif
+#include "leo-propagation-loss-model.h"
+#include "isl-propagation-loss-model.h"
+#include "leo-sinr-error-model.h"
 #include "mock-channel.h"
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("MockChannel");
 
+namespace {
+
+/**
+ * \brief Threads that compute the receptions of a transmission
+ *
+ * The threads are started on first use and shared by all channels. They
+ * only run while the simulator thread waits for them in Run, which it takes
+ * part in.
+ */
+class MockChannelWorkers
+{
+public:
+  MockChannelWorkers ()
+    : m_job (0), m_n (0), m_next (0), m_active (0), m_busy (0), m_generation (0), m_stop (false)
+  {
+  }
+
+  ~MockChannelWorkers ()
+  {
+    {
+      std::unique_lock<std::mutex> lock (m_mutex);
+      m_stop = true;
+    }
+    m_start.notify_all ();
+    for (std::thread &thread : m_threads)
+      {
+        thread.join ();
+      }
+  }
+
+  /**
+   * \brief Run a job for all indices and wait until it is done
+   * \param threads number of threads including the calling one
+   * \param n number of indices
+   * \param job the job, must not touch reference counted objects
+   */
+  void Run (uint32_t threads, std::size_t n, const std::function<void (std::size_t)> &job)
+  {
+    {
+      std::unique_lock<std::mutex> lock (m_mutex);
+      while (m_threads.size () + 1 < threads)
+        {
+          uint32_t index = m_threads.size ();
+          m_threads.push_back (std::thread (&MockChannelWorkers::Work, this, index));
+        }
+      m_job = &job;
+      m_n = n;
+      m_next = 0;
+      m_active = threads - 1;
+      m_busy = m_active;
+      m_generation++;
+    }
+    m_start.notify_all ();
+    Drain ();
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_done.wait (lock, [this] { return m_busy == 0; });
+    m_job = 0;
+  }
+
+private:
+  /// Number of indices a thread takes at once
+  static constexpr std::size_t CHUNK = 16;
+
+  /// Take indices of the current job until there are none left
+  void Drain (void)
+  {
+    for (;;)
+      {
+        std::size_t begin = m_next.fetch_add (CHUNK);
+        if (begin >= m_n)
+          {
+            return;
+          }
+        std::size_t end = std::min (begin + CHUNK, m_n);
+        for (std::size_t i = begin; i < end; i++)
+          {
+            (*m_job) (i);
+          }
+      }
+  }
+
+  /**
+   * \brief Main loop of a worker
+   * \param index index of the worker
+   */
+  void Work (uint32_t index)
+  {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock (m_mutex);
+    for (;;)
+      {
+        m_start.wait (lock, [this, seen] { return m_stop || m_generation != seen; });
+        if (m_stop)
+          {
+            return;
+          }
+        seen = m_generation;
+        if (index >= m_active)
+          {
+            continue;
+          }
+        lock.unlock ();
+        Drain ();
+        lock.lock ();
+        if (--m_busy == 0)
+          {
+            m_done.notify_one ();
+          }
+      }
+  }
+
+  /// Worker threads
+  std::vector<std::thread> m_threads;
+  /// Protects everything but m_next
+  std::mutex m_mutex;
+  /// Signals a new job or the shutdown
+  std::condition_variable m_start;
+  /// Signals that all workers are done with the job
+  std::condition_variable m_done;
+  /// Current job
+  const std::function<void (std::size_t)> *m_job;
+  /// Number of indices of the current job
+  std::size_t m_n;
+  /// Next index to take
+  std::atomic<std::size_t> m_next;
+  /// Number of workers taking part in the current job
+  uint32_t m_active;
+  /// Number of workers that are not done with the current job
+  uint32_t m_busy;
+  /// Number of jobs so far
+  uint64_t m_generation;
+  /// Whether the workers shall exit
+  bool m_stop;
+};
+
+} // anonymous namespace
+
 NS_OBJECT_ENSURE_REGISTERED (MockChannel);
 
 TypeId
@@ -46,6 +201,29 @@ MockChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&MockChannel::m_propagationLoss),
                    MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("Threads",
+                   "Number of threads to compute the receptions of a transmission "
+                   "with, 0 for one per core, 1 to compute them on the simulator thread",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&MockChannel::m_threads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("ParallelThreshold",
+                   "Minimum number of receivers of a transmission to compute "
+                   "the receptions in parallel",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&MockChannel::m_parallelThreshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Interference",
+                   "Compute the SINR of every reception from the signals "
+                   "arriving at the receiver at the same time",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MockChannel::m_interference),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NoisePower",
+                   "Noise power at the receivers in dBm",
+                   DoubleValue (-110.0),
+                   MakeDoubleAccessor (&MockChannel::m_noisePower),
+                   MakeDoubleChecker<double> ())
     .AddTraceSource ("TxRxMockChannel",
                      "Trace source indicating transmission of packet "
                      "from the MockChannel, used by the Animation "
@@ -59,7 +237,8 @@ MockChannel::GetTypeId (void)
 //
 // By default, you get a channel that
 // has an "infitely" fast transmission speed and zero processing delay.
-MockChannel::MockChannel() : Channel (), m_link (0)
+MockChannel::MockChannel() : Channel (), m_link (0), m_threads (1), m_parallelThreshold (64),
+  m_interference (false), m_noisePower (-110.0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -194,17 +373,188 @@ MockChannel::Deliver (
       NS_LOG_DEBUG ("delay = "<<delay);
     }
 
-  Simulator::ScheduleWithContext (dst->GetNode ()->GetId (),
-        			  delay,
-        			  &MockNetDevice::Receive,
-        			  dst,
-        			  p->Copy (),
-        			  src,
-        			  rxPower);
+  ScheduleReceive (p, src, dst, rxPower, delay, txTime);
+  return true;
+}
+
+void
+MockChannel::ScheduleReceive (Ptr<const Packet> p,
+                              Ptr<MockNetDevice> src,
+                              Ptr<MockNetDevice> dst,
+                              double rxPower,
+                              Time delay,
+                              Time txTime)
+{
+#ifdef NS3_MPI
+  if (MpiInterface::IsEnabled ()
+      && dst->GetNode ()->GetSystemId () != MpiInterface::GetSystemId ())
+    {
+      // the receiver is simulated by another rank, which needs to know who
+      // sent the frame and how strong it arrives
+      Ptr<Packet> copy = p->Copy ();
+      MockMpiHeader header;
+      header.SetSender (src->GetNode ()->GetId (), src->GetIfIndex ());
+      header.SetRxPower (rxPower);
+      copy->AddHeader (header);
+      MpiInterface::SendPacket (copy, Simulator::Now () + delay,
+                                dst->GetNode ()->GetId (), dst->GetIfIndex ());
+    }
+  else
+#endif
+  if (m_interference)
+    {
+      Time start = Simulator::Now () + delay - txTime;
+      m_signals[dst].Add (start, Simulator::Now () + delay, pow (10.0, rxPower / 10.0) / 1000.0);
+      Simulator::ScheduleWithContext (dst->GetNode ()->GetId (),
+                                      delay,
+                                      &MockChannel::EndReceive,
+                                      this,
+                                      dst,
+                                      p->Copy (),
+                                      src,
+                                      rxPower,
+                                      start);
+    }
+  else
+    {
+      Simulator::ScheduleWithContext (dst->GetNode ()->GetId (),
+                                      delay,
+                                      &MockNetDevice::Receive,
+                                      dst,
+                                      p->Copy (),
+                                      src,
+                                      rxPower);
+    }
 
   // Call the tx anim callback on the net device
   m_txrxMock (p, src, dst, txTime, delay);
-  return true;
+}
+
+void
+MockChannel::EndReceive (Ptr<MockNetDevice> dst,
+                         Ptr<Packet> p,
+                         Ptr<MockNetDevice> src,
+                         double rxPower,
+                         Time start)
+{
+  NS_LOG_FUNCTION (this << dst << p << src << rxPower << start);
+
+  LeoInterference &signals = m_signals[dst];
+  double signal = pow (10.0, rxPower / 10.0) / 1000.0;
+  double noise = pow (10.0, m_noisePower / 10.0) / 1000.0;
+  double interference = 0.0;
+  if (start < Simulator::Now ())
+    {
+      interference = std::max (0.0, signals.GetAveragePower (start, Simulator::Now ()) - signal);
+    }
+  signals.Release (start, Simulator::Now ());
+
+  double sinr = 10.0 * log10 (signal / (noise + interference));
+  NS_LOG_DEBUG ("sinr = " << sinr << " interference = " << interference);
+  LeoSinrTag tag (sinr);
+  p->ReplacePacketTag (tag);
+  dst->Receive (p, src, rxPower);
+}
+
+uint32_t
+MockChannel::GetNThreads (void) const
+{
+  if (m_threads == 0)
+    {
+      return std::max (1u, std::thread::hardware_concurrency ());
+    }
+  return m_threads;
+}
+
+bool
+MockChannel::DeliverAll (Ptr<const Packet> p,
+                         Ptr<MockNetDevice> src,
+                         const std::vector<Ptr<MockNetDevice> > &dsts,
+                         Time txTime)
+{
+  NS_LOG_FUNCTION (this << p << src->GetAddress () << dsts.size () << txTime);
+
+  uint32_t threads = GetNThreads ();
+  bool parallel = threads > 1 && dsts.size () >= m_parallelThreshold;
+
+  // the workers only get plain positions and models that compute the loss
+  // from them, everything else is left to Deliver
+  Ptr<PropagationLossModel> pLoss = GetPropagationLoss ();
+  const LeoPropagationLossModel *leoLoss = PeekPointer (DynamicCast<LeoPropagationLossModel> (pLoss));
+  const IslPropagationLossModel *islLoss = PeekPointer (DynamicCast<IslPropagationLossModel> (pLoss));
+  if (pLoss != 0 && ((leoLoss == 0 && islLoss == 0) || pLoss->GetNext () != 0))
+    {
+      parallel = false;
+    }
+  Ptr<ConstantSpeedPropagationDelayModel> pDelay = DynamicCast<ConstantSpeedPropagationDelayModel> (GetPropagationDelay ());
+  if (GetPropagationDelay () != 0 && pDelay == 0)
+    {
+      parallel = false;
+    }
+
+  std::vector<Vector> positions;
+  Ptr<MobilityModel> srcMob = src->GetNode ()->GetObject<MobilityModel> ();
+  if (parallel && srcMob != 0)
+    {
+      positions.reserve (dsts.size ());
+      for (Ptr<MockNetDevice> dst : dsts)
+        {
+          Ptr<MobilityModel> dstMob = dst->GetNode ()->GetObject<MobilityModel> ();
+          if (dstMob == 0)
+            {
+              break;
+            }
+          positions.push_back (dstMob->GetPosition ());
+        }
+    }
+
+  bool result = false;
+  if (!parallel || positions.size () != dsts.size ())
+    {
+      for (Ptr<MockNetDevice> dst : dsts)
+        {
+          if (Deliver (p, src, dst, txTime))
+            {
+              result = true;
+            }
+        }
+      return result;
+    }
+
+  double txPower = src->GetTxPower ();
+  double speed = pDelay != 0 ? pDelay->GetSpeed () : 0.0;
+  Vector srcPos = srcMob->GetPosition ();
+  std::vector<double> rxPower (dsts.size (), txPower);
+  std::vector<double> seconds (dsts.size (), 0.0);
+  std::function<void (std::size_t)> job = [&] (std::size_t i)
+    {
+      if (leoLoss != 0)
+        {
+          rxPower[i] = leoLoss->CalcRxPowerAt (txPower, srcPos, positions[i]);
+        }
+      else if (islLoss != 0)
+        {
+          rxPower[i] = islLoss->CalcRxPowerAt (txPower, srcPos, positions[i]);
+        }
+      if (speed > 0)
+        {
+          seconds[i] = CalculateDistance (srcPos, positions[i]) / speed;
+        }
+    };
+  static MockChannelWorkers workers;
+  workers.Run (threads, dsts.size (), job);
+
+  for (std::size_t i = 0; i < dsts.size (); i++)
+    {
+      if (pLoss != 0 && rxPower[i] < -120.0)
+        {
+          NS_LOG_WARN (this << "unable to reach destination " << dsts[i]->GetNode ()->GetId () << " from " << src->GetNode ()->GetId ());
+          continue;
+        }
+      ScheduleReceive (p, src, dsts[i], rxPower[i], txTime + Seconds (seconds[i]), txTime);
+      result = true;
+    }
+  return result;
 }
 
 void
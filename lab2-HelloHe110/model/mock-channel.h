@@ -19,7 +19,9 @@
 #ifndef MOCK_CHANNEL_H
 #define MOCK_CHANNEL_H
 
+#include <map>
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 #include "ns3/object.h"
@@ -33,6 +35,7 @@
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "mock-net-device.h"
+#include "leo-interference.h"
 
 /**
  * \file
@@ -47,6 +50,14 @@ class MockNetDevice;
 /**
  * \ingroup leo
  * \brief Base class for LeoMockChannel and IslMockChannel
+ *
+ * With Interference enabled, the channel keeps track of the signals arriving
+ * at each receiver. Every signal only interferes at the receivers the
+ * propagation loss model lets it reach, i.e. inside the visibility cell of
+ * its transmitter. When the last bit of a packet has arrived, its SINR
+ * averaged over its duration is attached as LeoSinrTag, which
+ * LeoSinrErrorModel turns into packet losses. Receivers on other MPI ranks
+ * do not see any interference.
  */
 class MockChannel : public Channel
 {
@@ -154,7 +165,55 @@ protected:
    */
   bool Deliver ( Ptr<const Packet> p, Ptr<MockNetDevice> src, Ptr<MockNetDevice> dst, Time txTime);
 
+  /**
+   * \brief Deliver a packet to several destinations
+   *
+   * If there are at least ParallelThreshold destinations and more than one
+   * thread is configured, the reception power and the propagation delay of
+   * all destinations are computed on worker threads. The receptions are
+   * scheduled afterwards on the simulator thread in the order of the
+   * destinations, so the result is the same as calling Deliver for each of
+   * them.
+   *
+   * \param p packet
+   * \param src source of a packet
+   * \param dsts destinations of the packet
+   * \param txTime transmission time of the packet
+   * \return true iff the packet has been delivered to at least one destination
+   */
+  bool DeliverAll (Ptr<const Packet> p, Ptr<MockNetDevice> src,
+                   const std::vector<Ptr<MockNetDevice> > &dsts, Time txTime);
+
 private:
+  /**
+   * \brief Schedule the reception of a packet at a destination
+   * \param p packet
+   * \param src source of a packet
+   * \param dst destination of a packet
+   * \param rxPower reception power at the destination
+   * \param delay time until the last bit has been received
+   * \param txTime transmission time of the packet
+   */
+  void ScheduleReceive (Ptr<const Packet> p, Ptr<MockNetDevice> src, Ptr<MockNetDevice> dst,
+                        double rxPower, Time delay, Time txTime);
+
+  /**
+   * \brief Hand a packet to its destination with the SINR it has been
+   * received with
+   * \param dst destination of the packet
+   * \param p packet
+   * \param src source of the packet
+   * \param rxPower reception power at the destination in dBm
+   * \param start arrival of the first bit
+   */
+  void EndReceive (Ptr<MockNetDevice> dst, Ptr<Packet> p, Ptr<MockNetDevice> src,
+                   double rxPower, Time start);
+
+  /**
+   * \brief Get the number of threads to compute receptions with
+   * \return number of threads, including the simulator thread
+   */
+  uint32_t GetNThreads (void) const;
 
   /// All devices that are attached to the channel
   std::vector<Ptr<MockNetDevice> > m_link;
@@ -165,6 +224,21 @@ private:
   /// Propagation loss model to be used with this channel
   Ptr<PropagationLossModel> m_propagationLoss;
 
+  /// Number of threads to compute receptions with, 0 for one per core
+  uint32_t m_threads;
+
+  /// Minimum number of destinations to compute receptions in parallel
+  uint32_t m_parallelThreshold;
+
+  /// Whether the SINR of the receptions is computed
+  bool m_interference;
+
+  /// Noise power at the receivers in dBm
+  double m_noisePower;
+
+  /// Signals arriving at each receiver
+  std::map<Ptr<MockNetDevice>, LeoInterference> m_signals;
+
 }; // class MockChannel
 
 } // namespace ns3
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <cstring>
+
+#include "ns3/log.h"
+
+#include "mock-mpi-header.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MockMpiHeader");
+
+NS_OBJECT_ENSURE_REGISTERED (MockMpiHeader);
+
+TypeId
+MockMpiHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MockMpiHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Leo")
+    .AddConstructor<MockMpiHeader> ()
+  ;
+  return tid;
+}
+
+MockMpiHeader::MockMpiHeader ()
+  : m_node (0),
+    m_device (0),
+    m_rxPower (0.0)
+{
+}
+
+MockMpiHeader::~MockMpiHeader ()
+{
+}
+
+TypeId
+MockMpiHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+MockMpiHeader::SetSender (uint32_t node, uint32_t device)
+{
+  m_node = node;
+  m_device = device;
+}
+
+uint32_t
+MockMpiHeader::GetNode (void) const
+{
+  return m_node;
+}
+
+uint32_t
+MockMpiHeader::GetDevice (void) const
+{
+  return m_device;
+}
+
+void
+MockMpiHeader::SetRxPower (double rxPower)
+{
+  m_rxPower = rxPower;
+}
+
+double
+MockMpiHeader::GetRxPower (void) const
+{
+  return m_rxPower;
+}
+
+void
+MockMpiHeader::Print (std::ostream &os) const
+{
+  os << "node=" << m_node << " device=" << m_device << " rxPower=" << m_rxPower;
+}
+
+uint32_t
+MockMpiHeader::GetSerializedSize (void) const
+{
+  return 16;
+}
+
+void
+MockMpiHeader::Serialize (Buffer::Iterator start) const
+{
+  // the bits of the double are passed on unchanged, so that the remote rank
+  // works with exactly the power a local receiver would have seen
+  uint64_t power;
+  std::memcpy (&power, &m_rxPower, sizeof (power));
+  start.WriteHtonU32 (m_node);
+  start.WriteHtonU32 (m_device);
+  start.WriteHtonU64 (power);
+}
+
+uint32_t
+MockMpiHeader::Deserialize (Buffer::Iterator start)
+{
+  m_node = start.ReadNtohU32 ();
+  m_device = start.ReadNtohU32 ();
+  uint64_t power = start.ReadNtohU64 ();
+  std::memcpy (&m_rxPower, &power, sizeof (power));
+  return GetSerializedSize ();
+}
+
+};
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#ifndef MOCK_MPI_HEADER_H
+#define MOCK_MPI_HEADER_H
+
+#include "ns3/header.h"
+
+/**
+ * \file
+ * \ingroup leo
+ * Declaration of MockMpiHeader
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup leo
+ * \brief Describes a frame that crosses to another MPI rank
+ *
+ * The receiving rank needs the sending device and the power the frame
+ * arrives with, which are passed to MockNetDevice::Receive locally. The
+ * header is removed again before the frame is received.
+ */
+class MockMpiHeader : public Header
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /// constructor
+  MockMpiHeader ();
+  /// destructor
+  virtual ~MockMpiHeader ();
+
+  /**
+   * \brief Set the sending device
+   * \param node node id of the sender
+   * \param device index of the device on the node
+   */
+  void SetSender (uint32_t node, uint32_t device);
+
+  /**
+   * \brief Get the node id of the sender
+   * \return the node id
+   */
+  uint32_t GetNode (void) const;
+
+  /**
+   * \brief Get the index of the sending device on its node
+   * \return the device index
+   */
+  uint32_t GetDevice (void) const;
+
+  /**
+   * \brief Set the receive power
+   * \param rxPower receive power in dBm
+   */
+  void SetRxPower (double rxPower);
+
+  /**
+   * \brief Get the receive power
+   * \return receive power in dBm
+   */
+  double GetRxPower (void) const;
+
+  // Inherited from Header
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  /// Node id of the sender
+  uint32_t m_node;
+  /// Index of the sending device
+  uint32_t m_device;
+  /// Receive power in dBm
+  double m_rxPower;
+};
+
+};
+
+#endif /* MOCK_MPI_HEADER_H */
@@ -29,6 +29,12 @@
 #include "ns3/ethernet-header.h"
 #include "ns3/ethernet-trailer.h"
 #include "ns3/double.h"
+#include "ns3/node-list.h"
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#include "mock-mpi-header.h"
+#endif
 #include "mock-channel.h"
 #include "mock-net-device.h"
 
@@ -294,7 +300,9 @@ MockNetDevice::DoDispose ()
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
   m_queue = 0;
+  m_queueDest.clear ();
   m_queueInterface = 0;
+  m_forwardCallback = MakeNullCallback<void, Ptr<MockNetDevice>, Ptr<Packet>, const EthernetHeader &> ();
   NetDevice::DoDispose ();
 }
 
@@ -305,6 +313,12 @@ MockNetDevice::SetDataRate (DataRate bps)
   m_bps = bps;
 }
 
+DataRate
+MockNetDevice::GetDataRate (void) const
+{
+  return m_bps;
+}
+
 void
 MockNetDevice::SetInterframeGap (Time t)
 {
@@ -374,10 +388,14 @@ MockNetDevice::TransmitComplete (const Address &dest)
 
   //
   // Got another packet off of the queue, so start the transmit process again.
+  // It goes wherever it was sent to, which need not be the destination of the
+  // last one.
   //
+  Address next = m_queueDest.front ();
+  m_queueDest.pop_front ();
   m_snifferTrace (p);
   m_promiscSnifferTrace (p);
-  TransmitStart (p, dest);
+  TransmitStart (p, next);
 }
 
 bool
@@ -389,6 +407,16 @@ MockNetDevice::Attach (Ptr<MockChannel> ch)
 
   m_channelDevId = m_channel->Attach (this);
 
+#ifdef NS3_MPI
+  // frames from other ranks arrive through the MPI interface
+  if (MpiInterface::IsEnabled () && !GetObject<MpiReceiver> ())
+    {
+      Ptr<MpiReceiver> receiver = CreateObject<MpiReceiver> ();
+      receiver->SetReceiveCallback (MakeCallback (&MockNetDevice::DoMpiReceive, this));
+      AggregateObject (receiver);
+    }
+#endif
+
   //
   // This device is up whenever it is attached to a channel.  A better plan
   // would be to have the link come up when both devices are attached, but this
@@ -453,6 +481,22 @@ MockNetDevice::Receive (Ptr<Packet> packet,
       return;
     }
 
+  //
+  // Frames for other devices are relayed as they are, which takes a single
+  // lookup in the forwarder.
+  //
+  if (!m_forwardCallback.IsNull ())
+    {
+      EthernetHeader header;
+      packet->PeekHeader (header);
+      Mac48Address destination = header.GetDestination ();
+      if (destination != m_address && !destination.IsGroup ())
+        {
+          m_forwardCallback (this, packet, header);
+          return;
+        }
+    }
+
   //
   // Trace sinks will expect complete packets, not packets without some of the
   // headers.
@@ -682,6 +726,20 @@ MockNetDevice::Send (Ptr<Packet> packet,
   Mac48Address source = Mac48Address::ConvertFrom (m_address);
   AddHeader (packet, source, destination, protocolNumber);
 
+  return SendFrame (packet, dest);
+}
+
+bool
+MockNetDevice::SendFrame (Ptr<Packet> packet, const Address &dest)
+{
+  NS_LOG_FUNCTION (this << packet << dest);
+
+  if (IsLinkUp () == false)
+    {
+      m_macTxDropTrace (packet);
+      return false;
+    }
+
   m_macTxTrace (packet);
 
   //
@@ -689,15 +747,19 @@ MockNetDevice::Send (Ptr<Packet> packet,
   //
   if (m_queue->Enqueue (packet))
     {
+      m_queueDest.push_back (dest);
+
       //
       // If the channel is ready for transition we send the packet right now
       //
       if (m_txMachineState == READY)
         {
           packet = m_queue->Dequeue ();
+          Address next = m_queueDest.front ();
+          m_queueDest.pop_front ();
           m_promiscSnifferTrace (packet);
           m_snifferTrace (packet);
-          TransmitStart (packet, dest);
+          TransmitStart (packet, next);
         }
       else
       	{
@@ -755,6 +817,12 @@ MockNetDevice::SetPromiscReceiveCallback (NetDevice::PromiscReceiveCallback cb)
   m_promiscCallback = cb;
 }
 
+void
+MockNetDevice::SetForwardCallback (MockNetDevice::ForwardCallback cb)
+{
+  m_forwardCallback = cb;
+}
+
 bool
 MockNetDevice::SupportsSendFrom (void) const
 {
@@ -762,12 +830,19 @@ MockNetDevice::SupportsSendFrom (void) const
   return false;
 }
 
+#ifdef NS3_MPI
 void
-MockNetDevice::DoMpiReceive (Ptr<Packet> p, Ptr<MockNetDevice> senderDevice, double txPower)
+MockNetDevice::DoMpiReceive (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << p);
-  Receive (p, senderDevice, txPower);
+
+  MockMpiHeader header;
+  p->RemoveHeader (header);
+  Ptr<Node> node = NodeList::GetNode (header.GetNode ());
+  Ptr<MockNetDevice> senderDevice = DynamicCast<MockNetDevice> (node->GetDevice (header.GetDevice ()));
+  Receive (p, senderDevice, header.GetRxPower ());
 }
+#endif
 
 Address
 MockNetDevice::GetRemote (Ptr<MockNetDevice> senderDevice) const
@@ -20,6 +20,7 @@
 #define MOCK_NET_DEVICE_H
 
 #include <cstring>
+#include <deque>
 
 #include "ns3/address.h"
 #include "ns3/node.h"
@@ -32,6 +33,7 @@
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
 #include "ns3/mobility-model.h"
+#include "ns3/ethernet-header.h"
 
 /**
  * \file
@@ -88,6 +90,13 @@ public:
    */
   void SetDataRate (DataRate bps);
 
+  /**
+   * Get the Data Rate used for transmission of packets.
+   *
+   * \return the data rate at which this object operates
+   */
+  DataRate GetDataRate (void) const;
+
   /**
    * Set the interframe gap used to separate packets.  The interframe gap
    * defines the minimum space required between packets sent by this device.
@@ -165,6 +174,34 @@ public:
    */
   void Receive (Ptr<Packet> p, Ptr<MockNetDevice> senderDevice, double rxPower);
 
+  /**
+   * Callback for frames that are addressed to another unicast device
+   *
+   * The frame is passed on as received, including its Ethernet header and
+   * trailer, together with the already parsed header.
+   */
+  typedef Callback<void, Ptr<MockNetDevice>, Ptr<Packet>, const EthernetHeader &> ForwardCallback;
+
+  /**
+   * Forward frames for other devices at layer 2 instead of passing them up
+   *
+   * If set, unicast frames that are not addressed to this device are handed
+   * to the callback right after the physical layer, without being decoded
+   * or passed to the node.
+   *
+   * \param cb the callback, a null callback disables forwarding
+   */
+  void SetForwardCallback (ForwardCallback cb);
+
+  /**
+   * Send a complete frame without adding another header
+   *
+   * \param frame the frame, including Ethernet header and trailer
+   * \param dest address of the device on the channel to send the frame to
+   * \return true if the frame has been queued
+   */
+  bool SendFrame (Ptr<Packet> frame, const Address &dest);
+
   // The remaining methods are documented in ns3::NetDevice*
 
   virtual void SetIfIndex (const uint32_t index);
@@ -211,12 +248,17 @@ public:
   void NotifyLinkDown (void);
 
 protected:
+#ifdef NS3_MPI
   /**
    * \brief Handler for MPI receive event
    *
+   * The packet starts with a MockMpiHeader that identifies the sender and
+   * carries the receive power.
+   *
    * \param p Packet received
    */
-  void DoMpiReceive (Ptr<Packet> p, Ptr<MockNetDevice> sender, double txPower);
+  void DoMpiReceive (Ptr<Packet> p);
+#endif
 
   virtual void DoInitialize (void);
   virtual void NotifyNewAggregate (void);
@@ -501,6 +543,13 @@ private:
   uint32_t m_channelDevId;
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
+
+  /**
+   * Channel destinations of the packets in m_queue, in the same order
+   */
+  std::deque<Address> m_queueDest;
+
+  ForwardCallback m_forwardCallback; //!< Layer 2 forwarding callback
 };
 
 } // namespace ns3
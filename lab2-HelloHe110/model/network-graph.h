@@ -0,0 +1,293 @@
+#ifndef NETWORK_GRAPH_H
+#define NETWORK_GRAPH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Loader for network.graph shared by the Lab 3 optimizers and leo-lab4.
+// The leo module installs it as ns3/network-graph.h, the Lab 3 tools
+// include it through their network_graph.h.
+//
+// The text format is "V S L" followed by L lines "v s rate" with the rate
+// in kbps. It is parsed straight from a memory mapping of the file. The
+// binary format holds the same links in compressed sparse rows grouped by
+// station, in native byte order:
+//
+//   char     magic[4]       "NGRB"
+//   uint32_t version        1
+//   uint32_t V, S
+//   uint64_t L
+//   uint32_t begin[V + 1]   first link of each station
+//   uint32_t sat[L]
+//   double   rate[L]
+//
+// LoadNetworkGraph reads either format, graph_convert.cc converts between
+// them. Within a station the links keep the order of the text file.
+
+struct NetworkGraph {
+  int V = 0, S = 0;
+  std::vector<uint32_t> begin;  // first link of each station, V + 1 entries
+  std::vector<uint32_t> sat;    // satellite of each link
+  std::vector<double> rate;     // rate of each link in kbps
+
+  std::size_t Links() const { return sat.size(); }
+
+  // Rate of the link between station v and satellite s, 0 if there is none
+  double Rate(int v, int s) const {
+    for (uint32_t k = begin[v]; k < begin[v + 1]; ++k) {
+      if ((int)sat[k] == s) return rate[k];
+    }
+    return 0.0;
+  }
+};
+
+namespace network_graph {
+
+const char kMagic[4] = {'N', 'G', 'R', 'B'};
+const uint32_t kVersion = 1;
+
+// Read-only mapping of a whole file
+class MappedFile {
+ public:
+  explicit MappedFile(const char* path) : data_(nullptr), size_(0) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED) {
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+        size_ = st.st_size;
+      }
+    }
+    close(fd);
+  }
+  ~MappedFile() {
+    if (data_) munmap(const_cast<char*>(data_), size_);
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool ok() const { return data_ != nullptr; }
+  const char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  const char* data_;
+  std::size_t size_;
+};
+
+inline void SkipSpace(const char*& p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+}
+
+inline bool ParseUnsigned(const char*& p, const char* end, uint64_t& value) {
+  SkipSpace(p, end);
+  if (p == end || *p < '0' || *p > '9') return false;
+  value = 0;
+  while (p < end && *p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+  return true;
+}
+
+// Decimal number like 38344.399700 or 1e-3. Numbers with at most 19
+// significant digits and a small exponent are converted exactly from an
+// integer mantissa and a power of ten, everything else by strtod.
+inline bool ParseDouble(const char*& p, const char* end, double& value) {
+  static const double kPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  SkipSpace(p, end);
+  const char* start = p;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+  uint64_t mantissa = 0;
+  int digits = 0, exponent = 0;
+  bool any = false;
+  while (p < end && *p >= '0' && *p <= '9') {
+    if (digits < 19) {
+      mantissa = mantissa * 10 + (*p - '0');
+      if (mantissa) ++digits;
+    } else {
+      ++exponent;
+    }
+    ++p;
+    any = true;
+  }
+  if (p < end && *p == '.') {
+    ++p;
+    while (p < end && *p >= '0' && *p <= '9') {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        if (mantissa) ++digits;
+        --exponent;
+      }
+      ++p;
+      any = true;
+    }
+  }
+  if (!any) return false;
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    const char* q = p + 1;
+    bool minus = false;
+    if (q < end && (*q == '-' || *q == '+')) minus = *q++ == '-';
+    if (q < end && *q >= '0' && *q <= '9') {
+      int e = 0;
+      while (q < end && *q >= '0' && *q <= '9') e = std::min(e * 10 + (*q++ - '0'), 100000);
+      exponent += minus ? -e : e;
+      p = q;
+    }
+  }
+  if (mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22) {
+    value = exponent < 0 ? mantissa / kPow10[-exponent] : mantissa * kPow10[exponent];
+  } else {
+    char buffer[128];
+    std::size_t n = std::min<std::size_t>(p - start, sizeof(buffer) - 1);
+    std::memcpy(buffer, start, n);
+    buffer[n] = '\0';
+    value = std::strtod(buffer, nullptr);
+    return true;
+  }
+  if (negative) value = -value;
+  return true;
+}
+
+inline bool Fail(std::string* error, const std::string& message) {
+  if (error) *error = message;
+  return false;
+}
+
+}  // namespace network_graph
+
+// Read the text format. Links past the L of the header are ignored.
+inline bool ReadNetworkGraphText(const char* path, NetworkGraph& g, std::string* error = nullptr) {
+  using namespace network_graph;
+  MappedFile file(path);
+  if (!file.ok()) return Fail(error, std::string("Cannot open ") + path);
+  const char* p = file.data();
+  const char* end = p + file.size();
+
+  uint64_t V, S, L;
+  if (!ParseUnsigned(p, end, V) || !ParseUnsigned(p, end, S) || !ParseUnsigned(p, end, L)) {
+    return Fail(error, std::string("Missing header in ") + path);
+  }
+  std::vector<uint32_t> station, satellite;
+  std::vector<double> rate;
+  station.reserve(L);
+  satellite.reserve(L);
+  rate.reserve(L);
+  for (uint64_t i = 0; i < L; ++i) {
+    uint64_t v, s;
+    double r;
+    if (!ParseUnsigned(p, end, v) || !ParseUnsigned(p, end, s) || !ParseDouble(p, end, r)) break;
+    if (v >= V || s >= S) return Fail(error, "Link " + std::to_string(i) + " out of range");
+    station.push_back(v);
+    satellite.push_back(s);
+    rate.push_back(r);
+  }
+
+  // counting sort by station, stable within a station
+  g.V = V;
+  g.S = S;
+  g.begin.assign(V + 1, 0);
+  for (uint32_t v : station) ++g.begin[v + 1];
+  for (uint64_t v = 0; v < V; ++v) g.begin[v + 1] += g.begin[v];
+  std::vector<uint32_t> next(g.begin.begin(), g.begin.end() - 1);
+  g.sat.resize(station.size());
+  g.rate.resize(station.size());
+  for (std::size_t i = 0; i < station.size(); ++i) {
+    uint32_t k = next[station[i]]++;
+    g.sat[k] = satellite[i];
+    g.rate[k] = rate[i];
+  }
+  return true;
+}
+
+inline bool ReadNetworkGraphBinary(const char* path, NetworkGraph& g, std::string* error = nullptr) {
+  using namespace network_graph;
+  MappedFile file(path);
+  if (!file.ok()) return Fail(error, std::string("Cannot open ") + path);
+  const char* p = file.data();
+  const std::size_t header = 4 + 3 * sizeof(uint32_t) + sizeof(uint64_t);
+  if (file.size() < header || std::memcmp(p, kMagic, 4) != 0) {
+    return Fail(error, std::string("Not a binary graph: ") + path);
+  }
+  uint32_t version, V, S;
+  uint64_t L;
+  std::memcpy(&version, p + 4, sizeof(version));
+  std::memcpy(&V, p + 8, sizeof(V));
+  std::memcpy(&S, p + 12, sizeof(S));
+  std::memcpy(&L, p + 16, sizeof(L));
+  if (version != kVersion) return Fail(error, "Unsupported version " + std::to_string(version));
+  if (file.size() != header + (V + 1) * sizeof(uint32_t) + L * (sizeof(uint32_t) + sizeof(double))) {
+    return Fail(error, std::string("Truncated binary graph: ") + path);
+  }
+  p += header;
+  g.V = V;
+  g.S = S;
+  g.begin.resize(V + 1);
+  g.sat.resize(L);
+  g.rate.resize(L);
+  std::memcpy(g.begin.data(), p, (V + 1) * sizeof(uint32_t));
+  p += (V + 1) * sizeof(uint32_t);
+  std::memcpy(g.sat.data(), p, L * sizeof(uint32_t));
+  p += L * sizeof(uint32_t);
+  std::memcpy(g.rate.data(), p, L * sizeof(double));
+  if (g.begin[V] != L) return Fail(error, std::string("Corrupt binary graph: ") + path);
+  return true;
+}
+
+// Whether a file starts with the magic of the binary format
+inline bool IsNetworkGraphBinary(const char* path) {
+  char magic[4] = {0, 0, 0, 0};
+  FILE* f = std::fopen(path, "rb");
+  if (!f) return false;
+  std::size_t n = std::fread(magic, 1, 4, f);
+  std::fclose(f);
+  return n == 4 && std::memcmp(magic, network_graph::kMagic, 4) == 0;
+}
+
+// Read either format
+inline bool LoadNetworkGraph(const char* path, NetworkGraph& g, std::string* error = nullptr) {
+  if (IsNetworkGraphBinary(path)) return ReadNetworkGraphBinary(path, g, error);
+  return ReadNetworkGraphText(path, g, error);
+}
+
+inline bool WriteNetworkGraphText(const char* path, const NetworkGraph& g) {
+  FILE* f = std::fopen(path, "w");
+  if (!f) return false;
+  std::fprintf(f, "%d %d %zu\n", g.V, g.S, g.Links());
+  for (int v = 0; v < g.V; ++v) {
+    for (uint32_t k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+      std::fprintf(f, "%d %u %.6f\n", v, g.sat[k], g.rate[k]);
+    }
+  }
+  return std::fclose(f) == 0;
+}
+
+inline bool WriteNetworkGraphBinary(const char* path, const NetworkGraph& g) {
+  FILE* f = std::fopen(path, "wb");
+  if (!f) return false;
+  uint32_t version = network_graph::kVersion, V = g.V, S = g.S;
+  uint64_t L = g.Links();
+  std::fwrite(network_graph::kMagic, 1, 4, f);
+  std::fwrite(&version, sizeof(version), 1, f);
+  std::fwrite(&V, sizeof(V), 1, f);
+  std::fwrite(&S, sizeof(S), 1, f);
+  std::fwrite(&L, sizeof(L), 1, f);
+  std::fwrite(g.begin.data(), sizeof(uint32_t), g.begin.size(), f);
+  std::fwrite(g.sat.data(), sizeof(uint32_t), g.sat.size(), f);
+  std::fwrite(g.rate.data(), sizeof(double), g.rate.size(), f);
+  return std::fclose(f) == 0;
+}
+
+#endif  // NETWORK_GRAPH_H
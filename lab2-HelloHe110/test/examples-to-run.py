@@ -11,6 +11,8 @@ cpp_examples = [
     ("leo-orbit", "True", "True"),
     ("leo-delay", "True", "True"),
     ("leo-bulk-send", "True", "True"),
+    ("leo-scheduler-benchmark --duration=0.5", "True", "False"),
+    ("leo-graph-series --duration=10 --format=binary", "True", "False"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
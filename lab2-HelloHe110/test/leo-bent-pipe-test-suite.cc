@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <math.h>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/node-container.h"
+#include "ns3/test.h"
+
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Routes are found by destination address only
+ */
+class LeoBentPipeForwarderTestCase : public TestCase
+{
+public:
+  LeoBentPipeForwarderTestCase () : TestCase ("forwarding table") {}
+  virtual ~LeoBentPipeForwarderTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    Ptr<LeoBentPipeForwarder> forwarder = CreateObject<LeoBentPipeForwarder> ();
+    Ptr<MockNetDevice> device = CreateObject<MockNetDevice> ();
+    Mac48Address dest ("00:00:00:00:01:02");
+    Mac48Address other ("00:00:00:00:02:01");
+    Mac48Address nextHop ("00:00:00:00:00:07");
+
+    forwarder->AddRoute (dest, device, nextHop);
+    NS_TEST_ASSERT_MSG_EQ (forwarder->GetNRoutes (), 1, "route not added");
+
+    Ptr<MockNetDevice> found;
+    Mac48Address foundHop;
+    NS_TEST_ASSERT_MSG_EQ (forwarder->Lookup (dest, found, foundHop), true, "route not found");
+    NS_TEST_ASSERT_MSG_EQ (found, device, "wrong device");
+    NS_TEST_ASSERT_MSG_EQ (foundHop, nextHop, "wrong next hop");
+    NS_TEST_ASSERT_MSG_EQ (forwarder->Lookup (other, found, foundHop), false, "byte order mixed up");
+
+    forwarder->AddRoute (dest, device, other);
+    NS_TEST_ASSERT_MSG_EQ (forwarder->GetNRoutes (), 1, "route should be replaced");
+    forwarder->Lookup (dest, found, foundHop);
+    NS_TEST_ASSERT_MSG_EQ (foundHop, other, "route not replaced");
+
+    forwarder->RemoveRoute (dest);
+    NS_TEST_ASSERT_MSG_EQ (forwarder->Lookup (dest, found, foundHop), false, "route not removed");
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Satellites without IP stack get layer 2 routes from the geometry
+ */
+class LeoBentPipeRoutesTestCase : public TestCase
+{
+public:
+  LeoBentPipeRoutesTestCase () : TestCase ("routes for transparent satellites") {}
+  virtual ~LeoBentPipeRoutesTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    double radius = LEO_EARTH_RAD_KM * 1000;
+    double orbit = radius + 1e6;
+    double angle = 30 * M_PI / 180;
+    NodeContainer satellites (2);
+    NodeContainer stations (2);
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+    positions->Add (Vector (orbit, 0, 0));
+    positions->Add (Vector (orbit * cos (angle), orbit * sin (angle), 0));
+    positions->Add (Vector (radius, 0, 0));
+    positions->Add (Vector (radius * cos (angle), radius * sin (angle), 0));
+    mobility.SetPositionAllocator (positions);
+    mobility.Install (satellites);
+    mobility.Install (stations);
+
+    IslHelper islCh;
+    NetDeviceContainer islNet = islCh.Install (satellites);
+    LeoChannelHelper utCh;
+    NetDeviceContainer utNet = utCh.Install (satellites, stations);
+
+    // only the ground stations get an IP stack
+    InternetStackHelper stack;
+    stack.Install (stations);
+    NetDeviceContainer stationDevices;
+    stationDevices.Add (utNet.Get (2));
+    stationDevices.Add (utNet.Get (3));
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase ("10.1.0.0", "255.255.0.0");
+    ipv4.Assign (stationDevices);
+
+    LeoBentPipeHelper bentPipe;
+    bentPipe.Install (satellites);
+    bentPipe.PopulateArpCache (stations);
+
+    LeoStaticRoutingHelper staticRouting;
+    staticRouting.SetRouteManagerAttribute ("Interval", TimeValue (Seconds (0)));
+    Ptr<LeoStaticRouteManager> manager = staticRouting.Install (satellites, stations);
+    NS_TEST_ASSERT_MSG_EQ (manager->GetNextHop (stations.Get (0)->GetId (), stations.Get (1)->GetId ()),
+                           satellites.Get (0)->GetId (), "should go up to the satellite above");
+
+    Ptr<LeoBentPipeForwarder> above = satellites.Get (0)->GetObject<LeoBentPipeForwarder> ();
+    NS_TEST_ASSERT_MSG_EQ ((above != 0), true, "forwarder not installed");
+    NS_TEST_ASSERT_MSG_EQ (above->GetNRoutes (), 2, "one route to each station");
+
+    Mac48Address dest = Mac48Address::ConvertFrom (stationDevices.Get (1)->GetAddress ());
+    Ptr<MockNetDevice> device;
+    Mac48Address nextHop;
+    NS_TEST_ASSERT_MSG_EQ (above->Lookup (dest, device, nextHop), true, "no route to the far station");
+    NS_TEST_ASSERT_MSG_EQ (device, islNet.Get (0), "should cross the ISL");
+    NS_TEST_ASSERT_MSG_EQ (nextHop, Mac48Address::ConvertFrom (islNet.Get (1)->GetAddress ()), "wrong next satellite");
+
+    Simulator::Destroy ();
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class LeoBentPipeTestSuite : TestSuite
+{
+public:
+  LeoBentPipeTestSuite() : TestSuite ("leo-bent-pipe", UNIT) {
+      AddTestCase (new LeoBentPipeForwarderTestCase, TestCase::QUICK);
+      AddTestCase (new LeoBentPipeRoutesTestCase, TestCase::QUICK);
+  }
+};
+
+static LeoBentPipeTestSuite leoBentPipeTestSuite;
@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/node-container.h"
+#include "ns3/test.h"
+
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Routes wait for later contacts if that arrives earlier
+ */
+class LeoContactPlanRouteTestCase : public TestCase
+{
+public:
+  LeoContactPlanRouteTestCase () : TestCase ("earliest arrival routes") {}
+  virtual ~LeoContactPlanRouteTestCase () {}
+private:
+  void Add (Ptr<LeoContactPlan> plan, uint32_t from, uint32_t to, double start, double end)
+  {
+    LeoContact contact;
+    contact.from = from;
+    contact.to = to;
+    contact.start = Seconds (start);
+    contact.end = Seconds (end);
+    contact.delay = MilliSeconds (1);
+    plan->AddContact (contact);
+  }
+
+  virtual void DoRun (void)
+  {
+    Ptr<LeoContactPlan> plan = CreateObject<LeoContactPlan> ();
+    Add (plan, 0, 1, 0, 10);
+    Add (plan, 1, 2, 20, 30);
+    Add (plan, 0, 2, 100, 110);
+    NS_TEST_ASSERT_MSG_EQ (plan->GetNContacts (), 3, "contacts not added");
+
+    LeoContactRoute route;
+    NS_TEST_ASSERT_MSG_EQ (plan->FindRoute (0, 2, Seconds (5), route), true, "no route found");
+    NS_TEST_ASSERT_MSG_EQ (route.nextHop, 1, "should be stored at the relay");
+    NS_TEST_ASSERT_MSG_EQ (route.hops, 2, "route has two contacts");
+    NS_TEST_ASSERT_MSG_EQ (route.start, Seconds (5), "first contact is up already");
+    NS_TEST_ASSERT_MSG_EQ (route.arrival, Seconds (20) + MilliSeconds (1), "wrong arrival");
+    NS_TEST_ASSERT_MSG_EQ (route.expires, Seconds (10), "route ends with the first contact");
+
+    std::vector<LeoContact> excluded (1, route.limit);
+    NS_TEST_ASSERT_MSG_EQ (plan->FindRoute (0, 2, Seconds (5), route, excluded), true, "no alternative found");
+    NS_TEST_ASSERT_MSG_EQ (route.nextHop, 2, "alternative is the direct contact");
+    NS_TEST_ASSERT_MSG_EQ (route.start, Seconds (100), "alternative waits for the direct contact");
+
+    NS_TEST_ASSERT_MSG_EQ (plan->FindRoute (0, 2, Seconds (15), route), true, "no route after the relay contact");
+    NS_TEST_ASSERT_MSG_EQ (route.nextHop, 2, "relay contact is over");
+    NS_TEST_ASSERT_MSG_EQ (plan->FindRoute (0, 2, Seconds (120), route), false, "plan is over");
+    NS_TEST_ASSERT_MSG_EQ (plan->FindRoute (2, 0, Seconds (0), route), false, "contacts are directed");
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Contacts follow the elevation and the line of sight
+ */
+class LeoContactPlanComputeTestCase : public TestCase
+{
+public:
+  LeoContactPlanComputeTestCase () : TestCase ("contacts from positions") {}
+  virtual ~LeoContactPlanComputeTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    double radius = LEO_EARTH_RAD_KM * 1000;
+    NodeContainer satellites (2);
+    NodeContainer stations (1);
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+    positions->Add (Vector (radius + 1e6, 0, 0));
+    positions->Add (Vector (-radius - 1e6, 0, 0));
+    positions->Add (Vector (radius, 0, 0));
+    mobility.SetPositionAllocator (positions);
+    mobility.Install (satellites);
+    mobility.Install (stations);
+
+    Ptr<LeoContactPlan> plan = CreateObject<LeoContactPlan> ();
+    plan->Compute (satellites, stations, Seconds (0), Seconds (100));
+
+    uint32_t above = satellites.Get (0)->GetId ();
+    uint32_t behind = satellites.Get (1)->GetId ();
+    uint32_t station = stations.Get (0)->GetId ();
+    NS_TEST_ASSERT_MSG_EQ (plan->GetNContacts (), 2, "only the satellite above the station is visible");
+    NS_TEST_ASSERT_MSG_EQ (plan->GetContacts (station).size (), 1, "missing down contact");
+    NS_TEST_ASSERT_MSG_EQ (plan->GetContacts (station)[0].to, above, "wrong satellite");
+    NS_TEST_ASSERT_MSG_EQ (plan->GetContacts (station)[0].end, Seconds (100), "contact should last");
+    NS_TEST_ASSERT_MSG_EQ (plan->GetContacts (behind).size (), 0, "earth blocks the satellites");
+
+    Simulator::Destroy ();
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class LeoContactGraphRoutingTestSuite : TestSuite
+{
+public:
+  LeoContactGraphRoutingTestSuite() : TestSuite ("leo-contact-graph-routing", UNIT) {
+      AddTestCase (new LeoContactPlanRouteTestCase, TestCase::QUICK);
+      AddTestCase (new LeoContactPlanComputeTestCase, TestCase::QUICK);
+  }
+};
+
+static LeoContactGraphRoutingTestSuite leoContactGraphRoutingTestSuite;
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/test.h"
+
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief A satellite above two ground stations and one ground station on the
+ * other side of the earth, all ground stations sending at 1 Mbit/s
+ */
+class LeoFluidFlowTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param name name of the test
+   */
+  LeoFluidFlowTestCase (std::string name) : TestCase (name) {}
+  virtual ~LeoFluidFlowTestCase () {}
+protected:
+  /// The satellite
+  Ptr<Node> m_satellite;
+  /// The ground stations
+  NodeContainer m_stations;
+
+  Ptr<Node> CreateNode (Vector position, LeoMockNetDevice::DeviceType type, Ptr<LeoMockChannel> channel)
+  {
+    Ptr<Node> node = CreateObject<Node> ();
+    Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+    mobility->SetPosition (position);
+    node->AggregateObject (mobility);
+    Ptr<LeoMockNetDevice> dev = CreateObject<LeoMockNetDevice> ();
+    dev->SetAddress (Mac48Address::Allocate ());
+    dev->SetDeviceType (type);
+    dev->SetDataRate (DataRate ("1Mbps"));
+    node->AddDevice (dev);
+    dev->Attach (channel);
+    return node;
+  }
+
+  void CreateTopology (void)
+  {
+    Ptr<LeoMockChannel> channel = CreateObject<LeoMockChannel> ();
+    double radius = LEO_EARTH_RAD_KM * 1000;
+    m_satellite = CreateNode (Vector (radius + 1e6, 0, 0), LeoMockNetDevice::SAT, channel);
+    m_stations = NodeContainer ();
+    m_stations.Add (CreateNode (Vector (radius, 0, 0), LeoMockNetDevice::GND, channel));
+    m_stations.Add (CreateNode (Vector (radius * cos (0.02), radius * sin (0.02), 0), LeoMockNetDevice::GND, channel));
+    m_stations.Add (CreateNode (Vector (-radius, 0, 0), LeoMockNetDevice::GND, channel));
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Flows over the same device share its rate max-min fairly
+ */
+class LeoFluidFlowShareTestCase : public LeoFluidFlowTestCase
+{
+public:
+  LeoFluidFlowShareTestCase () : LeoFluidFlowTestCase ("flows share a device fairly") {}
+  virtual ~LeoFluidFlowShareTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    CreateTopology ();
+    Ptr<LeoFluidFlowManager> manager = CreateObject<LeoFluidFlowManager> ();
+    // 125000 bytes per second for three flows, the short one leaves after
+    // 1.5 s and the others get half of the rate from then on
+    uint32_t a = manager->AddFlow (m_stations.Get (0), m_satellite, 125000);
+    uint32_t b = manager->AddFlow (m_stations.Get (0), m_satellite, 125000);
+    uint32_t c = manager->AddFlow (m_stations.Get (0), m_satellite, 62500);
+    // another device, not shared
+    uint32_t d = manager->AddFlow (m_stations.Get (1), m_satellite, 125000, Seconds (1));
+    // below the horizon
+    uint32_t e = manager->AddFlow (m_stations.Get (2), m_satellite, 125000);
+
+    Simulator::Stop (Seconds (10));
+    Simulator::Run ();
+
+    NS_TEST_ASSERT_MSG_EQ_TOL (manager->GetFinishTime (c).GetSeconds (), 1.5, 1e-6, "short flow");
+    NS_TEST_ASSERT_MSG_EQ_TOL (manager->GetFinishTime (a).GetSeconds (), 2.5, 1e-6, "long flow");
+    NS_TEST_ASSERT_MSG_EQ_TOL (manager->GetFinishTime (b).GetSeconds (), 2.5, 1e-6, "long flow");
+    NS_TEST_ASSERT_MSG_EQ_TOL (manager->GetStartTime (d).GetSeconds (), 1.0, 1e-6, "delayed flow");
+    NS_TEST_ASSERT_MSG_EQ_TOL (manager->GetFinishTime (d).GetSeconds (), 2.0, 1e-6, "delayed flow");
+    NS_TEST_ASSERT_MSG_EQ (manager->IsFinished (e), false, "flow without visibility completed");
+    NS_TEST_ASSERT_MSG_EQ (manager->GetTotalRx (m_satellite), 437500, "received bytes");
+
+    Simulator::Destroy ();
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Packet level flows take a share and data rate changes are noticed
+ */
+class LeoFluidFlowHybridTestCase : public LeoFluidFlowTestCase
+{
+public:
+  LeoFluidFlowHybridTestCase () : LeoFluidFlowTestCase ("packet level flows take a share") {}
+  virtual ~LeoFluidFlowHybridTestCase () {}
+private:
+  Ptr<LeoFluidFlowManager> m_manager;
+
+  void SetDataRate (Ptr<Node> node, std::string rate)
+  {
+    StaticCast<MockNetDevice> (node->GetDevice (0))->SetDataRate (DataRate (rate));
+    m_manager->Update ();
+  }
+
+  virtual void DoRun (void)
+  {
+    CreateTopology ();
+    m_manager = CreateObject<LeoFluidFlowManager> ();
+    uint32_t packet = m_manager->AddPacketFlow (NodeContainer (m_stations.Get (0), m_satellite));
+    uint32_t a = m_manager->AddFlow (m_stations.Get (0), m_satellite, 125000);
+    Simulator::Schedule (Seconds (1), &LeoFluidFlowManager::RemoveFlow, m_manager, packet);
+
+    uint32_t b = m_manager->AddFlow (m_stations.Get (1), m_satellite, 250000);
+    Simulator::Schedule (Seconds (1), &LeoFluidFlowHybridTestCase::SetDataRate, this,
+                         m_stations.Get (1), std::string ("2Mbps"));
+
+    Simulator::Stop (Seconds (10));
+    Simulator::Run ();
+
+    // half of the rate for one second, then all of it
+    NS_TEST_ASSERT_MSG_EQ_TOL (m_manager->GetFinishTime (a).GetSeconds (), 1.5, 1e-6, "shared flow");
+    // 125000 bytes in the first second, the rest at twice the rate
+    NS_TEST_ASSERT_MSG_EQ_TOL (m_manager->GetFinishTime (b).GetSeconds (), 1.5, 1e-6, "faster flow");
+
+    Simulator::Destroy ();
+    m_manager = 0;
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class LeoFluidFlowTestSuite : public TestSuite
+{
+public:
+  LeoFluidFlowTestSuite ();
+};
+
+LeoFluidFlowTestSuite::LeoFluidFlowTestSuite ()
+  : TestSuite ("leo-fluid-flow", UNIT)
+{
+  AddTestCase (new LeoFluidFlowShareTestCase, TestCase::QUICK);
+  AddTestCase (new LeoFluidFlowHybridTestCase, TestCase::QUICK);
+}
+
+static LeoFluidFlowTestSuite leoFluidFlowTestSuite;
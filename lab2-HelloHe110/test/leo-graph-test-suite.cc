@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <math.h>
+#include <sstream>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/node-container.h"
+#include "ns3/test.h"
+
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Rates follow the link budget of bf.m
+ */
+class LeoGraphRateTestCase : public TestCase
+{
+public:
+  LeoGraphRateTestCase () : TestCase ("rates of links") {}
+  virtual ~LeoGraphRateTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    // the link budget of network.pos
+    LeoGraphHelper graphs;
+    graphs.SetLinkBudget (105.9, -110.0, 2e6, -60.0);
+
+    // 157.553298 dB path loss with the best beam pointing straight up
+    Vector station (LEO_PROP_EARTH_RAD, 0, 0);
+    Vector satellite (LEO_PROP_EARTH_RAD + 1200009.000003, 0, 0);
+    double snr = pow (10.0, (105.9 - 157.553298 + 110.0) / 10.0);
+    NS_TEST_ASSERT_MSG_EQ_TOL (graphs.GetRate (station, satellite), 2e6 * log2 (1 + snr) / 1e3, 1e-2,
+                               "wrong rate");
+
+    // below the threshold and below the horizon
+    graphs.SetLinkBudget (105.9, -110.0, 2e6, -50.0);
+    NS_TEST_ASSERT_MSG_EQ (graphs.GetRate (station, satellite), 0.0, "link below threshold");
+    graphs.SetLinkBudget (105.9, -110.0, 2e6, -60.0);
+    NS_TEST_ASSERT_MSG_EQ (graphs.GetRate (station, Vector (-LEO_PROP_EARTH_RAD - 1.2e6, 0, 0)), 0.0,
+                           "link through the earth");
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Graphs are the same with any number of threads and in both formats
+ */
+class LeoGraphWriteTestCase : public TestCase
+{
+public:
+  LeoGraphWriteTestCase () : TestCase ("graphs of a time window") {}
+  virtual ~LeoGraphWriteTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    NodeContainer stations (3);
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+    for (uint32_t i = 0; i < stations.GetN (); i++)
+      {
+        double angle = i * 0.05;
+        positions->Add (Vector (LEO_PROP_EARTH_RAD * cos (angle), LEO_PROP_EARTH_RAD * sin (angle), 0));
+      }
+    mobility.SetPositionAllocator (positions);
+    mobility.Install (stations);
+    // satellites pass over the stations on the equator
+    LeoOrbitNodeHelper orbit;
+    NodeContainer satellites = orbit.Install (LeoOrbit (1200, 0, 1, 12));
+
+    LeoGraphHelper graphs;
+    graphs.SetThreads (1);
+    std::vector<LeoGraph> expected;
+    uint32_t nLinks = 0;
+    for (uint32_t k = 0; k <= 10; k++)
+      {
+        expected.push_back (graphs.Compute (stations, satellites, Seconds (60 * k)));
+        nLinks += expected.back ().links.size ();
+      }
+    NS_TEST_ASSERT_MSG_GT (nLinks, 0, "no links at all");
+
+    graphs.SetThreads (4);
+    std::ostringstream text;
+    std::ostringstream binary;
+    uint32_t written = graphs.Write (stations, satellites, Seconds (0), Seconds (600), Seconds (60), &text, &binary);
+    NS_TEST_ASSERT_MSG_EQ (written, expected.size (), "wrong number of graphs");
+
+    std::istringstream textIn (text.str ());
+    std::istringstream binaryIn (binary.str ());
+    NS_TEST_ASSERT_MSG_EQ (LeoGraphHelper::ReadBinaryHeader (binaryIn), true, "not the binary format");
+    for (const LeoGraph &graph : expected)
+      {
+        uint32_t nStations, nSatellites, n;
+        textIn >> nStations >> nSatellites >> n;
+        NS_TEST_ASSERT_MSG_EQ (nStations, 3, "wrong header");
+        NS_TEST_ASSERT_MSG_EQ (nSatellites, 12, "wrong header");
+        NS_TEST_ASSERT_MSG_EQ (n, graph.links.size (), "wrong number of links");
+
+        LeoGraph read;
+        NS_TEST_ASSERT_MSG_EQ (LeoGraphHelper::ReadBinary (binaryIn, read), true, "graph missing");
+        NS_TEST_ASSERT_MSG_EQ (read.time, graph.time, "wrong time");
+        NS_TEST_ASSERT_MSG_EQ (read.links.size (), graph.links.size (), "wrong number of links");
+        for (std::size_t i = 0; i < graph.links.size (); i++)
+          {
+            uint32_t station, satellite;
+            double rate;
+            textIn >> station >> satellite >> rate;
+            NS_TEST_ASSERT_MSG_EQ (station, graph.links[i].station, "wrong order");
+            NS_TEST_ASSERT_MSG_EQ (satellite, graph.links[i].satellite, "wrong order");
+            NS_TEST_ASSERT_MSG_EQ_TOL (rate, graph.links[i].rate, 1e-6, "wrong rate");
+            NS_TEST_ASSERT_MSG_EQ (read.links[i].station, graph.links[i].station, "wrong order");
+            NS_TEST_ASSERT_MSG_EQ (read.links[i].satellite, graph.links[i].satellite, "wrong order");
+            NS_TEST_ASSERT_MSG_EQ_TOL (read.links[i].rate, graph.links[i].rate, graph.links[i].rate * 1e-6,
+                                       "wrong rate");
+          }
+      }
+    LeoGraph read;
+    NS_TEST_ASSERT_MSG_EQ (LeoGraphHelper::ReadBinary (binaryIn, read), false, "too many graphs");
+
+    Simulator::Destroy ();
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class LeoGraphTestSuite : public TestSuite
+{
+public:
+  LeoGraphTestSuite ();
+};
+
+LeoGraphTestSuite::LeoGraphTestSuite ()
+  : TestSuite ("leo-graph", UNIT)
+{
+  AddTestCase (new LeoGraphRateTestCase, TestCase::QUICK);
+  AddTestCase (new LeoGraphWriteTestCase, TestCase::QUICK);
+}
+
+static LeoGraphTestSuite leoGraphTestSuite;
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/node-container.h"
+#include "ns3/test.h"
+
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Next hops follow the +Grid and take the shortest way around
+ */
+class LeoGridRoutingNextHopTestCase : public TestCase
+{
+public:
+  LeoGridRoutingNextHopTestCase () : TestCase ("next hops on a 6x6 grid") {}
+  virtual ~LeoGridRoutingNextHopTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    Ptr<LeoGridRouting> routing = CreateObject<LeoGridRouting> ();
+    routing->SetAttribute ("NumOrbits", UintegerValue (6));
+    routing->SetAttribute ("NumSatellites", UintegerValue (6));
+
+    NS_TEST_ASSERT_MSG_EQ (routing->GetNextHop (0, 0), 0, "already at destination");
+    NS_TEST_ASSERT_MSG_EQ (routing->GetNextHop (0, 2), 1, "forward in plane");
+    NS_TEST_ASSERT_MSG_EQ (routing->GetNextHop (0, 4), 5, "backward in plane");
+    NS_TEST_ASSERT_MSG_EQ (routing->GetNextHop (0, 35), 30, "across the seam");
+    NS_TEST_ASSERT_MSG_EQ (routing->GetHopCount (0, 35), 2, "one plane and one slot apart");
+
+    routing->SetAttribute ("CrossSeam", BooleanValue (false));
+    NS_TEST_ASSERT_MSG_EQ (routing->GetNextHop (0, 35), 6, "not across the seam");
+    NS_TEST_ASSERT_MSG_EQ (routing->GetHopCount (0, 35), 6, "five planes and one slot apart");
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Following the next hops reaches every satellite in the predicted
+ * number of hops
+ */
+class LeoGridRoutingPathTestCase : public TestCase
+{
+public:
+  LeoGridRoutingPathTestCase () : TestCase ("paths reach all satellites") {}
+  virtual ~LeoGridRoutingPathTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    Ptr<LeoGridRouting> routing = CreateObject<LeoGridRouting> ();
+    routing->SetAttribute ("NumOrbits", UintegerValue (5));
+    routing->SetAttribute ("NumSatellites", UintegerValue (7));
+
+    for (uint32_t from = 0; from < 35; from++)
+      {
+        for (uint32_t to = 0; to < 35; to++)
+          {
+            uint32_t curr = from;
+            uint32_t hops = 0;
+            while (curr != to && hops <= 35)
+              {
+                curr = routing->GetNextHop (curr, to);
+                hops++;
+              }
+            NS_TEST_ASSERT_MSG_EQ (hops, routing->GetHopCount (from, to), "path is not minimal");
+          }
+      }
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief The satellite right above a position is the nearest one
+ */
+class LeoGridRoutingNearestTestCase : public TestCase
+{
+public:
+  LeoGridRoutingNearestTestCase () : TestCase ("nearest satellite") {}
+  virtual ~LeoGridRoutingNearestTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    LeoOrbit orbit (1200, 20, 6, 6);
+    LeoOrbitNodeHelper orbitHelper;
+    NodeContainer satellites = orbitHelper.Install (orbit);
+
+    LeoGridRoutingHelper helper;
+    helper.SetConstellation (satellites, orbit, NodeContainer ());
+    Ptr<LeoGridRouting> routing = DynamicCast<LeoGridRouting> (helper.Create (satellites.Get (0)));
+
+    for (uint32_t i = 0; i < satellites.GetN (); i++)
+      {
+        Vector pos = satellites.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+        double scale = LEO_EARTH_RAD_KM * 1000 / pos.GetLength ();
+        Vector ground = Vector (pos.x * scale, pos.y * scale, pos.z * scale);
+        NS_TEST_ASSERT_MSG_EQ (routing->GetNearestSatellite (ground), i, "satellite above the ground position should be nearest");
+      }
+
+    Simulator::Destroy ();
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class LeoGridRoutingTestSuite : TestSuite
+{
+public:
+  LeoGridRoutingTestSuite() : TestSuite ("leo-grid-routing", UNIT) {
+      AddTestCase (new LeoGridRoutingNextHopTestCase, TestCase::QUICK);
+      AddTestCase (new LeoGridRoutingPathTestCase, TestCase::QUICK);
+      AddTestCase (new LeoGridRoutingNearestTestCase, TestCase::QUICK);
+  }
+};
+
+static LeoGridRoutingTestSuite leoGridRoutingTestSuite;
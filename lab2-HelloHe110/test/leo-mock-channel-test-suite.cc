@@ -21,6 +21,7 @@
 #include "ns3/internet-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/node-container.h"
+#include "ns3/mobility-module.h"
 
 #include "ns3/leo-module.h"
 #include "ns3/test.h"
@@ -233,6 +234,194 @@ private:
   }
 };
 
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Receptions computed on worker threads equal those of the simulator thread
+ */
+class LeoMockChannelParallelTestCase : public TestCase
+{
+public:
+  LeoMockChannelParallelTestCase () : TestCase ("parallel delivery schedules the same receptions") {}
+  virtual ~LeoMockChannelParallelTestCase () {}
+private:
+  /// Receiving node and time of the last bit of all receptions
+  std::vector<std::pair<uint32_t, Time> > m_receptions;
+
+  void TxRx (Ptr<const Packet> p, Ptr<NetDevice> src, Ptr<NetDevice> dst, Time txTime, Time rxTime)
+  {
+    m_receptions.push_back (std::make_pair (dst->GetNode ()->GetId (), rxTime));
+  }
+
+  std::vector<std::pair<uint32_t, Time> > Transmit (uint32_t threads)
+  {
+    Ptr<LeoMockChannel> channel = CreateObject<LeoMockChannel> ();
+    channel->SetAttribute ("PropagationDelay", StringValue ("ns3::ConstantSpeedPropagationDelayModel"));
+    channel->SetAttribute ("PropagationLoss", StringValue ("ns3::LeoPropagationLossModel"));
+    channel->SetAttribute ("Threads", UintegerValue (threads));
+    channel->SetAttribute ("ParallelThreshold", UintegerValue (1));
+    channel->TraceConnectWithoutContext ("TxRxMockChannel",
+                                         MakeCallback (&LeoMockChannelParallelTestCase::TxRx, this));
+
+    Ptr<Node> srcNode = CreateObject<Node> ();
+    Ptr<ConstantPositionMobilityModel> srcMob = CreateObject<ConstantPositionMobilityModel> ();
+    srcMob->SetPosition (Vector (LEO_PROP_EARTH_RAD, 0, 0));
+    srcNode->AggregateObject (srcMob);
+    Ptr<LeoMockNetDevice> srcDev = CreateObject<LeoMockNetDevice> ();
+    srcDev->SetNode (srcNode);
+    srcDev->SetDeviceType (LeoMockNetDevice::GND);
+    srcDev->SetAddress (Mac48Address::Allocate ());
+    int32_t srcId = channel->Attach (srcDev);
+
+    // satellites spread over the sky, some of them below the elevation angle
+    Address destAddr;
+    for (uint32_t i = 0; i < 100; i++)
+      {
+        double angle = (i * 0.4) * M_PI / 180.0;
+        double radius = LEO_PROP_EARTH_RAD + 1e6;
+        Ptr<Node> dstNode = CreateObject<Node> ();
+        Ptr<ConstantPositionMobilityModel> dstMob = CreateObject<ConstantPositionMobilityModel> ();
+        dstMob->SetPosition (Vector (radius * cos (angle), radius * sin (angle), 0));
+        dstNode->AggregateObject (dstMob);
+        Ptr<LeoMockNetDevice> dstDev = CreateObject<LeoMockNetDevice> ();
+        dstDev->SetNode (dstNode);
+        dstDev->SetDeviceType (LeoMockNetDevice::SAT);
+        dstDev->SetAddress (Mac48Address::Allocate ());
+        channel->Attach (dstDev);
+        destAddr = dstDev->GetAddress ();
+      }
+
+    m_receptions.clear ();
+    channel->TransmitStart (Create<Packet> (), srcId, destAddr, MilliSeconds (1));
+    Simulator::Destroy ();
+    return m_receptions;
+  }
+
+  virtual void DoRun (void)
+  {
+    std::vector<std::pair<uint32_t, Time> > serial = Transmit (1);
+    std::vector<std::pair<uint32_t, Time> > parallel = Transmit (4);
+
+    NS_TEST_ASSERT_MSG_GT (serial.size (), 0, "no satellite reached");
+    NS_TEST_ASSERT_MSG_LT (serial.size (), 100, "satellites below the elevation angle reached");
+    NS_TEST_ASSERT_MSG_EQ (parallel.size (), serial.size (), "different number of receptions");
+    for (std::size_t i = 0; i < serial.size (); i++)
+      {
+        // node ids differ between the runs, but the order of the satellites does not
+        NS_TEST_ASSERT_MSG_EQ (parallel[i].second, serial[i].second, "different reception time");
+        NS_TEST_ASSERT_MSG_EQ (parallel[i].first - parallel[0].first, serial[i].first - serial[0].first,
+                               "different receiver");
+      }
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class LeoInterferenceTestCase : public TestCase
+{
+public:
+  LeoInterferenceTestCase () : TestCase ("overlapping signals are averaged over the reception") {}
+  virtual ~LeoInterferenceTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    LeoInterference signals;
+    signals.Add (MilliSeconds (0), MilliSeconds (10), 1.0);
+    signals.Add (MilliSeconds (5), MilliSeconds (15), 2.0);
+    signals.Add (MilliSeconds (20), MilliSeconds (30), 4.0);
+
+    NS_TEST_ASSERT_MSG_EQ_TOL (signals.GetAveragePower (MilliSeconds (0), MilliSeconds (10)), 2.0, 1e-9, "wrong power of first signal");
+    signals.Release (MilliSeconds (0), MilliSeconds (10));
+    NS_TEST_ASSERT_MSG_EQ_TOL (signals.GetAveragePower (MilliSeconds (5), MilliSeconds (15)), 2.5, 1e-9, "wrong power of second signal");
+    signals.Release (MilliSeconds (5), MilliSeconds (15));
+    NS_TEST_ASSERT_MSG_EQ_TOL (signals.GetAveragePower (MilliSeconds (20), MilliSeconds (30)), 4.0, 1e-9, "wrong power of third signal");
+    signals.Release (MilliSeconds (20), MilliSeconds (30));
+    NS_TEST_ASSERT_MSG_EQ (signals.GetNChanges (), 0, "changes of released signals are kept");
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class LeoMockChannelInterferenceTestCase : public TestCase
+{
+public:
+  LeoMockChannelInterferenceTestCase () : TestCase ("overlapping transmissions lower the SINR") {}
+  virtual ~LeoMockChannelInterferenceTestCase () {}
+private:
+  /// SINR of all receptions in dB
+  std::vector<double> m_sinr;
+
+  void PhyRxEnd (Ptr<const Packet> p)
+  {
+    LeoSinrTag tag;
+    if (p->PeekPacketTag (tag))
+      {
+        m_sinr.push_back (tag.GetSinr ());
+      }
+  }
+
+  Ptr<LeoMockNetDevice> AddDevice (Ptr<LeoMockChannel> channel, Vector position,
+                                   LeoMockNetDevice::DeviceType type)
+  {
+    Ptr<Node> node = CreateObject<Node> ();
+    Ptr<ConstantPositionMobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+    mob->SetPosition (position);
+    node->AggregateObject (mob);
+    Ptr<LeoMockNetDevice> dev = CreateObject<LeoMockNetDevice> ();
+    dev->SetNode (node);
+    dev->SetDeviceType (type);
+    dev->SetAddress (Mac48Address::Allocate ());
+    channel->Attach (dev);
+    return dev;
+  }
+
+  virtual void DoRun (void)
+  {
+    Ptr<LeoMockChannel> channel = CreateObject<LeoMockChannel> ();
+    channel->SetAttribute ("PropagationDelay", StringValue ("ns3::ConstantSpeedPropagationDelayModel"));
+    channel->SetAttribute ("PropagationLoss", StringValue ("ns3::LeoPropagationLossModel"));
+    channel->SetAttribute ("Interference", BooleanValue (true));
+
+    double angle = 1.0 * M_PI / 180.0;
+    Ptr<LeoMockNetDevice> first = AddDevice (channel, Vector (LEO_PROP_EARTH_RAD, 0, 0), LeoMockNetDevice::GND);
+    Ptr<LeoMockNetDevice> second = AddDevice (channel, Vector (LEO_PROP_EARTH_RAD * cos (angle), LEO_PROP_EARTH_RAD * sin (angle), 0), LeoMockNetDevice::GND);
+    Ptr<LeoMockNetDevice> sat = AddDevice (channel, Vector (LEO_PROP_EARTH_RAD + 1e6, 0, 0), LeoMockNetDevice::SAT);
+
+    // drop everything after the SINR has been recorded, the packets carry no headers
+    Ptr<LeoSinrErrorModel> em = CreateObject<LeoSinrErrorModel> ();
+    em->SetAttribute ("MinSinr", DoubleValue (1000.0));
+    sat->SetReceiveErrorModel (em);
+    sat->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&LeoMockChannelInterferenceTestCase::PhyRxEnd, this));
+
+    Address dst = sat->GetAddress ();
+    Ptr<const Packet> p = Create<Packet> (100);
+    Simulator::Schedule (MilliSeconds (0), &LeoMockChannel::TransmitStart, channel,
+                         p, 0u, dst, MilliSeconds (1));
+    Simulator::Schedule (MicroSeconds (500), &LeoMockChannel::TransmitStart, channel,
+                         p, 1u, dst, MilliSeconds (1));
+    Simulator::Schedule (MilliSeconds (10), &LeoMockChannel::TransmitStart, channel,
+                         p, 0u, dst, MilliSeconds (1));
+    Simulator::Run ();
+    Simulator::Destroy ();
+
+    // both overlap for about half of their duration with a signal of about
+    // the same power, which halves the SINR
+    NS_TEST_ASSERT_MSG_EQ (m_sinr.size (), 3, "not all packets received");
+    NS_TEST_ASSERT_MSG_EQ_TOL (m_sinr[0], 3.0, 0.5, "wrong SINR of first packet");
+    NS_TEST_ASSERT_MSG_EQ_TOL (m_sinr[1], 3.0, 0.5, "wrong SINR of second packet");
+    NS_TEST_ASSERT_MSG_GT (m_sinr[2], 100.0, "interference on a single packet");
+  }
+};
+
 /**
  * \ingroup leo-test
  * \ingroup tests
@@ -253,6 +442,9 @@ LeoMockChannelTestSuite::LeoMockChannelTestSuite ()
   AddTestCase (new LeoMockChannelTransmitSpaceGroundTestCase, TestCase::QUICK);
   AddTestCase (new LeoMockChannelTransmitSpaceSpaceTestCase, TestCase::QUICK);
   AddTestCase (new LeoMockChannelTransmitGroundGroundTestCase, TestCase::QUICK);
+  AddTestCase (new LeoMockChannelParallelTestCase, TestCase::QUICK);
+  AddTestCase (new LeoInterferenceTestCase, TestCase::QUICK);
+  AddTestCase (new LeoMockChannelInterferenceTestCase, TestCase::QUICK);
 }
 
 static LeoMockChannelTestSuite islMockChannelTestSuite;
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/node-container.h"
+#include "ns3/test.h"
+
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief The header carries the sender and the exact receive power
+ */
+class MockMpiHeaderTestCase : public TestCase
+{
+public:
+  MockMpiHeaderTestCase () : TestCase ("header round trip") {}
+  virtual ~MockMpiHeaderTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    Ptr<Packet> p = Create<Packet> (100);
+    MockMpiHeader header;
+    header.SetSender (42, 3);
+    header.SetRxPower (-97.123456789);
+    p->AddHeader (header);
+    NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 100 + header.GetSerializedSize (), "header not added");
+
+    MockMpiHeader received;
+    p->RemoveHeader (received);
+    NS_TEST_ASSERT_MSG_EQ (received.GetNode (), 42, "wrong node");
+    NS_TEST_ASSERT_MSG_EQ (received.GetDevice (), 3, "wrong device");
+    NS_TEST_ASSERT_MSG_EQ (received.GetRxPower (), -97.123456789, "power should be exact");
+    NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 100, "header not removed");
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief The lookahead is the delay between the closest nodes of different
+ * ranks
+ */
+class LeoMpiLookAheadTestCase : public TestCase
+{
+public:
+  LeoMpiLookAheadTestCase () : TestCase ("lookahead from distances") {}
+  virtual ~LeoMpiLookAheadTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    double radius = LEO_EARTH_RAD_KM * 1000;
+    NodeContainer satellites;
+    satellites.Create (1, 0);
+    NodeContainer stations;
+    stations.Create (1, 0);
+    stations.Create (1, 1);
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+    positions->Add (Vector (radius + 1e6, 0, 0));
+    positions->Add (Vector (radius, 0, 0));
+    positions->Add (Vector (radius + 1e5, 0, 0));
+    mobility.SetPositionAllocator (positions);
+    mobility.Install (satellites);
+    mobility.Install (stations);
+
+    LeoMpiHelper helper;
+    helper.SetStep (Seconds (1));
+    Time lookAhead = helper.CalculateLookAhead (satellites, stations, Seconds (10));
+    Time expected = Seconds ((9e5 - 8000) / LEO_SPEED_OF_LIGHT_IN_AIR);
+    NS_TEST_ASSERT_MSG_EQ_TOL (lookAhead, expected, NanoSeconds (1), "only the station of the other rank counts");
+
+    NodeContainer local;
+    local.Add (stations.Get (0));
+    NS_TEST_ASSERT_MSG_EQ (helper.CalculateLookAhead (satellites, local, Seconds (10)), Time::Max (),
+                           "nothing crosses the ranks");
+
+    Simulator::Destroy ();
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class LeoMpiTestSuite : TestSuite
+{
+public:
+  LeoMpiTestSuite() : TestSuite ("leo-mpi", UNIT) {
+      AddTestCase (new MockMpiHeaderTestCase, TestCase::QUICK);
+      AddTestCase (new LeoMpiLookAheadTestCase, TestCase::QUICK);
+  }
+};
+
+static LeoMpiTestSuite leoMpiTestSuite;
@@ -139,6 +139,88 @@ private:
   }
 };
 
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief The best beam of the codebook is used for every angle
+ */
+class LeoArrayGainTestCase : public TestCase
+{
+public:
+  LeoArrayGainTestCase () : TestCase ("gain of the best beam") {}
+  virtual ~LeoArrayGainTestCase () {}
+private:
+  void DoRun ()
+  {
+    Ptr<LeoArrayGain> array = CreateObject<LeoArrayGain> ();
+    NS_TEST_ASSERT_MSG_EQ (array->GetNBeams (), 19, "codebook from 0 to 90 degrees in steps of 5");
+    NS_TEST_ASSERT_MSG_EQ_TOL (array->GetGain (30.0), 256.0, 1e-6, "a beam points at 30 degrees");
+    NS_TEST_ASSERT_MSG_EQ (array->GetBestBeam (31.0), 6, "wrong beam");
+    NS_TEST_ASSERT_MSG_LT (array->GetGain (0, 30.0), 10.0, "beam to nadir is narrow");
+    NS_TEST_ASSERT_MSG_LT (array->GetGain (32.5), 256.0, "no beam points between two beams");
+    NS_TEST_ASSERT_MSG_GT (array->GetGain (32.5), 100.0, "neighboring beam is not used");
+
+    std::vector<double> angles;
+    for (double angle = 0; angle <= 90; angle += 7.3)
+      {
+        angles.push_back (angle);
+      }
+    std::vector<double> gains;
+    array->GetGains (angles, gains);
+    for (std::size_t i = 0; i < angles.size (); i++)
+      {
+        NS_TEST_ASSERT_MSG_EQ (gains[i], array->GetGain (angles[i]), "batch lookup differs");
+      }
+
+    array->SetAttribute ("Antennas", UintegerValue (4));
+    NS_TEST_ASSERT_MSG_EQ_TOL (array->GetGain (45.0), 16.0, 1e-6, "table not updated");
+
+    NS_TEST_ASSERT_MSG_EQ_TOL (LeoArrayGain::GetLinkAngle (Vector (7e6, 0, 0), Vector (6e6, 0, 0)), 0.0, 1e-9,
+                               "nadir is 0 degrees");
+    NS_TEST_ASSERT_MSG_EQ_TOL (LeoArrayGain::GetLinkAngle (Vector (7e6, 0, 0), Vector (6e6, 1e6, 0)), 45.0, 1e-9,
+                               "wrong angle");
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief With beamforming the path loss follows the geometry
+ */
+class LeoPropagationBeamformingTestCase : public TestCase
+{
+public:
+  LeoPropagationBeamformingTestCase () : TestCase ("path loss with beamforming") {}
+  virtual ~LeoPropagationBeamformingTestCase () {}
+private:
+  void DoRun ()
+  {
+    Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+    a->SetPosition (Vector3D (LEO_PROP_EARTH_RAD, 0, 0));
+    Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+    b->SetPosition (Vector3D (LEO_PROP_EARTH_RAD + 1200009.000003, 0, 0));
+
+    Ptr<LeoPropagationLossModel> model = CreateObject<LeoPropagationLossModel> ();
+    model->SetAttribute ("FreeSpacePathLoss", DoubleValue (100.0));
+    model->SetAttribute ("LinkMargin", DoubleValue (0.0));
+    model->SetAttribute ("Beamforming", BooleanValue (true));
+
+    // result of bf.m for a satellite 1200 km above the station at 24 GHz
+    NS_TEST_ASSERT_MSG_EQ_TOL (model->GetPathLoss (a->GetPosition (), b->GetPosition ()), 157.553298, 1e-6,
+                               "path loss differs from the offline computation");
+    NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (20.0, a, b), 20.0 - 157.553298, 1e-6, "Rx power is incorrect");
+
+    // the loss grows with the distance as the satellite moves
+    b->SetPosition (Vector3D (LEO_PROP_EARTH_RAD + 1200000.0, 600000.0, 0));
+    NS_TEST_ASSERT_MSG_GT (model->GetPathLoss (a->GetPosition (), b->GetPosition ()), 157.553298, "loss did not change");
+
+    model->SetAttribute ("Beamforming", BooleanValue (false));
+    NS_TEST_ASSERT_MSG_EQ (model->GetPathLoss (a->GetPosition (), b->GetPosition ()), 100.0, "constant loss not used");
+  }
+};
+
 /**
  * \ingroup leo-test
  * \ingroup tests
@@ -159,6 +241,8 @@ LeoPropagationTestSuite::LeoPropagationTestSuite ()
   AddTestCase (new LeoPropagationRxLosTestCase, TestCase::QUICK);
   AddTestCase (new LeoPropagationBadAngleTestCase, TestCase::QUICK);
   AddTestCase (new LeoPropagationLossTestCase, TestCase::QUICK);
+  AddTestCase (new LeoArrayGainTestCase, TestCase::QUICK);
+  AddTestCase (new LeoPropagationBeamformingTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
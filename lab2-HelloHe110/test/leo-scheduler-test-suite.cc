@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <algorithm>
+
+#include "ns3/core-module.h"
+#include "ns3/test.h"
+
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Events leave the scheduler in the order of their keys
+ */
+class LeoCalendarSchedulerOrderTestCase : public TestCase
+{
+public:
+  LeoCalendarSchedulerOrderTestCase () : TestCase ("events are removed in order") {}
+  virtual ~LeoCalendarSchedulerOrderTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    // a small calendar, so that the overflow heap is used as well
+    Ptr<LeoCalendarScheduler> scheduler = CreateObject<LeoCalendarScheduler> ();
+    scheduler->SetAttribute ("BucketWidth", TimeValue (NanoSeconds (1000)));
+    scheduler->SetAttribute ("Buckets", UintegerValue (6));
+
+    std::vector<Scheduler::Event> events;
+    uint64_t state = 42;
+    for (uint32_t i = 0; i < 1000; i++)
+      {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        Scheduler::Event ev;
+        ev.impl = 0;
+        // bursts of events at the same time and events far ahead
+        ev.key.m_ts = (i % 3 == 0) ? 15000 : 10000 + (state >> 33) % 100000;
+        ev.key.m_uid = i;
+        ev.key.m_context = 0;
+        events.push_back (ev);
+        scheduler->Insert (ev);
+      }
+
+    // the cursor moves ahead when peeking, earlier events must still come first
+    Scheduler::Event early;
+    early.impl = 0;
+    early.key.m_ts = 0;
+    early.key.m_uid = 1000;
+    early.key.m_context = 0;
+    scheduler->PeekNext ();
+    scheduler->Insert (early);
+    events.push_back (early);
+
+    // removed events are not returned
+    scheduler->Remove (events[7]);
+    scheduler->Remove (events[500]);
+    events.erase (events.begin () + 500);
+    events.erase (events.begin () + 7);
+
+    std::sort (events.begin (), events.end ());
+    for (const Scheduler::Event &ev : events)
+      {
+        NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), false, "scheduler ran empty");
+        NS_TEST_ASSERT_MSG_EQ (scheduler->PeekNext ().key.m_uid, ev.key.m_uid, "wrong next event");
+        Scheduler::Event next = scheduler->RemoveNext ();
+        NS_TEST_ASSERT_MSG_EQ (next.key.m_uid, ev.key.m_uid, "wrong event removed");
+        NS_TEST_ASSERT_MSG_EQ (next.key.m_ts, ev.key.m_ts, "wrong timestamp");
+      }
+    NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), true, "events left");
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief The simulator runs events with the installed scheduler
+ */
+class LeoSchedulerHelperTestCase : public TestCase
+{
+public:
+  LeoSchedulerHelperTestCase () : TestCase ("helper installs the scheduler") {}
+  virtual ~LeoSchedulerHelperTestCase () {}
+private:
+  /// Times at which the events ran
+  std::vector<Time> m_times;
+
+  void Record (void)
+  {
+    m_times.push_back (Simulator::Now ());
+  }
+
+  virtual void DoRun (void)
+  {
+    Simulator::Schedule (Seconds (3), &LeoSchedulerHelperTestCase::Record, this);
+    LeoSchedulerHelper helper;
+    helper.SetAttribute ("BucketWidth", TimeValue (MilliSeconds (2)));
+    helper.Install ();
+    Simulator::Schedule (MilliSeconds (5), &LeoSchedulerHelperTestCase::Record, this);
+    Simulator::Schedule (Seconds (100), &LeoSchedulerHelperTestCase::Record, this);
+    Simulator::Schedule (MilliSeconds (1), &LeoSchedulerHelperTestCase::Record, this);
+    Simulator::Run ();
+    Simulator::Destroy ();
+
+    NS_TEST_ASSERT_MSG_EQ (m_times.size (), 4, "events lost");
+    NS_TEST_ASSERT_MSG_EQ (m_times[0], MilliSeconds (1), "wrong order");
+    NS_TEST_ASSERT_MSG_EQ (m_times[1], MilliSeconds (5), "wrong order");
+    NS_TEST_ASSERT_MSG_EQ (m_times[2], Seconds (3), "wrong order");
+    NS_TEST_ASSERT_MSG_EQ (m_times[3], Seconds (100), "wrong order");
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class LeoSchedulerTestSuite : public TestSuite
+{
+public:
+  LeoSchedulerTestSuite ();
+};
+
+LeoSchedulerTestSuite::LeoSchedulerTestSuite ()
+  : TestSuite ("leo-scheduler", UNIT)
+{
+  AddTestCase (new LeoCalendarSchedulerOrderTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSchedulerHelperTestCase, TestCase::QUICK);
+}
+
+static LeoSchedulerTestSuite leoSchedulerTestSuite;
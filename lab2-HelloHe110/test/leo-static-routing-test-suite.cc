@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <math.h>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/node-container.h"
+#include "ns3/test.h"
+
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Routes go up to the satellite above the source, across the ISL and
+ * down to the destination
+ */
+class LeoStaticRoutingPathTestCase : public TestCase
+{
+public:
+  LeoStaticRoutingPathTestCase () : TestCase ("routes from geometry") {}
+  virtual ~LeoStaticRoutingPathTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    double radius = LEO_EARTH_RAD_KM * 1000;
+    double orbit = radius + 1e6;
+    double angle = 30 * M_PI / 180;
+    NodeContainer satellites (2);
+    NodeContainer stations (2);
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+    positions->Add (Vector (orbit, 0, 0));
+    positions->Add (Vector (orbit * cos (angle), orbit * sin (angle), 0));
+    positions->Add (Vector (radius, 0, 0));
+    positions->Add (Vector (radius * cos (angle), radius * sin (angle), 0));
+    mobility.SetPositionAllocator (positions);
+    mobility.Install (satellites);
+    mobility.Install (stations);
+
+    IslHelper islCh;
+    NetDeviceContainer islNet = islCh.Install (satellites);
+    LeoChannelHelper utCh;
+    NetDeviceContainer utNet = utCh.Install (satellites, stations);
+
+    LeoStaticRoutingHelper staticRouting;
+    staticRouting.SetRouteManagerAttribute ("Interval", TimeValue (Seconds (0)));
+    InternetStackHelper stack;
+    stack.SetRoutingHelper (staticRouting);
+    stack.Install (satellites);
+    stack.Install (stations);
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase ("10.1.0.0", "255.255.0.0");
+    ipv4.Assign (utNet);
+    ipv4.SetBase ("10.2.0.0", "255.255.0.0");
+    ipv4.Assign (islNet);
+
+    Ptr<LeoStaticRouteManager> manager = staticRouting.Install (satellites, stations);
+
+    uint32_t above = satellites.Get (0)->GetId ();
+    uint32_t other = satellites.Get (1)->GetId ();
+    uint32_t source = stations.Get (0)->GetId ();
+    uint32_t dest = stations.Get (1)->GetId ();
+    NS_TEST_ASSERT_MSG_EQ (manager->GetNextHop (source, dest), above, "should go up to the satellite above");
+    NS_TEST_ASSERT_MSG_EQ (manager->GetNextHop (above, dest), other, "should cross the ISL");
+    NS_TEST_ASSERT_MSG_EQ (manager->GetNextHop (other, dest), dest, "should go down to the destination");
+    NS_TEST_ASSERT_MSG_EQ (manager->GetNextHop (dest, dest), dest, "already at the destination");
+    NS_TEST_ASSERT_MSG_EQ (manager->GetNChanges (), 6, "three hops towards each station");
+
+    uint64_t changes = manager->GetNChanges ();
+    manager->Update ();
+    NS_TEST_ASSERT_MSG_EQ (manager->GetNChanges (), changes, "nothing moved, nothing should change");
+
+    Simulator::Destroy ();
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class LeoStaticRoutingTestSuite : TestSuite
+{
+public:
+  LeoStaticRoutingTestSuite() : TestSuite ("leo-static-routing", UNIT) {
+      AddTestCase (new LeoStaticRoutingPathTestCase, TestCase::QUICK);
+  }
+};
+
+static LeoStaticRoutingTestSuite leoStaticRoutingTestSuite;
@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Tim Schubert <ns-3-leo@timschubert.net>
+ */
+
+#include <fstream>
+#include <unistd.h>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/node-container.h"
+#include "ns3/test.h"
+
+#include "ns3/leo-module.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief A shared ephemeris has the positions and contacts of the original
+ */
+class LeoEphemerisShareTestCase : public TestCase
+{
+public:
+  LeoEphemerisShareTestCase () : TestCase ("shared positions and contacts") {}
+  virtual ~LeoEphemerisShareTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    double radius = LEO_EARTH_RAD_KM * 1000;
+    NodeContainer satellites (2);
+    NodeContainer stations (1);
+    MobilityHelper mobility;
+    mobility.SetMobilityModel ("ns3::LeoCircularOrbitMobilityModel",
+                               "Altitude", DoubleValue (1000.0),
+                               "Inclination", DoubleValue (20.0));
+    mobility.Install (satellites.Get (0));
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+    positions->Add (Vector (-radius - 1e6, 0, 0));
+    positions->Add (Vector (radius, 0, 0));
+    mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator (positions);
+    mobility.Install (satellites.Get (1));
+    mobility.Install (stations);
+    NodeContainer nodes (satellites, stations);
+
+    Ptr<LeoContactPlan> plan = CreateObject<LeoContactPlan> ();
+    plan->Compute (satellites, stations, Seconds (0), Seconds (600));
+    Ptr<LeoEphemeris> ephemeris = CreateObject<LeoEphemeris> ();
+    ephemeris->Compute (nodes, Seconds (0), Seconds (600), Seconds (1));
+    ephemeris->SetContacts (plan, Seconds (0), Seconds (600));
+
+    std::ostringstream name;
+    name << "/leo-ephemeris-test-" << getpid ();
+    NS_TEST_ASSERT_MSG_EQ (ephemeris->Share (name.str ()), true, "unable to share");
+    Ptr<LeoEphemeris> shared = CreateObject<LeoEphemeris> ();
+    NS_TEST_ASSERT_MSG_EQ (shared->Open (name.str ()), true, "unable to open");
+    LeoEphemeris::Unlink (name.str ());
+
+    Ptr<LeoCircularOrbitMobilityModel> orbit = satellites.Get (0)->GetObject<LeoCircularOrbitMobilityModel> ();
+    uint32_t satellite = satellites.Get (0)->GetId ();
+    NS_TEST_ASSERT_MSG_EQ (shared->HasNode (satellite), true, "node missing");
+    NS_TEST_ASSERT_MSG_EQ (shared->Covers (Seconds (600)), true, "window too short");
+    NS_TEST_ASSERT_MSG_EQ (shared->Covers (Seconds (601)), false, "window too long");
+    Vector position = shared->GetPosition (satellite, MilliSeconds (250500));
+    NS_TEST_ASSERT_MSG_EQ_TOL (CalculateDistance (position, orbit->GetPositionAt (MilliSeconds (250500))), 0, 10,
+                               "interpolated position too far off");
+    NS_TEST_ASSERT_MSG_EQ (CalculateDistance (shared->GetPosition (stations.Get (0)->GetId (), Seconds (3)),
+                                              Vector (radius, 0, 0)), 0, "station moved");
+
+    NS_TEST_ASSERT_MSG_EQ (shared->HasContacts (nodes, Seconds (0), Seconds (600)), true, "contacts missing");
+    NS_TEST_ASSERT_MSG_EQ (shared->HasContacts (satellites, Seconds (0), Seconds (600)), false, "other nodes");
+    Ptr<LeoContactPlan> loaded = CreateObject<LeoContactPlan> ();
+    loaded->SetEphemeris (shared);
+    loaded->Compute (satellites, stations, Seconds (0), Seconds (600));
+    NS_TEST_ASSERT_MSG_EQ (loaded->GetNContacts (), plan->GetNContacts (), "contacts lost");
+    for (uint32_t i = 0; i < nodes.GetN (); i++)
+      {
+        uint32_t node = nodes.Get (i)->GetId ();
+        NS_TEST_ASSERT_MSG_EQ (loaded->GetContacts (node).size (), plan->GetContacts (node).size (), "contacts lost");
+        for (std::size_t j = 0; j < plan->GetContacts (node).size (); j++)
+          {
+            NS_TEST_ASSERT_MSG_EQ (loaded->GetContacts (node)[j].to, plan->GetContacts (node)[j].to, "wrong contact");
+            NS_TEST_ASSERT_MSG_EQ (loaded->GetContacts (node)[j].start, plan->GetContacts (node)[j].start, "wrong contact");
+            NS_TEST_ASSERT_MSG_EQ (loaded->GetContacts (node)[j].end, plan->GetContacts (node)[j].end, "wrong contact");
+            NS_TEST_ASSERT_MSG_EQ (loaded->GetContacts (node)[j].delay, plan->GetContacts (node)[j].delay, "wrong contact");
+          }
+      }
+
+    Simulator::Destroy ();
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Every combination is run and its output collected
+ */
+class LeoSweepHelperTestCase : public TestCase
+{
+public:
+  LeoSweepHelperTestCase () : TestCase ("sweep over parameters") {}
+  virtual ~LeoSweepHelperTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    LeoSweepHelper sweep;
+    sweep.SetProgram ("/bin/echo");
+    sweep.AddParameter ("a", std::vector<std::string> ({"1", "2"}));
+    sweep.AddParameter ("b", std::vector<std::string> ({"x", "y", "z"}));
+    sweep.AddArgument ("--c=3");
+    sweep.SetReplications (2);
+    sweep.SetWorkers (4);
+
+    NS_TEST_ASSERT_MSG_EQ (sweep.GetNRuns (), 12, "wrong number of runs");
+    std::vector<std::string> arguments = sweep.GetArguments (7);
+    NS_TEST_ASSERT_MSG_EQ (arguments.size (), 4, "wrong arguments");
+    NS_TEST_ASSERT_MSG_EQ (arguments[0], "--c=3", "wrong arguments");
+    NS_TEST_ASSERT_MSG_EQ (arguments[1], "--a=2", "wrong arguments");
+    NS_TEST_ASSERT_MSG_EQ (arguments[2], "--b=x", "wrong arguments");
+    NS_TEST_ASSERT_MSG_EQ (arguments[3], "--RngRun=2", "wrong arguments");
+
+    std::string output = CreateTempDirFilename ("leo-sweep.tsv");
+    NS_TEST_ASSERT_MSG_GT (sweep.Run (output), 0, "no throughput");
+
+    std::ifstream in (output);
+    std::string line;
+    std::getline (in, line);
+    NS_TEST_ASSERT_MSG_EQ (line, "a\tb\treplication\tstatus\tseconds\toutput", "wrong header");
+    uint32_t rows = 0;
+    while (std::getline (in, line))
+      {
+        std::istringstream row (line);
+        std::string a, b, replication, status, seconds, printed;
+        std::getline (row, a, '\t');
+        std::getline (row, b, '\t');
+        std::getline (row, replication, '\t');
+        std::getline (row, status, '\t');
+        std::getline (row, seconds, '\t');
+        std::getline (row, printed, '\t');
+        // rows are in the order of the runs, whichever finished first
+        std::vector<std::string> expected = sweep.GetArguments (rows);
+        NS_TEST_ASSERT_MSG_EQ (a, expected[1].substr (4), "wrong value");
+        NS_TEST_ASSERT_MSG_EQ (b, expected[2].substr (4), "wrong value");
+        NS_TEST_ASSERT_MSG_EQ (status, "0", "run failed");
+        NS_TEST_ASSERT_MSG_EQ (printed, expected[0] + " " + expected[1] + " " + expected[2] + " " + expected[3],
+                               "wrong output");
+        rows++;
+      }
+    NS_TEST_ASSERT_MSG_EQ (rows, 12, "runs missing");
+  }
+};
+
+/**
+ * \ingroup leo-test
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class LeoSweepTestSuite : public TestSuite
+{
+public:
+  LeoSweepTestSuite ();
+};
+
+LeoSweepTestSuite::LeoSweepTestSuite ()
+  : TestSuite ("leo-sweep", UNIT)
+{
+  AddTestCase (new LeoEphemerisShareTestCase, TestCase::QUICK);
+  AddTestCase (new LeoSweepHelperTestCase, TestCase::QUICK);
+}
+
+static LeoSweepTestSuite leoSweepTestSuite;
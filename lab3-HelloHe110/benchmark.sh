@@ -0,0 +1,31 @@
+#!/bin/sh
+# Build the generator, the solvers and the harness, generate LEO instances
+# from 10^2 to 10^6 links and benchmark every solver on them.
+#   ./benchmark.sh [timeout s=60] [threads] [out=bench]
+# The OR-Tools solvers are included if they compile.
+set -e
+timeout=${1:-60}
+threads=${2:-$(nproc)}
+out=${3:-bench}
+mkdir -p "$out/bin"
+
+g++ -O2 -o "$out/bin/graph_generate" graph_generate.cc
+g++ -O2 -o "$out/bin/solver_benchmark" solver_benchmark.cc
+g++ -O2 -o "$out/bin/lab3_greedy" lab3_greedy.cc
+g++ -O2 -o "$out/bin/lab3_makespan" lab3_makespan.cc
+g++ -O2 -o "$out/bin/lab3_incremental" lab3_incremental.cc
+if g++ -O2 -pthread -DWITH_ORTOOLS -o "$out/bin/lab3_portfolio" lab3_portfolio.cc -lortools 2>/dev/null; then
+  g++ -O2 -o "$out/bin/lab3_ortools" lab3_ortools.cc -lortools
+  g++ -O2 -o "$out/bin/lab3_cpsat" lab3_cpsat.cc -lortools
+else
+  echo "OR-Tools not found, benchmarking the native solvers only"
+  g++ -O2 -pthread -o "$out/bin/lab3_portfolio" lab3_portfolio.cc
+fi
+
+graphs=""
+for links in 100 1000 10000 100000 1000000; do
+  "$out/bin/graph_generate" "$out/leo_$links.graph" --links=$links --seed=1
+  graphs="$graphs $out/leo_$links.graph"
+done
+
+"$out/bin/solver_benchmark" --bin="$out/bin" --timeout="$timeout" --threads="$threads" $graphs | tee "$out/results.csv"
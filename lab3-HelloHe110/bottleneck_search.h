@@ -0,0 +1,308 @@
+#ifndef BOTTLENECK_SEARCH_H
+#define BOTTLENECK_SEARCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// Station assignment with the placement and local search shared by
+// lab3_greedy.cc, makespan_lp.h and incremental_assignment.h.
+//
+// Stations are placed longest fastest link first, each on the satellite on
+// which it finishes earliest. Improve then works on the bottleneck
+// satellite, taken from a max-heap of loads: the best move of one of its
+// stations to another of its links, else the best swap with the station of
+// a neighbouring satellite that gains the most by moving to the bottleneck,
+// as long as both satellites end below the current maximum. If neither
+// helps, a chain of moves b -> s1 -> ... -> sk is searched breadth-first,
+// each satellite passing one of its stations on and staying below the
+// maximum. Moves and swaps scan the stations of the bottleneck and the
+// links into it; a chain search may visit every link.
+class BottleneckSearch {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Link {
+    int sat;
+    double t;  // time for one data unit
+  };
+
+  // Grow to at least V stations and S satellites
+  void Resize(int V, int S) {
+    V_ = std::max(V_, V);
+    S_ = std::max(S_, S);
+    adj_.resize(V_);
+    assignment_.resize(V_, -1);
+    slot_.resize(V_, -1);
+    members_.resize(S_);
+    rev_.resize(S_);
+    load_.resize(S_, 0.0);
+    partner_.resize(S_, -1);
+    partner_round_.resize(S_, -1);
+    partner_gain_.resize(S_, 0.0);
+    seen_.resize(S_, -1);
+    prev_sat_.resize(S_, -1);
+    moved_.resize(S_, -1);
+    moved_in_.resize(S_, 0.0);
+  }
+
+  // Add or change the link between v and s, returns true if it is new
+  bool SetLink(int v, int s, double t) {
+    Resize(v + 1, s + 1);
+    std::vector<Link>& links = adj_[v];
+    auto it = std::lower_bound(links.begin(), links.end(), s,
+                               [](const Link& l, int sat) { return l.sat < sat; });
+    if (it == links.end() || it->sat != s) {
+      links.insert(it, {s, t});
+      rev_[s].push_back(v);
+      return true;
+    }
+    if (assignment_[v] == s) load_[s] += t - it->t;
+    it->t = t;
+    return false;
+  }
+
+  // Remove the link between v and s, taking v off s if it is there.
+  // Returns true if v lost its satellite.
+  bool RemoveLink(int v, int s) {
+    if (v >= V_ || s >= S_) return false;
+    std::vector<Link>& links = adj_[v];
+    auto it = std::lower_bound(links.begin(), links.end(), s,
+                               [](const Link& l, int sat) { return l.sat < sat; });
+    if (it == links.end() || it->sat != s) return false;
+    bool lost = assignment_[v] == s;
+    if (lost) Remove(v);
+    links.erase(it);
+    rev_[s].erase(std::find(rev_[s].begin(), rev_[s].end(), v));
+    return lost;
+  }
+
+  // Links of station v, sorted by satellite
+  const std::vector<Link>& Links(int v) const { return adj_[v]; }
+
+  // Time of station v on satellite s, or infinity if there is no link
+  double Time(int v, int s) const {
+    if (s < 0) return std::numeric_limits<double>::infinity();
+    auto it = std::lower_bound(adj_[v].begin(), adj_[v].end(), s,
+                               [](const Link& l, int sat) { return l.sat < sat; });
+    if (it == adj_[v].end() || it->sat != s) return std::numeric_limits<double>::infinity();
+    return it->t;
+  }
+
+  double Fastest(int v) const {
+    double t = std::numeric_limits<double>::infinity();
+    for (const Link& l : adj_[v]) t = std::min(t, l.t);
+    return t;
+  }
+
+  void Insert(int v, int s) {
+    assignment_[v] = s;
+    slot_[v] = members_[s].size();
+    members_[s].push_back(v);
+    load_[s] += Time(v, s);
+  }
+
+  void Remove(int v) {
+    int s = assignment_[v];
+    int last = members_[s].back();
+    members_[s][slot_[v]] = last;
+    slot_[last] = slot_[v];
+    members_[s].pop_back();
+    load_[s] -= Time(v, s);
+    assignment_[v] = -1;
+  }
+
+  // Put station v on the satellite it finishes earliest on, the faster
+  // link on a tie
+  void Place(int v) {
+    int sat = -1;
+    double finish = std::numeric_limits<double>::infinity();
+    for (const Link& l : adj_[v]) {
+      double f = load_[l.sat] + l.t;
+      if (f < finish || (f == finish && l.t < Time(v, sat))) {
+        finish = f;
+        sat = l.sat;
+      }
+    }
+    if (sat >= 0) Insert(v, sat);
+  }
+
+  // Place the stations, longest fastest link first
+  void PlaceLongestFirst(std::vector<int> stations) {
+    std::vector<double> fastest(V_);
+    for (int v : stations) fastest[v] = Fastest(v);
+    std::sort(stations.begin(), stations.end(), [&](int a, int b) { return fastest[a] > fastest[b]; });
+    for (int v : stations) Place(v);
+  }
+
+  // Sum the loads again, repeated updates drift
+  void Recompute() {
+    std::fill(load_.begin(), load_.end(), 0.0);
+    for (int v = 0; v < V_; ++v) {
+      if (assignment_[v] >= 0) load_[assignment_[v]] += Time(v, assignment_[v]);
+    }
+  }
+
+  // Local search on the bottleneck until nothing lowers it or the deadline
+  // passes. Returns the number of stations moved.
+  int Improve(Clock::time_point deadline = Clock::time_point::max()) {
+    if (S_ == 0) return 0;
+    const double eps = 1e-12;
+    const bool timed = deadline != Clock::time_point::max();
+    std::priority_queue<std::pair<double, int>> loads;
+    for (int s = 0; s < S_; ++s) loads.push({load_[s], s});
+    int changes = 0;
+    for (;;) {
+      if (timed && Clock::now() >= deadline) break;
+      while (loads.top().first != load_[loads.top().second]) loads.pop();
+      int b = loads.top().second;
+      double T = load_[b];
+
+      // best move: lowest resulting maximum of the two satellites
+      int best_v = -1, best_u = -1, best_s = -1;
+      double best = T - eps;
+      for (int v : members_[b]) {
+        double tvb = Time(v, b);
+        for (const Link& l : adj_[v]) {
+          if (l.sat == b) continue;
+          double m = std::max(load_[l.sat] + l.t, T - tvb);
+          if (m < best) {
+            best = m;
+            best_v = v;
+            best_s = l.sat;
+          }
+        }
+      }
+      if (best_v < 0) {
+        // swap with a station on a neighbouring satellite: on each of them
+        // the one that gains the most by moving to b, t(u, s) - t(u, b)
+        ++round_;
+        for (int u : rev_[b]) {
+          int s = assignment_[u];
+          if (s < 0 || s == b) continue;
+          double gain = Time(u, s) - Time(u, b);
+          if (partner_round_[s] != round_ || gain > partner_gain_[s]) {
+            partner_round_[s] = round_;
+            partner_gain_[s] = gain;
+            partner_[s] = u;
+          }
+        }
+        for (int v : members_[b]) {
+          double tvb = Time(v, b);
+          for (const Link& l : adj_[v]) {
+            if (l.sat == b || partner_round_[l.sat] != round_) continue;
+            int u = partner_[l.sat];
+            double tub = Time(u, b);
+            if (tub >= tvb) continue;
+            double m = std::max(T - tvb + tub, load_[l.sat] - Time(u, l.sat) + l.t);
+            if (m < best) {
+              best = m;
+              best_v = v;
+              best_u = u;
+              best_s = l.sat;
+            }
+          }
+        }
+      }
+      if (best_v < 0) {
+        int moved = Chain(b, loads);
+        if (moved == 0) break;
+        changes += moved;
+        ++chains_;
+        continue;
+      }
+      Remove(best_v);
+      if (best_u >= 0) Remove(best_u);
+      Insert(best_v, best_s);
+      if (best_u >= 0) Insert(best_u, b);
+      loads.push({load_[b], b});
+      loads.push({load_[best_s], best_s});
+      if (best_u >= 0) {
+        changes += 2;
+        ++swaps_;
+      } else {
+        changes += 1;
+        ++moves_;
+      }
+    }
+    return changes;
+  }
+
+  double Makespan() const {
+    return load_.empty() ? 0.0 : *std::max_element(load_.begin(), load_.end());
+  }
+
+  // Satellite of each station, -1 if it has none
+  const std::vector<int>& Assignment() const { return assignment_; }
+  // Collection time of each satellite
+  const std::vector<double>& Loads() const { return load_; }
+  int Stations() const { return V_; }
+  int Satellites() const { return S_; }
+  // Steps of Improve so far
+  long long Moves() const { return moves_; }
+  long long Swaps() const { return swaps_; }
+  long long Chains() const { return chains_; }
+
+ private:
+  // Chain of moves b -> s1 -> ... -> sk searched breadth-first, each
+  // satellite passing one of its stations on and staying below the load of
+  // b. Returns the number of stations moved, 0 if there is no such chain.
+  int Chain(int b, std::priority_queue<std::pair<double, int>>& loads) {
+    const double eps = 1e-12;
+    ++round_;
+    double T = load_[b];
+    std::queue<int> queue;
+    seen_[b] = round_;
+    moved_in_[b] = 0.0;
+    queue.push(b);
+    while (!queue.empty()) {
+      int x = queue.front();
+      queue.pop();
+      for (int v : members_[x]) {
+        if (load_[x] + moved_in_[x] - Time(v, x) >= T - eps) continue;
+        for (const Link& l : adj_[v]) {
+          if (seen_[l.sat] == round_) continue;
+          seen_[l.sat] = round_;
+          prev_sat_[l.sat] = x;
+          moved_[l.sat] = v;
+          moved_in_[l.sat] = l.t;
+          if (load_[l.sat] + l.t < T - eps) {
+            // apply from the end, every station leaves before the next arrives
+            int n = 0;
+            for (int y = l.sat; y != b; y = prev_sat_[y], ++n) {
+              Remove(moved_[y]);
+              Insert(moved_[y], y);
+              loads.push({load_[y], y});
+            }
+            loads.push({load_[b], b});
+            return n;
+          }
+          queue.push(l.sat);
+        }
+      }
+    }
+    return 0;
+  }
+
+  int V_ = 0, S_ = 0;
+  std::vector<std::vector<Link>> adj_;  // links of each station by satellite
+  std::vector<int> assignment_, slot_;
+  std::vector<std::vector<int>> members_;
+  std::vector<double> load_;
+  std::vector<std::vector<int>> rev_;   // stations with a link to each satellite
+  // swap partner on each satellite, valid in the round it was found
+  std::vector<int> partner_;
+  std::vector<long long> partner_round_;
+  std::vector<double> partner_gain_;
+  // breadth-first search of Chain
+  std::vector<long long> seen_;
+  std::vector<int> prev_sat_, moved_;
+  std::vector<double> moved_in_;
+  long long round_ = 0;
+  long long moves_ = 0, swaps_ = 0, chains_ = 0;
+};
+
+#endif  // BOTTLENECK_SEARCH_H
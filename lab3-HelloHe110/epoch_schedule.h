@@ -0,0 +1,305 @@
+#ifndef EPOCH_SCHEDULE_H
+#define EPOCH_SCHEDULE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "network_graph.h"
+#include "incremental_assignment.h"
+
+// Collection schedule over a sequence of snapshots instead of a single one.
+// Epoch k is the interval [k E, (k + 1) E) in which the links of its graph
+// are visible. Every station has the same amount of data, which it may send
+// in pieces to different satellites, one piece per epoch. A satellite
+// receives one piece at a time and at most capacity seconds per epoch, and
+// switching a station to another satellite costs the handover time on the
+// new one before its piece starts.
+//
+// Rolling horizon: each Step plans the next horizon epochs and commits only
+// the first of them. The stations are planned longest remaining time first.
+// Each takes the start that finishes earliest: the piece in the first epoch
+// goes to one of its visible satellites, or there is none, and the later
+// epochs follow greedily. A station stays on its satellite while nothing
+// else finishes earlier. A station not done within the window is estimated
+// at its last rate after it. Once the rest of the data fits into the next
+// epoch, that epoch is the snapshot problem of lab3 and is solved with
+// IncrementalAssignment instead. Only the graphs of the window have to be
+// held, so the work per epoch does not grow with the number of epochs.
+
+// Links of one epoch, sorted by satellite within each station
+struct Epoch {
+  int V = 0, S = 0;
+  std::vector<uint32_t> begin;
+  std::vector<uint32_t> sat;
+  std::vector<double> rate;  // kbps
+
+  // Rate of station v to satellite s, 0 if s is not visible from v
+  double Rate(int v, int s) const {
+    if (v >= V) return 0.0;
+    auto first = sat.begin() + begin[v], last = sat.begin() + begin[v + 1];
+    auto it = std::lower_bound(first, last, (uint32_t)s);
+    return it != last && (int)*it == s ? rate[it - sat.begin()] : 0.0;
+  }
+};
+
+inline Epoch MakeEpoch(const NetworkGraph& graph) {
+  Epoch e;
+  e.V = graph.V;
+  e.S = graph.S;
+  e.begin.push_back(0);
+  std::vector<std::pair<uint32_t, double>> row;
+  for (int v = 0; v < graph.V; ++v) {
+    row.clear();
+    for (uint32_t k = graph.begin[v]; k < graph.begin[v + 1]; ++k) {
+      if (graph.rate[k] > 0) row.push_back({graph.sat[k], graph.rate[k]});
+    }
+    std::sort(row.begin(), row.end());
+    for (const auto& link : row) {
+      e.sat.push_back(link.first);
+      e.rate.push_back(link.second);
+    }
+    e.begin.push_back(e.sat.size());
+  }
+  return e;
+}
+
+// A piece of a station's data sent to one satellite, times in seconds from
+// the start of epoch 0
+struct EpochTransfer {
+  int station, satellite, epoch;
+  double start, end;
+  double data;  // kbit
+  double rate;  // kbps
+};
+
+class EpochScheduler {
+ public:
+  struct Options {
+    double epoch = 60;     // length of an epoch, s
+    double capacity = 0;   // receive time of a satellite per epoch, s, 0 for the whole epoch
+    double handover = 0;   // time lost by switching a station to another satellite, s
+    double data = 1000;    // data of every station, kbit, 1000 / rate as in lab3
+    int horizon = 4;       // epochs planned by each step
+  };
+
+  EpochScheduler(int stations, const Options& options)
+      : options_(options),
+        left_(stations, options.data),
+        current_(stations, -1),
+        finish_(stations, -1.0),
+        active_(stations) {
+    if (options_.capacity <= 0 || options_.capacity > options_.epoch) options_.capacity = options_.epoch;
+  }
+
+  // Plan the epochs of window, the first of which is the next epoch, and
+  // commit the transfers of that first epoch
+  void Step(const std::vector<const Epoch*>& window) {
+    const int H = window.size(), S = window[0]->S;
+    S_ = S;
+    if (FinishWithin(*window[0])) {
+      ++epoch_;
+      return;
+    }
+    used_.assign((std::size_t)H * S, 0.0);
+
+    std::vector<std::pair<double, int>> order;
+    for (int v = 0; v < (int)left_.size(); ++v) {
+      if (left_[v] <= 0) continue;
+      double best = 0;
+      const Epoch& e = *window[0];
+      if (v < e.V) {
+        for (uint32_t k = e.begin[v]; k < e.begin[v + 1]; ++k) best = std::max(best, e.rate[k]);
+      }
+      // with a handover time, stations that can go on with their
+      // satellite are placed first and keep it
+      double key = best > 0 ? left_[v] / best : 0.0;
+      if (options_.handover > 0 && current_[v] >= 0 && e.Rate(v, current_[v]) > 0) {
+        key += options_.epoch * window.size();
+      }
+      order.push_back({key, v});
+    }
+    std::sort(order.begin(), order.end(), std::greater<std::pair<double, int>>());
+
+    std::vector<EpochTransfer> plan, best_plan;
+    for (const auto& item : order) {
+      int v = item.second;
+      // start on each visible satellite, or wait for the next epoch
+      double best_finish = std::numeric_limits<double>::infinity();
+      int best_handovers = 0;
+      best_plan.clear();
+      const Epoch& e = *window[0];
+      std::vector<int> starts = {-1};
+      if (v < e.V) {
+        for (uint32_t k = e.begin[v]; k < e.begin[v + 1]; ++k) starts.push_back(e.sat[k]);
+      }
+      for (int first : starts) {
+        int handovers = 0;
+        double finish = Plan(window, v, first, plan, handovers);
+        if (finish < best_finish - 1e-9 ||
+            (finish < best_finish + 1e-9 && handovers < best_handovers)) {
+          best_finish = finish;
+          best_handovers = handovers;
+          best_plan.swap(plan);
+        }
+      }
+      for (const EpochTransfer& t : best_plan) {
+        int k = t.epoch - epoch_;
+        used_[(std::size_t)k * S + t.satellite] = t.end - Start(k);
+      }
+      for (const EpochTransfer& t : best_plan) {
+        if (t.epoch != epoch_) break;
+        if (current_[v] >= 0 && current_[v] != t.satellite) ++handovers_;
+        current_[v] = t.satellite;
+        left_[v] -= t.data;
+        if (left_[v] <= options_.data * 1e-9) {
+          left_[v] = 0;
+          finish_[v] = t.end;
+          --active_;
+        }
+        transfers_.push_back(t);
+      }
+    }
+    ++epoch_;
+  }
+
+  bool Done() const { return active_ == 0; }
+  int Unfinished() const { return active_; }
+  int Epochs() const { return epoch_; }
+  int Handovers() const { return handovers_; }
+  double Finish(int v) const { return finish_[v]; }
+  double CompletionTime() const { return *std::max_element(finish_.begin(), finish_.end()); }
+  const std::vector<EpochTransfer>& Transfers() const { return transfers_; }
+
+ private:
+  double Start(int k) const { return (epoch_ + k) * options_.epoch; }
+
+  // Time of the rest of station v's data on satellite s, with the handover
+  double Rest(int v, int s, double rate) const {
+    return left_[v] / rate + (current_[v] >= 0 && current_[v] != s ? options_.handover : 0.0);
+  }
+
+  // Send all data left in epoch e as a min-makespan assignment with the
+  // times of the rest, if that fits into the capacity
+  bool FinishWithin(const Epoch& e) {
+    // quick check: the work on the fastest links spread over all satellites
+    double total = 0;
+    std::vector<char> visible(e.S, 0);
+    for (int v = 0; v < (int)left_.size(); ++v) {
+      if (left_[v] <= 0) continue;
+      double fastest = std::numeric_limits<double>::infinity();
+      for (uint32_t k = v < e.V ? e.begin[v] : 0; v < e.V && k < e.begin[v + 1]; ++k) {
+        fastest = std::min(fastest, Rest(v, e.sat[k], e.rate[k]));
+        visible[e.sat[k]] = 1;
+      }
+      if (fastest > options_.capacity) return false;
+      total += fastest;
+    }
+    if (total > options_.capacity * std::count(visible.begin(), visible.end(), 1)) return false;
+
+    // times of the rest as rates of the 1000 / rate convention
+    NetworkGraph g;
+    g.V = left_.size();
+    g.S = e.S;
+    g.begin.push_back(0);
+    for (int v = 0; v < g.V; ++v) {
+      for (uint32_t k = v < e.V ? e.begin[v] : 0; v < e.V && left_[v] > 0 && k < e.begin[v + 1]; ++k) {
+        g.sat.push_back(e.sat[k]);
+        g.rate.push_back(1000.0 / Rest(v, e.sat[k], e.rate[k]));
+      }
+      g.begin.push_back(g.sat.size());
+    }
+    IncrementalAssignment assignment;
+    assignment.Load(g);
+    assignment.Resolve();
+    if (assignment.Makespan() > options_.capacity) return false;
+
+    std::vector<double> busy(e.S, 0.0);
+    for (int v = 0; v < g.V; ++v) {
+      int s = assignment.Assignment()[v];
+      if (left_[v] <= 0) continue;
+      double rate = e.Rate(v, s);
+      double penalty = current_[v] >= 0 && current_[v] != s ? options_.handover : 0.0;
+      double start = Start(0) + busy[s] + penalty;
+      transfers_.push_back({v, s, epoch_, start, start + left_[v] / rate, left_[v], rate});
+      busy[s] += penalty + left_[v] / rate;
+      if (penalty > 0) ++handovers_;
+      current_[v] = s;
+      left_[v] = 0;
+      finish_[v] = transfers_.back().end;
+      --active_;
+    }
+    return true;
+  }
+
+  // Pieces of station v through the window when its first piece goes to
+  // satellite first, or waits with -1. Returns the finish time, estimated
+  // at the last rate if the window is not enough.
+  double Plan(const std::vector<const Epoch*>& window, int v, int first,
+              std::vector<EpochTransfer>& plan, int& handovers) const {
+    const int H = window.size();
+    const Options& o = options_;
+    plan.clear();
+    double left = left_[v], last_rate = 0;
+    int prev = current_[v];
+    for (int k = 0; k < H; ++k) {
+      const Epoch& e = *window[k];
+      int s = -1;
+      double best = std::numeric_limits<double>::infinity();
+      if (k == 0) {
+        s = first;
+      } else if (v < e.V) {
+        // the satellite that finishes the rest earliest, or moves the most
+        for (uint32_t i = e.begin[v]; i < e.begin[v + 1]; ++i) {
+          double f = Estimate(k, e.sat[i], e.rate[i], prev, left);
+          if (f < best || (f == best && (int)e.sat[i] == prev)) {
+            best = f;
+            s = e.sat[i];
+          }
+        }
+      }
+      if (s < 0) continue;
+      double rate = e.Rate(v, s);
+      double penalty = prev >= 0 && s != prev ? o.handover : 0.0;
+      double used = used_[(std::size_t)k * S_ + s];
+      double avail = o.capacity - used - penalty;
+      if (rate <= 0 || avail <= 0) continue;
+      double data = std::min(left, avail * rate);
+      double start = Start(k) + used + penalty;
+      plan.push_back({v, s, epoch_ + k, start, start + data / rate, data, rate});
+      if (penalty > 0) ++handovers;
+      prev = s;
+      last_rate = rate;
+      left -= data;
+      if (left <= o.data * 1e-9) return plan.back().end;
+    }
+    if (last_rate <= 0) return std::numeric_limits<double>::infinity();
+    return Start(H) + left / last_rate;
+  }
+
+  // Finish of the rest of a station's data on satellite s in window epoch
+  // k, at the rate of s after it if it does not fit
+  double Estimate(int k, int s, double rate, int prev, double left) const {
+    double penalty = prev >= 0 && s != prev ? options_.handover : 0.0;
+    double used = used_[(std::size_t)k * S_ + s] + penalty;
+    double avail = std::max(0.0, options_.capacity - used);
+    if (left <= avail * rate) return Start(k) + used + left / rate;
+    return Start(k + 1) + (left - avail * rate) / rate;
+  }
+
+  Options options_;
+  std::vector<double> left_;    // data of each station still to send, kbit
+  std::vector<int> current_;    // satellite of each station's last piece, -1 before the first
+  std::vector<double> finish_;  // end of each station's last piece, -1 while data is left
+  std::vector<double> used_;    // receive time used of each satellite in each window epoch
+  std::vector<EpochTransfer> transfers_;
+  int active_;
+  int S_ = 0;
+  int epoch_ = 0;
+  int handovers_ = 0;
+};
+
+#endif  // EPOCH_SCHEDULE_H
@@ -0,0 +1,31 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include "network_graph.h"
+
+// Convert network.graph between the text and the binary format of
+// network_graph.h. Without a format the output gets the other one.
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <input> <output> [text|binary]" << std::endl;
+    return 1;
+  }
+
+  NetworkGraph g;
+  std::string error;
+  if (!LoadNetworkGraph(argv[1], g, &error)) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+
+  bool binary = argc > 3 ? std::strcmp(argv[3], "binary") == 0 : !IsNetworkGraphBinary(argv[1]);
+  bool ok = binary ? WriteNetworkGraphBinary(argv[2], g) : WriteNetworkGraphText(argv[2], g);
+  if (!ok) {
+    std::cerr << "Cannot write " << argv[2] << std::endl;
+    return 1;
+  }
+
+  std::cout << argv[2] << " written with " << g.V << " stations, " << g.S
+            << " satellites and " << g.Links() << " links" << std::endl;
+  return 0;
+}
@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "network_graph.h"
+
+// Generate network.graph instances of any size from LEO geometry instead of
+// the 20 fixed positions of network.pos. The satellites fly a Walker delta
+// constellation of circular orbits (planes, satellites per plane, phasing,
+// altitude, inclination), the ground stations sit on a latitude/longitude
+// grid over a region, jittered within their cell. A station links to every
+// satellite above the minimum elevation whose received power passes the
+// threshold, with the link budget and the 16 element beam steering of bf.m.
+// The same options and seed always give the same graph.
+//
+// --epochs=K writes K graphs, interval seconds apart, next to the output:
+// big.graph -> big.0.graph ... big.<K-1>.graph. Stations that see no
+// satellite in some epoch are left out of all of them, so station ids mean
+// the same in every epoch.
+
+const double kPi = 3.14159265358979323846;
+const double kEarthRadius = 6371e3;     // m
+const double kEarthMu = 3.986004418e14;  // m^3/s^2
+const double kEarthRotation = 7.2921159e-5;  // rad/s
+const double kLightSpeed = 299792458.0;
+const int kAntennas = 16;  // tx_antenna_number of bf.m
+const double kBeamStep = 5.0;  // tx_beam_direction = 0:5:90 in bf.m
+
+struct Options {
+  int stations = 1000;
+  long long links = 0;  // if set, the number of stations is searched to reach it
+  double lat_min = -50, lat_max = 50, lon_min = -180, lon_max = 180;  // degrees
+  int planes = 72, per_plane = 22, phasing = 1;
+  double altitude = 550e3, inclination = 53, min_elevation = 25;
+  double time = 0, interval = 60;
+  int epochs = 1;
+  unsigned seed = 1;
+  bool binary = false;
+  std::string out = "network.graph";
+  // network.pos: P_tx, N0, freq, bandwidth, rx_thresh
+  double tx_power = 105.9, noise = -110, frequency = 24e9, bandwidth = 2e6, threshold = -60;
+};
+
+struct Vec3 {
+  double x, y, z;
+};
+
+static Vec3 Sub(const Vec3& a, const Vec3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+static double Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+static bool ReadLinkBudget(const char* path, Options& o) {
+  std::ifstream in(path);
+  return (bool)(in >> o.tx_power >> o.noise >> o.frequency >> o.bandwidth >> o.threshold);
+}
+
+// Satellite positions at time t in the earth-fixed frame
+static std::vector<Vec3> Satellites(const Options& o, double raan0, double t) {
+  const double a = kEarthRadius + o.altitude;
+  const double n = std::sqrt(kEarthMu / (a * a * a));
+  const double inc = o.inclination * kPi / 180;
+  const double rotation = kEarthRotation * t;
+  const int total = o.planes * o.per_plane;
+  std::vector<Vec3> sats;
+  sats.reserve(total);
+  for (int p = 0; p < o.planes; ++p) {
+    double raan = raan0 + 2 * kPi * p / o.planes - rotation;
+    for (int j = 0; j < o.per_plane; ++j) {
+      double u = 2 * kPi * j / o.per_plane + 2 * kPi * o.phasing * p / total + n * t;
+      sats.push_back({a * (std::cos(raan) * std::cos(u) - std::sin(raan) * std::sin(u) * std::cos(inc)),
+                      a * (std::sin(raan) * std::cos(u) + std::cos(raan) * std::sin(u) * std::cos(inc)),
+                      a * std::sin(u) * std::sin(inc)});
+    }
+  }
+  return sats;
+}
+
+// Grid of count stations over the region, each jittered within its cell
+static std::vector<Vec3> Stations(const Options& o, int count) {
+  double lat_span = o.lat_max - o.lat_min, lon_span = o.lon_max - o.lon_min;
+  int rows = std::max(1, (int)std::lround(std::sqrt(count * lat_span / lon_span)));
+  int cols = (count + rows - 1) / rows;
+  std::mt19937 rng(o.seed);
+  std::uniform_real_distribution<double> jitter(0.0, 1.0);
+  std::vector<Vec3> stations;
+  stations.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    double lat = (o.lat_min + lat_span * (i / cols + jitter(rng)) / rows) * kPi / 180;
+    double lon = (o.lon_min + lon_span * (i % cols + jitter(rng)) / cols) * kPi / 180;
+    stations.push_back({kEarthRadius * std::cos(lat) * std::cos(lon),
+                        kEarthRadius * std::cos(lat) * std::sin(lon), kEarthRadius * std::sin(lat)});
+  }
+  return stations;
+}
+
+// Gain of the uniform array steered with the beam closest to the zenith
+// angle, as picked by bf.m
+static double ArrayGain(double zenith) {
+  double beam = std::round(zenith / kBeamStep) * kBeamStep * kPi / 180;
+  double psi = kPi * (std::sin(zenith * kPi / 180) - std::sin(beam));  // d = 0.5
+  std::complex<double> sum = 0;
+  for (int k = 0; k < kAntennas; ++k) sum += std::polar(1.0, k * psi);
+  return std::norm(sum);
+}
+
+// Links of every station to the satellites, rate in kbps, by the link
+// budget of bf.m: Friis path gain and the Shannon capacity of the bandwidth
+static void Links(const Options& o, const std::vector<Vec3>& stations, const std::vector<Vec3>& sats,
+                  std::vector<std::vector<std::pair<int, double>>>& links) {
+  const double lambda = kLightSpeed / o.frequency;
+  const double min_sin = std::sin(o.min_elevation * kPi / 180);
+  const double noise_w = std::pow(10.0, (o.noise - 30) / 10);
+  links.assign(stations.size(), {});
+  for (std::size_t v = 0; v < stations.size(); ++v) {
+    const Vec3& g = stations[v];
+    for (std::size_t s = 0; s < sats.size(); ++s) {
+      Vec3 d = Sub(sats[s], g);
+      double up = Dot(d, g) / kEarthRadius;
+      if (up <= 0) continue;
+      double dist = std::sqrt(Dot(d, d));
+      double sin_elevation = up / dist;
+      if (sin_elevation < min_sin) continue;
+      double zenith = std::acos(std::min(1.0, sin_elevation)) * 180 / kPi;  // elev of bf.m
+      double friis = ArrayGain(zenith) * std::pow(lambda / (4 * kPi * dist), 2);
+      double rx_dbm = o.tx_power + 10 * std::log10(friis);
+      if (rx_dbm < o.threshold) continue;
+      double snr = std::pow(10.0, (rx_dbm - 30) / 10) / noise_w;
+      links[v].push_back({(int)s, o.bandwidth * std::log2(1 + snr) / 1e3});
+    }
+  }
+}
+
+static long long Count(const std::vector<std::vector<std::pair<int, double>>>& links) {
+  long long count = 0;
+  for (const auto& l : links) count += l.size();
+  return count;
+}
+
+// Output of an epoch: big.graph -> big.3.graph
+static std::string EpochPath(const std::string& path, int epoch) {
+  std::string::size_type slash = path.find_last_of('/');
+  std::string::size_type dot = path.find_last_of('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return path + "." + std::to_string(epoch);
+  }
+  return path.substr(0, dot) + "." + std::to_string(epoch) + path.substr(dot);
+}
+
+static bool Parse(int argc, char** argv, Options& o) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    std::string::size_type eq = arg.find('=');
+    std::string key = arg.substr(0, eq), value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    if (key == "--stations") {
+      o.stations = std::stoi(value);
+    } else if (key == "--links") {
+      o.links = std::stoll(value);
+    } else if (key == "--region") {
+      char comma;
+      std::istringstream in(value);
+      if (!(in >> o.lat_min >> comma >> o.lat_max >> comma >> o.lon_min >> comma >> o.lon_max)) return false;
+    } else if (key == "--walker") {
+      // planes/satellites per plane/phasing
+      char slash;
+      std::istringstream in(value);
+      if (!(in >> o.planes >> slash >> o.per_plane >> slash >> o.phasing)) return false;
+    } else if (key == "--altitude") {
+      o.altitude = std::stod(value) * 1e3;
+    } else if (key == "--inclination") {
+      o.inclination = std::stod(value);
+    } else if (key == "--min-elevation") {
+      o.min_elevation = std::stod(value);
+    } else if (key == "--time") {
+      o.time = std::stod(value);
+    } else if (key == "--epochs") {
+      o.epochs = std::stoi(value);
+    } else if (key == "--interval") {
+      o.interval = std::stod(value);
+    } else if (key == "--seed") {
+      o.seed = std::stoul(value);
+    } else if (key == "--budget") {
+      if (!ReadLinkBudget(value.c_str(), o)) {
+        std::cerr << "Cannot read the link budget of " << value << std::endl;
+        return false;
+      }
+    } else if (key == "--binary") {
+      o.binary = true;
+    } else if (arg.compare(0, 2, "--") != 0) {
+      o.out = arg;
+    } else {
+      return false;
+    }
+  }
+  return o.stations > 0 && o.epochs > 0 && o.planes > 0 && o.per_plane > 0;
+}
+
+int main(int argc, char** argv) {
+  Options o;
+  if (!Parse(argc, argv, o)) {
+    std::cerr << "Usage: " << argv[0] << " [output=network.graph] [--stations=1000 | --links=L]"
+              << " [--region=lat_min,lat_max,lon_min,lon_max] [--walker=72/22/1] [--altitude=550]"
+              << " [--inclination=53] [--min-elevation=25] [--time=0] [--epochs=1] [--interval=60]"
+              << " [--seed=1] [--budget=network.pos] [--binary]" << std::endl;
+    return 1;
+  }
+  std::mt19937 rng(o.seed + 1);
+  double raan0 = std::uniform_real_distribution<double>(0, 2 * kPi / o.planes)(rng);
+
+  // Links grow with the number of stations, a few rescaled guesses of it
+  // reach the target within a few percent
+  std::vector<std::vector<std::pair<int, double>>> links;
+  if (o.links > 0) {
+    std::vector<Vec3> sats = Satellites(o, raan0, o.time);
+    int count = std::max<long long>(1, o.links / 10);
+    for (int round = 0; round < 8; ++round) {
+      Links(o, Stations(o, count), sats, links);
+      long long found = Count(links);
+      if (found > 0 && std::abs(found - o.links) <= o.links / 50) break;
+      count = std::max<long long>(1, found > 0 ? std::llround((double)count * o.links / found) : count * 10);
+    }
+    o.stations = count;
+  }
+
+  std::vector<Vec3> stations = Stations(o, o.stations);
+  std::vector<std::vector<std::vector<std::pair<int, double>>>> epochs(o.epochs);
+  std::vector<char> keep(o.stations, 1);
+  for (int e = 0; e < o.epochs; ++e) {
+    Links(o, stations, Satellites(o, raan0, o.time + e * o.interval), epochs[e]);
+    for (int v = 0; v < o.stations; ++v) {
+      if (epochs[e][v].empty()) keep[v] = 0;
+    }
+  }
+  int dropped = std::count(keep.begin(), keep.end(), 0);
+
+  for (int e = 0; e < o.epochs; ++e) {
+    NetworkGraph g;
+    g.V = o.stations - dropped;
+    g.S = o.planes * o.per_plane;
+    g.begin.push_back(0);
+    for (int v = 0; v < o.stations; ++v) {
+      if (!keep[v]) continue;
+      for (const auto& l : epochs[e][v]) {
+        g.sat.push_back(l.first);
+        g.rate.push_back(l.second);
+      }
+      g.begin.push_back(g.sat.size());
+    }
+    std::string path = o.epochs > 1 ? EpochPath(o.out, e) : o.out;
+    bool ok = o.binary ? WriteNetworkGraphBinary(path.c_str(), g) : WriteNetworkGraphText(path.c_str(), g);
+    if (!ok) {
+      std::cerr << "Cannot write " << path << std::endl;
+      return 1;
+    }
+    std::cout << path << " written with " << g.V << " stations, " << g.S << " satellites and "
+              << g.Links() << " links at t=" << o.time + e * o.interval << " s" << std::endl;
+  }
+  if (dropped > 0) {
+    std::cout << dropped << " stations without a visible satellite left out" << std::endl;
+  }
+  return 0;
+}
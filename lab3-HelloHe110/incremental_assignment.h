@@ -0,0 +1,127 @@
+#ifndef INCREMENTAL_ASSIGNMENT_H
+#define INCREMENTAL_ASSIGNMENT_H
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "network_graph.h"
+#include "bottleneck_search.h"
+
+// Station assignment that is kept across time steps. Each step passes the
+// new graph, or single rate changes, and Resolve repairs the previous
+// assignment instead of starting over: stations that lost their link are
+// placed where they finish earliest, then the bottleneck satellite is
+// relieved by the moves, swaps and chains of moves of bottleneck_search.h.
+// With small drifts of the rates between steps this touches a handful of
+// stations.
+class IncrementalAssignment {
+ public:
+  // Apply the difference between the current links and those of g
+  void Load(const NetworkGraph& g) {
+    Resize(g.V, g.S);
+    std::vector<std::pair<int, double>> row;
+    for (int v = 0; v < Stations(); ++v) {
+      row.clear();
+      if (v < g.V) {
+        for (uint32_t k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+          if (g.rate[k] > 0) row.push_back({(int)g.sat[k], g.rate[k]});
+        }
+      }
+      std::sort(row.begin(), row.end());
+      // links that are gone, then new and changed ones
+      std::vector<int> gone;
+      std::size_t i = 0;
+      for (const BottleneckSearch::Link& l : search_.Links(v)) {
+        while (i < row.size() && row[i].first < l.sat) ++i;
+        if (i == row.size() || row[i].first != l.sat) gone.push_back(l.sat);
+      }
+      for (int s : gone) SetRate(v, s, 0.0);
+      for (const auto& link : row) SetRate(v, link.first, link.second);
+    }
+  }
+
+  // Add, change or, with a rate of 0, remove the link between v and s
+  void SetRate(int v, int s, double rate) {
+    Resize(std::max(Stations(), v + 1), std::max(Satellites(), s + 1));
+    if (rate > 0) {
+      // a station that had no link left gets one again
+      if (search_.SetLink(v, s, 1000.0 / rate) && search_.Assignment()[v] < 0) Queue(v);
+    } else if (search_.RemoveLink(v, s)) {
+      Queue(v);
+    }
+  }
+
+  // Take over an assignment found elsewhere, e.g. by a solver. Stations
+  // set to a satellite they have no link with are placed by Resolve.
+  void SetAssignment(const std::vector<int>& sat) {
+    for (int v = 0; v < Stations() && v < (int)sat.size(); ++v) {
+      int current = search_.Assignment()[v];
+      if (sat[v] == current) continue;
+      if (current >= 0) search_.Remove(v);
+      if (sat[v] >= 0 && sat[v] < Satellites() &&
+          search_.Time(v, sat[v]) < std::numeric_limits<double>::infinity()) {
+        search_.Insert(v, sat[v]);
+      } else {
+        Queue(v);
+      }
+    }
+  }
+
+  // Repair and improve the assignment, returns the number of changes.
+  // Stations without a satellite are always placed, the local search stops
+  // after budget_ms milliseconds if that is positive.
+  int Resolve(double budget_ms = 0) {
+    BottleneckSearch::Clock::time_point deadline = BottleneckSearch::Clock::time_point::max();
+    if (budget_ms > 0) {
+      deadline = BottleneckSearch::Clock::now() +
+                 std::chrono::duration_cast<BottleneckSearch::Clock::duration>(
+                     std::chrono::duration<double, std::milli>(budget_ms));
+    }
+
+    // exact loads, the incremental updates drift
+    search_.Recompute();
+
+    // stations without a satellite, longest first
+    std::vector<int> pending;
+    for (int v : unassigned_) {
+      queued_[v] = 0;
+      if (search_.Assignment()[v] < 0 && !search_.Links(v).empty()) pending.push_back(v);
+    }
+    unassigned_.clear();
+    std::sort(pending.begin(), pending.end());
+    search_.PlaceLongestFirst(pending);
+
+    return pending.size() + search_.Improve(deadline);
+  }
+
+  double Makespan() const { return search_.Makespan(); }
+
+  // Satellite of each station, -1 if it has no link
+  const std::vector<int>& Assignment() const { return search_.Assignment(); }
+  // Collection time of each satellite
+  const std::vector<double>& Loads() const { return search_.Loads(); }
+  int Stations() const { return search_.Stations(); }
+  int Satellites() const { return search_.Satellites(); }
+
+ private:
+  void Resize(int V, int S) {
+    queued_.resize(std::max(Stations(), V), 0);
+    for (int v = Stations(); v < V; ++v) Queue(v);
+    search_.Resize(V, S);
+  }
+
+  void Queue(int v) {
+    if (queued_[v]) return;
+    queued_[v] = 1;
+    unassigned_.push_back(v);
+  }
+
+  BottleneckSearch search_;
+  std::vector<int> unassigned_;  // stations that need a satellite
+  std::vector<char> queued_;     // whether a station is in unassigned_
+};
+
+#endif  // INCREMENTAL_ASSIGNMENT_H
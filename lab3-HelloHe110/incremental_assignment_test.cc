@@ -0,0 +1,63 @@
+#include <iostream>
+#include <string>
+#include "incremental_assignment.h"
+
+// Checks of IncrementalAssignment across rate changes, prints the failed
+// ones and exits with 1 if there is any.
+
+static int failures = 0;
+
+static void Check(bool ok, const std::string& what) {
+  if (!ok) {
+    std::cerr << "FAILED: " << what << std::endl;
+    ++failures;
+  }
+}
+
+// A station whose only link goes away is left without a satellite, and is
+// placed again once the link comes back
+static void LinkReturns() {
+  IncrementalAssignment a;
+  a.SetRate(0, 0, 1000);
+  a.SetRate(1, 1, 500);
+  a.Resolve();
+  Check(a.Assignment()[0] == 0, "station 0 starts on satellite 0");
+
+  a.SetRate(0, 0, 0);
+  a.Resolve();
+  Check(a.Assignment()[0] == -1, "station 0 has no satellite without a link");
+
+  a.SetRate(0, 0, 1000);
+  a.Resolve();
+  Check(a.Assignment()[0] == 0, "station 0 is placed again after its link returns");
+  Check(a.Makespan() == 2.0, "makespan after the link returns");
+
+  // repeated changes queue the station only once
+  a.SetRate(0, 0, 0);
+  a.SetRate(0, 0, 1000);
+  a.SetRate(0, 1, 1000);
+  Check(a.Resolve() == 1, "station 0 is placed once after several changes");
+}
+
+// A station that loses its satellite moves to the one it finishes earliest on
+static void LinkMoves() {
+  IncrementalAssignment a;
+  a.SetRate(0, 0, 1000);
+  a.SetRate(0, 1, 100);
+  a.SetRate(1, 1, 1000);
+  a.Resolve();
+  Check(a.Assignment()[0] == 0, "station 0 takes its fast link");
+
+  a.SetRate(0, 0, 0);
+  a.Resolve();
+  Check(a.Assignment()[0] == 1, "station 0 moves to satellite 1");
+  Check(a.Makespan() == 11.0, "makespan after the move");
+}
+
+int main() {
+  LinkReturns();
+  LinkMoves();
+  if (failures > 0) return 1;
+  std::cout << "incremental_assignment_test passed" << std::endl;
+  return 0;
+}
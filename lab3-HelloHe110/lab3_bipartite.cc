@@ -23,6 +23,7 @@
 #include "ortools/base/logging.h"
 #include "ortools/init/init.h"
 #include "ortools/linear_solver/linear_solver.h"
+#include "weighted_matching.h"
 // [END import]
 
 namespace operations_research {
@@ -47,6 +48,20 @@ void BipartiteMatching(){
     {3, 9, 1}
   };
 
+  // [START native]
+  // Same matching without a solver: Hungarian method for a matrix this
+  // small, the auction algorithm of weighted_matching.h for large ones
+  std::vector<int> match = MaxWeightMatching(weights);
+  int native_value = 0;
+  for(int i=0;i<left_num;i++){
+    if(match[i] >= 0){
+      native_value += weights[i][match[i]];
+      LOG(INFO) << "Native match: A" << i << " - B" << match[i] << " (weight: " << weights[i][match[i]] << ")";
+    }
+  }
+  LOG(INFO) << "Native objective value = " << native_value;
+  // [END native]
+
   // [START variables]
   // Create variable x[i][j]: whether the edge between A[i] and B[j] is selected
   std::vector<std::vector<MPVariable*> > x(left_num, std::vector<MPVariable*>(right_num));
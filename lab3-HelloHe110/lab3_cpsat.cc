@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ortools/sat/cp_model.h"
+#include "ortools/sat/cp_model.pb.h"
+#include "ortools/sat/cp_model_solver.h"
+#include "ortools/sat/model.h"
+#include "ortools/sat/sat_parameters.pb.h"
+#include "network_graph.h"
+#include "incremental_assignment.h"
+
+using namespace operations_research;
+using namespace operations_research::sat;
+
+// The model of lab3_ortools.cc in CP-SAT, which searches with several
+// workers in parallel and proves min-max objectives much faster than CBC.
+// CP-SAT only takes integer coefficients, so times are scaled such that the
+// greedy makespan is kResolution units. The greedy solution is the hint, and
+// links longer than its makespan are left out. Satellites with exactly the
+// same links are interchangeable, their loads are ordered to break the
+// symmetry.
+
+const double kResolution = 1e6;
+
+int main(int argc, char** argv) {
+  const char* graph_file = (argc > 1 ? argv[1] : "BasicExample/src/network.graph");
+  const char* out_file = (argc > 2 ? argv[2] : "BasicExample/src/network.cpsat.out");
+  int workers = (argc > 3 ? std::stoi(argv[3]) : 8);
+  double time_limit = (argc > 4 ? std::stod(argv[4]) : 60.0);  // seconds
+  NetworkGraph graph;
+  std::string error;
+  if (!LoadNetworkGraph(graph_file, graph, &error)) {
+    std::cerr << "ERROR: " << error << std::endl;
+    return 1;
+  }
+  int V = graph.V, S = graph.S;
+  for (int v = 0; v < V; ++v) {
+    if (graph.begin[v] == graph.begin[v + 1]) {
+      std::cerr << "ERROR: Ground station " << v << " has no valid links. Infeasible.\n";
+      return 1;
+    }
+  }
+
+  // Greedy solution: hint and upper bound
+  IncrementalAssignment greedy;
+  greedy.Load(graph);
+  greedy.Resolve();
+  std::vector<int> hint = greedy.Assignment();
+  double upper = greedy.Makespan();
+  double scale = kResolution / upper;
+
+  // Links no longer than the greedy makespan, time in scaled units
+  struct Link {
+    int v, s;
+    int64_t t;
+  };
+  std::vector<Link> links;
+  for (int v = 0; v < V; ++v) {
+    for (uint32_t k = graph.begin[v]; k < graph.begin[v + 1]; ++k) {
+      double t = 1000.0 / graph.rate[k];
+      if (graph.rate[k] > 0 && (t <= upper || (int)graph.sat[k] == hint[v])) {
+        links.push_back({v, (int)graph.sat[k], std::llround(t * scale)});
+      }
+    }
+  }
+
+  // Satellites with the same (station, time) column, in id order
+  std::vector<std::vector<std::pair<int, int64_t>>> column(S);
+  for (const Link& l : links) column[l.s].push_back({l.v, l.t});
+  std::map<std::vector<std::pair<int, int64_t>>, std::vector<int>> identical;
+  // most stations that can share a satellite, for the rounding of the bound
+  std::size_t most_stations = 0;
+  for (int s = 0; s < S; ++s) {
+    if (!column[s].empty()) identical[column[s]].push_back(s);
+    most_stations = std::max(most_stations, column[s].size());
+  }
+  column.clear();
+
+  // The hint has to respect the order of the loads, so the station sets of
+  // a group of identical satellites are handed out by decreasing load
+  std::vector<int64_t> hint_load(S, 0);
+  for (const Link& l : links) {
+    if (hint[l.v] == l.s) hint_load[l.s] += l.t;
+  }
+  for (const auto& group : identical) {
+    const std::vector<int>& sats = group.second;
+    if (sats.size() < 2) continue;
+    std::vector<int> by_load = sats;
+    std::stable_sort(by_load.begin(), by_load.end(),
+                     [&](int a, int b) { return hint_load[a] > hint_load[b]; });
+    std::vector<int> renamed(S, -1);
+    for (std::size_t i = 0; i < sats.size(); ++i) renamed[by_load[i]] = sats[i];
+    for (int v = 0; v < V; ++v) {
+      if (renamed[hint[v]] >= 0) hint[v] = renamed[hint[v]];
+    }
+    std::vector<int64_t> loads;
+    for (int s : by_load) loads.push_back(hint_load[s]);
+    for (std::size_t i = 0; i < sats.size(); ++i) hint_load[sats[i]] = loads[i];
+  }
+
+  CpModelBuilder model;
+  std::vector<BoolVar> x(links.size());
+  for (std::size_t k = 0; k < links.size(); ++k) x[k] = model.NewBoolVar();
+  int64_t hint_max = *std::max_element(hint_load.begin(), hint_load.end());
+  IntVar T = model.NewIntVar(Domain(0, hint_max));
+
+  // 1) Each ground station selects exactly one satellite
+  std::vector<std::vector<BoolVar>> of_station(V);
+  for (std::size_t k = 0; k < links.size(); ++k) of_station[links[k].v].push_back(x[k]);
+  for (int v = 0; v < V; ++v) model.AddExactlyOne(of_station[v]);
+  of_station.clear();
+
+  // 2) Satellite loads: T >= sum of times for assigned stations
+  std::vector<LinearExpr> load(S);
+  for (std::size_t k = 0; k < links.size(); ++k) load[links[k].s] += x[k] * links[k].t;
+  for (int s = 0; s < S; ++s) model.AddLessOrEqual(load[s], T);
+
+  // 3) Symmetry breaking: identical satellites in decreasing load
+  int symmetric = 0;
+  for (const auto& group : identical) {
+    const std::vector<int>& sats = group.second;
+    for (std::size_t i = 0; i + 1 < sats.size(); ++i) {
+      model.AddGreaterOrEqual(load[sats[i]], load[sats[i + 1]]);
+      ++symmetric;
+    }
+  }
+
+  model.Minimize(T);
+  for (std::size_t k = 0; k < links.size(); ++k) model.AddHint(x[k], hint[links[k].v] == links[k].s);
+  model.AddHint(T, hint_max);
+
+  SatParameters parameters;
+  parameters.set_num_workers(workers);
+  parameters.set_max_time_in_seconds(time_limit);
+  Model sat_model;
+  sat_model.Add(NewSatParameters(parameters));
+  const CpSolverResponse response = SolveCpModel(model.Build(), &sat_model);
+  if (response.status() != CpSolverStatus::OPTIMAL && response.status() != CpSolverStatus::FEASIBLE) {
+    std::cerr << "ERROR: No solution (status=" << CpSolverStatus_Name(response.status()) << ")."
+              << std::endl;
+    return 1;
+  }
+
+  // Assignment and collection times in real units
+  std::vector<int> best_sat(V, -1);
+  std::vector<double> sat_time(S, 0.0);
+  for (std::size_t k = 0; k < links.size(); ++k) {
+    if (SolutionBooleanValue(response, x[k])) {
+      best_sat[links[k].v] = links[k].s;
+      sat_time[links[k].s] += 1000.0 / graph.Rate(links[k].v, links[k].s);
+    }
+  }
+  double makespan = *std::max_element(sat_time.begin(), sat_time.end());
+
+  // Write output
+  std::ofstream outfile(out_file);
+  outfile << makespan << "\n";
+  // assignments
+  for (int v = 0; v < V; ++v) {
+    outfile << v << " " << best_sat[v] << "\n";
+  }
+  // per-satellite times
+  for (int s = 0; s < S; ++s) {
+    outfile << s << " " << sat_time[s] << "\n";
+  }
+  outfile.close();
+
+  // The bound is of the scaled model, which rounds every time by at most
+  // half a unit, so a satellite with n stations may be up to n / 2 units
+  // lighter in real time than its scaled load
+  double bound = std::max(0.0, (response.best_objective_bound() - 0.5 * most_stations) / scale);
+  std::cout << "Success: " << out_file << " generated with T=" << makespan << " ("
+            << CpSolverStatus_Name(response.status()) << ")" << std::endl;
+  std::cout << "greedy hint T=" << upper << ", bound=" << bound << " (gap "
+            << 100.0 * (makespan / bound - 1) << "%), " << symmetric
+            << " symmetry constraints, " << workers << " workers, "
+            << response.wall_time() << " s" << std::endl;
+  return 0;
+}
@@ -3,48 +3,65 @@
 #include <vector>
 #include <string>
 #include <limits>
+#include <algorithm>
+#include "network_graph.h"
+#include "bottleneck_search.h"
 
 int main(int argc, char** argv) {
-  // Read network.graph
+  // Read network.graph, text or binary
   const char* graph_file = (argc > 1 ? argv[1] : "BasicExample/src/network.graph");
-  std::ifstream infile(graph_file);
-  if (!infile.is_open()) {
-    std::cerr << "Cannot open " << graph_file << std::endl;
+  // Optimal T to compare against, e.g. written by lab3_ortools
+  const char* reference_file = (argc > 2 ? argv[2] : "BasicExample/src/network.ortools.out");
+  NetworkGraph graph;
+  std::string error;
+  if (!LoadNetworkGraph(graph_file, graph, &error)) {
+    std::cerr << error << std::endl;
     return 1;
   }
 
-  int V, S, L;
-  infile >> V >> S >> L;
-
-  // For each ground station: track best satellite (max rate)
-  std::vector<double> best_rate(V, 0.0);
-  std::vector<int> best_sat(V, -1);
-
-  for (int i = 0; i < L; ++i) {
-    int v, s;
-    double rate;
-    infile >> v >> s >> rate;
-    if (rate > best_rate[v]) {
-      best_rate[v] = rate;
-      best_sat[v]  = s;
+  int V = graph.V, S = graph.S;
+  BottleneckSearch search;
+  search.Resize(V, S);
+  for (int v = 0; v < V; ++v) {
+    for (uint32_t k = graph.begin[v]; k < graph.begin[v + 1]; ++k) {
+      if (graph.rate[k] > 0) search.SetLink(v, graph.sat[k], 1000.0 / graph.rate[k]); // time for one data unit
     }
   }
-  infile.close();
 
-  // Compute per-satellite collection times and global max
-  std::vector<double> sat_time(S, 0.0);
-  double T = 0.0;
+  // Fastest link of each station, also the lower bound of its time
+  std::vector<double> min_time(V);
+  std::vector<int> order(V);
   for (int v = 0; v < V; ++v) {
-    if (best_sat[v] < 0) {
+    if (search.Links(v).empty()) {
       std::cerr << "No valid link for station " << v << std::endl;
       return 1;
     }
-    double t = 1000.0 / best_rate[v]; // time for one data unit
-    sat_time[best_sat[v]] += t;
+    min_time[v] = search.Fastest(v);
+    order[v] = v;
   }
-  for (int s = 0; s < S; ++s) {
-    if (sat_time[s] > T) T = sat_time[s];
+
+  // 1) LPT: place the longest jobs first, each on the candidate satellite
+  // on which it finishes earliest
+  search.PlaceLongestFirst(order);
+
+  // 2) Local search on the bottleneck satellite: moves, swaps and chains of
+  // moves, see bottleneck_search.h
+  search.Improve();
+
+  // Loads drift from repeated updates, sum them again
+  search.Recompute();
+  const std::vector<int>& best_sat = search.Assignment();
+  const std::vector<double>& sat_time = search.Loads();
+  double T = search.Makespan();
+
+  // Lower bound: every station needs its fastest link, and the total of
+  // those is spread over S satellites at best
+  double bound = 0.0, total = 0.0;
+  for (int v = 0; v < V; ++v) {
+    bound = std::max(bound, min_time[v]);
+    total += min_time[v];
   }
+  bound = std::max(bound, total / S);
 
   // Write network.greedy.out
   std::ofstream outfile("BasicExample/src/network.greedy.out");
@@ -60,5 +77,14 @@ int main(int argc, char** argv) {
   outfile.close();
 
   std::cout << "network.greedy.out generated with T=" << T << std::endl;
+  std::cout << "local search: " << search.Moves() << " moves, " << search.Swaps() << " swaps, "
+            << search.Chains() << " chains" << std::endl;
+  std::cout << "lower bound=" << bound << " (T/bound=" << T / bound << ")" << std::endl;
+  std::ifstream reference(reference_file);
+  double optimum;
+  if (reference >> optimum && optimum > 0) {
+    std::cout << "optimum=" << optimum << " from " << reference_file
+              << " (T/optimum=" << T / optimum << ")" << std::endl;
+  }
   return 0;
 }
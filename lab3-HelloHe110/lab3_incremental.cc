@@ -0,0 +1,78 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "network_graph.h"
+#include "incremental_assignment.h"
+
+// Output next to the graph: network.graph -> network.incremental.out
+static std::string OutputPath(const std::string& graph_path) {
+  std::string::size_type slash = graph_path.find_last_of('/');
+  std::string::size_type dot = graph_path.find_last_of('.');
+  std::string stem = graph_path;
+  if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+    stem = graph_path.substr(0, dot);
+  }
+  return stem + ".incremental.out";
+}
+
+int main(int argc, char** argv) {
+  // One graph per time step, solved in order from the previous assignment.
+  // --budget-ms=N bounds the local search of every step after the first.
+  std::vector<std::string> steps;
+  double budget_ms = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.compare(0, 12, "--budget-ms=") == 0) {
+      budget_ms = std::stod(arg.substr(12));
+    } else {
+      steps.push_back(arg);
+    }
+  }
+  if (steps.empty()) steps.push_back("BasicExample/src/network.graph");
+
+  IncrementalAssignment assignment;
+  for (std::size_t i = 0; i < steps.size(); ++i) {
+    NetworkGraph graph;
+    std::string error;
+    auto start = std::chrono::steady_clock::now();
+    if (!LoadNetworkGraph(steps[i].c_str(), graph, &error)) {
+      std::cerr << error << std::endl;
+      return 1;
+    }
+    auto loaded = std::chrono::steady_clock::now();
+    assignment.Load(graph);
+    int changes = assignment.Resolve(i > 0 ? budget_ms : 0);
+    auto solved = std::chrono::steady_clock::now();
+
+    const std::vector<int>& sat = assignment.Assignment();
+    for (int v = 0; v < graph.V; ++v) {
+      if (sat[v] < 0) {
+        std::cerr << "No valid link for station " << v << " in " << steps[i] << std::endl;
+        return 1;
+      }
+    }
+
+    // Write the same format as network.greedy.out
+    double T = assignment.Makespan();
+    std::string out = OutputPath(steps[i]);
+    std::ofstream outfile(out);
+    outfile << T << std::endl;
+    // ground_station_id satellite_id
+    for (int v = 0; v < graph.V; ++v) {
+      outfile << v << " " << sat[v] << std::endl;
+    }
+    // satellite_id data_collection_time
+    for (int s = 0; s < graph.S; ++s) {
+      outfile << s << " " << assignment.Loads()[s] << std::endl;
+    }
+    outfile.close();
+
+    std::chrono::duration<double, std::milli> load_ms = loaded - start, solve_ms = solved - loaded;
+    std::cout << "step " << i << ": " << out << " T=" << T << ", " << changes
+              << " changes, load " << load_ms.count() << " ms, solve " << solve_ms.count()
+              << " ms" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,54 @@
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include "network_graph.h"
+#include "makespan_lp.h"
+
+using namespace makespan;
+
+int main(int argc, char** argv) {
+  const char* graph_file = (argc > 1 ? argv[1] : "BasicExample/src/network.graph");
+  const char* out_file = (argc > 2 ? argv[2] : "BasicExample/src/network.makespan.out");
+  NetworkGraph graph;
+  std::string error;
+  if (!LoadNetworkGraph(graph_file, graph, &error)) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+
+  Graph g;
+  int missing;
+  if (!BuildGraph(graph, g, missing)) {
+    std::cerr << "No valid link for station " << missing << std::endl;
+    return 1;
+  }
+  graph = NetworkGraph();
+
+  double bound;
+  int guesses;
+  std::vector<int> best = Solve(g, bound, guesses);
+
+  std::vector<double> sat_time = Loads(g, best);
+  double T = *std::max_element(sat_time.begin(), sat_time.end());
+
+  // Write the .out file
+  std::ofstream outfile(out_file);
+  outfile << T << std::endl;
+  // ground_station_id satellite_id
+  for (int v = 0; v < g.V; ++v) {
+    outfile << v << " " << best[v] << std::endl;
+  }
+  // satellite_id data_collection_time
+  for (int s = 0; s < g.S; ++s) {
+    outfile << s << " " << sat_time[s] << std::endl;
+  }
+  outfile.close();
+
+  std::cout << out_file << " generated with T=" << T << std::endl;
+  std::cout << "LP lower bound=" << bound << " after " << guesses << " guesses (gap "
+            << 100.0 * (T / bound - 1) << "%)" << std::endl;
+  return 0;
+}
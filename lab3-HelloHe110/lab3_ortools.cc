@@ -1,41 +1,46 @@
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <vector>
 #include <string>
-#include <unordered_map>
 #include <algorithm>
 #include "ortools/linear_solver/linear_solver.h"
+#include "network_graph.h"
+#include "incremental_assignment.h"
 
 using namespace operations_research;
 
-int main(int argc, char** argv) {
-  const char* graph_path = (argc > 1 ? argv[1] : "BasicExample/src/network.graph");
-  std::ifstream infile(graph_path);
-  if (!infile.is_open()) {
-    std::cerr << "ERROR: Cannot open graph file: " << graph_path << std::endl;
-    return 1;
-  }
-
-  int V, S, L;
-  infile >> V >> S >> L;
-  // Adjacency: for each v, list of (s, time)
-  std::vector<std::vector<std::pair<int, double>>> adj(V);
-  for (int i = 0; i < L; ++i) {
-    int v, s; double rate;
-    infile >> v >> s >> rate;
-    double t = 1000.0 / rate;
-    adj[v].emplace_back(s, t);
+// Output of a time step next to its graph: network.graph -> network.ortools.out
+static std::string StepOutputPath(const std::string& graph_path) {
+  std::string::size_type slash = graph_path.find_last_of('/');
+  std::string::size_type dot = graph_path.find_last_of('.');
+  std::string stem = graph_path;
+  if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+    stem = graph_path.substr(0, dot);
   }
-  infile.close();
+  return stem + ".ortools.out";
+}
 
-  // Check every station has >=1 link
-  for (int v = 0; v < V; ++v) {
-    if (adj[v].empty()) {
-      std::cerr << "ERROR: Ground station " << v
-                << " has no valid links. Infeasible.\n";
-      return 1;
+int main(int argc, char** argv) {
+  // Several graphs are solved as time steps of the same network: the model
+  // is kept and only its coefficients change, and each step starts from the
+  // previous assignment repaired for the new rates. --step-ms=N limits the
+  // solver time of the steps after the first one. Variables and constraints
+  // are unnamed unless --names is given, e.g. to export the model.
+  std::vector<std::string> steps;
+  int step_ms = 0;
+  bool names = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.compare(0, 10, "--step-ms=") == 0) {
+      step_ms = std::stoi(arg.substr(10));
+    } else if (arg == "--names") {
+      names = true;
+    } else {
+      steps.push_back(arg);
     }
   }
+  if (steps.empty()) steps.push_back("BasicExample/src/network.graph");
 
   // Create CBC solver
   std::unique_ptr<MPSolver> solver(
@@ -45,94 +50,153 @@ int main(int argc, char** argv) {
     return 1;
   }
 
-  // Decision vars x[v][k] for each link k of station v
-  std::vector<std::vector<const MPVariable*>> x(V);
-  std::vector<std::vector<int>> sat_of(V);
-  for (int v = 0; v < V; ++v) {
-    for (int k = 0; k < (int)adj[v].size(); ++k) {
-      int s = adj[v][k].first;
-      x[v].push_back(
-        solver->MakeBoolVar("x_" + std::to_string(v) + "_" + std::to_string(s))
-      );
-      sat_of[v].push_back(s);
-    }
-  }
-
   // Max collection time
-  const MPVariable* T = solver->MakeNumVar(0.0, MPSolver::infinity(), "T");
-
-  // 1) Each ground station selects exactly one satellite
-  for (int v = 0; v < V; ++v) {
-    MPConstraint* c = solver->MakeRowConstraint(1.0, 1.0, "assign_" + std::to_string(v));
-    for (auto* var : x[v]) c->SetCoefficient(var, 1.0);
-  }
-
-  // 2) Satellite loads: T >= sum of times for assigned stations
-  // For each satellite s, create constraint: T - sum_{v assigned to s}(t_vk * x_vk) >= 0
-  std::unordered_map<int, MPConstraint*> sat_time;
-  for (int v = 0; v < V; ++v) {
-    for (int k = 0; k < (int)x[v].size(); ++k) {
-      int s = sat_of[v][k];
-      double t = adj[v][k].second;
-      if (!sat_time.count(s)) {
-        sat_time[s] = solver->MakeRowConstraint(0.0,
-                                                MPSolver::infinity(),
-                                                "time_s_" + std::to_string(s));
-        sat_time[s]->SetCoefficient(T, 1.0);
-      }
-      sat_time[s]->SetCoefficient(x[v][k], -t);
-    }
-  }
+  MPVariable* T = solver->MakeNumVar(0.0, MPSolver::infinity(), "T");
 
   // Objective: minimize T
   MPObjective* obj = solver->MutableObjective();
   obj->SetCoefficient(T, 1.0);
   obj->SetMinimization();
 
-  // Solve
-  const MPSolver::ResultStatus status = solver->Solve();
-  if (status != MPSolver::OPTIMAL) {
-    std::cerr << "ERROR: Infeasible or no optimal solution (status=" << status << ")." << std::endl;
-    return 1;
-  }
+  // Decision vars of every link a station ever had, sorted by satellite.
+  // Links that are gone are kept with an upper bound of 0.
+  struct Link {
+    int sat;
+    double t;  // time for one data unit in the current step
+    MPVariable* var;
+  };
+  std::vector<std::vector<Link>> x;
+  std::vector<MPConstraint*> assign;
+  std::vector<MPConstraint*> sat_time;  // nullptr for satellites without links
+  IncrementalAssignment repair;
+
+  for (std::size_t step = 0; step < steps.size(); ++step) {
+    const char* graph_path = steps[step].c_str();
+    NetworkGraph graph;
+    std::string error;
+    if (!LoadNetworkGraph(graph_path, graph, &error)) {
+      std::cerr << "ERROR: " << error << std::endl;
+      return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
 
-  // Write output
-  std::ofstream outfile("BasicExample/src/network.ortools.out");
-  outfile << T->solution_value() << "\n";
-  // assignments
-  for (int v = 0; v < V; ++v) {
-    for (int k = 0; k < (int)x[v].size(); ++k) {
-      if (x[v][k]->solution_value() > 0.5) {
-        outfile << v << " " << sat_of[v][k] << "\n";
+    int V = graph.V;
+    // Check every station has >=1 link
+    for (int v = 0; v < V; ++v) {
+      if (graph.begin[v] == graph.begin[v + 1]) {
+        std::cerr << "ERROR: Ground station " << v
+                  << " has no valid links. Infeasible.\n";
+        return 1;
       }
     }
-  }
-  // per-satellite times
-  std::vector<std::pair<int, double>> sorted_times;
-  for (const auto& kv : sat_time) {
-    int s = kv.first;
-    double total = 0;
-    // sum again or track separately
+
+    // Links that are gone keep this bound, the others are opened again below
+    for (std::vector<Link>& links : x) {
+      for (Link& l : links) l.var->SetUB(0.0);
+    }
+
+    // 1) Each ground station selects exactly one satellite
+    while ((int)x.size() < V) {
+      int v = x.size();
+      x.emplace_back();
+      assign.push_back(solver->MakeRowConstraint(1.0, 1.0, names ? "assign_" + std::to_string(v) : ""));
+    }
+    for (int v = (int)x.size() - 1; v >= V; --v) assign[v]->SetBounds(0.0, 0.0);
+
+    // 2) Satellite loads: T >= sum of times for assigned stations
+    // For each satellite s, create constraint: T - sum_{v assigned to s}(t_vk * x_vk) >= 0
+    if ((int)sat_time.size() < graph.S) sat_time.resize(graph.S, nullptr);
     for (int v = 0; v < V; ++v) {
-      for (int k = 0; k < (int)x[v].size(); ++k) {
-        if (sat_of[v][k] == s && x[v][k]->solution_value() > 0.5) {
-          total += adj[v][k].second;
+      for (uint32_t k = graph.begin[v]; k < graph.begin[v + 1]; ++k) {
+        int s = graph.sat[k];
+        double t = 1000.0 / graph.rate[k];
+        if (!sat_time[s]) {
+          sat_time[s] = solver->MakeRowConstraint(0.0,
+                                                  MPSolver::infinity(),
+                                                  names ? "time_s_" + std::to_string(s) : "");
+          sat_time[s]->SetCoefficient(T, 1.0);
         }
+        auto it = std::lower_bound(x[v].begin(), x[v].end(), s,
+                                   [](const Link& l, int sat) { return l.sat < sat; });
+        if (it == x[v].end() || it->sat != s) {
+          MPVariable* var = solver->MakeBoolVar(names ? "x_" + std::to_string(v) + "_" + std::to_string(s) : "");
+          assign[v]->SetCoefficient(var, 1.0);
+          it = x[v].insert(it, {s, t, var});
+        }
+        it->t = t;
+        it->var->SetUB(1.0);
+        sat_time[s]->SetCoefficient(it->var, -t);
       }
     }
-    sorted_times.push_back({s, total});
-  }
-  
-  // Sort by satellite number
-  std::sort(sorted_times.begin(), sorted_times.end());
-  
-  // Output in sorted order
-  for (const auto& [s, total] : sorted_times) {
-    outfile << s << " " << total << "\n";
-  }
-  outfile.close();
 
-  std::cout << "Success: network.ortools.out generated with T="
-            << T->solution_value() << std::endl;
+    // Warm start: the previous assignment repaired for the new rates is a
+    // solution hint, and its makespan bounds T from above
+    // (half of the step time each for the repair and the solver)
+    if (steps.size() > 1) {
+      repair.Load(graph);
+      repair.Resolve(step > 0 ? step_ms / 2.0 : 0);
+    }
+    if (step > 0) {
+      std::vector<std::pair<const MPVariable*, double>> hint;
+      for (int v = 0; v < V; ++v) {
+        for (const Link& l : x[v]) hint.push_back({l.var, l.sat == repair.Assignment()[v] ? 1.0 : 0.0});
+      }
+      hint.push_back({T, repair.Makespan()});
+      solver->SetHint(hint);
+      T->SetUB(repair.Makespan());
+      if (step_ms > 0) solver->set_time_limit(std::max(1, step_ms / 2));
+    }
+
+    // Solve
+    const MPSolver::ResultStatus status = solver->Solve();
+    T->SetUB(MPSolver::infinity());
+    bool solved = status == MPSolver::OPTIMAL || (step > 0 && status == MPSolver::FEASIBLE);
+    if (!solved && step == 0) {
+      std::cerr << "ERROR: Infeasible or no optimal solution (status=" << status << ")." << std::endl;
+      return 1;
+    }
+
+    // Assignment of this step, the repaired one if the solver found nothing,
+    // and the collection times in one pass over the links. A single graph
+    // is never repaired.
+    std::vector<int> best_sat(V, -1);
+    std::vector<double> total(sat_time.size(), 0.0);
+    for (int v = 0; v < V; ++v) {
+      if (steps.size() > 1) best_sat[v] = repair.Assignment()[v];
+      for (const Link& l : x[v]) {
+        if (solved && l.var->solution_value() > 0.5) best_sat[v] = l.sat;
+      }
+      for (const Link& l : x[v]) {
+        if (l.sat == best_sat[v]) total[l.sat] += l.t;
+      }
+    }
+    double makespan = solved ? T->solution_value() : repair.Makespan();
+    if (steps.size() > 1) repair.SetAssignment(best_sat);
+
+    // Write output
+    std::string out = steps.size() > 1 ? StepOutputPath(steps[step])
+                                       : std::string("BasicExample/src/network.ortools.out");
+    std::ofstream outfile(out);
+    outfile << makespan << "\n";
+    // assignments
+    for (int v = 0; v < V; ++v) {
+      outfile << v << " " << best_sat[v] << "\n";
+    }
+    // per-satellite times in satellite order
+    for (int s = 0; s < (int)sat_time.size(); ++s) {
+      if (sat_time[s]) outfile << s << " " << total[s] << "\n";
+    }
+    outfile.close();
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    if (steps.size() > 1) {
+      std::cout << "step " << step << ": " << out << " T=" << makespan
+                << (solved ? "" : " (repaired, solver found nothing)") << ", "
+                << elapsed.count() << " ms" << std::endl;
+    } else {
+      std::cout << "Success: network.ortools.out generated with T="
+                << makespan << std::endl;
+    }
+  }
   return 0;
 }
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "network_graph.h"
+#include "incremental_assignment.h"
+#include "makespan_lp.h"
+#ifdef WITH_ORTOOLS
+#include "ortools/linear_solver/linear_solver.h"
+#endif
+
+// Portfolio of assignment backends running at the same time on one parsed
+// graph until a wall-clock budget runs out:
+//
+//   greedy        LPT and bottleneck local search (lab3_greedy.cc)
+//   lp rounding   binary search with LP rounding (lab3_makespan.cc)
+//   cbc           the MILP of lab3_ortools.cc, built with -DWITH_ORTOOLS
+//   local search  workers kicking random stations of the incumbent to other
+//                 satellites and repairing
+//
+// Each thread runs one of the backends in this order and turns into a local
+// search worker once it is done; the threads left over are local search
+// workers from the start. With fewer threads than backends the last ones do
+// not run. Every backend checks the deadline, so the run ends on time.
+//
+// The best assignment is only ever replaced by a better one. Its makespan
+// is an atomic that every backend prunes against without locking: the LP
+// search never guesses above it, CBC gets the incumbent as hint and upper
+// bound of T whenever it restarts, and the local search starts from it.
+// The LP lower bound ends the run early once the incumbent meets it.
+
+using Clock = std::chrono::steady_clock;
+
+enum Backend { GREEDY, LOCAL_SEARCH, LP_ROUNDING, CBC };
+const char* const kBackendNames[] = {"greedy", "local search", "lp rounding", "cbc"};
+
+struct Solution {
+  double makespan;
+  Backend backend;
+  double seconds;  // since the start
+  std::vector<int> assignment;
+};
+
+// Best solution so far. Its makespan is read without a lock; taking or
+// replacing the solution holds a mutex only to copy the pointer. A replaced
+// solution is freed as soon as the last reader holding it lets go.
+class Incumbent {
+ public:
+  std::shared_ptr<const Solution> Get() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return best_;
+  }
+
+  double Makespan() const { return makespan_.load(); }
+
+  // Publish the solution if it is better than the incumbent
+  bool Offer(std::shared_ptr<const Solution> solution) {
+    // most offers lose, those do not lock
+    if (solution->makespan >= Makespan()) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (best_ && best_->makespan <= solution->makespan) return false;
+    makespan_.store(solution->makespan);
+    best_.swap(solution);
+    return true;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::shared_ptr<const Solution> best_;
+  std::atomic<double> makespan_{std::numeric_limits<double>::infinity()};
+};
+
+struct Shared {
+  const NetworkGraph* graph;
+  const makespan::Graph* g;
+  Incumbent incumbent;
+  std::atomic<double> bound{0.0};  // lower bound on the optimum
+  std::atomic<bool> stop{false};
+  Clock::time_point start, deadline;
+
+  bool Stopped() const { return stop.load(std::memory_order_relaxed) || Clock::now() >= deadline; }
+
+  // at least a microsecond, a budget of 0 means none to Resolve
+  double RemainingMs() const {
+    return std::max(1e-3, std::chrono::duration<double, std::milli>(deadline - Clock::now()).count());
+  }
+
+  void Offer(Backend backend, const std::vector<int>& assignment) {
+    std::shared_ptr<Solution> s = std::make_shared<Solution>();
+    s->makespan = makespan::Makespan(*g, assignment);
+    s->backend = backend;
+    s->seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    s->assignment = assignment;
+    incumbent.Offer(std::move(s));
+  }
+
+  void RaiseBound(double value) {
+    double current = bound.load();
+    while (value > current && !bound.compare_exchange_weak(current, value)) {
+    }
+  }
+};
+
+static void RunGreedy(Shared& shared) {
+  IncrementalAssignment greedy;
+  greedy.Load(*shared.graph);
+  greedy.Resolve(shared.RemainingMs());
+  shared.Offer(GREEDY, greedy.Assignment());
+}
+
+// Iterated local search: kick a few stations of the incumbent to random
+// other links, repair, and publish if that beats the incumbent
+static void RunLocalSearch(Shared& shared, unsigned seed) {
+  const makespan::Graph& g = *shared.g;
+  if (shared.Stopped()) return;
+  std::mt19937 rng(seed);
+  IncrementalAssignment search;
+  search.Load(*shared.graph);
+  std::vector<int> kicked;
+  while (!shared.Stopped()) {
+    std::shared_ptr<const Solution> best = shared.incumbent.Get();
+    if (!best) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+    kicked = best->assignment;
+    int kicks = 1 + rng() % std::max(1, g.V / 200);
+    for (int i = 0; i < kicks; ++i) {
+      int v = rng() % g.V;
+      int n = g.begin[v + 1] - g.begin[v];
+      kicked[v] = g.sat[g.begin[v] + rng() % n];
+    }
+    // only the stations that differ from the last try are moved
+    search.SetAssignment(kicked);
+    search.Resolve(shared.RemainingMs());
+    if (search.Makespan() < best->makespan) shared.Offer(LOCAL_SEARCH, search.Assignment());
+  }
+}
+
+static void RunLpRounding(Shared& shared) {
+  const makespan::Graph& g = *shared.g;
+  std::vector<int> assignment(g.V);
+  for (int v = 0; v < g.V; ++v) {
+    int k = std::min_element(g.time.begin() + g.begin[v], g.time.begin() + g.begin[v + 1]) - g.time.begin();
+    assignment[v] = g.sat[k];
+  }
+  makespan::Polish(g, assignment, shared.deadline);
+  shared.Offer(LP_ROUNDING, assignment);
+
+  // the guesses go on above the bound and the last undecided one
+  double undecided = 0.0, hi = shared.incumbent.Makespan();
+  std::vector<double> x;
+  for (int guesses = 0; guesses < 40 && !shared.Stopped(); ++guesses) {
+    // nothing above the incumbent is worth trying
+    hi = std::min(hi, shared.incumbent.Makespan());
+    double lo = std::max(shared.bound.load(), undecided);
+    if (hi <= lo * (1 + 1e-3)) break;
+    double T = (lo + hi) / 2;
+    double dual;
+    makespan::Result result = makespan::Feasible(g, T, x, dual, shared.deadline);
+    shared.RaiseBound(std::min(T, dual * T));
+    if (result == makespan::FEASIBLE) {
+      assignment = makespan::Round(g, x, shared.deadline);
+      if (assignment.empty()) break;
+      makespan::Polish(g, assignment, shared.deadline);
+      shared.Offer(LP_ROUNDING, assignment);
+      hi = T;
+    } else if (result == makespan::INFEASIBLE) {
+      shared.RaiseBound(T);
+    } else {
+      undecided = T;
+    }
+  }
+}
+
+#ifdef WITH_ORTOOLS
+static void RunCbc(Shared& shared) {
+  using namespace operations_research;
+  const makespan::Graph& g = *shared.g;
+  std::unique_ptr<MPSolver> solver(MPSolver::CreateSolver("CBC_MIXED_INTEGER_PROGRAMMING"));
+  if (!solver) return;
+  MPVariable* T = solver->MakeNumVar(0.0, MPSolver::infinity(), "");
+  std::vector<MPVariable*> x(g.sat.size());
+  std::vector<MPConstraint*> sat_time(g.S);
+  for (int s = 0; s < g.S; ++s) {
+    sat_time[s] = solver->MakeRowConstraint(0.0, MPSolver::infinity());
+    sat_time[s]->SetCoefficient(T, 1.0);
+  }
+  for (int v = 0; v < g.V; ++v) {
+    MPConstraint* assign = solver->MakeRowConstraint(1.0, 1.0);
+    for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+      x[k] = solver->MakeBoolVar("");
+      assign->SetCoefficient(x[k], 1.0);
+      sat_time[g.sat[k]]->SetCoefficient(x[k], -g.time[k]);
+    }
+  }
+  MPObjective* objective = solver->MutableObjective();
+  objective->SetCoefficient(T, 1.0);
+  objective->SetMinimization();
+
+  // MPSolver has no callbacks for CBC, so it runs in rounds of doubling
+  // length, each starting from the incumbent and only looking below it
+  std::shared_ptr<const Solution> hinted;
+  std::vector<std::pair<const MPVariable*, double>> hint;
+  std::vector<int> assignment(g.V);
+  for (double round_ms = 1000; !shared.Stopped(); round_ms *= 2) {
+    std::shared_ptr<const Solution> best = shared.incumbent.Get();
+    if (best && best != hinted) {
+      hint.clear();
+      for (int v = 0; v < g.V; ++v) {
+        for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+          hint.push_back({x[k], g.sat[k] == best->assignment[v] ? 1.0 : 0.0});
+        }
+      }
+      hint.push_back({T, best->makespan});
+      solver->SetHint(hint);
+      T->SetUB(best->makespan * (1 + 1e-9));
+      hinted = best;
+    }
+    solver->set_time_limit(std::max<int64_t>(1, std::min(round_ms, shared.RemainingMs())));
+    MPSolver::ResultStatus status = solver->Solve();
+    // nothing found within the round
+    if (status == MPSolver::NOT_SOLVED) continue;
+    if (status != MPSolver::OPTIMAL && status != MPSolver::FEASIBLE) return;
+
+    for (int v = 0; v < g.V; ++v) {
+      for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+        if (x[k]->solution_value() > 0.5) assignment[v] = g.sat[k];
+      }
+    }
+    shared.Offer(CBC, assignment);
+    if (status == MPSolver::OPTIMAL) {
+      shared.RaiseBound(T->solution_value());
+      return;
+    }
+  }
+}
+#endif
+
+int main(int argc, char** argv) {
+  const char* graph_file = (argc > 1 ? argv[1] : "BasicExample/src/network.graph");
+  const char* out_file = (argc > 2 ? argv[2] : "BasicExample/src/network.portfolio.out");
+  double budget = (argc > 3 ? std::stod(argv[3]) : 10.0);  // seconds
+  int threads = (argc > 4 ? std::stoi(argv[4]) : (int)std::thread::hardware_concurrency());
+
+  Shared shared;
+  shared.start = Clock::now();
+  shared.deadline = shared.start + std::chrono::duration_cast<Clock::duration>(
+                                       std::chrono::duration<double>(budget));
+  NetworkGraph graph;
+  std::string error;
+  if (!LoadNetworkGraph(graph_file, graph, &error)) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+  makespan::Graph g;
+  int missing;
+  if (!makespan::BuildGraph(graph, g, missing)) {
+    std::cerr << "No valid link for station " << missing << std::endl;
+    return 1;
+  }
+  shared.graph = &graph;
+  shared.g = &g;
+  // also the bound when there is no thread for the LP rounding
+  shared.RaiseBound(makespan::SimpleBound(g));
+
+  // greedy, LP rounding and CBC get a thread each while there are enough,
+  // every thread goes on with the local search
+  std::vector<void (*)(Shared&)> backends = {RunGreedy, RunLpRounding};
+#ifdef WITH_ORTOOLS
+  backends.push_back(RunCbc);
+#endif
+  std::vector<std::thread> workers;
+  for (int i = 0; i < std::max(1, threads); ++i) {
+    void (*backend)(Shared&) = i < (int)backends.size() ? backends[i] : nullptr;
+    workers.emplace_back([&shared, backend, i]() {
+      if (backend) backend(shared);
+      RunLocalSearch(shared, 1u + i);
+    });
+  }
+
+  // Report every new incumbent until the budget runs out or the incumbent
+  // meets the lower bound
+  std::shared_ptr<const Solution> reported;
+  for (;;) {
+    std::shared_ptr<const Solution> best = shared.incumbent.Get();
+    if (best && best != reported) {
+      std::cout << best->seconds << " s: T=" << best->makespan << " by "
+                << kBackendNames[best->backend] << std::endl;
+      reported = best;
+    }
+    if (best && best->makespan <= shared.bound.load() * (1 + 1e-9)) break;
+    if (Clock::now() >= shared.deadline) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  shared.stop = true;
+  for (std::thread& worker : workers) worker.join();
+
+  std::shared_ptr<const Solution> best = shared.incumbent.Get();
+  std::vector<double> sat_time = makespan::Loads(g, best->assignment);
+  double T = *std::max_element(sat_time.begin(), sat_time.end());
+
+  // Write the .out file
+  std::ofstream outfile(out_file);
+  outfile << T << std::endl;
+  // ground_station_id satellite_id
+  for (int v = 0; v < g.V; ++v) {
+    outfile << v << " " << best->assignment[v] << std::endl;
+  }
+  // satellite_id data_collection_time
+  for (int s = 0; s < g.S; ++s) {
+    outfile << s << " " << sat_time[s] << std::endl;
+  }
+  outfile.close();
+
+  double bound = shared.bound.load();
+  std::cout << out_file << " generated with T=" << T << " by " << kBackendNames[best->backend]
+            << " after " << best->seconds << " s" << std::endl;
+  std::cout << "lower bound=" << bound << " (gap " << 100.0 * (T / bound - 1) << "%), "
+            << workers.size() << " threads" << std::endl;
+  return 0;
+}
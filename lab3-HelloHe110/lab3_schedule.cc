@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "network_graph.h"
+#include "incremental_assignment.h"
+#include "epoch_schedule.h"
+
+// Collection schedule over one graph per epoch, e.g. from
+// graph_generate --epochs. Writes the transfers for the schedule mode of
+// leo-lab4.cc and compares the collection time with what the snapshot
+// assignment of the first epoch would need if the links stayed as they are.
+
+int main(int argc, char** argv) {
+  EpochScheduler::Options options;
+  std::string out_file = "BasicExample/src/network.schedule";
+  std::vector<std::string> epochs;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    std::string::size_type eq = arg.find('=');
+    std::string key = arg.substr(0, eq), value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    if (key == "--epoch-s") {
+      options.epoch = std::stod(value);
+    } else if (key == "--capacity-s") {
+      options.capacity = std::stod(value);
+    } else if (key == "--handover-s") {
+      options.handover = std::stod(value);
+    } else if (key == "--data") {
+      options.data = std::stod(value);
+    } else if (key == "--horizon") {
+      options.horizon = std::max(1, std::stoi(value));
+    } else if (key == "--out") {
+      out_file = value;
+    } else {
+      epochs.push_back(arg);
+    }
+  }
+  if (epochs.empty()) epochs.push_back("BasicExample/src/network.graph");
+
+  // Only the graphs of the current window are loaded
+  std::deque<std::unique_ptr<Epoch>> window;
+  std::size_t loaded = 0;
+  auto load = [&]() {
+    NetworkGraph graph;
+    std::string error;
+    if (!LoadNetworkGraph(epochs[loaded].c_str(), graph, &error)) {
+      std::cerr << error << std::endl;
+      return false;
+    }
+    window.emplace_back(new Epoch(MakeEpoch(graph)));
+    ++loaded;
+    return true;
+  };
+  if (!load()) return 1;
+  const int V = window[0]->V;
+
+  // Snapshot assignment of the first epoch, each satellite sending its
+  // stations one after the other
+  std::vector<double> snapshot_start(V), snapshot_end(V);
+  std::vector<int> snapshot_sat;
+  double snapshot_T;
+  {
+    NetworkGraph graph;
+    LoadNetworkGraph(epochs[0].c_str(), graph);
+    IncrementalAssignment assignment;
+    assignment.Load(graph);
+    assignment.Resolve();
+    snapshot_sat = assignment.Assignment();
+    snapshot_T = assignment.Makespan() * options.data / 1000;
+    std::vector<double> busy(graph.S, 0.0);
+    for (int v = 0; v < V; ++v) {
+      int s = snapshot_sat[v];
+      if (s < 0) continue;
+      snapshot_start[v] = busy[s];
+      busy[s] += options.data / window[0]->Rate(v, s);
+      snapshot_end[v] = busy[s];
+    }
+  }
+  int cut = 0;
+  std::vector<char> is_cut(V, 0);
+  auto check_snapshot = [&](const Epoch& e, int k) {
+    // transfers of the snapshot running while their link is gone
+    double from = k * options.epoch, to = from + options.epoch;
+    for (int v = 0; v < V; ++v) {
+      int s = snapshot_sat[v];
+      if (s < 0 || is_cut[v] || snapshot_start[v] >= to || snapshot_end[v] <= from) continue;
+      if (e.Rate(v, s) <= 0) {
+        is_cut[v] = 1;
+        ++cut;
+      }
+    }
+  };
+  check_snapshot(*window[0], 0);
+
+  auto start = std::chrono::steady_clock::now();
+  EpochScheduler scheduler(V, options);
+  while (!scheduler.Done() && (!window.empty() || loaded < epochs.size())) {
+    while ((int)window.size() < options.horizon && loaded < epochs.size()) {
+      if (!load()) return 1;
+      check_snapshot(*window.back(), loaded - 1);
+    }
+    std::vector<const Epoch*> view;
+    for (const auto& e : window) view.push_back(e.get());
+    scheduler.Step(view);
+    window.pop_front();
+  }
+  std::chrono::duration<double, std::milli> solve_ms = std::chrono::steady_clock::now() - start;
+  // the snapshot may take longer than the schedule
+  while (loaded < epochs.size() && loaded * options.epoch < snapshot_T) {
+    if (!load()) return 1;
+    check_snapshot(*window.back(), loaded - 1);
+    window.pop_front();
+  }
+
+  // Write the schedule: T, then one transfer per line in order of start,
+  // station satellite start end data(kbit) rate(kbps)
+  std::vector<EpochTransfer> transfers = scheduler.Transfers();
+  std::stable_sort(transfers.begin(), transfers.end(),
+                   [](const EpochTransfer& a, const EpochTransfer& b) { return a.start < b.start; });
+  double T = scheduler.CompletionTime();
+  std::ofstream outfile(out_file);
+  outfile.precision(10);
+  outfile << T << std::endl;
+  for (const EpochTransfer& t : transfers) {
+    outfile << t.station << " " << t.satellite << " " << t.start << " " << t.end << " " << t.data
+            << " " << t.rate << std::endl;
+  }
+  outfile.close();
+
+  if (!scheduler.Done()) {
+    std::cerr << scheduler.Unfinished() << " stations still have data after " << scheduler.Epochs()
+              << " epochs" << std::endl;
+    return 1;
+  }
+  std::cout << out_file << " generated with T=" << T << " s, " << transfers.size() << " transfers, "
+            << scheduler.Handovers() << " handovers over " << scheduler.Epochs() << " epochs in "
+            << solve_ms.count() << " ms" << std::endl;
+  std::cout << "snapshot assignment of the first epoch: T=" << snapshot_T << " s, " << cut << " of "
+            << V << " transfers lose their link" << std::endl;
+  return 0;
+}
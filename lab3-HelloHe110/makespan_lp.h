@@ -0,0 +1,430 @@
+#ifndef MAKESPAN_LP_H
+#define MAKESPAN_LP_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "network_graph.h"
+#include "bottleneck_search.h"
+
+// Min-makespan assignment of ground stations to satellites without a MILP
+// solver. T is binary searched; for each guess the LP relaxation restricted
+// to links no longer than T is either solved approximately or proven
+// infeasible by a dual certificate. Fractional solutions are rounded like
+// Lenstra-Shmoys-Tardos (each satellite exceeds T by at most one job, so
+// the result is within 2 + kEps times the smallest feasible guess) and
+// polished by local search. Only a certificate raises the lower bound; a
+// guess that is neither solved nor disproven moves the search above it, so
+// the result is within 2 + kEps times the optimum when the search closes in
+// on the bound, and within that times their remaining ratio otherwise.
+// Shared by lab3_makespan.cc and lab3_portfolio.cc.
+
+namespace makespan {
+
+// Links of all stations, sorted by satellite within each station
+struct Graph {
+  int V, S;
+  std::vector<int> begin;   // first link of each station, V + 1 entries
+  std::vector<int> sat;     // satellite of each link
+  std::vector<double> time; // time for one data unit over each link
+};
+
+enum Result { FEASIBLE, INFEASIBLE, UNKNOWN };
+
+const double kEps = 0.02;     // accepted overload of a fractional solution
+const int kMaxSweeps = 200;
+
+typedef std::chrono::steady_clock Clock;
+const Clock::time_point kNoDeadline = Clock::time_point::max();
+
+// Time of station v on satellite s, or infinity if there is no link
+inline double LinkTime(const Graph& g, int v, int s) {
+  auto first = g.sat.begin() + g.begin[v];
+  auto last = g.sat.begin() + g.begin[v + 1];
+  auto it = std::lower_bound(first, last, s);
+  if (it == last || *it != s) return std::numeric_limits<double>::infinity();
+  return g.time[it - g.sat.begin()];
+}
+
+// Links of a loaded graph with a positive rate. Fails on the first station
+// without any, returned in missing.
+inline bool BuildGraph(const NetworkGraph& graph, Graph& g, int& missing) {
+  g.V = graph.V;
+  g.S = graph.S;
+  g.begin.assign(1, 0);
+  g.sat.clear();
+  g.time.clear();
+  std::vector<std::pair<int, double>> links;
+  for (int v = 0; v < g.V; ++v) {
+    links.clear();
+    for (uint32_t k = graph.begin[v]; k < graph.begin[v + 1]; ++k) {
+      if (graph.rate[k] > 0) links.emplace_back(graph.sat[k], 1000.0 / graph.rate[k]);
+    }
+    if (links.empty()) {
+      missing = v;
+      return false;
+    }
+    std::sort(links.begin(), links.end());
+    for (const auto& link : links) {
+      g.sat.push_back(link.first);
+      g.time.push_back(link.second);
+    }
+    g.begin.push_back(g.sat.size());
+  }
+  return true;
+}
+
+// Try to find fractional x over the links no longer than T with every
+// satellite loaded at most (1 + kEps) T. The potential sum_s exp(alpha *
+// load_s / T) is lowered one station at a time: its share moves towards its
+// cheapest link under the weights exp(alpha * load_s / T) by an exact line
+// search, which only touches the satellites of that station. The normalized
+// weights are dual multipliers; if every station on its cheapest link under
+// them costs more than T in total, no fractional solution within T exists.
+// The best such dual value is returned in dual, as a fraction of T. Gives
+// up with UNKNOWN once the deadline has passed.
+inline Result Feasible(const Graph& g, double T, std::vector<double>& x, double& dual,
+                       Clock::time_point deadline = kNoDeadline) {
+  const int V = g.V, S = g.S;
+  const double alpha = 2 * std::log((double)S + 1) / kEps;
+  std::vector<double> load(S, 0.0), lambda(S);
+  x.assign(g.sat.size(), 0.0);
+  dual = 0;
+
+  // start on the fastest allowed link of each station
+  for (int v = 0; v < V; ++v) {
+    int best = -1;
+    for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+      if (g.time[k] <= T && (best < 0 || g.time[k] < g.time[best])) best = k;
+    }
+    if (best < 0) return INFEASIBLE;
+    x[best] = 1.0;
+    load[g.sat[best]] += g.time[best] / T;
+  }
+
+  for (int sweep = 0; sweep < kMaxSweeps; ++sweep) {
+    double m = *std::max_element(load.begin(), load.end());
+    if (m <= 1 + kEps) return FEASIBLE;
+    if (Clock::now() >= deadline) return UNKNOWN;
+
+    // dual value of the current weights
+    double sum = 0;
+    for (int s = 0; s < S; ++s) {
+      lambda[s] = std::exp(alpha * (load[s] - m));
+      sum += lambda[s];
+    }
+    double value = 0;
+    for (int v = 0; v < V; ++v) {
+      double cost = std::numeric_limits<double>::infinity();
+      for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+        if (g.time[k] <= T) cost = std::min(cost, lambda[g.sat[k]] * g.time[k]);
+      }
+      value += cost / (sum * T);
+    }
+    dual = std::max(dual, value);
+    if (value > 1 + 1e-9) return INFEASIBLE;
+
+    for (int v = 0; v < V; ++v) {
+      if (v % 1024 == 0 && Clock::now() >= deadline) return UNKNOWN;
+      int target = -1;
+      double cost = std::numeric_limits<double>::infinity(), current = 0;
+      for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+        if (g.time[k] > T) continue;
+        double c = std::exp(alpha * (load[g.sat[k]] - m)) * g.time[k];
+        current += x[k] * c;
+        if (c < cost) {
+          cost = c;
+          target = k;
+        }
+      }
+      if (cost >= current * (1 - 1e-12)) continue;
+
+      // derivative of the potential of the station's satellites after
+      // moving a share of d towards the target
+      auto slope = [&](double d) {
+        double total = 0;
+        for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+          double change = ((k == target) - x[k]) * g.time[k] / T;
+          if (change == 0) continue;
+          total += change * std::exp(alpha * (load[g.sat[k]] + d * change - m));
+        }
+        return total;
+      };
+      double d = 1;
+      if (slope(1) > 0) {
+        double lo = 0, hi = 1;
+        for (int i = 0; i < 30; ++i) {
+          double mid = (lo + hi) / 2;
+          if (slope(mid) > 0) hi = mid; else lo = mid;
+        }
+        d = (lo + hi) / 2;
+      }
+      for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+        double share = (1 - d) * x[k] + (k == target ? d : 0);
+        load[g.sat[k]] += (share - x[k]) * g.time[k] / T;
+        x[k] = share;
+      }
+    }
+  }
+  double m = *std::max_element(load.begin(), load.end());
+  return m <= 1 + kEps ? FEASIBLE : UNKNOWN;
+}
+
+// Round fractional x: the stations on each satellite, longest first, fill
+// ceil(sum x) slots of size one, and a perfect matching of stations to the
+// slots they touch picks one satellite per station. Returns no assignment
+// if the deadline passes first.
+inline std::vector<int> Round(const Graph& g, const std::vector<double>& x,
+                              Clock::time_point deadline = kNoDeadline) {
+  const int V = g.V, S = g.S;
+  std::vector<std::vector<std::pair<double, int>>> on(S); // (time, link)
+  for (int v = 0; v < V; ++v) {
+    for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+      if (x[k] > 1e-9) on[g.sat[k]].push_back({g.time[k], k});
+    }
+  }
+
+  std::vector<int> station_of_link(g.sat.size());
+  for (int v = 0; v < V; ++v) {
+    for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) station_of_link[k] = v;
+  }
+
+  std::vector<std::vector<int>> edges(V);
+  std::vector<int> slot_sat;
+  for (int s = 0; s < S; ++s) {
+    std::sort(on[s].begin(), on[s].end(), std::greater<std::pair<double, int>>());
+    double fill = 0;
+    int slot = -1;
+    for (const auto& entry : on[s]) {
+      int k = entry.second;
+      double amount = x[k];
+      if (slot < 0 || fill >= 1 - 1e-9) {
+        slot = slot_sat.size();
+        slot_sat.push_back(s);
+        fill = 0;
+      }
+      edges[station_of_link[k]].push_back(slot);
+      fill += amount;
+      if (fill > 1 + 1e-9) {
+        // the rest spills into the next slot
+        slot = slot_sat.size();
+        slot_sat.push_back(s);
+        fill -= 1;
+        edges[station_of_link[k]].push_back(slot);
+      }
+    }
+  }
+
+  // Hopcroft-Karp
+  const int N = slot_sat.size();
+  const int kFree = -1;
+  std::vector<int> match_v(V, kFree), match_slot(N, kFree), dist(V);
+  auto bfs = [&]() {
+    std::queue<int> q;
+    bool found = false;
+    for (int v = 0; v < V; ++v) {
+      if (match_v[v] == kFree) {
+        dist[v] = 0;
+        q.push(v);
+      } else {
+        dist[v] = -1;
+      }
+    }
+    while (!q.empty()) {
+      int v = q.front();
+      q.pop();
+      for (int slot : edges[v]) {
+        int w = match_slot[slot];
+        if (w == kFree) {
+          found = true;
+        } else if (dist[w] < 0) {
+          dist[w] = dist[v] + 1;
+          q.push(w);
+        }
+      }
+    }
+    return found;
+  };
+  std::vector<std::size_t> next(V);
+  // iterative augmenting path search along the BFS layers
+  auto augment = [&](int root) {
+    std::vector<int> path(1, root);
+    while (!path.empty()) {
+      int v = path.back();
+      if (next[v] == edges[v].size()) {
+        dist[v] = -1;
+        path.pop_back();
+        continue;
+      }
+      int slot = edges[v][next[v]++];
+      int w = match_slot[slot];
+      if (w == kFree) {
+        // flip the path
+        for (int i = path.size() - 1; i >= 0; --i) {
+          int u = path[i];
+          int taken = edges[u][next[u] - 1];
+          match_v[u] = taken;
+          match_slot[taken] = u;
+        }
+        return true;
+      }
+      if (dist[w] == dist[v] + 1) path.push_back(w);
+    }
+    return false;
+  };
+  while (bfs()) {
+    std::fill(next.begin(), next.end(), 0);
+    for (int v = 0; v < V; ++v) {
+      if (v % 1024 == 0 && Clock::now() >= deadline) return std::vector<int>();
+      if (match_v[v] == kFree) augment(v);
+    }
+  }
+
+  std::vector<int> assignment(V);
+  for (int v = 0; v < V; ++v) {
+    if (match_v[v] != kFree) {
+      assignment[v] = slot_sat[match_v[v]];
+    } else {
+      // only left over by rounding noise, take the fastest link
+      int best = g.begin[v];
+      for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) {
+        if (g.time[k] < g.time[best]) best = k;
+      }
+      assignment[v] = g.sat[best];
+    }
+  }
+  return assignment;
+}
+
+// Collection time of every satellite
+inline std::vector<double> Loads(const Graph& g, const std::vector<int>& assignment) {
+  std::vector<double> sat_time(g.S, 0.0);
+  for (int v = 0; v < g.V; ++v) sat_time[assignment[v]] += LinkTime(g, v, assignment[v]);
+  return sat_time;
+}
+
+inline double Makespan(const Graph& g, const std::vector<int>& assignment) {
+  std::vector<double> sat_time = Loads(g, assignment);
+  return *std::max_element(sat_time.begin(), sat_time.end());
+}
+
+// Links of g for the local search of bottleneck_search.h
+inline BottleneckSearch Search(const Graph& g) {
+  BottleneckSearch search;
+  search.Resize(g.V, g.S);
+  for (int v = 0; v < g.V; ++v) {
+    for (int k = g.begin[v]; k < g.begin[v + 1]; ++k) search.SetLink(v, g.sat[k], g.time[k]);
+  }
+  return search;
+}
+
+// Moves, swaps and chains of moves on the bottleneck satellite of
+// bottleneck_search.h while they lower it. Stops early at the deadline.
+inline void Polish(const Graph& g, std::vector<int>& assignment,
+                   Clock::time_point deadline = kNoDeadline) {
+  BottleneckSearch search = Search(g);
+  for (int v = 0; v < g.V; ++v) search.Insert(v, assignment[v]);
+  search.Improve(deadline);
+  assignment = search.Assignment();
+}
+
+// The longest fastest link of a station, or all fastest links spread
+// evenly over the satellites
+inline double SimpleBound(const Graph& g) {
+  double lower = 0.0, total = 0.0;
+  for (int v = 0; v < g.V; ++v) {
+    double fastest = *std::min_element(g.time.begin() + g.begin[v], g.time.begin() + g.begin[v + 1]);
+    lower = std::max(lower, fastest);
+    total += fastest;
+  }
+  return std::max(lower, total / g.S);
+}
+
+// Longest fastest link first, each station on the satellite where it
+// finishes earliest, then polished: the assignment of lab3_greedy.cc
+inline std::vector<int> Greedy(const Graph& g) {
+  BottleneckSearch search = Search(g);
+  std::vector<int> order(g.V);
+  for (int v = 0; v < g.V; ++v) order[v] = v;
+  search.PlaceLongestFirst(order);
+  std::vector<int> assignment = search.Assignment();
+  Polish(g, assignment);
+  return assignment;
+}
+
+// Binary search on T. A fractional solution within T only exists if the
+// optimum is at least min(T, dual value), so every guess yields a lower
+// bound, and a disproven guess raises it to T. An undecided guess leaves
+// the bound alone and the search goes on above it. The search starts between
+// SimpleBound, which no T below the slowest station's fastest link can
+// pass, and the greedy assignment, and returns the better of that and the
+// rounded assignments with its lower bound and the number of guesses.
+inline std::vector<int> Solve(const Graph& g, double& bound, int& guesses) {
+  double lower = SimpleBound(g);
+  std::vector<int> best = Greedy(g);
+  double upper = Makespan(g, best);
+
+  bound = lower;
+  guesses = 0;
+  // the guesses go on above the bound and the last undecided one
+  double undecided = lower, hi = upper;
+  std::vector<double> x;
+  while (hi > std::max(bound, undecided) * (1 + 1e-3) && guesses < 40) {
+    double T = (std::max(bound, undecided) + hi) / 2;
+    double dual;
+    ++guesses;
+    Result result = Feasible(g, T, x, dual);
+    bound = std::max(bound, std::min(T, dual * T));
+    if (result == FEASIBLE) {
+      std::vector<int> assignment = Round(g, x);
+      Polish(g, assignment);
+      double makespan = Makespan(g, assignment);
+      if (makespan < upper) {
+        upper = makespan;
+        best = assignment;
+      }
+      hi = T;
+    } else if (result == INFEASIBLE) {
+      bound = std::max(bound, T);
+    } else {
+      undecided = T;
+    }
+  }
+  bound = std::min(bound, upper);
+  return best;
+}
+
+// Only the lower bound of the binary search of Solve below a known
+// makespan, without rounding, for at most the given number of seconds
+inline double LowerBound(const Graph& g, double upper, double seconds) {
+  Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                                  std::chrono::duration<double>(seconds));
+  double bound = SimpleBound(g);
+  double undecided = bound, hi = upper;
+  std::vector<double> x;
+  for (int guesses = 0; hi > std::max(bound, undecided) * (1 + 1e-3) && guesses < 40; ++guesses) {
+    if (Clock::now() >= deadline) break;
+    double T = (std::max(bound, undecided) + hi) / 2;
+    double dual;
+    Result result = Feasible(g, T, x, dual, deadline);
+    bound = std::max(bound, std::min(T, dual * T));
+    if (result == FEASIBLE) {
+      hi = T;
+    } else if (result == INFEASIBLE) {
+      bound = std::max(bound, T);
+    } else {
+      undecided = T;
+    }
+  }
+  return std::min(bound, upper);
+}
+
+}  // namespace makespan
+
+#endif  // MAKESPAN_LP_H
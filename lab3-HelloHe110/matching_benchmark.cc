@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "weighted_matching.h"
+#ifdef WITH_ORTOOLS
+#include "ortools/linear_solver/linear_solver.h"
+#endif
+
+// Solve times of the matching engines on random station-to-beam instances
+// of growing size: every left node has kDegree edges to random right nodes
+// with weights 1 to 10000, ten left nodes per right node. The Hungarian
+// method only runs while the dense matrix is small, CBC (built with
+// -DWITH_ORTOOLS) only up to kMaxCbcEdges. All engines must agree on the
+// optimal weight.
+
+const int kDegree = 10;
+const int kMaxHungarianLeft = 2000;
+const std::size_t kMaxCbcEdges = 200000;
+
+static int64_t Weight(const std::vector<WeightedEdge>& edges, int left_num, const std::vector<int>& match) {
+  // best edge of each matched pair, the generator may repeat pairs
+  std::vector<std::vector<std::pair<int, int64_t>>> adj(left_num);
+  for (const WeightedEdge& e : edges) adj[e.left].push_back({e.right, e.weight});
+  int64_t total = 0;
+  for (int i = 0; i < left_num; ++i) {
+    if (match[i] < 0) continue;
+    int64_t best = 0;
+    for (const auto& link : adj[i]) {
+      if (link.first == match[i]) best = std::max(best, link.second);
+    }
+    total += best;
+  }
+  return total;
+}
+
+#ifdef WITH_ORTOOLS
+static std::vector<int> CbcMatching(int left_num, int right_num, const std::vector<WeightedEdge>& edges) {
+  using namespace operations_research;
+  std::unique_ptr<MPSolver> solver(MPSolver::CreateSolver("CBC_MIXED_INTEGER_PROGRAMMING"));
+  std::vector<MPConstraint*> left(left_num), right(right_num);
+  for (int i = 0; i < left_num; ++i) left[i] = solver->MakeRowConstraint(0.0, 1.0);
+  for (int j = 0; j < right_num; ++j) right[j] = solver->MakeRowConstraint(0.0, 1.0);
+  MPObjective* objective = solver->MutableObjective();
+  std::vector<MPVariable*> x(edges.size());
+  for (std::size_t k = 0; k < edges.size(); ++k) {
+    x[k] = solver->MakeBoolVar("");
+    left[edges[k].left]->SetCoefficient(x[k], 1.0);
+    right[edges[k].right]->SetCoefficient(x[k], 1.0);
+    objective->SetCoefficient(x[k], edges[k].weight);
+  }
+  objective->SetMaximization();
+  std::vector<int> match(left_num, -1);
+  if (solver->Solve() != MPSolver::OPTIMAL) return match;
+  for (std::size_t k = 0; k < edges.size(); ++k) {
+    if (x[k]->solution_value() > 0.5) match[edges[k].left] = edges[k].right;
+  }
+  return match;
+}
+#endif
+
+int main(int argc, char** argv) {
+  int max_left = (argc > 1 ? std::stoi(argv[1]) : 100000);
+  int threads = (argc > 2 ? std::stoi(argv[2]) : (int)std::thread::hardware_concurrency());
+  std::mt19937 rng(1);
+
+  std::cout << "left,right,edges,engine,threads,ms,weight" << std::endl;
+  for (int left_num = 100; left_num <= max_left; left_num *= 10) {
+    int right_num = std::max(1, left_num / 10);
+    std::vector<WeightedEdge> edges;
+    for (int i = 0; i < left_num; ++i) {
+      for (int k = 0; k < kDegree; ++k) {
+        edges.push_back({i, (int)(rng() % right_num), (int64_t)(1 + rng() % 10000)});
+      }
+    }
+    auto report = [&](const char* engine, int used, const std::vector<int>& match, double ms) {
+      std::cout << left_num << "," << right_num << "," << edges.size() << "," << engine << ","
+                << used << "," << ms << "," << Weight(edges, left_num, match) << std::endl;
+    };
+    auto time = [](auto&& solve, std::vector<int>& match) {
+      auto start = std::chrono::steady_clock::now();
+      match = solve();
+      return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::vector<int> match;
+    double ms = time([&]() { return AuctionMatching(left_num, right_num, edges, 1); }, match);
+    report("auction", 1, match, ms);
+    if (threads > 1) {
+      ms = time([&]() { return AuctionMatching(left_num, right_num, edges, threads); }, match);
+      report("auction", threads, match, ms);
+    }
+    if (left_num <= kMaxHungarianLeft) {
+      std::vector<std::vector<int64_t>> dense(left_num, std::vector<int64_t>(right_num, 0));
+      for (const WeightedEdge& e : edges) dense[e.left][e.right] = std::max(dense[e.left][e.right], e.weight);
+      ms = time([&]() { return HungarianMatching(dense); }, match);
+      report("hungarian", 1, match, ms);
+    }
+#ifdef WITH_ORTOOLS
+    if (edges.size() <= kMaxCbcEdges) {
+      ms = time([&]() { return CbcMatching(left_num, right_num, edges); }, match);
+      report("cbc", 1, match, ms);
+    }
+#endif
+  }
+  return 0;
+}
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "network_graph.h"
+#include "makespan_lp.h"
+
+// Run the assignment solvers on a set of graphs, each in its own process
+// and scratch directory under a time limit, and print one CSV line per run:
+// wall time, peak RSS, the makespan T of the written .out file and its gap
+// to the LP lower bound of makespan_lp.h, searched below the best T of all
+// runs for at most the same time limit. T is recomputed from the graph,
+// so a run only counts as ok if every station is on one of its links.
+// Solvers whose binary is missing in --bin are skipped.
+
+namespace fs = std::filesystem;
+
+struct Solver {
+  const char* name;
+  const char* binary;
+  // {graph}, {out}, {budget} (seconds) and {threads} are filled in
+  std::vector<std::string> args;
+  // output file, relative to the scratch directory
+  const char* out;
+};
+
+static const std::vector<Solver> kSolvers = {
+    {"greedy", "lab3_greedy", {"{graph}", "none"}, "BasicExample/src/network.greedy.out"},
+    {"makespan", "lab3_makespan", {"{graph}", "{out}"}, "network.out"},
+    {"portfolio", "lab3_portfolio", {"{graph}", "{out}", "{budget}", "{threads}"}, "network.out"},
+    {"incremental", "lab3_incremental", {"{graph}"}, "network.incremental.out"},
+    {"ortools", "lab3_ortools", {"{graph}"}, "BasicExample/src/network.ortools.out"},
+    {"cpsat", "lab3_cpsat", {"{graph}", "{out}", "{threads}", "{budget}"}, "network.out"},
+};
+
+struct Run {
+  std::string status;
+  double wall = 0;  // s
+  long peak_rss = 0;  // KiB
+  double T = 0;
+};
+
+// Makespan of the assignment in out, 0 if it is not a valid one
+static double CheckOutput(const fs::path& out, const NetworkGraph& graph) {
+  std::ifstream in(out);
+  double reported;
+  if (!(in >> reported)) return 0;
+  std::vector<int> sat(graph.V, -1);
+  std::vector<double> load(graph.S, 0.0);
+  for (int i = 0; i < graph.V; ++i) {
+    int v, s;
+    if (!(in >> v >> s) || v < 0 || v >= graph.V || sat[v] >= 0) return 0;
+    double rate = s >= 0 && s < graph.S ? graph.Rate(v, s) : 0.0;
+    if (rate <= 0) return 0;
+    sat[v] = s;
+    load[s] += 1000.0 / rate;
+  }
+  return *std::max_element(load.begin(), load.end());
+}
+
+static Run Execute(const Solver& solver, const fs::path& binary, const fs::path& graph_path,
+                   const NetworkGraph& graph, const fs::path& dir, double timeout, int threads) {
+  fs::remove_all(dir);
+  fs::create_directories(dir / "BasicExample/src");
+  fs::create_symlink(graph_path, dir / "network.graph");
+
+  std::vector<std::string> args = {binary.string()};
+  for (std::string arg : solver.args) {
+    if (arg == "{graph}") arg = "network.graph";
+    if (arg == "{out}") arg = solver.out;
+    if (arg == "{budget}") arg = std::to_string(std::max(1.0, timeout * 0.75));
+    if (arg == "{threads}") arg = std::to_string(threads);
+    args.push_back(arg);
+  }
+  std::vector<char*> argv;
+  for (std::string& arg : args) argv.push_back(&arg[0]);
+  argv.push_back(nullptr);
+
+  Run run;
+  auto start = std::chrono::steady_clock::now();
+  pid_t pid = fork();
+  if (pid < 0) {
+    run.status = "failed";
+    return run;
+  }
+  if (pid == 0) {
+    // own process group, so that a timeout also stops its children
+    setpgid(0, 0);
+    if (chdir(dir.c_str()) != 0) _exit(127);
+    int log = open("solver.log", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (log >= 0) {
+      dup2(log, 1);
+      dup2(log, 2);
+    }
+    execv(argv[0], argv.data());
+    _exit(127);
+  }
+  setpgid(pid, pid);
+
+  int status = 0;
+  struct rusage usage = {};
+  bool timed_out = false;
+  for (;;) {
+    pid_t done = wait4(pid, &status, WNOHANG, &usage);
+    if (done == pid || (done < 0 && errno != EINTR)) break;
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (!timed_out && elapsed.count() > timeout) {
+      kill(-pid, SIGKILL);
+      timed_out = true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  run.wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  run.peak_rss = usage.ru_maxrss;
+
+  if (timed_out) {
+    run.status = "timeout";
+  } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    run.status = "failed";
+  } else {
+    run.T = CheckOutput(dir / solver.out, graph);
+    run.status = run.T > 0 ? "ok" : "invalid";
+  }
+  return run;
+}
+
+int main(int argc, char** argv) {
+  double timeout = 60;  // seconds
+  int threads = std::max(1u, std::thread::hardware_concurrency());
+  fs::path bin = ".";
+  fs::path work = fs::temp_directory_path() / "solver_benchmark";
+  std::vector<std::string> only, graphs;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.compare(0, 10, "--timeout=") == 0) {
+      timeout = std::stod(arg.substr(10));
+    } else if (arg.compare(0, 10, "--threads=") == 0) {
+      threads = std::stoi(arg.substr(10));
+    } else if (arg.compare(0, 6, "--bin=") == 0) {
+      bin = arg.substr(6);
+    } else if (arg.compare(0, 7, "--work=") == 0) {
+      work = arg.substr(7);
+    } else if (arg.compare(0, 10, "--solvers=") == 0) {
+      std::istringstream list(arg.substr(10));
+      for (std::string name; std::getline(list, name, ',');) only.push_back(name);
+    } else {
+      graphs.push_back(arg);
+    }
+  }
+  if (graphs.empty()) {
+    std::cerr << "Usage: " << argv[0] << " [--timeout=60] [--threads=N] [--bin=.] [--work=DIR]"
+              << " [--solvers=greedy,makespan,...] graph..." << std::endl;
+    return 1;
+  }
+
+  std::vector<std::pair<const Solver*, fs::path>> solvers;
+  for (const Solver& solver : kSolvers) {
+    if (!only.empty() && std::find(only.begin(), only.end(), solver.name) == only.end()) continue;
+    fs::path binary = fs::absolute(bin / solver.binary);
+    if (access(binary.c_str(), X_OK) != 0) {
+      std::cerr << "skipping " << solver.name << ": " << binary.string() << " not found" << std::endl;
+      continue;
+    }
+    solvers.push_back({&solver, binary});
+  }
+
+  std::cout << "graph,stations,satellites,links,solver,status,wall_s,peak_rss_kb,T,bound,gap_percent"
+            << std::endl;
+  for (const std::string& path : graphs) {
+    NetworkGraph graph;
+    std::string error;
+    if (!LoadNetworkGraph(path.c_str(), graph, &error)) {
+      std::cerr << error << std::endl;
+      continue;
+    }
+    makespan::Graph g;
+    int missing;
+    if (!makespan::BuildGraph(graph, g, missing)) {
+      std::cerr << path << ": no valid link for station " << missing << std::endl;
+      continue;
+    }
+
+    std::vector<Run> runs;
+    double best = 0;
+    for (const auto& solver : solvers) {
+      runs.push_back(Execute(*solver.first, solver.second, fs::absolute(path), graph,
+                             work / solver.first->name, timeout, threads));
+      if (runs.back().status == "ok" && (best == 0 || runs.back().T < best)) best = runs.back().T;
+    }
+    // the best makespan found caps the search for the bound
+    double bound = best > 0 ? makespan::LowerBound(g, best, timeout) : makespan::SimpleBound(g);
+
+    for (std::size_t i = 0; i < solvers.size(); ++i) {
+      const Run& run = runs[i];
+      std::cout << path << "," << graph.V << "," << graph.S << "," << graph.Links() << ","
+                << solvers[i].first->name << "," << run.status << "," << run.wall << ","
+                << run.peak_rss << ",";
+      if (run.status == "ok") {
+        std::cout << run.T << "," << bound << "," << 100.0 * (run.T / bound - 1) << std::endl;
+      } else {
+        std::cout << "," << bound << "," << std::endl;
+      }
+    }
+  }
+  fs::remove_all(work);
+  return 0;
+}
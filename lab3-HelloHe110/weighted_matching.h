@@ -0,0 +1,249 @@
+#ifndef WEIGHTED_MATCHING_H
+#define WEIGHTED_MATCHING_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+// Maximum weight bipartite matching without a MILP solver.
+//
+// AuctionMatching runs the auction algorithm with epsilon scaling over a
+// sparse edge list. Every unmatched left node bids for the right node of
+// highest value, weight minus price, raising its price by the margin to the
+// second best plus epsilon. All bids of a round are computed at the same
+// time (Jacobi style) and split over threads, then each right node goes to
+// its highest bidder. Weights are scaled by n + 1, so the last round with
+// epsilon 1 is optimal. Left and right nodes may stay unmatched: the graph
+// is made square with a copy of each side, where left i can pair with its
+// own copy of i and the copies pair with each other along the edges, so
+// every matching extends to a perfect one of the same weight.
+//
+// HungarianMatching is the O(n^3) Hungarian method on a dense matrix, faster
+// for small inputs. MaxWeightMatching takes the weight matrix of
+// lab3_bipartite.cc and picks one of the two.
+
+struct WeightedEdge {
+  int left, right;
+  int64_t weight;
+};
+
+namespace weighted_matching {
+
+// Below this many bidders a round is not worth the threads
+const int kMinParallelBids = 4096;
+// Dense inputs up to this size go to the Hungarian method
+const int kMaxHungarian = 400;
+
+}  // namespace weighted_matching
+
+// Right node matched to each left node, -1 if none. Edges with a weight of
+// at most 0 are never worth taking and are ignored.
+inline std::vector<int> AuctionMatching(int left_num, int right_num,
+                                        const std::vector<WeightedEdge>& edges, int threads = 1) {
+  // Persons are the left nodes, then the copies of the right nodes; objects
+  // are the right nodes, then the copies of the left nodes
+  const int n = left_num + right_num;
+  std::vector<int> begin(n + 1, 0);
+  int64_t max_weight = 0;
+  for (const WeightedEdge& e : edges) {
+    if (e.weight <= 0) continue;
+    ++begin[e.left + 1];              // e.right
+    ++begin[left_num + e.right + 1];  // copy of e.left
+
+    max_weight = std::max(max_weight, e.weight);
+  }
+  for (int i = 0; i < n; ++i) ++begin[i + 1];  // own copy
+  for (int i = 0; i < n; ++i) begin[i + 1] += begin[i];
+  std::vector<int> object(begin[n]);
+  std::vector<int64_t> benefit(begin[n]);
+  std::vector<int> fill(begin.begin(), begin.end() - 1);
+  auto add = [&](int person, int obj, int64_t value) {
+    object[fill[person]] = obj;
+    benefit[fill[person]++] = value;
+  };
+  const int64_t scale = n + 1;
+  for (int i = 0; i < left_num; ++i) add(i, right_num + i, 0);
+  for (int j = 0; j < right_num; ++j) add(left_num + j, j, 0);
+  for (const WeightedEdge& e : edges) {
+    if (e.weight <= 0) continue;
+    add(e.left, e.right, e.weight * scale);
+    add(left_num + e.right, right_num + e.left, 0);
+  }
+
+  std::vector<int64_t> price(n, 0);
+  std::vector<int> owner(n), assigned(n);
+  std::vector<int> bidders, next, bid_object;
+  std::vector<int64_t> bid_price, best_bid(n);
+  std::vector<int> best_bidder(n), touched;
+  std::vector<long long> bid_round(n, -1);
+  long long round = 0;
+
+  // one bid of person i for the current prices
+  auto bid = [&](int i, int& target, int64_t& amount, int64_t eps) {
+    int64_t v1 = std::numeric_limits<int64_t>::min(), v2 = v1;
+    target = -1;
+    for (int k = begin[i]; k < begin[i + 1]; ++k) {
+      int64_t value = benefit[k] - price[object[k]];
+      if (value > v1) {
+        v2 = v1;
+        v1 = value;
+        target = object[k];
+      } else if (value > v2) {
+        v2 = value;
+      }
+    }
+    // nobody else can take an only object, the margin is just eps
+    if (v2 == std::numeric_limits<int64_t>::min()) v2 = v1;
+    amount = price[target] + (v1 - v2) + eps;
+  };
+
+  int64_t eps = std::max<int64_t>(1, max_weight * scale / 8);
+  for (;;) {
+    std::fill(owner.begin(), owner.end(), -1);
+    std::fill(assigned.begin(), assigned.end(), -1);
+    bidders.resize(n);
+    for (int i = 0; i < n; ++i) bidders[i] = i;
+
+    while (!bidders.empty()) {
+      const int m = bidders.size();
+      bid_object.resize(m);
+      bid_price.resize(m);
+      int workers = m >= weighted_matching::kMinParallelBids ? std::max(1, threads) : 1;
+      if (workers == 1) {
+        for (int b = 0; b < m; ++b) bid(bidders[b], bid_object[b], bid_price[b], eps);
+      } else {
+        std::vector<std::thread> pool;
+        for (int w = 0; w < workers; ++w) {
+          pool.emplace_back([&, w]() {
+            for (int b = (long long)m * w / workers; b < (long long)m * (w + 1) / workers; ++b) {
+              bid(bidders[b], bid_object[b], bid_price[b], eps);
+            }
+          });
+        }
+        for (std::thread& t : pool) t.join();
+      }
+
+      // highest bid for every object
+      ++round;
+      touched.clear();
+      for (int b = 0; b < m; ++b) {
+        int j = bid_object[b];
+        if (bid_round[j] != round) {
+          bid_round[j] = round;
+          best_bid[j] = bid_price[b];
+          best_bidder[j] = bidders[b];
+          touched.push_back(j);
+        } else if (bid_price[b] > best_bid[j]) {
+          best_bid[j] = bid_price[b];
+          best_bidder[j] = bidders[b];
+        }
+      }
+      next.clear();
+      for (int b = 0; b < m; ++b) {
+        if (best_bidder[bid_object[b]] != bidders[b]) next.push_back(bidders[b]);
+      }
+      for (int j : touched) {
+        if (owner[j] >= 0) {
+          assigned[owner[j]] = -1;
+          next.push_back(owner[j]);
+        }
+        owner[j] = best_bidder[j];
+        assigned[owner[j]] = j;
+        price[j] = best_bid[j];
+      }
+      bidders.swap(next);
+    }
+    if (eps == 1) break;
+    eps = std::max<int64_t>(1, eps / 4);
+  }
+
+  std::vector<int> match(left_num, -1);
+  for (int i = 0; i < left_num; ++i) {
+    if (assigned[i] < right_num) match[i] = assigned[i];
+  }
+  return match;
+}
+
+// Hungarian method on a dense matrix of weights[left][right]. Entries of at
+// most 0 count as no edge.
+inline std::vector<int> HungarianMatching(const std::vector<std::vector<int64_t>>& weights) {
+  const int left_num = weights.size();
+  const int right_num = left_num ? weights[0].size() : 0;
+  const int n = std::max(left_num, right_num);
+  // minimum cost assignment on the square matrix of -max(w, 0), 1-based
+  auto cost = [&](int i, int j) -> int64_t {
+    if (i > left_num || j > right_num) return 0;
+    return -std::max<int64_t>(0, weights[i - 1][j - 1]);
+  };
+  const int64_t inf = std::numeric_limits<int64_t>::max() / 4;
+  std::vector<int64_t> u(n + 1, 0), v(n + 1, 0), minv(n + 1);
+  std::vector<int> p(n + 1, 0), way(n + 1, 0);
+  std::vector<char> used(n + 1);
+  for (int i = 1; i <= n; ++i) {
+    p[0] = i;
+    int j0 = 0;
+    std::fill(minv.begin(), minv.end(), inf);
+    std::fill(used.begin(), used.end(), 0);
+    do {
+      used[j0] = 1;
+      int i0 = p[j0], j1 = 0;
+      int64_t delta = inf;
+      for (int j = 1; j <= n; ++j) {
+        if (used[j]) continue;
+        int64_t cur = cost(i0, j) - u[i0] - v[j];
+        if (cur < minv[j]) {
+          minv[j] = cur;
+          way[j] = j0;
+        }
+        if (minv[j] < delta) {
+          delta = minv[j];
+          j1 = j;
+        }
+      }
+      for (int j = 0; j <= n; ++j) {
+        if (used[j]) {
+          u[p[j]] += delta;
+          v[j] -= delta;
+        } else {
+          minv[j] -= delta;
+        }
+      }
+      j0 = j1;
+    } while (p[j0] != 0);
+    do {
+      int j1 = way[j0];
+      p[j0] = p[j1];
+      j0 = j1;
+    } while (j0);
+  }
+  std::vector<int> match(left_num, -1);
+  for (int j = 1; j <= right_num; ++j) {
+    int i = p[j];
+    if (i >= 1 && i <= left_num && weights[i - 1][j - 1] > 0) match[i - 1] = j - 1;
+  }
+  return match;
+}
+
+// Weight matrix left[i] to right[j] as in lab3_bipartite.cc, 0 for no edge
+inline std::vector<int> MaxWeightMatching(const std::vector<std::vector<int>>& weights, int threads = 1) {
+  const int left_num = weights.size();
+  const int right_num = left_num ? weights[0].size() : 0;
+  if (std::max(left_num, right_num) <= weighted_matching::kMaxHungarian) {
+    std::vector<std::vector<int64_t>> dense(left_num, std::vector<int64_t>(right_num));
+    for (int i = 0; i < left_num; ++i) {
+      for (int j = 0; j < right_num; ++j) dense[i][j] = weights[i][j];
+    }
+    return HungarianMatching(dense);
+  }
+  std::vector<WeightedEdge> edges;
+  for (int i = 0; i < left_num; ++i) {
+    for (int j = 0; j < right_num; ++j) {
+      if (weights[i][j] > 0) edges.push_back({i, j, weights[i][j]});
+    }
+  }
+  return AuctionMatching(left_num, right_num, edges, threads);
+}
+
+#endif  // WEIGHTED_MATCHING_H
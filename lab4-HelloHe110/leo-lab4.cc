@@ -2,6 +2,9 @@
 #include <fstream>
 #include <map>
 #include <queue>
+#include <deque>
+#include <set>
+#include <sstream>
 
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
@@ -12,6 +15,7 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/leo-module.h"
+#include "ns3/network-graph.h"
 
 using namespace ns3;
 using namespace std;
@@ -22,7 +26,7 @@ NodeContainer groundStations;
 NetDeviceContainer utNet;
 ApplicationContainer sinkApps;
 
-map<pair<int, int>, string> linkRates;
+NetworkGraph linkRates;
 map<int, vector<int>> satToGsQueue;
 map<int, vector<int>> assocMap;
 map<int, double> gsStartTime, gsEndTime;
@@ -30,11 +34,31 @@ map<int, double> satFinishTime, satCollectTime;
 map<int, bool> gsStarted, satBusy;
 string outputFile;
 std::string ns3_path_head = "contrib/leo/examples/";
-std::map<int, int> sat_cnt;
+std::map<int, uint64_t> satBytes;  // bytes sent to each satellite at packet level
 
 typedef pair<int, int> GsSatPair;
 int SIZEEE = 125000 * 1;
 
+// fluid mode: transfers are fluid flows, except for the ground stations in packetGs
+string mode = "packet";
+set<int> packetGs;
+Ptr<LeoFluidFlowManager> fluid;
+map<int, uint32_t> packetFlow;
+
+// schedule mode: the transfers of lab3_schedule, each satellite and each
+// ground station sending its transfers one after the other in that order
+struct Transfer {
+  int gs, sat;
+  double start;  // planned start, s
+  uint32_t bytes;
+  DataRate rate;
+};
+vector<Transfer> transfers;
+map<int, deque<int>> satTransfers, gsTransfers;
+vector<bool> transferReady;
+map<int, int> satActive;
+map<int, double> transferStart;
+
 string GetNodeId(string str) {
   size_t pos1 = str.find("/", 0);
   size_t pos2 = str.find("/", pos1 + 1);
@@ -43,17 +67,17 @@ string GetNodeId(string str) {
 }
 
 void ParseLinkRates(string filename) {
-  ifstream in(ns3_path_head + filename);
-  int numGs, numSat, dummy;
-  in >> numGs >> numSat >> dummy;
-  
-  int gs, sat, rate;
-  while (in >> gs >> sat >> rate) {
-    // printf("gs: %d, sat: %d, rate: %d\n", gs, sat, rate);
-    linkRates[make_pair(gs, sat)] = to_string(rate) + "kbps";
+  string error;
+  if (!LoadNetworkGraph((ns3_path_head + filename).c_str(), linkRates, &error)) {
+    NS_FATAL_ERROR(error);
   }
 }
 
+DataRate GetLinkRate(int gsId, int satId) {
+  // rates in network.graph are in kbps
+  return DataRate(static_cast<uint64_t>(linkRates.Rate(gsId, satId) * 1000));
+}
+
 
 void ParseAssociation(string filename) {
   // printf("============================================\n");
@@ -72,61 +96,159 @@ void ParseAssociation(string filename) {
   // printf("============================================\n");
 }
 
-void SendPacket(int gsId, int satId) {
+void ParseSchedule(string filename) {
+  ifstream in(ns3_path_head + filename);
+  double T, start, end, kbit, kbps;
+  int gs, sat;
+  in >> T;
+  // ground_station satellite start end data(kbit) rate(kbps)
+  while (in >> gs >> sat >> start >> end >> kbit >> kbps) {
+    if (gs >= (int)groundStations.GetN() || sat >= (int)satellites.GetN()) {
+      NS_FATAL_ERROR("Transfer from " << gs << " to " << sat << " is outside the simulated nodes");
+    }
+    satTransfers[sat].push_back(transfers.size());
+    gsTransfers[gs].push_back(transfers.size());
+    assocMap[sat].push_back(gs);
+    transfers.push_back({gs, sat, start, static_cast<uint32_t>(kbit * 125),
+                         DataRate(static_cast<uint64_t>(kbps * 1000))});
+  }
+  transferReady.assign(transfers.size(), false);
+}
+
+void StartTransfer(int gsId, int satId, uint32_t bytes, DataRate rate) {
   Ptr<Node> gsNode = groundStations.Get(gsId);
   Ptr<Node> satNode = satellites.Get(satId);
 
-  sat_cnt[satId]++;
-
   // utNet.Get(gsNode->GetId())->SetAttribute("DataRate", StringValue(linkRates[make_pair(gsId, satId)]));
-  utNet.Get(gsNode->GetId())->GetObject<MockNetDevice>()->SetDataRate(linkRates[make_pair(gsId, satId)]);
+  utNet.Get(gsNode->GetId())->GetObject<MockNetDevice>()->SetDataRate(rate);
   // utNet.Get(satNode->GetId())->SetAttribute("DataRate", StringValue(linkRates[make_pair(gsId, satId)]));
-  utNet.Get(satNode->GetId())->GetObject<MockNetDevice>()->SetDataRate(linkRates[make_pair(gsId, satId)]);
+  utNet.Get(satNode->GetId())->GetObject<MockNetDevice>()->SetDataRate(rate);
+
+  if (!gsStartTime.count(gsId)) gsStartTime[gsId] = Simulator::Now().GetSeconds();
+  gsStarted[gsId] = true;
+  satBusy[satId] = true;
+
+  if (fluid && !packetGs.count(gsId)) {
+    fluid->AddFlow(gsNode, satNode, bytes);
+    return;
+  }
+  satBytes[satId] += bytes;
+  if (fluid) {
+    // the packet level transfer takes its share from the fluid flows
+    packetFlow[gsId] = fluid->AddPacketFlow(NodeContainer(gsNode, satNode));
+  }
 
   Ipv4Address dstAddr = satNode->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
 
   BulkSendHelper source("ns3::TcpSocketFactory", InetSocketAddress(dstAddr, port));
-  source.SetAttribute("MaxBytes", UintegerValue(SIZEEE));
+  source.SetAttribute("MaxBytes", UintegerValue(bytes));
   source.SetAttribute("SendSize", UintegerValue(512));
 
   ApplicationContainer app = source.Install(gsNode);
   // app.Start(Seconds(Simulator::Now().GetSeconds()));
   app.Start(Seconds(0));
+}
 
-  gsStartTime[gsId] = Simulator::Now().GetSeconds();
-  gsStarted[gsId] = true;
-  satBusy[satId] = true;
+void SendPacket(int gsId, int satId) {
+  StartTransfer(gsId, satId, SIZEEE, GetLinkRate(gsId, satId));
 }
 
-static void EchoRx(std::string context, const Ptr<const Packet> packet, const TcpHeader &header, const Ptr<const TcpSocketBase> socket) {
-  int nodeId = stoi(GetNodeId(context));
-  if (nodeId >= (int)satellites.GetN()) return;
+// Start the next transfer of the satellite once it is due and both ends
+// are free
+void TryTransfer(int satId) {
+  if (satActive.count(satId) || satTransfers[satId].empty()) return;
+  int i = satTransfers[satId].front();
+  const Transfer &t = transfers[i];
+  if (!transferReady[i] || gsTransfers[t.gs].front() != i) return;
+  satActive[satId] = i;
+  transferStart[i] = Simulator::Now().GetSeconds();
+  StartTransfer(t.gs, t.sat, t.bytes, t.rate);
+}
 
-  // Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinkApps.Get(nodeId));
-  Ptr<PacketSink> sink = DynamicCast<PacketSink>(satellites.Get(nodeId)->GetApplication(0));
-  if (!sink) return;
-  uint64_t totalRx = sink->GetTotalRx();
-  if (totalRx < (uint64_t)(SIZEEE * (sat_cnt[nodeId]))) return;
+void TransferDue(int i) {
+  transferReady[i] = true;
+  TryTransfer(transfers[i].sat);
+}
+
+// Whether the transfers of the ground station are simulated as packets
+bool IsPacketLevel(int gsId) {
+  return !fluid || packetGs.count(gsId);
+}
+
+// context is the Rx trace path if a packet level reception completed the
+// transfer, empty for a fluid flow
+void FinishTransfer(int satId, const string &context) {
+  if (!satActive.count(satId)) return;
+  int i = satActive[satId];
+  const Transfer &t = transfers[i];
+  if (!context.empty() && !IsPacketLevel(t.gs)) return;
+  double now = Simulator::Now().GetSeconds();
+  gsEndTime[t.gs] = now;
+  satFinishTime[satId] = now;
+  satCollectTime[satId] += now - transferStart[i];
+  if (packetFlow.count(t.gs)) {
+    fluid->RemoveFlow(packetFlow[t.gs]);
+    packetFlow.erase(t.gs);
+  }
+  if (!context.empty()) printf("nodeId: %d from %s\n", satId, context.c_str());
+  printf("Satellite %d finished receiving from %d at time: %f (planned start %f)\n", satId, t.gs, now, t.start);
+
+  satActive.erase(satId);
+  satTransfers[satId].pop_front();
+  gsTransfers[t.gs].pop_front();
+  TryTransfer(satId);
+  if (!gsTransfers[t.gs].empty()) TryTransfer(transfers[gsTransfers[t.gs].front()].sat);
+}
 
-  for (int gsId : assocMap[nodeId]) {
+void FinishGs(int satId, const string &context = "") {
+  if (!transfers.empty()) {
+    FinishTransfer(satId, context);
+    return;
+  }
+  for (int gsId : assocMap[satId]) {
     if (gsEndTime.find(gsId) == gsEndTime.end() && gsStartTime.count(gsId)) {
+      if (!context.empty() && !IsPacketLevel(gsId)) return;
       gsEndTime[gsId] = Simulator::Now().GetSeconds();
-      satFinishTime[nodeId] = gsEndTime[gsId];
-      satCollectTime[nodeId] += gsEndTime[gsId] - gsStartTime[gsId];
-      printf("nodeId: %s from %s\n", GetNodeId(context).c_str(), context.c_str());
-      printf("Satellite %d finished receiving data at time: %f\n", nodeId, satFinishTime[nodeId]);
+      satFinishTime[satId] = gsEndTime[gsId];
+      satCollectTime[satId] += gsEndTime[gsId] - gsStartTime[gsId];
+      if (packetFlow.count(gsId)) {
+        fluid->RemoveFlow(packetFlow[gsId]);
+        packetFlow.erase(gsId);
+      }
+      if (!context.empty()) printf("nodeId: %d from %s\n", satId, context.c_str());
+      printf("Satellite %d finished receiving data at time: %f\n", satId, satFinishTime[satId]);
       break;
     }
   }
 
-  for (int gsId : assocMap[nodeId]) {
+  for (int gsId : assocMap[satId]) {
     if (gsStartTime.find(gsId) == gsStartTime.end()) {
-      Simulator::ScheduleNow(&SendPacket, gsId, nodeId);
+      Simulator::ScheduleNow(&SendPacket, gsId, satId);
       break;
     }
   }
 }
 
+static void EchoRx(std::string context, const Ptr<const Packet> packet, const TcpHeader &header, const Ptr<const TcpSocketBase> socket) {
+  int nodeId = stoi(GetNodeId(context));
+  if (nodeId >= (int)satellites.GetN()) return;
+
+  // Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinkApps.Get(nodeId));
+  Ptr<PacketSink> sink = DynamicCast<PacketSink>(satellites.Get(nodeId)->GetApplication(0));
+  if (!sink) return;
+  uint64_t totalRx = sink->GetTotalRx();
+  if (totalRx < satBytes[nodeId]) return;
+
+  // later ACK and FIN segments also get here once everything is received,
+  // only a transfer that is still open is finished and reported
+  FinishGs(nodeId, context);
+}
+
+static void FluidCompleted(uint32_t id, uint32_t source, uint32_t sink, Time start, Time finish) {
+  // satellites are created first, so their node ids are their indices
+  FinishGs(sink);
+}
+
 void Connect() {
   Config::Connect("/NodeList/*/$ns3::TcpL4Protocol/SocketList/*/Rx", MakeCallback(&EchoRx));
 }
@@ -136,14 +258,29 @@ int main(int argc, char *argv[]) {
   double duration = 100;
   string inputFile = "network.ortools.out";
   string graphFile = "network.graph";
+  string packetGsList;
+  string scheduleFile;
 
   CommandLine cmd;
   cmd.AddValue("duration", "Duration of the simulation in seconds", duration);
   cmd.AddValue("constellation", "LEO constellation link settings name", constellation);
   cmd.AddValue("inputFile", "Input file", inputFile);
   cmd.AddValue("outputFile", "Output file", outputFile);
+  cmd.AddValue("mode", "Simulate the transfers as packets or as fluid flows (packet|fluid)", mode);
+  cmd.AddValue("packetGs", "Comma separated ground stations that stay on packet level in fluid mode", packetGsList);
+  cmd.AddValue("scheduleFile", "Schedule of lab3_schedule to replay instead of the assignment in inputFile", scheduleFile);
   cmd.Parse(argc, argv);
 
+  stringstream gsList(packetGsList);
+  string gs;
+  while (getline(gsList, gs, ',')) {
+    if (!gs.empty()) packetGs.insert(stoi(gs));
+  }
+  if (mode == "fluid") {
+    fluid = CreateObject<LeoFluidFlowManager>();
+    fluid->TraceConnectWithoutContext("Completed", MakeCallback(&FluidCompleted));
+  }
+
   Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(512));
   Config::SetDefault("ns3::TcpSocketBase::MinRto", TimeValue(Seconds(2.0)));
 
@@ -173,7 +310,11 @@ int main(int argc, char *argv[]) {
   ground.Add(groundStations, LeoLatLong(15, 30));
 
   ParseLinkRates(graphFile);
-  ParseAssociation(inputFile);
+  if (scheduleFile.empty()) {
+    ParseAssociation(inputFile);
+  } else {
+    ParseSchedule(scheduleFile);
+  }
 
   LeoChannelHelper utCh;
   utCh.SetConstellation(constellation);
@@ -205,6 +346,10 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  for (size_t i = 0; i < transfers.size(); ++i) {
+    Simulator::Schedule(Seconds(transfers[i].start), &TransferDue, (int)i);
+  }
+
   Simulator::Schedule(Seconds(1e-7), &Connect);
   Simulator::Stop(Seconds(duration));
   Simulator::Run();
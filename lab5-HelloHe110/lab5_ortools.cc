@@ -19,21 +19,45 @@ struct SDPair {
 // 學號（作為輸出之一部份）
 int student_id = 111550022;
 
+// 是否為變數與約束命名（匯出模型除錯時才需要，預設關閉以節省建模時間與記憶體）
+bool named_variables = false;
+
+// 模型中的一條有向邊：真實邊或某一流的虛擬邊
+struct ModelEdge {
+    int from, to;
+    double capacity;
+    int real;   // 真實邊的編號，虛擬邊為 -1
+    int flow;   // 虛擬邊所屬的流，真實邊為 -1
+};
+
 // 單一測資案例的求解函式
 double SolveSingleTestCase(int U, int E, int F, istream& in, ostream& out) {
-    // 1. 讀取真實邊資料，建立容量矩陣（無向圖：雙向皆記錄）
-    vector<vector<double>> capacity(U, vector<double>(U, 0));
-    vector<Edge> real_edges;
+    // 1. 讀取真實邊資料（無向圖：雙向皆記錄），同一有向邊重複出現時以最後一筆容量為準
+    vector<Edge> input_edges;
+    input_edges.reserve(2 * E);
     for (int i = 0; i < E; ++i) {
         int u, v;
         double cap;
         in >> u >> v >> cap;
-        capacity[u][v] = cap;
-        capacity[v][u] = cap;
-        real_edges.push_back({u, v, cap});
-        real_edges.push_back({v, u, cap});
+        input_edges.push_back({u, v, cap});
+        input_edges.push_back({v, u, cap});
+    }
+    vector<int> order(input_edges.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return make_pair(input_edges[a].from, input_edges[a].to) <
+               make_pair(input_edges[b].from, input_edges[b].to);
+    });
+    vector<Edge> real_edges;  // 依 (from, to) 排序
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Edge& e = input_edges[order[i]];
+        if (i + 1 < order.size() && input_edges[order[i + 1]].from == e.from &&
+            input_edges[order[i + 1]].to == e.to) continue;
+        real_edges.push_back(e);
     }
-  
+    input_edges.clear();
+    int R = real_edges.size();
+
     // 2. 讀取 F 組來源與目的對
     vector<SDPair> flows(F);
     vector<int> sources, destinations;
@@ -44,16 +68,14 @@ double SolveSingleTestCase(int U, int E, int F, istream& in, ostream& out) {
         sources.push_back(s);
         destinations.push_back(d);
     }
-  
+
     // 3. 計算每個真實節點的流出與流入上界（總出／入容量）
     vector<double> out_bound(U, 0.0), in_bound(U, 0.0);
-    for (int u = 0; u < U; ++u) {
-        for (int v = 0; v < U; ++v) {
-            out_bound[u] += capacity[u][v];
-            in_bound[u]  += capacity[v][u];
-        }
+    for (const Edge& e : real_edges) {
+        out_bound[e.from] += e.capacity;
+        in_bound[e.to] += e.capacity;
     }
-  
+
     // 4. 虛擬節點設定：總數 V = U + 2*F
     // 為每流建立一個虛擬來源節點及一個虛擬目的節點
     int V = U + 2 * F;
@@ -62,189 +84,160 @@ double SolveSingleTestCase(int U, int E, int F, istream& in, ostream& out) {
         virSrcs[i] = U + i;
         virDsts[i] = U + F + i;
     }
-  
-    // 5. 構造允許的邊集合：
-    //    ① 真實邊：所有 (u,v) (u,v ∈ [0, U))
+
+    // 5. 構造邊集合並依 (from, to) 排序：
+    //    ① 真實邊
     //    ② 虛擬邊：對每個流 i，增加 (virSrcs[i], sources[i]) 與 (destinations[i], virDsts[i])
-    set<pair<int, int>> allowed_edges;
-    for (auto& e : real_edges)
-        allowed_edges.insert({e.from, e.to});
+    vector<ModelEdge> all_edges;
+    all_edges.reserve(R + 2 * F);
+    for (int r = 0; r < R; ++r)
+        all_edges.push_back({real_edges[r].from, real_edges[r].to, real_edges[r].capacity, r, -1});
     for (int i = 0; i < F; ++i) {
-        allowed_edges.insert({virSrcs[i], sources[i]});
-        allowed_edges.insert({destinations[i], virDsts[i]});
+        all_edges.push_back({virSrcs[i], sources[i], out_bound[sources[i]], -1, i});
+        all_edges.push_back({destinations[i], virDsts[i], in_bound[destinations[i]], -1, i});
     }
-    vector<pair<int, int>> all_edges(allowed_edges.begin(), allowed_edges.end());
-    sort(all_edges.begin(), all_edges.end());
-  
+    sort(all_edges.begin(), all_edges.end(), [](const ModelEdge& a, const ModelEdge& b) {
+        return make_pair(a.from, a.to) < make_pair(b.from, b.to);
+    });
+
+    // 每個真實節點的出邊與入邊（真實邊編號，分別依終點與起點排序）
+    vector<vector<int>> out_edges(U), in_edges(U);
+    for (int r = 0; r < R; ++r) out_edges[real_edges[r].from].push_back(r);
+    for (int r = 0; r < R; ++r) in_edges[real_edges[r].to].push_back(r);
+    for (int u = 0; u < U; ++u)
+        sort(in_edges[u].begin(), in_edges[u].end(),
+             [&](int a, int b) { return real_edges[a].from < real_edges[b].from; });
+
     // 6. 建立混合整數求解器（使用 CBC 作為 MILP 求解器）
     MPSolver solver("ILP", MPSolver::CBC_MIXED_INTEGER_PROGRAMMING);
     cerr << "[DEBUG] Solver(ILP-CBC_MIXED_INTEGER_PROGRAMMING) created\n";
+    auto name = [](const string& prefix, int f, int u, int v) {
+        if (!named_variables) return string();
+        return prefix + (f >= 0 ? "_f" + to_string(f) : "") + "_" + to_string(u) + "_" + to_string(v);
+    };
 
-    // 7. 建立變數
+    // 7. 建立變數，以陣列索引：X[f][r]、Y[f][r] 為流 f 在真實邊 r 上的變數，
+    //    X[f][R]、Y[f][R] 為虛擬來源邊，X[f][R+1]、Y[f][R+1] 為虛擬目的邊
     // X[f,u,v]：連續變數，代表流 f 在邊 (u,v) 上的流量，且其上界：
     //      真實邊：capacity[u][v]
     //      虛擬來源邊：out_bound[ sources[f] ]
     //      虛擬目的邊：in_bound[ destinations[f] ]
     // Y[f,u,v]：二元變數，表示流 f 是否選擇使用邊 (u,v)
     // Z[u,v]：對真實邊 (u,v)（u,v ∈ [0,U)），只在 f==0 時建立，用以後續限制節點單一發射／接收
-    map<tuple<int, int, int>, const MPVariable*> X;
-    map<tuple<int, int, int>, const MPVariable*> Y;
-    map<pair<int, int>, const MPVariable*> Z;
+    const int kSrcEdge = R, kDstEdge = R + 1;
+    vector<vector<const MPVariable*>> X(F, vector<const MPVariable*>(R + 2));
+    vector<vector<const MPVariable*>> Y(F, vector<const MPVariable*>(R + 2));
+    vector<const MPVariable*> Z(R);
+    auto slot = [&](const ModelEdge& e) {
+        if (e.real >= 0) return e.real;
+        return e.from >= U ? kSrcEdge : kDstEdge;
+    };
     for (int f = 0; f < F; ++f) {
-        for (auto& edge : all_edges) {
-            int u = edge.first, v = edge.second;
-            double ub = 0;
-            if (u < U && v < U) { ub = capacity[u][v]; } // 真實邊
-            else if (u >= U) {   // 虛擬來源邊，要求 u == virSrcs[f]且 v == sources[f]
-                if (u == virSrcs[f] && v == sources[f]) ub = out_bound[sources[f]];
-                else continue; // 非本流的虛擬邊略過
-            } 
-            else if (v >= U) {   // 虛擬目的邊，要求 v == virDsts[f]且 u == destinations[f]
-                if (v == virDsts[f] && u == destinations[f]) ub = in_bound[destinations[f]];
-                else continue;
-            }
-
-            string varName = "X_f" + to_string(f) + "_" + to_string(u) + "_" + to_string(v);
-            X[{f, u, v}] = solver.MakeNumVar(0.0, ub, varName);
-            string varY = "Y_f" + to_string(f) + "_" + to_string(u) + "_" + to_string(v);
-            Y[{f, u, v}] = solver.MakeBoolVar(varY);
-            
+        for (const ModelEdge& e : all_edges) {
+            if (e.real < 0 && e.flow != f) continue; // 非本流的虛擬邊略過
+            int k = slot(e);
+            X[f][k] = solver.MakeNumVar(0.0, e.capacity, name("X", f, e.from, e.to));
+            Y[f][k] = solver.MakeBoolVar(name("Y", f, e.from, e.to));
             // 只對真實邊建立全局 Z 變數（只在 f==0 時建立一次即可）
-            if (f == 0 && u < U && v < U) {
-                string varZ = "Z_" + to_string(u) + "_" + to_string(v);
-                Z[{u, v}] = solver.MakeBoolVar(varZ);
-            }
+            if (f == 0 && e.real >= 0) Z[e.real] = solver.MakeBoolVar(name("Z", -1, e.from, e.to));
         }
     }
-  
+
     // 8. 目標函數：最大化各流從虛擬來源至真實來源的流量總和
     MPObjective* const objective = solver.MutableObjective();
-    for (int f = 0; f < F; ++f) {
-        auto it = X.find({f, virSrcs[f], sources[f]});
-        if (it != X.end())  objective->SetCoefficient(it->second, 1.0);
-    }
+    for (int f = 0; f < F; ++f) objective->SetCoefficient(X[f][kSrcEdge], 1.0);
     objective->SetMaximization();
 
-    // 9. 加入約束
+    // 9. 加入約束（只對有邊的節點建立）
 
-    // (1) 單一路徑約束：對每個流 f 及每個節點 u (u ∈ [0,V))，
-    //  「從 u 發出」以及「進入 u」的 Y 變數總和均 ≤ 1
+    // (1) 單一路徑約束：對每個流 f 及每個節點 u，
+    //  「從 u 發出」以及「進入 u」的 Y 變數總和均 ≤ 1
     for (int f = 0; f < F; ++f) {
-        for (int u = 0; u < V; ++u) {
-            MPConstraint* out_cons = solver.MakeRowConstraint(0.0, 1.0);
-            MPConstraint* in_cons  = solver.MakeRowConstraint(0.0, 1.0);
-            for (int v = 0; v < V; ++v) {
-                auto key = make_tuple(f, u, v);
-                if (X.find(key) != X.end()) out_cons->SetCoefficient(Y[key], 1);
-
-                auto key_in = make_tuple(f, v, u);
-                if (X.find(key_in) != X.end()) in_cons->SetCoefficient(Y[key_in], 1);
+        for (int u = 0; u < U; ++u) {
+            bool has_out = !out_edges[u].empty() || u == destinations[f];
+            bool has_in = !in_edges[u].empty() || u == sources[f];
+            if (has_out) {
+                MPConstraint* out_cons = solver.MakeRowConstraint(0.0, 1.0);
+                for (int r : out_edges[u]) out_cons->SetCoefficient(Y[f][r], 1);
+                if (u == destinations[f]) out_cons->SetCoefficient(Y[f][kDstEdge], 1);
+            }
+            if (has_in) {
+                MPConstraint* in_cons = solver.MakeRowConstraint(0.0, 1.0);
+                for (int r : in_edges[u]) in_cons->SetCoefficient(Y[f][r], 1);
+                if (u == sources[f]) in_cons->SetCoefficient(Y[f][kSrcEdge], 1);
             }
         }
+        // 虛擬來源只有一條出邊，虛擬目的只有一條入邊
+        solver.MakeRowConstraint(0.0, 1.0)->SetCoefficient(Y[f][kSrcEdge], 1);
+        solver.MakeRowConstraint(0.0, 1.0)->SetCoefficient(Y[f][kDstEdge], 1);
     }
-  
+
     // (2) 流量守恆約束
     // (a) 在流的進入與離開網路處：虛擬來源到真實來源的流量與真實目的到虛擬目的流量必相同
     for (int f = 0; f < F; ++f) {
         MPConstraint* flow_se = solver.MakeRowConstraint(0.0, 0.0);
-        auto key_in = make_tuple(f, virSrcs[f], sources[f]);
-        if (X.find(key_in) != X.end()) flow_se->SetCoefficient(X[key_in], 1.0);
-        auto key_out = make_tuple(f, destinations[f], virDsts[f]);
-        if (X.find(key_out) != X.end()) flow_se->SetCoefficient(X[key_out], -1.0);
+        flow_se->SetCoefficient(X[f][kSrcEdge], 1.0);
+        flow_se->SetCoefficient(X[f][kDstEdge], -1.0);
     }
-  
+
     // (b) 真實節點（u ∈ [0, U)）上流量平衡：進流 - 出流 = 0
     for (int f = 0; f < F; ++f) {
         for (int u = 0; u < U; ++u) {
+            if (out_edges[u].empty() && in_edges[u].empty() && u != sources[f] && u != destinations[f])
+                continue;
             MPConstraint* flow_cons = solver.MakeRowConstraint(0.0, 0.0);
-            for (int v = 0; v < V; ++v) {
-                auto key = make_tuple(f, u, v);
-                if (X.find(key) != X.end()) flow_cons->SetCoefficient(X[key], 1.0);
-                auto key2 = make_tuple(f, v, u);
-                if (X.find(key2) != X.end()) flow_cons->SetCoefficient(X[key2], -1.0);
-            }
+            for (int r : out_edges[u]) flow_cons->SetCoefficient(X[f][r], 1.0);
+            if (u == destinations[f]) flow_cons->SetCoefficient(X[f][kDstEdge], 1.0);
+            for (int r : in_edges[u]) flow_cons->SetCoefficient(X[f][r], -1.0);
+            if (u == sources[f]) flow_cons->SetCoefficient(X[f][kSrcEdge], -1.0);
         }
     }
-  
+
     // (3) 邊容量約束：對所有真實邊 (u,v) (u,v ∈ [0,U))，
-    //  所有流在此邊上的流量總和 ≤ capacity[u][v]
-    for (auto& edge : all_edges) {
-        int u = edge.first, v = edge.second;
-        if (u < U && v < U) {
-            MPConstraint* cap_cons = solver.MakeRowConstraint(0.0, capacity[u][v]);
-            for (int f = 0; f < F; ++f) {
-                auto key = make_tuple(f, u, v);
-                if (X.find(key) != X.end()) cap_cons->SetCoefficient(X[key], 1.0);
-            }
-        }
+    //  所有流在此邊上的流量總和 ≤ capacity[u][v]
+    for (int r = 0; r < R; ++r) {
+        MPConstraint* cap_cons = solver.MakeRowConstraint(0.0, real_edges[r].capacity);
+        for (int f = 0; f < F; ++f) cap_cons->SetCoefficient(X[f][r], 1.0);
     }
-  
-    // (4) X 與 Y 綁定：對每組 (f,u,v)，必須滿足  
-    //  X[f,u,v] ≤ Y[f,u,v] × (該邊上界)
-    for (auto& entry : X) {
-        int f, u, v;
-        tie(f, u, v) = entry.first;
-        double bound = 0;
-        if (u < U && v < U) bound = capacity[u][v];
-        else if (u >= U) bound = out_bound[sources[f]]; // 虛擬來源邊
-        else if (v >= U) bound = in_bound[destinations[f]]; // 虛擬目的邊
-        // MPConstraint* bind_cons = solver.MakeRowConstraint(-solver.infinity(), 0.0);
-        MPConstraint* bind_cons = solver.MakeRowConstraint(0.0, solver.infinity());
-        bind_cons->SetCoefficient(entry.second, -1.0);
-        bind_cons->SetCoefficient(Y[entry.first], bound);
+
+    // (4) X 與 Y 綁定：對每組 (f,u,v)，必須滿足
+    //  X[f,u,v] ≤ Y[f,u,v] × (該邊上界)
+    for (int f = 0; f < F; ++f) {
+        for (const ModelEdge& e : all_edges) {
+            if (e.real < 0 && e.flow != f) continue;
+            int k = slot(e);
+            MPConstraint* bind_cons = solver.MakeRowConstraint(0.0, solver.infinity());
+            bind_cons->SetCoefficient(X[f][k], -1.0);
+            bind_cons->SetCoefficient(Y[f][k], e.capacity);
+        }
     }
-  
-    // (5) Y 與 Z 綁定：對每個真實邊 (u,v) (u,v ∈ [0,U))，對所有流 f 均須滿足：  
-    //  Z[u,v] ≥ Y[f,u,v]
-    for (auto& edge : all_edges) {
-        int u = edge.first, v = edge.second;
-        if (u < U && v < U) {
-            for (int f = 0; f < F; ++f) {
-                auto key = make_tuple(f, u, v);
-                if (Y.find(key) != Y.end()) {
-                    MPConstraint* yz_cons = solver.MakeRowConstraint(0.0, solver.infinity());
-                    yz_cons->SetCoefficient(Y[key], -1.0);
-                    yz_cons->SetCoefficient(Z[{u, v}], 1.0);
-                }
-            }
+
+    // (5) Y 與 Z 綁定：對每個真實邊 (u,v) (u,v ∈ [0,U))，對所有流 f 均須滿足：
+    //  Z[u,v] ≥ Y[f,u,v]
+    for (int r = 0; r < R; ++r) {
+        for (int f = 0; f < F; ++f) {
+            MPConstraint* yz_cons = solver.MakeRowConstraint(0.0, solver.infinity());
+            yz_cons->SetCoefficient(Y[f][r], -1.0);
+            yz_cons->SetCoefficient(Z[r], 1.0);
         }
     }
-    // [新增排他性約束]
-    // 對每條真實邊 (u,v) (u,v ∈ [0,U))，所有流 f 的 Y[f,u,v] 之和 ≤ 1，
-    // 即每條物理邊同時只能被最多一條 SD 路使用
-    // for (int u = 0; u < U; u++) {
-    //     for (int v = 0; v < U; v++) {
-    //         if (capacity[u][v] > 0) {  // 此物理邊存在
-    //             MPConstraint* exclusivity = solver.MakeRowConstraint(0.0, 1.0);
-    //             for (int f = 0; f < F; f++) {
-    //                 auto key = make_tuple(f, u, v);
-    //                 if (Y.find(key) != Y.end())
-    //                     exclusivity->SetCoefficient(Y[key], 1.0);
-    //             }
-    //         }
-    //     }
-    // }
-  
+
     // (6) 單一發射限制：對真實節點，每個節點 u (u ∈ [0,U)) 的所有從 u 出發的真實邊，
-    //  其全局變數 Z 的總和 ≤ 1
-    for (int u = 0; u < V; ++u) {
+    //  其全局變數 Z 的總和 ≤ 1
+    for (int u = 0; u < U; ++u) {
+        if (out_edges[u].empty()) continue;
         MPConstraint* tx_cons = solver.MakeRowConstraint(0.0, 1.0);
-        for (int v = 0; v < V; ++v) {
-            if (u < U && v < U && Z.find({u, v}) != Z.end())
-                tx_cons->SetCoefficient(Z[{u, v}], 1.0);
-        }
+        for (int r : out_edges[u]) tx_cons->SetCoefficient(Z[r], 1.0);
     }
-  
+
     // (7) 單一接收限制：對真實節點，每個節點 u (u ∈ [0,U)) 的所有進入 u 的真實邊，
-    //  其全局變數 Z 的總和 ≤ 1
-    for (int u = 0; u < V; ++u) {
+    //  其全局變數 Z 的總和 ≤ 1
+    for (int u = 0; u < U; ++u) {
+        if (in_edges[u].empty()) continue;
         MPConstraint* rx_cons = solver.MakeRowConstraint(0.0, 1.0);
-        for (int v = 0; v < V; ++v) {
-            if (v < U && u < U && Z.find({v, u}) != Z.end())
-                rx_cons->SetCoefficient(Z[{v, u}], 1.0);
-        }
+        for (int r : in_edges[u]) rx_cons->SetCoefficient(Z[r], 1.0);
     }
-  
+
     // 10. 求解模型
     MPSolver::ResultStatus result_status = solver.Solve();
     cerr << "[DEBUG] Solver status: " << result_status << "\n";
@@ -254,44 +247,42 @@ double SolveSingleTestCase(int U, int E, int F, istream& in, ostream& out) {
         out << "0\n";
         return 0.0;
     }
-  
-    // 11. 記錄所有被使用的真實邊
-    map<pair<int, int>, bool> edge_used_map;
-    for (auto& [key, xvar] : X) {
-        int f, u, v;
-        tie(f, u, v) = key;
-        if (u < U && v < U && xvar->solution_value() > 1e-6) {
-            edge_used_map[{u, v}] = true;
-        }
-    }
+
+    // 11. 一次讀出所有解值，並記錄所有被使用的真實邊（依 (u,v) 排序）
+    vector<vector<double>> flow_on(F, vector<double>(R + 2));
+    for (int f = 0; f < F; ++f)
+        for (int k = 0; k < R + 2; ++k) flow_on[f][k] = X[f][k]->solution_value();
     vector<pair<int, int>> used_edges;
-    for (auto& [uv, flag] : edge_used_map) {
-        if (flag) {
-            used_edges.push_back(uv);
+    for (int r = 0; r < R; ++r) {
+        for (int f = 0; f < F; ++f) {
+            if (flow_on[f][r] > 1e-6) {
+                used_edges.push_back({real_edges[r].from, real_edges[r].to});
+                break;
+            }
         }
     }
-    // out << "--------------------------------\n";
     out << used_edges.size() << "\n";
     for (const auto& [u, v] : used_edges) {
         out << u << " " << v << "\n";
     }
-    // out << "\n";
 
-    // 12. 根據 X 變數的解，找出所有被使用的真實邊（u,v 且 u,v ∈ [0,U)，且流量 > 1e-6）
+    // 12. 根據 X 變數的解，沿著流量 > 1e-6 的邊找出每個流的路徑
     double total_throughput = 0;
+    vector<int> parent(V);
     for (int f = 0; f < F; ++f) {
         int s = flows[f].src, d = flows[f].dst;
         int vs = virSrcs[f], vd = virDsts[f];
-        
-        double rate = X[{f, vs, s}]->solution_value();
-        
+
+        double rate = flow_on[f][kSrcEdge];
+
         cerr << "[DEBUG] Flow " << f << " rate: " << rate << " (src=" << s << ", dst=" << d << ", vs=" << vs << ", vd=" << vd << ")\n";
-        
+
         if (rate < 1e-6) {
             out << "0 0\n";
         } else {
             // BFS to reconstruct path from source to destination
-            unordered_map<int, int> parent;
+            const int kUnseen = -2;
+            fill(parent.begin(), parent.end(), kUnseen);
             queue<int> q;
             q.push(s);  // 從實際源點開始
             parent[s] = -1;
@@ -304,13 +295,13 @@ double SolveSingleTestCase(int U, int E, int F, istream& in, ostream& out) {
                     break;
                 }
 
-                for (int v = 0; v < V; ++v) {
-                    auto it = X.find({f, u, v});
-                    if (it != X.end() && it->second->solution_value() > 1e-6 && !parent.count(v)) {
+                auto visit = [&](int v, int k) {
+                    if (flow_on[f][k] > 1e-6 && parent[v] == kUnseen) {
                         parent[v] = u;
                         q.push(v);
                     }
-                }
+                };
+                for (int r : out_edges[u]) visit(real_edges[r].to, r);
             }
 
             if (!found_path) {
@@ -327,21 +318,17 @@ double SolveSingleTestCase(int U, int E, int F, istream& in, ostream& out) {
                 }
                 reverse(path.begin(), path.end());
 
-                // out << fixed << setprecision(6) << rate << " " << path.size() << "    ";
                 out << fixed << setprecision(6) << rate << " " << path.size();
-                // out << vs;
                 for (int u : path) out << " " << u;
                 out << "\n";
-                // out << " " << vd << "\n";
                 total_throughput += rate;
             }
         }
     }
-    
-    // out << "total throughput: " << fixed << setprecision(6) << total_throughput << "\n";
+
     out << fixed << setprecision(6) << total_throughput << "\n";
     cerr << "[DEBUG] Total throughput: " << total_throughput << "\n";
-    
+
     return total_throughput;
 }
 
@@ -369,7 +356,10 @@ void SolveAllCases(istream& in, ostream& out) {
 
 }  // namespace operations_research
 
-int main() {
+int main(int argc, char** argv) {
+    // --names 為變數與約束命名
+    for (int i = 1; i < argc; ++i)
+        if (string(argv[i]) == "--names") operations_research::named_variables = true;
     operations_research::SolveAllCases(cin, cout);
     return 0;
 }
@@ -159,6 +159,9 @@ int main (int argc, char *argv[]) {
     ipv4.SetBase ("10.2.0.0", "255.255.0.0");
     ipv4.Assign (islNet);
 
+    // Build every ground station route before traffic starts
+    nixRouting.PrecomputeRoutes (groundStations, groundStations);
+
     // Task 2.2 & Task 3.2 : Call SendPacket()
     std::vector<Ptr<PacketSink>> sinks;
     if (Task == 2) {
@@ -35,6 +35,13 @@ void NixVectorHelper<T>::SetPathFile (std::string pathFile) {
   m_pathFile = pathFile;
 }
 
+template <typename T>
+void
+NixVectorHelper<T>::Set (std::string name, const AttributeValue &value)
+{
+  m_agentFactory.Set (name, value);
+}
+
 template <typename T>
 NixVectorHelper<T>::NixVectorHelper ()
 {
@@ -80,6 +87,32 @@ NixVectorHelper<T>::PrintRoutingPathAt (Time printTime, Ptr<Node> source, IpAddr
   Simulator::Schedule (printTime, &NixVectorHelper<T>::PrintRoute, source, dest, stream, unit);
 }
 
+template <typename T>
+void
+NixVectorHelper<T>::PrecomputeRoutes (NodeContainer sources, NodeContainer destinations, uint32_t threads)
+{
+  if (sources.GetN () == 0)
+    {
+      return;
+    }
+
+  std::vector<uint32_t> sourceIds;
+  std::vector<uint32_t> destinationIds;
+  for (NodeContainer::Iterator it = sources.Begin (); it != sources.End (); ++it)
+    {
+      sourceIds.push_back ((*it)->GetId ());
+    }
+  for (NodeContainer::Iterator it = destinations.Begin (); it != destinations.End (); ++it)
+    {
+      destinationIds.push_back ((*it)->GetId ());
+    }
+
+  Ptr<Node> node = sources.Get (0);
+  Ptr<NixVectorRouting<IpRoutingProtocol>> rp = T::template GetRouting <NixVectorRouting<IpRoutingProtocol>> (node->GetObject<Ip> ()->GetRoutingProtocol ());
+  NS_ASSERT (rp);
+  rp->PrecomputePaths (sourceIds, destinationIds, threads);
+}
+
 template <typename T>
 void
 NixVectorHelper<T>::PrintRoute (Ptr<Node> source, IpAddress dest, Ptr<OutputStreamWrapper> stream, Time::Unit unit)
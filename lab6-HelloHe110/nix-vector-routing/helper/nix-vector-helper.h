@@ -27,6 +27,7 @@
 #define NIX_VECTOR_HELPER_H
 
 #include "ns3/object-factory.h"
+#include "ns3/node-container.h"
 #include "ns3/ipv4-routing-helper.h"
 #include "ns3/ipv6-routing-helper.h"
 
@@ -104,9 +105,29 @@ public:
    */
   void PrintRoutingPathAt (Time printTime, Ptr<Node> source, IpAddress dest, Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S);
 
+  /**
+   * \brief Computes the routes between two sets of nodes up front, on
+   * several threads, instead of lazily inside the event loop.
+   * \param sources the nodes that originate traffic
+   * \param destinations the nodes the traffic is sent to
+   * \param threads number of worker threads, 0 for one per core
+   *
+   * Must be called after the addresses are assigned and before
+   * Simulator::Run.  This method calls the PrecomputePaths() method
+   * of the NixVectorRouting of the first source.
+   */
+  void PrecomputeRoutes (NodeContainer sources, NodeContainer destinations, uint32_t threads = 0);
+
   // Task 1-1:
   void SetPathFile (std::string pathFile);
 
+  /**
+   * \brief Set an attribute of the routing agents created by this helper
+   * \param name the name of the attribute, e.g. "MaxPaths"
+   * \param value the value of the attribute
+   */
+  void Set (std::string name, const AttributeValue &value);
+
 private:
   // Task 1-1:
   std::string m_pathFile;
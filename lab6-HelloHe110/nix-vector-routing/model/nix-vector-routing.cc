@@ -24,6 +24,10 @@
  */
 
 #include <queue>
+#include <algorithm>
+#include <limits>
+#include <atomic>
+#include <thread>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
@@ -32,6 +36,8 @@
 #include "ns3/names.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/loopback-net-device.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 
 #include "nix-vector-routing.h"
 
@@ -51,6 +57,36 @@ typename NixVectorRouting<T>::IpAddressToNodeMap NixVectorRouting<T>::g_ipAddres
 template <typename T>
 typename NixVectorRouting<T>::NetDeviceToIpInterfaceMap NixVectorRouting<T>::g_netdeviceToIpInterfaceMap;
 
+template <typename T>
+bool NixVectorRouting<T>::g_isAddressMapDirty = false;
+
+template <typename T>
+std::set<uint32_t> NixVectorRouting<T>::g_dirtyNodes;
+
+template <typename T>
+typename NixVectorRouting<T>::Adjacency_t NixVectorRouting<T>::g_adjacency;
+
+template <typename T>
+typename NixVectorRouting<T>::ReverseAdjacency_t NixVectorRouting<T>::g_reverseAdjacency;
+
+template <typename T>
+std::set<uint32_t> NixVectorRouting<T>::g_treeOwners;
+
+template <typename T>
+std::set<uint32_t> NixVectorRouting<T>::g_pathSetOwners;
+
+template <typename T>
+bool NixVectorRouting<T>::g_explicitPaths = false;
+
+template <typename T>
+typename NixVectorRouting<T>::CacheHolderMap NixVectorRouting<T>::g_cacheHolders;
+
+template <typename T>
+typename NixVectorRouting<T>::NodeToIpAddressMap NixVectorRouting<T>::g_nodeToIpAddressMap;
+
+/// Hop distance of nodes not reached by a shortest path tree
+static const uint32_t NIX_UNREACHED = std::numeric_limits<uint32_t>::max ();
+
 // Task 1-1:
 template <typename T>
 void NixVectorRouting<T>::SetPaths (std::string pathFile) {
@@ -75,6 +111,11 @@ void NixVectorRouting<T>::SetPaths (std::string pathFile) {
     Table[{src, dst}] = path;
   }
   file.close();
+
+  if (!Table.empty ())
+    {
+      g_explicitPaths = true;
+    }
 }
 
 template <typename T>
@@ -87,13 +128,27 @@ NixVectorRouting<T>::GetTypeId (void)
     .SetParent<T> ()
     .SetGroupName ("NixVectorRouting")
     .template AddConstructor<NixVectorRouting<T> > ()
+    .AddAttribute ("MaxPaths",
+                   "Maximum number of disjoint nix-vectors kept per destination. "
+                   "Flows are spread over them by hashing their 5-tuple.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&NixVectorRouting<T>::m_maxPaths),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("NodeDisjoint",
+                   "Whether the alternative paths must be node-disjoint "
+                   "instead of link-disjoint",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NixVectorRouting<T>::m_nodeDisjoint),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 template <typename T>
 NixVectorRouting<T>::NixVectorRouting ()
-  : m_totalNeighbors (0)
+  : m_maxPaths (1),
+    m_nodeDisjoint (false),
+    m_totalNeighbors (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -180,11 +235,26 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache (void) const
       rp->FlushNixCache ();
       rp->FlushIpRouteCache ();
       rp->m_totalNeighbors = 0;
+      rp->m_sptParent.clear ();
+      rp->m_sptDist.clear ();
+      rp->m_sptChildren.clear ();
+      rp->m_nixPathCache.clear ();
     }
 
   // IP address to node mapping is potentially invalid so clear it.
   // Will be repopulated in lazy evaluation when mapping is needed.
   g_ipAddressToNodeMap.clear ();
+  g_netdeviceToIpInterfaceMap.clear ();
+  g_nodeToIpAddressMap.clear ();
+
+  // The routing graph and all trees are rebuilt lazily as well
+  g_adjacency.clear ();
+  g_reverseAdjacency.clear ();
+  g_treeOwners.clear ();
+  g_pathSetOwners.clear ();
+  g_dirtyNodes.clear ();
+  g_cacheHolders.clear ();
+  g_isAddressMapDirty = false;
 }
 
 template <typename T>
@@ -259,6 +329,22 @@ NixVectorRouting<T>::GetNixVector (Ptr<Node> source, IpAddress dest, Ptr<NetDevi
       NS_LOG_DEBUG ("Do not process packets to self");
       return 0;
     }
+  else if (!oif && source == m_node)
+    {
+      // walk up the shortest path tree, which is kept
+      // up to date across topology changes
+      if (m_sptParent.empty ())
+        {
+          BuildShortestPathTree ();
+        }
+
+      if (BuildNixVector (m_sptParent, source->GetId (), destNode->GetId (), nixVector))
+        {
+          return nixVector;
+        }
+      NS_LOG_ERROR ("No routing path exists");
+      return 0;
+    }
   else
     {
       // otherwise proceed as normal 
@@ -291,17 +377,17 @@ template <typename T>
 Ptr<NixVector>
 NixVectorRouting<T>::GetNixVectorInCache (const IpAddress &address, bool &foundInCache) const
 {
-  // NS_LOG_FUNCTION (this << address);
+  NS_LOG_FUNCTION (this << address);
 
-  // CheckCacheStateAndFlush ();
+  CheckCacheStateAndFlush ();
 
-  // typename NixMap_t::iterator iter = m_nixCache.find (address);
-  // if (iter != m_nixCache.end ())
-  //   {
-  //     NS_LOG_LOGIC ("Found Nix-vector in cache.");
-  //     foundInCache = true;
-  //     return iter->second;
-  //   }
+  typename NixMap_t::iterator iter = m_nixCache.find (address);
+  if (iter != m_nixCache.end ())
+    {
+      NS_LOG_LOGIC ("Found Nix-vector in cache.");
+      foundInCache = true;
+      return iter->second;
+    }
 
   // not in cache
   foundInCache = false;
@@ -313,16 +399,16 @@ template <typename T>
 Ptr<typename NixVectorRouting<T>::IpRoute>
 NixVectorRouting<T>::GetIpRouteInCache (IpAddress address)
 {
-  // NS_LOG_FUNCTION (this << address);
+  NS_LOG_FUNCTION (this << address);
 
-  // CheckCacheStateAndFlush ();
+  CheckCacheStateAndFlush ();
 
-  // typename IpRouteMap_t::iterator iter = m_ipRouteCache.find (address);
-  // if (iter != m_ipRouteCache.end ())
-  //   {
-  //     NS_LOG_LOGIC ("Found IpRoute in cache.");
-  //     return iter->second;
-  //   }
+  typename IpRouteMap_t::iterator iter = m_ipRouteCache.find (address);
+  if (iter != m_ipRouteCache.end ())
+    {
+      NS_LOG_LOGIC ("Found IpRoute in cache.");
+      return iter->second;
+    }
 
   // not in cache
   return 0;
@@ -536,6 +622,8 @@ NixVectorRouting<T>::BuildIpAddressToNodeMap (void) const
 {
   NS_LOG_FUNCTION_NOARGS ();
 
+  g_nodeToIpAddressMap.clear ();
+
   for (NodeList::Iterator it = NodeList::Begin (); it != NodeList::End (); ++it)
     {
       Ptr<Node> node = *it;
@@ -568,6 +656,7 @@ NixVectorRouting<T>::BuildIpAddressToNodeMap (void) const
 
                           NS_LOG_LOGIC ("Adding IP address " << addr << " for node " << node->GetId () << " to NIX Vector IP address to node map");
                           g_ipAddressToNodeMap[addr] = node;
+                          g_nodeToIpAddressMap[node->GetId ()].push_back (addr);
                         }
                     }
                 }
@@ -796,7 +885,23 @@ NixVectorRouting<T>::RouteOutput (Ptr<Packet> p, const IpHeader &header, Ptr<Net
       nixVectorInCache = GetNixVector (m_node, destAddress, oif);
 
       // cache it
-      m_nixCache.insert (typename NixMap_t::value_type (destAddress, nixVectorInCache));
+      CacheNixVector (destAddress, nixVectorInCache);
+    }
+
+  // spread flows over the alternative paths, the first
+  // path is the one the single-path case would use
+  uint32_t pathIndex = 0;
+  if (nixVectorInCache && m_maxPaths > 1 && !oif)
+    {
+      NixPathSet &pathSet = GetNixPathSet (destAddress, nixVectorInCache);
+      pathIndex = GetFlowHash (p, header) % pathSet.nixVectors.size ();
+      nixVectorInCache = pathSet.nixVectors[pathIndex];
+      if (p)
+        {
+          pathSet.packets[pathIndex]++;
+          pathSet.bytes[pathIndex] += p->GetSize ();
+        }
+      NS_LOG_LOGIC ("Flow mapped to path " << pathIndex << " of " << pathSet.nixVectors.size ());
     }
 
   // path exists
@@ -821,10 +926,14 @@ NixVectorRouting<T>::RouteOutput (Ptr<Packet> p, const IpHeader &header, Ptr<Net
       uint32_t nodeIndex = nixVectorForPacket->ExtractNeighborIndex (numberOfBits);
 
       // Search here in a cache for this node index
-      // and look for a IpRoute
-      rtentry = GetIpRouteInCache (destAddress);
+      // and look for a IpRoute, routes are only cached
+      // for the first path towards a destination
+      if (pathIndex == 0)
+        {
+          rtentry = GetIpRouteInCache (destAddress);
+        }
 
-      if (!rtentry || !(rtentry->GetOutputDevice () == oif))
+      if (!rtentry || (oif && !(rtentry->GetOutputDevice () == oif)))
         {
           // not in cache or a different specified output
           // device is to be used
@@ -873,7 +982,10 @@ NixVectorRouting<T>::RouteOutput (Ptr<Packet> p, const IpHeader &header, Ptr<Net
           sockerr = Socket::ERROR_NOTERROR;
 
           // add rtentry to cache
-          m_ipRouteCache.insert (typename IpRouteMap_t::value_type (destAddress, rtentry));
+          if (pathIndex == 0)
+            {
+              CacheIpRoute (destAddress, rtentry);
+            }
         }
 
       NS_LOG_LOGIC ("Nix-vector contents: " << *nixVectorInCache << " : Remaining bits: " << nixVectorForPacket->GetRemainingBits ());
@@ -973,7 +1085,14 @@ NixVectorRouting<T>::RouteInput (Ptr<const Packet> p, const IpHeader &header, Pt
   uint32_t numberOfBits = nixVector->BitCount (m_totalNeighbors);
   uint32_t nodeIndex = nixVector->ExtractNeighborIndex (numberOfBits);
 
-  rtentry = GetIpRouteInCache (destAddress);
+  // with several paths per destination, or paths given per
+  // source, the next hop depends on the packet, not only on
+  // the destination
+  bool cacheable = m_maxPaths == 1 && !g_explicitPaths;
+  if (cacheable)
+    {
+      rtentry = GetIpRouteInCache (destAddress);
+    }
   // not in cache
   if (!rtentry)
     {
@@ -992,7 +1111,10 @@ NixVectorRouting<T>::RouteInput (Ptr<const Packet> p, const IpHeader &header, Pt
       rtentry->SetOutputDevice (m_ip->GetNetDevice (interfaceIndex));
 
       // add rtentry to cache
-      m_ipRouteCache.insert (typename IpRouteMap_t::value_type (destAddress, rtentry));
+      if (cacheable)
+        {
+          CacheIpRoute (destAddress, rtentry);
+        }
     }
 
   NS_LOG_LOGIC ("At Node " << m_node->GetId () << ", Extracting " << numberOfBits <<
@@ -1078,6 +1200,33 @@ NixVectorRouting<T>::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::U
           *os << std::endl;
         }
     }
+  if (m_maxPaths > 1)
+    {
+      *os << "NixPaths (up to " << m_maxPaths << (m_nodeDisjoint ? " node" : " link") << "-disjoint):" << std::endl;
+      if (m_nixPathCache.size () > 0)
+        {
+          *os << std::setw (30) << "Destination";
+          *os << std::setw (6) << "Path";
+          *os << std::setw (6) << "Hops";
+          *os << std::setw (12) << "Packets";
+          *os << std::setw (14) << "Bytes";
+          *os << "NixVector" << std::endl;
+          for (typename NixPathMap_t::const_iterator it = m_nixPathCache.begin (); it != m_nixPathCache.end (); it++)
+            {
+              std::ostringstream dest;
+              dest << it->first;
+              for (std::size_t i = 0; i < it->second.nixVectors.size (); i++)
+                {
+                  *os << std::setw (30) << (i == 0 ? dest.str () : "");
+                  *os << std::setw (6) << i;
+                  *os << std::setw (6) << it->second.nodes[i].size () - 1;
+                  *os << std::setw (12) << it->second.packets[i];
+                  *os << std::setw (14) << it->second.bytes[i];
+                  *os << *(it->second.nixVectors[i]) << std::endl;
+                }
+            }
+        }
+    }
   *os << std::endl;
   // Restore the previous ostream state
   (*os).copyfmt (oldState);
@@ -1088,37 +1237,37 @@ template <typename T>
 void
 NixVectorRouting<T>::NotifyInterfaceUp (uint32_t i)
 {
-  g_isCacheDirty = true;
+  MarkTopologyDirty (false);
 }
 template <typename T>
 void
 NixVectorRouting<T>::NotifyInterfaceDown (uint32_t i)
 {
-  g_isCacheDirty = true;
+  MarkTopologyDirty (false);
 }
 template <typename T>
 void
 NixVectorRouting<T>::NotifyAddAddress (uint32_t interface, IpInterfaceAddress address)
 {
-  g_isCacheDirty = true;
+  MarkTopologyDirty (true);
 }
 template <typename T>
 void
 NixVectorRouting<T>::NotifyRemoveAddress (uint32_t interface, IpInterfaceAddress address)
 {
-  g_isCacheDirty = true;
+  MarkTopologyDirty (true);
 }
 template <typename T>
 void
 NixVectorRouting<T>::NotifyAddRoute (IpAddress dst, Ipv6Prefix mask, IpAddress nextHop, uint32_t interface, IpAddress prefixToUse)
 {
-  g_isCacheDirty = true;
+  MarkTopologyDirty (false);
 }
 template <typename T>
 void
 NixVectorRouting<T>::NotifyRemoveRoute (IpAddress dst, Ipv6Prefix mask, IpAddress nextHop, uint32_t interface, IpAddress prefixToUse)
 {
-  g_isCacheDirty = true;
+  MarkTopologyDirty (false);
 }
 
 template <typename T>
@@ -1324,7 +1473,7 @@ NixVectorRouting<T>::PrintRoutingPath (Ptr<Node> source, IpAddress dest,
       // dest IP address
       nixVectorInCache = GetNixVector (source, dest, nullptr);
       // cache it
-      m_nixCache.insert (typename NixMap_t::value_type (dest, nixVectorInCache));
+      CacheNixVector (dest, nixVectorInCache);
     }
 
   if (nixVectorInCache || (!nixVectorInCache && source == destNode))
@@ -1416,13 +1565,954 @@ template <typename T>
 void 
 NixVectorRouting<T>::CheckCacheStateAndFlush (void) const
 {
-  if (g_isCacheDirty)
+  if (!g_adjacency.empty () && g_adjacency.size () != NodeList::GetNNodes ())
     {
+      // nodes were added after the routing graph snapshot was
+      // taken, nothing can be repaired incrementally
       FlushGlobalNixRoutingCache ();
+    }
+
+  if (g_isCacheDirty)
+    {
+      ApplyTopologyChanges ();
       g_isCacheDirty = false;
     }
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::MarkTopologyDirty (bool addressChanged)
+{
+  g_isCacheDirty = true;
+  g_isAddressMapDirty |= addressChanged;
+
+  Ptr<Node> node = m_node;
+  if (!node && m_ip)
+    {
+      node = m_ip->template GetObject<Node> ();
+    }
+  if (node)
+    {
+      g_dirtyNodes.insert (node->GetId ());
+    }
+  else
+    {
+      // cannot tell which edges changed, start over
+      FlushGlobalNixRoutingCache ();
+    }
+}
+
+template <typename T>
+std::vector<uint32_t>
+NixVectorRouting<T>::GetAdjacentNodes (Ptr<Node> node) const
+{
+  NS_LOG_FUNCTION (this << node);
+
+  std::vector<uint32_t> neighbors;
+  Ptr<IpL3Protocol> ip = node->GetObject<IpL3Protocol> ();
+
+  for (uint32_t i = 0; i < node->GetNDevices (); i++)
+    {
+      Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+
+      // make sure that we can go this way
+      if (ip)
+        {
+          int32_t interfaceIndex = (ip)->GetInterfaceForDevice (localNetDevice);
+          if (interfaceIndex == -1 || !(ip->IsUp (interfaceIndex)))
+            {
+              continue;
+            }
+        }
+      if (!(localNetDevice->IsLinkUp ()))
+        {
+          continue;
+        }
+      Ptr<Channel> channel = localNetDevice->GetChannel ();
+      if (channel == 0)
+        {
+          continue;
+        }
+
+      NetDeviceContainer netDeviceContainer;
+      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+
+      for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+        {
+          Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice (*iter);
+          if (remoteIpInterface == 0 || !(remoteIpInterface->IsUp ()))
+            {
+              continue;
+            }
+          // keep the first device that reaches a neighbor,
+          // as BFS does when it sets the parent
+          uint32_t id = (*iter)->GetNode ()->GetId ();
+          if (std::find (neighbors.begin (), neighbors.end (), id) == neighbors.end ())
+            {
+              neighbors.push_back (id);
+            }
+        }
+    }
+
+  return neighbors;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::BuildRoutingGraph (void) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  uint32_t numberOfNodes = NodeList::GetNNodes ();
+  g_adjacency.assign (numberOfNodes, std::vector<uint32_t> ());
+  g_reverseAdjacency.assign (numberOfNodes, std::set<uint32_t> ());
+
+  for (NodeList::Iterator it = NodeList::Begin (); it != NodeList::End (); ++it)
+    {
+      uint32_t id = (*it)->GetId ();
+      g_adjacency[id] = GetAdjacentNodes (*it);
+      for (uint32_t neighbor : g_adjacency[id])
+        {
+          g_reverseAdjacency[neighbor].insert (id);
+        }
+    }
+
+  // the snapshot reflects every change reported so far
+  g_dirtyNodes.clear ();
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::BuildShortestPathTree (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (g_adjacency.empty ())
+    {
+      BuildRoutingGraph ();
+    }
+
+  uint32_t numberOfNodes = g_adjacency.size ();
+  uint32_t source = m_node->GetId ();
+
+  m_sptParent.assign (numberOfNodes, 0);
+  m_sptDist.assign (numberOfNodes, NIX_UNREACHED);
+  m_sptChildren.assign (numberOfNodes, std::vector<uint32_t> ());
+
+  std::queue<uint32_t> greyNodeList;
+  greyNodeList.push (source);
+  m_sptParent[source] = m_node;
+  m_sptDist[source] = 0;
+
+  // the neighbors are in device order, so equal-cost
+  // ties go the same way as in BFS
+  while (!greyNodeList.empty ())
+    {
+      uint32_t curr = greyNodeList.front ();
+      greyNodeList.pop ();
+      for (uint32_t next : g_adjacency[curr])
+        {
+          if (m_sptDist[next] == NIX_UNREACHED)
+            {
+              m_sptDist[next] = m_sptDist[curr] + 1;
+              m_sptParent[next] = NodeList::GetNode (curr);
+              m_sptChildren[curr].push_back (next);
+              greyNodeList.push (next);
+            }
+        }
+    }
+
+  g_treeOwners.insert (source);
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::ApplyTopologyChanges (void) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  if (g_isAddressMapDirty)
+    {
+      // routes towards the old addresses of the changed nodes are stale
+      for (uint32_t id : g_dirtyNodes)
+        {
+          InvalidateCachedRoutes (id);
+        }
+      g_ipAddressToNodeMap.clear ();
+      g_netdeviceToIpInterfaceMap.clear ();
+      g_nodeToIpAddressMap.clear ();
+      g_isAddressMapDirty = false;
+    }
+
+  if (g_adjacency.empty ())
+    {
+      // no snapshot yet, it will be built from the current state
+      g_dirtyNodes.clear ();
+      return;
+    }
+
+  // The edges of a dirty node change in both directions: its own
+  // devices decide its out-edges, while its interfaces being up
+  // decides the out-edges of its neighbors towards it.
+  std::set<uint32_t> candidates (g_dirtyNodes);
+  for (uint32_t id : g_dirtyNodes)
+    {
+      std::vector<uint32_t> current = GetAdjacentNodes (NodeList::GetNode (id));
+      candidates.insert (current.begin (), current.end ());
+      candidates.insert (g_adjacency[id].begin (), g_adjacency[id].end ());
+      candidates.insert (g_reverseAdjacency[id].begin (), g_reverseAdjacency[id].end ());
+    }
+  g_dirtyNodes.clear ();
+
+  std::vector<Edge_t> deleted;
+  std::vector<Edge_t> inserted;
+  std::vector<uint32_t> rewired;
+  for (uint32_t id : candidates)
+    {
+      std::vector<uint32_t> current = GetAdjacentNodes (NodeList::GetNode (id));
+      std::vector<uint32_t> &previous = g_adjacency[id];
+      if (current == previous)
+        {
+          continue;
+        }
+      std::set<uint32_t> currentSet (current.begin (), current.end ());
+      std::set<uint32_t> previousSet (previous.begin (), previous.end ());
+      for (uint32_t neighbor : previous)
+        {
+          if (!currentSet.count (neighbor))
+            {
+              deleted.push_back (Edge_t (id, neighbor));
+              g_reverseAdjacency[neighbor].erase (id);
+            }
+        }
+      for (uint32_t neighbor : current)
+        {
+          if (!previousSet.count (neighbor))
+            {
+              inserted.push_back (Edge_t (id, neighbor));
+              g_reverseAdjacency[neighbor].insert (id);
+            }
+        }
+      previous.swap (current);
+      rewired.push_back (id);
+    }
+
+  NS_LOG_LOGIC ("Topology change: " << deleted.size () << " edges deleted, "
+                << inserted.size () << " edges inserted");
+
+  if (rewired.empty ())
+    {
+      return;
+    }
+
+  std::set<uint32_t> staleDests;
+  for (uint32_t owner : g_treeOwners)
+    {
+      Ptr<NixVectorRouting<T> > rp = NodeList::GetNode (owner)->GetObject<NixVectorRouting> ();
+      if (!rp || rp->m_sptParent.empty ())
+        {
+          continue;
+        }
+
+      std::set<uint32_t> changed;
+      rp->RemoveTreeEdges (deleted, changed);
+      rp->InsertTreeEdges (inserted, changed);
+
+      // The nix index a node uses for a hop depends on its neighbor
+      // set, so every path going through a rewired node is stale.
+      for (uint32_t id : rewired)
+        {
+          if (rp->m_sptParent[id] == 0)
+            {
+              continue;
+            }
+          std::vector<uint32_t> subtree;
+          rp->CollectSubtree (id, subtree);
+          changed.insert (subtree.begin () + 1, subtree.end ());
+        }
+
+      NS_LOG_LOGIC ("Tree of node " << owner << ": " << changed.size () << " destinations changed");
+      staleDests.insert (changed.begin (), changed.end ());
+    }
+
+  for (uint32_t id : rewired)
+    {
+      Ptr<NixVectorRouting<T> > rp = NodeList::GetNode (id)->GetObject<NixVectorRouting> ();
+      if (rp)
+        {
+          rp->m_totalNeighbors = 0;
+        }
+    }
+
+  // paths given by SetPaths are not part of the trees either,
+  // their nix indices are stale once a relay on them is rewired
+  std::set<uint32_t> rewiredSet (rewired.begin (), rewired.end ());
+  if (g_explicitPaths)
+    {
+      for (NodeList::Iterator it = NodeList::Begin (); it != NodeList::End (); ++it)
+        {
+          Ptr<NixVectorRouting<T> > rp = (*it)->GetObject<NixVectorRouting> ();
+          if (!rp)
+            {
+              continue;
+            }
+          for (const auto &entry : rp->Table)
+            {
+              const std::vector<int> &path = entry.second;
+              for (std::size_t i = 0; i + 1 < path.size (); i++)
+                {
+                  if (rewiredSet.count (path[i]))
+                    {
+                      staleDests.insert (entry.first.second);
+                      break;
+                    }
+                }
+            }
+        }
+    }
+
+  for (uint32_t dest : staleDests)
+    {
+      InvalidateCachedRoutes (dest);
+    }
+
+  // alternative paths are not part of the trees, drop the
+  // path sets that go through a rewired node
+  for (uint32_t owner : g_pathSetOwners)
+    {
+      Ptr<NixVectorRouting<T> > rp = NodeList::GetNode (owner)->GetObject<NixVectorRouting> ();
+      if (!rp)
+        {
+          continue;
+        }
+      for (typename NixPathMap_t::iterator it = rp->m_nixPathCache.begin (); it != rp->m_nixPathCache.end (); )
+        {
+          bool stale = false;
+          for (const std::vector<uint32_t> &nodes : it->second.nodes)
+            {
+              for (std::size_t i = 0; i + 1 < nodes.size () && !stale; i++)
+                {
+                  stale = rewiredSet.count (nodes[i]) > 0;
+                }
+            }
+          if (stale)
+            {
+              it = rp->m_nixPathCache.erase (it);
+            }
+          else
+            {
+              it++;
+            }
+        }
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::RemoveTreeEdges (const std::vector<Edge_t> &deleted, std::set<uint32_t> &changed) const
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t source = m_node->GetId ();
+
+  // detach the subtrees hanging below the deleted tree edges
+  std::set<uint32_t> affected;
+  std::vector<uint32_t> subtree;
+  for (const Edge_t &edge : deleted)
+    {
+      uint32_t child = edge.second;
+      if (child == source || affected.count (child) || m_sptParent[child] == 0
+          || m_sptParent[child]->GetId () != edge.first)
+        {
+          continue;
+        }
+      SetTreeParent (child, 0);
+      subtree.clear ();
+      CollectSubtree (child, subtree);
+      affected.insert (subtree.begin (), subtree.end ());
+    }
+
+  if (affected.empty ())
+    {
+      return;
+    }
+
+  for (uint32_t id : affected)
+    {
+      m_sptParent[id] = 0;
+      m_sptDist[id] = NIX_UNREACHED;
+      m_sptChildren[id].clear ();
+    }
+
+  // seed every detached node with its best intact in-neighbor
+  typedef std::pair<uint32_t, uint32_t> Entry_t;
+  std::priority_queue<Entry_t, std::vector<Entry_t>, std::greater<Entry_t> > queue;
+  for (uint32_t id : affected)
+    {
+      for (uint32_t neighbor : g_reverseAdjacency[id])
+        {
+          if (affected.count (neighbor) || m_sptDist[neighbor] == NIX_UNREACHED)
+            {
+              continue;
+            }
+          if (m_sptDist[neighbor] + 1 < m_sptDist[id])
+            {
+              m_sptDist[id] = m_sptDist[neighbor] + 1;
+              m_sptParent[id] = NodeList::GetNode (neighbor);
+            }
+        }
+      if (m_sptDist[id] != NIX_UNREACHED)
+        {
+          queue.push (Entry_t (m_sptDist[id], id));
+        }
+    }
+
+  // and settle the rest of the detached region from there
+  while (!queue.empty ())
+    {
+      Entry_t entry = queue.top ();
+      queue.pop ();
+      if (entry.first != m_sptDist[entry.second])
+        {
+          continue;
+        }
+      for (uint32_t next : g_adjacency[entry.second])
+        {
+          if (affected.count (next) && entry.first + 1 < m_sptDist[next])
+            {
+              m_sptDist[next] = entry.first + 1;
+              m_sptParent[next] = NodeList::GetNode (entry.second);
+              queue.push (Entry_t (m_sptDist[next], next));
+            }
+        }
+    }
+
+  for (uint32_t id : affected)
+    {
+      if (m_sptParent[id] != 0)
+        {
+          m_sptChildren[m_sptParent[id]->GetId ()].push_back (id);
+        }
+    }
+
+  changed.insert (affected.begin (), affected.end ());
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::InsertTreeEdges (const std::vector<Edge_t> &inserted, std::set<uint32_t> &changed) const
+{
+  NS_LOG_FUNCTION (this);
+
+  typedef std::pair<uint32_t, uint32_t> Entry_t;
+  std::priority_queue<Entry_t, std::vector<Entry_t>, std::greater<Entry_t> > queue;
+  for (const Edge_t &edge : inserted)
+    {
+      uint32_t from = edge.first;
+      uint32_t to = edge.second;
+      if (m_sptDist[from] != NIX_UNREACHED && m_sptDist[from] + 1 < m_sptDist[to])
+        {
+          m_sptDist[to] = m_sptDist[from] + 1;
+          SetTreeParent (to, NodeList::GetNode (from));
+          queue.push (Entry_t (m_sptDist[to], to));
+        }
+    }
+
+  // a shorter path to a node shortens the paths to its whole subtree
+  while (!queue.empty ())
+    {
+      Entry_t entry = queue.top ();
+      queue.pop ();
+      if (entry.first != m_sptDist[entry.second])
+        {
+          continue;
+        }
+      changed.insert (entry.second);
+      for (uint32_t next : g_adjacency[entry.second])
+        {
+          if (entry.first + 1 < m_sptDist[next])
+            {
+              m_sptDist[next] = entry.first + 1;
+              SetTreeParent (next, NodeList::GetNode (entry.second));
+              queue.push (Entry_t (m_sptDist[next], next));
+            }
+        }
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::CollectSubtree (uint32_t root, std::vector<uint32_t> &subtree) const
+{
+  std::size_t first = subtree.size ();
+  subtree.push_back (root);
+  for (std::size_t i = first; i < subtree.size (); i++)
+    {
+      const std::vector<uint32_t> &children = m_sptChildren[subtree[i]];
+      subtree.insert (subtree.end (), children.begin (), children.end ());
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::SetTreeParent (uint32_t node, Ptr<Node> parent) const
+{
+  if (m_sptParent[node] != 0)
+    {
+      std::vector<uint32_t> &siblings = m_sptChildren[m_sptParent[node]->GetId ()];
+      for (std::size_t i = 0; i < siblings.size (); i++)
+        {
+          if (siblings[i] == node)
+            {
+              siblings[i] = siblings.back ();
+              siblings.pop_back ();
+              break;
+            }
+        }
+    }
+
+  m_sptParent[node] = parent;
+  if (parent != 0)
+    {
+      m_sptChildren[parent->GetId ()].push_back (node);
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::InvalidateCachedRoutes (uint32_t dest) const
+{
+  NS_LOG_FUNCTION (this << dest);
+
+  if (g_ipAddressToNodeMap.empty ())
+    {
+      BuildIpAddressToNodeMap ();
+    }
+
+  typename NodeToIpAddressMap::iterator addresses = g_nodeToIpAddressMap.find (dest);
+  if (addresses == g_nodeToIpAddressMap.end ())
+    {
+      return;
+    }
+
+  for (const IpAddress &address : addresses->second)
+    {
+      typename CacheHolderMap::iterator holders = g_cacheHolders.find (address);
+      if (holders == g_cacheHolders.end ())
+        {
+          continue;
+        }
+      for (uint32_t holder : holders->second)
+        {
+          Ptr<NixVectorRouting<T> > rp = NodeList::GetNode (holder)->GetObject<NixVectorRouting> ();
+          if (rp)
+            {
+              rp->m_nixCache.erase (address);
+              rp->m_ipRouteCache.erase (address);
+              rp->m_nixPathCache.erase (address);
+            }
+        }
+      g_cacheHolders.erase (holders);
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::CacheNixVector (IpAddress address, Ptr<NixVector> nixVector) const
+{
+  m_nixCache.insert (typename NixMap_t::value_type (address, nixVector));
+  g_cacheHolders[address].insert (m_node->GetId ());
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::CacheIpRoute (IpAddress address, Ptr<IpRoute> rtentry) const
+{
+  m_ipRouteCache.insert (typename IpRouteMap_t::value_type (address, rtentry));
+  g_cacheHolders[address].insert (m_node->GetId ());
+}
+
+template <typename T>
+typename NixVectorRouting<T>::NixPathSet &
+NixVectorRouting<T>::GetNixPathSet (IpAddress address, Ptr<NixVector> nixVector) const
+{
+  NS_LOG_FUNCTION (this << address);
+
+  typename NixPathMap_t::iterator it = m_nixPathCache.find (address);
+  if (it != m_nixPathCache.end ())
+    {
+      return it->second;
+    }
+
+  NixPathSet &pathSet = m_nixPathCache[address];
+  g_cacheHolders[address].insert (m_node->GetId ());
+  g_pathSetOwners.insert (m_node->GetId ());
+
+  // the first path is the shortest one found by the caller
+  Ptr<Node> destNode = GetNodeByIp (address);
+  std::vector<uint32_t> path;
+  if (!destNode || !GetNixVectorPath (m_node, destNode, nixVector, path))
+    {
+      pathSet.nixVectors.push_back (nixVector);
+      pathSet.nodes.push_back (std::vector<uint32_t> (1, m_node->GetId ()));
+      pathSet.packets.push_back (0);
+      pathSet.bytes.push_back (0);
+      return pathSet;
+    }
+  pathSet.nixVectors.push_back (nixVector);
+  pathSet.nodes.push_back (path);
+  pathSet.packets.push_back (0);
+  pathSet.bytes.push_back (0);
+
+  if (g_adjacency.empty ())
+    {
+      BuildRoutingGraph ();
+    }
+
+  // every further path avoids the links (or the relays) of the
+  // previous ones, so the set stops growing once the cut is used up
+  std::set<Edge_t> usedEdges;
+  std::set<uint32_t> usedNodes;
+  while (pathSet.nixVectors.size () < m_maxPaths)
+    {
+      const std::vector<uint32_t> &last = pathSet.nodes.back ();
+      for (std::size_t i = 0; i + 1 < last.size (); i++)
+        {
+          usedEdges.insert (Edge_t (last[i], last[i + 1]));
+          usedEdges.insert (Edge_t (last[i + 1], last[i]));
+          if (i > 0)
+            {
+              usedNodes.insert (last[i]);
+            }
+        }
+
+      std::vector< Ptr<Node> > parentVector;
+      if (!DisjointBFS (m_node->GetId (), destNode->GetId (), usedEdges, usedNodes, parentVector))
+        {
+          break;
+        }
+
+      Ptr<NixVector> alternative = Create<NixVector> ();
+      if (!BuildNixVector (parentVector, m_node->GetId (), destNode->GetId (), alternative)
+          || !GetNixVectorPath (m_node, destNode, alternative, path))
+        {
+          break;
+        }
+      pathSet.nixVectors.push_back (alternative);
+      pathSet.nodes.push_back (path);
+      pathSet.packets.push_back (0);
+      pathSet.bytes.push_back (0);
+    }
+
+  NS_LOG_LOGIC ("Found " << pathSet.nixVectors.size () << " disjoint paths to " << address);
+  return pathSet;
+}
+
+template <typename T>
+bool
+NixVectorRouting<T>::GetNixVectorPath (Ptr<Node> source, Ptr<Node> destNode, Ptr<NixVector> nixVector, std::vector<uint32_t> &path) const
+{
+  NS_LOG_FUNCTION (this << source << destNode);
+
+  // walk the nix-vector the way PrintRoutingPath does, on a copy
+  // so that the bits of the original are left untouched
+  Ptr<NixVector> walk = nixVector->Copy ();
+  path.clear ();
+  path.push_back (source->GetId ());
+  Ptr<Node> curr = source;
+  while (curr != destNode)
+    {
+      if (path.size () > NodeList::GetNNodes ())
+        {
+          return false;
+        }
+      uint32_t numberOfBits = walk->BitCount (FindTotalNeighbors (curr));
+      uint32_t nixIndex = walk->ExtractNeighborIndex (numberOfBits);
+      IpAddress gatewayIp;
+      FindNetDeviceForNixIndex (curr, nixIndex, gatewayIp);
+      curr = GetNodeByIp (gatewayIp);
+      if (!curr)
+        {
+          return false;
+        }
+      path.push_back (curr->GetId ());
+    }
+  return true;
+}
+
+template <typename T>
+bool
+NixVectorRouting<T>::DisjointBFS (uint32_t source, uint32_t dest,
+                                  const std::set<Edge_t> &usedEdges,
+                                  const std::set<uint32_t> &usedNodes,
+                                  std::vector< Ptr<Node> > &parentVector) const
+{
+  NS_LOG_FUNCTION (this << source << dest);
+
+  parentVector.assign (g_adjacency.size (), 0);
+  parentVector[source] = NodeList::GetNode (source);
+
+  std::queue<uint32_t> greyNodeList;
+  greyNodeList.push (source);
+  while (!greyNodeList.empty ())
+    {
+      uint32_t current = greyNodeList.front ();
+      greyNodeList.pop ();
+      for (uint32_t next : g_adjacency[current])
+        {
+          if (parentVector[next] != 0 || usedEdges.count (Edge_t (current, next)))
+            {
+              continue;
+            }
+          if (m_nodeDisjoint && next != dest && usedNodes.count (next))
+            {
+              continue;
+            }
+          parentVector[next] = NodeList::GetNode (current);
+          if (next == dest)
+            {
+              return true;
+            }
+          greyNodeList.push (next);
+        }
+    }
+  return false;
+}
+
+template <typename T>
+uint32_t
+NixVectorRouting<T>::GetFlowHash (Ptr<const Packet> p, const IpHeader &header) const
+{
+  // FNV-1a over the addresses, the protocol and the TCP ports
+  uint32_t hash = 2166136261U;
+  auto mix = [&hash] (uint32_t value)
+    {
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          hash ^= (value >> (8 * i)) & 0xff;
+          hash *= 16777619U;
+        }
+    };
+
+  IpAddressHash addressHash;
+  mix (addressHash (header.GetSource ()));
+  mix (addressHash (header.GetDestination ()));
+
+  uint8_t protocol;
+  if constexpr (IsIpv4::value)
+    {
+      protocol = header.GetProtocol ();
+    }
+  else
+    {
+      protocol = header.GetNextHeader ();
+    }
+  mix (protocol);
+
+  // TCP adds its header before asking for a route, UDP only after,
+  // so a UDP packet holds nothing but payload here and its flow is
+  // told apart by the addresses alone.  A TCP header is taken as
+  // present if its data offset fits the packet.
+  if (p && protocol == 6 && p->GetSize () >= 20)
+    {
+      uint8_t tcp[20];
+      p->CopyData (tcp, 20);
+      uint32_t headerLength = (tcp[12] >> 4) * 4;
+      if (headerLength >= 20 && headerLength <= p->GetSize ())
+        {
+          mix ((tcp[0] << 24) | (tcp[1] << 16) | (tcp[2] << 8) | tcp[3]);
+        }
+    }
+  return hash;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::PrecomputePaths (const std::vector<uint32_t> &sources,
+                                      const std::vector<uint32_t> &destinations,
+                                      uint32_t threads) const
+{
+  NS_LOG_FUNCTION (this << sources.size () << destinations.size () << threads);
+
+  CheckCacheStateAndFlush ();
+  if (g_ipAddressToNodeMap.empty ())
+    {
+      BuildIpAddressToNodeMap ();
+    }
+  if (g_adjacency.empty ())
+    {
+      BuildRoutingGraph ();
+    }
+
+  uint32_t numberOfNodes = g_adjacency.size ();
+
+  // neighbor indices and widths as BuildNixVector computes them,
+  // so that the workers never have to look at a net device
+  std::vector<std::unordered_map<uint32_t, uint32_t> > nixIndex (numberOfNodes);
+  std::vector<uint32_t> nixBits (numberOfNodes, 0);
+  for (uint32_t id = 0; id < numberOfNodes; id++)
+    {
+      Ptr<Node> node = NodeList::GetNode (id);
+      uint32_t totalNeighbors = 0;
+      for (uint32_t i = 0; i < node->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+          if (localNetDevice->IsBridge ())
+            {
+              continue;
+            }
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+          NetDeviceContainer netDeviceContainer;
+          GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+          for (uint32_t j = 0; j < netDeviceContainer.GetN (); j++)
+            {
+              nixIndex[id][netDeviceContainer.Get (j)->GetNode ()->GetId ()] = totalNeighbors + j;
+            }
+          totalNeighbors += netDeviceContainer.GetN ();
+        }
+      nixBits[id] = NixVector ().BitCount (totalNeighbors);
+    }
+
+  /// Output of one source, written by exactly one worker
+  struct SourceResult
+  {
+    std::vector<uint32_t> parent;            //!< parent node id, NIX_UNREACHED if none
+    std::vector<Ptr<NixVector> > nixVectors; //!< per destination, 0 if unreachable
+  };
+  std::vector<SourceResult> results (sources.size ());
+
+  // each worker takes the next unclaimed source until none is left,
+  // the sources are independent so this scales with the cores
+  std::atomic<std::size_t> next (0);
+  auto worker = [&] ()
+    {
+      std::queue<uint32_t> greyNodeList;
+      for (std::size_t k = next++; k < sources.size (); k = next++)
+        {
+          uint32_t source = sources[k];
+          SourceResult &result = results[k];
+          result.parent.assign (numberOfNodes, NIX_UNREACHED);
+          result.parent[source] = source;
+          greyNodeList.push (source);
+          while (!greyNodeList.empty ())
+            {
+              uint32_t curr = greyNodeList.front ();
+              greyNodeList.pop ();
+              for (uint32_t neighbor : g_adjacency[curr])
+                {
+                  if (result.parent[neighbor] == NIX_UNREACHED)
+                    {
+                      result.parent[neighbor] = curr;
+                      greyNodeList.push (neighbor);
+                    }
+                }
+            }
+
+          result.nixVectors.assign (destinations.size (), 0);
+          for (std::size_t d = 0; d < destinations.size (); d++)
+            {
+              uint32_t dest = destinations[d];
+              if (dest == source || result.parent[dest] == NIX_UNREACHED)
+                {
+                  continue;
+                }
+              // same order as the recursion in BuildNixVector
+              Ptr<NixVector> nixVector = Create<NixVector> ();
+              for (uint32_t hop = dest; hop != source; hop = result.parent[hop])
+                {
+                  uint32_t parent = result.parent[hop];
+                  // at () never inserts, the maps are shared by the workers
+                  nixVector->AddNeighborIndex (nixIndex[parent].at (hop), nixBits[parent]);
+                }
+              result.nixVectors[d] = nixVector;
+            }
+        }
+    };
+
+  if (threads == 0)
+    {
+      threads = std::max (1U, std::thread::hardware_concurrency ());
+    }
+  threads = std::min<std::size_t> (threads, std::max<std::size_t> (sources.size (), 1));
+  std::vector<std::thread> pool;
+  for (uint32_t i = 1; i < threads; i++)
+    {
+      pool.push_back (std::thread (worker));
+    }
+  worker ();
+  for (std::thread &t : pool)
+    {
+      t.join ();
+    }
+
+  // hand the trees and nix-vectors over to the agents
+  for (std::size_t k = 0; k < sources.size (); k++)
+    {
+      uint32_t source = sources[k];
+      Ptr<NixVectorRouting<T> > rp = NodeList::GetNode (source)->GetObject<NixVectorRouting> ();
+      if (!rp)
+        {
+          continue;
+        }
+      const SourceResult &result = results[k];
+
+      rp->m_sptParent.assign (numberOfNodes, 0);
+      rp->m_sptDist.assign (numberOfNodes, NIX_UNREACHED);
+      rp->m_sptChildren.assign (numberOfNodes, std::vector<uint32_t> ());
+      rp->m_sptParent[source] = rp->m_node;
+      rp->m_sptDist[source] = 0;
+      for (uint32_t id = 0; id < numberOfNodes; id++)
+        {
+          if (result.parent[id] == NIX_UNREACHED || id == source)
+            {
+              continue;
+            }
+          rp->m_sptParent[id] = NodeList::GetNode (result.parent[id]);
+          rp->m_sptChildren[result.parent[id]].push_back (id);
+        }
+      // walk up to the first node with a known distance and settle
+      // the nodes on the way, so every node is settled only once
+      std::vector<uint32_t> pending;
+      for (uint32_t id = 0; id < numberOfNodes; id++)
+        {
+          uint32_t hop = id;
+          while (result.parent[hop] != NIX_UNREACHED && rp->m_sptDist[hop] == NIX_UNREACHED)
+            {
+              pending.push_back (hop);
+              hop = result.parent[hop];
+            }
+          for (uint32_t dist = rp->m_sptDist[hop]; !pending.empty (); pending.pop_back ())
+            {
+              rp->m_sptDist[pending.back ()] = ++dist;
+            }
+        }
+      g_treeOwners.insert (source);
+
+      for (std::size_t d = 0; d < destinations.size (); d++)
+        {
+          if (result.nixVectors[d] == 0
+              || rp->Table.count ({(int) source, (int) destinations[d]}))
+            {
+              continue;
+            }
+          typename NodeToIpAddressMap::const_iterator addresses = g_nodeToIpAddressMap.find (destinations[d]);
+          if (addresses == g_nodeToIpAddressMap.end ())
+            {
+              continue;
+            }
+          for (const IpAddress &address : addresses->second)
+            {
+              rp->m_nixCache.erase (address);
+              rp->CacheNixVector (address, result.nixVectors[d]);
+            }
+        }
+    }
+}
+
 /* Public template function declarations */
 template void NixVectorRouting<Ipv4RoutingProtocol>::SetNode (Ptr<Node> node);
 template void NixVectorRouting<Ipv6RoutingProtocol>::SetNode (Ptr<Node> node);
@@ -1432,5 +2522,9 @@ template void NixVectorRouting<Ipv4RoutingProtocol>::PrintRoutingPath (Ptr<Node>
                                                                        Ptr<OutputStreamWrapper> stream, Time::Unit unit) const;
 template void NixVectorRouting<Ipv6RoutingProtocol>::PrintRoutingPath (Ptr<Node> source, IpAddress dest,
                                                                        Ptr<OutputStreamWrapper> stream, Time::Unit unit) const;
+template void NixVectorRouting<Ipv4RoutingProtocol>::PrecomputePaths (const std::vector<uint32_t> &sources, const std::vector<uint32_t> &destinations,
+                                                                      uint32_t threads) const;
+template void NixVectorRouting<Ipv6RoutingProtocol>::PrecomputePaths (const std::vector<uint32_t> &sources, const std::vector<uint32_t> &destinations,
+                                                                      uint32_t threads) const;
 
 } // namespace ns3
@@ -43,6 +43,8 @@
 #include "ns3/ipv6-l3-protocol.h"
 
 #include <map>
+#include <set>
+#include <vector>
 #include <unordered_map>
 
 namespace ns3 {
@@ -111,9 +113,11 @@ public:
   void SetNode (Ptr<Node> node);
 
   /**
-   * @brief Called when run-time link topology change occurs
-   * which iterates through the node list and flushes any
-   * nix vector caches
+   * @brief Iterates through the node list and flushes every
+   * nix vector cache, shortest path tree and the shared routing
+   * graph.  Run-time link changes are normally repaired
+   * incrementally (see ApplyTopologyChanges); a full flush is
+   * only needed when the set of nodes itself changes.
    *
    * \internal
    * \c const is used here due to need to potentially flush the cache
@@ -134,6 +138,26 @@ public:
    */
   void PrintRoutingPath (Ptr<Node> source, IpAddress dest, Ptr<OutputStreamWrapper> stream, Time::Unit unit) const;
 
+  /**
+   * @brief Builds the shortest path trees of the given sources and
+   * fills their nix-vector caches towards the given destinations,
+   * so that no BFS runs inside the event loop.
+   *
+   * The routing graph is snapshotted once and the BFS of every
+   * source runs on a pool of worker threads that only read integer
+   * tables; all ns-3 objects are touched before and after, on the
+   * calling thread.  Call it after addresses are assigned and
+   * before Simulator::Run.  Pairs listed in the path file are left
+   * to the lazy path.
+   *
+   * \param sources ids of the source nodes
+   * \param destinations ids of the destination nodes
+   * \param threads number of worker threads, 0 for one per core
+   */
+  void PrecomputePaths (const std::vector<uint32_t> &sources,
+                        const std::vector<uint32_t> &destinations,
+                        uint32_t threads = 0) const;
+
   // Task 1-1:
   void SetPaths (std::string pathFile);
 
@@ -160,6 +184,164 @@ private:
    */
   void ResetTotalNeighbors (void);
 
+  /// Directed edge (from, to) of the routing graph, as node ids
+  typedef std::pair<uint32_t, uint32_t> Edge_t;
+
+  /// Out-neighbors of every node of the routing graph, in the order BFS visits them
+  typedef std::vector<std::vector<uint32_t> > Adjacency_t;
+
+  /// In-neighbor sets of every node of the routing graph
+  typedef std::vector<std::set<uint32_t> > ReverseAdjacency_t;
+
+  /**
+   * Computes the nodes reachable in one hop from a node, following
+   * the same rules as BFS (interface up, link up, common subnet)
+   * \param node the node whose outgoing edges are wanted
+   * \returns the ids of the adjacent nodes, in device order and
+   *          without duplicates, so that equal-cost ties are broken
+   *          the way BFS breaks them
+   */
+  std::vector<uint32_t> GetAdjacentNodes (Ptr<Node> node) const;
+
+  /**
+   * Takes a snapshot of the whole routing graph into
+   * g_adjacency and g_reverseAdjacency
+   */
+  void BuildRoutingGraph (void) const;
+
+  /**
+   * Runs BFS once on the routing graph snapshot to build
+   * the shortest path tree rooted at this node
+   */
+  void BuildShortestPathTree (void) const;
+
+  /**
+   * Re-reads the edges of the nodes that reported a change,
+   * diffs them against the routing graph snapshot and repairs
+   * the shortest path tree of every node that owns one.  Only
+   * the cached routes towards destinations whose tree path
+   * changed are invalidated.
+   */
+  void ApplyTopologyChanges (void) const;
+
+  /**
+   * Repairs the shortest path tree after edges were deleted.  The
+   * subtrees hanging below deleted tree edges are detached and
+   * re-attached from their intact boundary.
+   * \param [in] deleted the deleted edges
+   * \param [out] changed the nodes whose tree path changed
+   */
+  void RemoveTreeEdges (const std::vector<Edge_t> &deleted, std::set<uint32_t> &changed) const;
+
+  /**
+   * Repairs the shortest path tree after edges were inserted by
+   * propagating the distance decreases they cause.
+   * \param [in] inserted the inserted edges
+   * \param [out] changed the nodes whose tree path changed
+   */
+  void InsertTreeEdges (const std::vector<Edge_t> &inserted, std::set<uint32_t> &changed) const;
+
+  /**
+   * Collects a node and all its descendants in the shortest path tree
+   * \param [in] root the root of the subtree
+   * \param [out] subtree the nodes of the subtree
+   */
+  void CollectSubtree (uint32_t root, std::vector<uint32_t> &subtree) const;
+
+  /**
+   * Moves a node under a new parent in the shortest path tree
+   * \param node the node to move
+   * \param parent the new parent node
+   */
+  void SetTreeParent (uint32_t node, Ptr<Node> parent) const;
+
+  /**
+   * Removes the cached nix-vectors and IpRoutes towards all addresses
+   * of a node, on every node that holds one
+   * \param dest the destination node id
+   */
+  void InvalidateCachedRoutes (uint32_t dest) const;
+
+  /**
+   * Inserts a nix-vector into m_nixCache and records this node
+   * as a holder of a route towards the address
+   * \param address destination address
+   * \param nixVector the nix-vector to cache
+   */
+  void CacheNixVector (IpAddress address, Ptr<NixVector> nixVector) const;
+
+  /**
+   * Inserts an IpRoute into m_ipRouteCache and records this node
+   * as a holder of a route towards the address
+   * \param address destination address
+   * \param rtentry the route to cache
+   */
+  void CacheIpRoute (IpAddress address, Ptr<IpRoute> rtentry) const;
+
+  /**
+   * Records that the topology seen from this node changed
+   * \param addressChanged true if an address was added or removed
+   */
+  void MarkTopologyDirty (bool addressChanged);
+
+  /// Alternative nix-vectors towards one destination
+  struct NixPathSet
+  {
+    std::vector< Ptr<NixVector> > nixVectors; //!< nix-vector of each path
+    std::vector< std::vector<uint32_t> > nodes; //!< node ids along each path
+    std::vector<uint64_t> packets; //!< packets routed on each path
+    std::vector<uint64_t> bytes; //!< bytes routed on each path
+  };
+
+  /// Map of IpAddress to the alternative paths towards it
+  typedef std::map<IpAddress, NixPathSet> NixPathMap_t;
+
+  /**
+   * Returns the cached set of up to m_maxPaths link- or node-disjoint
+   * nix-vectors towards a destination, computing it on first use.  The
+   * first path is the one given by GetNixVector, the others are found by
+   * BFS on the routing graph avoiding what earlier paths use.
+   * \param address destination address
+   * \param nixVector the nix-vector returned by GetNixVector
+   * \returns the path set
+   */
+  NixPathSet & GetNixPathSet (IpAddress address, Ptr<NixVector> nixVector) const;
+
+  /**
+   * Retraces the nodes a nix-vector visits
+   * \param [in] source Source node
+   * \param [in] destNode Destination node
+   * \param [in] nixVector the nix-vector
+   * \param [out] path ids of the visited nodes, including source and destination
+   * \returns true on success, false otherwise.
+   */
+  bool GetNixVectorPath (Ptr<Node> source, Ptr<Node> destNode, Ptr<NixVector> nixVector, std::vector<uint32_t> &path) const;
+
+  /**
+   * BFS on the routing graph that avoids a set of edges and nodes
+   * \param [in] source Source node id
+   * \param [in] dest Destination node id
+   * \param [in] usedEdges edges that must not be used
+   * \param [in] usedNodes nodes that must not be visited
+   * \param [out] parentVector Parent vector for retracing routes
+   * \returns false if dest not found, true o.w.
+   */
+  bool DisjointBFS (uint32_t source, uint32_t dest,
+                    const std::set<Edge_t> &usedEdges,
+                    const std::set<uint32_t> &usedNodes,
+                    std::vector< Ptr<Node> > &parentVector) const;
+
+  /**
+   * Hashes the 5-tuple of a packet so that all packets of a flow
+   * are mapped to the same path.  Ports are taken from the TCP header
+   * if the packet carries one; UDP adds its header after the route is
+   * chosen, so UDP flows are hashed by addresses and protocol only.
+   * \param p the packet, may be null
+   * \param header the IP header
+   * \returns the flow hash
+   */
+  uint32_t GetFlowHash (Ptr<const Packet> p, const IpHeader &header) const;
+
   /**
    * Takes in the source node and dest IP and calls GetNodeByIp,
    * BFS, accounting for any output interface specified, and finally
@@ -459,12 +641,63 @@ private:
    */
   static bool g_isCacheDirty;
 
+  /// Flag to mark that addresses changed and the address maps must be rebuilt
+  static bool g_isAddressMapDirty;
+
+  /// Nodes that reported a topology change since the last repair
+  static std::set<uint32_t> g_dirtyNodes;
+
+  /// Snapshot of the routing graph: out-neighbors of every node
+  static Adjacency_t g_adjacency;
+
+  /// Snapshot of the routing graph: in-neighbors of every node
+  static ReverseAdjacency_t g_reverseAdjacency;
+
+  /// Nodes that own a shortest path tree which must be kept up to date
+  static std::set<uint32_t> g_treeOwners;
+
+  /// Nodes that cache alternative paths which must be checked on changes
+  static std::set<uint32_t> g_pathSetOwners;
+
+  /**
+   * Whether any agent loaded paths with SetPaths.  The next hop of
+   * such a path depends on its source, so routes towards a destination
+   * can no longer be cached on the nodes that forward them.
+   */
+  static bool g_explicitPaths;
+
+  /// Mapping of IP address to the ids of the nodes caching a route to it
+  typedef std::unordered_map<IpAddress, std::set<uint32_t>, IpAddressHash> CacheHolderMap;
+  static CacheHolderMap g_cacheHolders; //!< Address to cache holders map.
+
+  /// Mapping of node id to the IP addresses of the node
+  typedef std::unordered_map<uint32_t, std::vector<IpAddress> > NodeToIpAddressMap;
+  static NodeToIpAddressMap g_nodeToIpAddressMap; //!< Node to addresses map.
+
+  /** Parent of every node in the shortest path tree rooted at m_node (0 if unreached) */
+  mutable std::vector< Ptr<Node> > m_sptParent;
+
+  /** Hop distance of every node from m_node */
+  mutable std::vector<uint32_t> m_sptDist;
+
+  /** Children of every node in the shortest path tree */
+  mutable std::vector< std::vector<uint32_t> > m_sptChildren;
+
   /** Cache stores nix-vectors based on destination ip */
   mutable NixMap_t m_nixCache;
 
   /** Cache stores IpRoutes based on destination ip */
   mutable IpRouteMap_t m_ipRouteCache;
 
+  /** Cache stores the alternative paths based on destination ip */
+  mutable NixPathMap_t m_nixPathCache;
+
+  /** Maximum number of disjoint paths kept per destination */
+  uint32_t m_maxPaths;
+
+  /** Whether alternative paths must be node-disjoint instead of link-disjoint */
+  bool m_nodeDisjoint;
+
   Ptr<Ip> m_ip; //!< IP object
   Ptr<Node> m_node; //!< Node object
 
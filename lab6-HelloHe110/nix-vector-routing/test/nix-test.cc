@@ -0,0 +1,342 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/test.h"
+
+#include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
+
+using namespace ns3;
+
+/**
+ * Connects two nodes with a point-to-point simple channel
+ * \param a first node
+ * \param b second node
+ * \param network network address of the link
+ * \returns the devices of the link
+ */
+static NetDeviceContainer
+Connect (Ptr<Node> a, Ptr<Node> b, const char *network)
+{
+  SimpleNetDeviceHelper link;
+  link.SetNetDevicePointToPointMode (true);
+  NetDeviceContainer devices = link.Install (NodeContainer (a, b));
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase (network, "255.255.255.0");
+  ipv4.Assign (devices);
+  return devices;
+}
+
+/**
+ * \param node the node
+ * \returns the destinations listed in the nix-vector cache of the node
+ */
+static std::string
+CachedDestinations (Ptr<Node> node)
+{
+  std::ostringstream os;
+  Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (&os);
+  node->GetObject<Ipv4> ()->GetRoutingProtocol ()->PrintRoutingTable (stream);
+  std::string table = os.str ();
+  std::string::size_type begin = table.find ("NixCache:");
+  std::string::size_type end = table.find ("IpRouteCache:");
+  return table.substr (begin, end - begin);
+}
+
+/**
+ * \param rp the routing protocol of the source
+ * \param source the source node
+ * \param dest the destination address
+ * \returns the route printed by PrintRoutingPath, without the time
+ */
+static std::string
+RoutingPath (Ptr<Ipv4NixVectorRouting> rp, Ptr<Node> source, Ipv4Address dest)
+{
+  std::ostringstream os;
+  rp->PrintRoutingPath (source, dest, Create<OutputStreamWrapper> (&os), Time::S);
+  std::string path = os.str ();
+  return path.substr (path.find ('\n') + 1);
+}
+
+/**
+ * \param node the source node
+ * \param source the source address
+ * \param dest the destination address
+ * \param sourcePort the TCP source port of the flow
+ * \returns the gateway of the route for a segment of the flow, the
+ * any address if there is no route
+ */
+static Ipv4Address
+TcpGateway (Ptr<Node> node, Ipv4Address source, Ipv4Address dest, uint16_t sourcePort)
+{
+  TcpHeader tcp;
+  tcp.SetSourcePort (sourcePort);
+  tcp.SetDestinationPort (9);
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (tcp);
+  Ipv4Header header;
+  header.SetSource (source);
+  header.SetDestination (dest);
+  header.SetProtocol (TcpL4Protocol::PROT_NUMBER);
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> route = node->GetObject<Ipv4> ()->GetRoutingProtocol ()->RouteOutput (p, header, Ptr<NetDevice> (), sockerr);
+  return route ? route->GetGateway () : Ipv4Address::GetAny ();
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief A link going down drops only the cached routes whose path
+ * changed, and the routes come back when it is up again
+ */
+class NixVectorRoutingCacheTestCase : public TestCase
+{
+public:
+  NixVectorRoutingCacheTestCase () : TestCase ("topology changes invalidate only affected routes") {}
+  virtual ~NixVectorRoutingCacheTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    // n0 - n1 - n2 - n3
+    //  |
+    // n4
+    NodeContainer nodes (5);
+    Ipv4NixVectorHelper nixRouting;
+    InternetStackHelper stack;
+    stack.SetRoutingHelper (nixRouting);
+    stack.Install (nodes);
+
+    Connect (nodes.Get (0), nodes.Get (1), "10.1.1.0");
+    Connect (nodes.Get (1), nodes.Get (2), "10.1.2.0");
+    Connect (nodes.Get (2), nodes.Get (3), "10.1.3.0");
+    Connect (nodes.Get (0), nodes.Get (4), "10.1.4.0");
+
+    Ptr<Node> source = nodes.Get (0);
+    Ptr<Ipv4NixVectorRouting> rp = source->GetObject<Ipv4NixVectorRouting> ();
+    NS_TEST_ASSERT_MSG_EQ ((rp != 0), true, "nix-vector routing should be installed");
+    rp->FlushGlobalNixRoutingCache ();
+
+    Ipv4Address toN2 ("10.1.2.2");
+    Ipv4Address toN3 ("10.1.3.2");
+    Ipv4Address toN4 ("10.1.4.2");
+    std::string pathN2 = RoutingPath (rp, source, toN2);
+    std::string pathN4 = RoutingPath (rp, source, toN4);
+    RoutingPath (rp, source, toN3);
+
+    std::string cached = CachedDestinations (source);
+    NS_TEST_ASSERT_MSG_NE (cached.find ("10.1.2.2"), std::string::npos, "route to n2 should be cached");
+    NS_TEST_ASSERT_MSG_NE (cached.find ("10.1.3.2"), std::string::npos, "route to n3 should be cached");
+    NS_TEST_ASSERT_MSG_NE (cached.find ("10.1.4.2"), std::string::npos, "route to n4 should be cached");
+
+    // cut n2 - n3
+    Ptr<Ipv4> ipv4 = nodes.Get (3)->GetObject<Ipv4> ();
+    uint32_t interface = ipv4->GetInterfaceForAddress (toN3);
+    ipv4->SetDown (interface);
+
+    cached = CachedDestinations (source);
+    NS_TEST_ASSERT_MSG_NE (cached.find ("10.1.2.2"), std::string::npos, "route to n2 did not change");
+    NS_TEST_ASSERT_MSG_EQ (cached.find ("10.1.3.2"), std::string::npos, "route to n3 should be dropped");
+    NS_TEST_ASSERT_MSG_NE (cached.find ("10.1.4.2"), std::string::npos, "route to n4 did not change");
+    NS_TEST_ASSERT_MSG_NE (RoutingPath (rp, source, toN3).find ("There does not exist a path"), std::string::npos,
+                           "n3 should be unreachable");
+
+    ipv4->SetUp (interface);
+
+    cached = CachedDestinations (source);
+    NS_TEST_ASSERT_MSG_EQ (cached.find ("10.1.3.2"), std::string::npos, "unreachable route to n3 should be dropped");
+    NS_TEST_ASSERT_MSG_NE (cached.find ("10.1.4.2"), std::string::npos, "route to n4 did not change");
+    NS_TEST_ASSERT_MSG_EQ (RoutingPath (rp, source, toN3).find ("There does not exist a path"), std::string::npos,
+                           "n3 should be reachable again");
+    NS_TEST_ASSERT_MSG_EQ (RoutingPath (rp, source, toN2), pathN2, "route to n2 should be unchanged");
+    NS_TEST_ASSERT_MSG_EQ (RoutingPath (rp, source, toN4), pathN4, "route to n4 should be unchanged");
+
+    // the shared maps outlive the nodes
+    rp->FlushGlobalNixRoutingCache ();
+    Simulator::Destroy ();
+  }
+};
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Routes precomputed on the thread pool are served from the
+ * cache and match the ones computed on demand, including the way
+ * equal-cost ties are broken
+ */
+class NixVectorRoutingPrecomputeTestCase : public TestCase
+{
+public:
+  NixVectorRoutingPrecomputeTestCase () : TestCase ("precomputed routes match routes on demand") {}
+  virtual ~NixVectorRoutingPrecomputeTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    // n0 - n2 - n3 - n4
+    //  |         |
+    // n1 --------+
+    // n0 lists n2 before n1 among its devices, so BFS reaches n3 over n2
+    NodeContainer nodes (5);
+    Ipv4NixVectorHelper nixRouting;
+    InternetStackHelper stack;
+    stack.SetRoutingHelper (nixRouting);
+    stack.Install (nodes);
+
+    Connect (nodes.Get (0), nodes.Get (2), "10.1.1.0");
+    Connect (nodes.Get (0), nodes.Get (1), "10.1.2.0");
+    Connect (nodes.Get (1), nodes.Get (3), "10.1.3.0");
+    Connect (nodes.Get (2), nodes.Get (3), "10.1.4.0");
+    Connect (nodes.Get (3), nodes.Get (4), "10.1.5.0");
+
+    Ptr<Node> source = nodes.Get (0);
+    Ptr<Ipv4NixVectorRouting> rp = source->GetObject<Ipv4NixVectorRouting> ();
+    Ptr<Ipv4NixVectorRouting> other = nodes.Get (4)->GetObject<Ipv4NixVectorRouting> ();
+    rp->FlushGlobalNixRoutingCache ();
+
+    nixRouting.PrecomputeRoutes (NodeContainer (source), NodeContainer (nodes.Get (3), nodes.Get (4)), 2);
+
+    std::string cached = CachedDestinations (source);
+    Ipv4Address dests[] = {Ipv4Address ("10.1.3.2"), Ipv4Address ("10.1.4.2"), Ipv4Address ("10.1.5.2")};
+    for (const Ipv4Address &dest : dests)
+      {
+        std::ostringstream address;
+        address << dest;
+        NS_TEST_ASSERT_MSG_NE (cached.find (address.str ()), std::string::npos,
+                               "route to " << dest << " should be precomputed");
+      }
+
+    std::vector<std::string> precomputed;
+    std::vector<std::string> bfs;
+    for (const Ipv4Address &dest : dests)
+      {
+        precomputed.push_back (RoutingPath (rp, source, dest));
+        // another node's agent runs the plain BFS for the source
+        bfs.push_back (RoutingPath (other, source, dest));
+      }
+
+    rp->FlushGlobalNixRoutingCache ();
+    for (std::size_t i = 0; i < precomputed.size (); i++)
+      {
+        NS_TEST_ASSERT_MSG_NE (precomputed[i].find ("(Node 2)"), std::string::npos,
+                               "route to " << dests[i] << " should follow the device order over n2");
+        NS_TEST_ASSERT_MSG_EQ (precomputed[i], RoutingPath (rp, source, dests[i]),
+                               "precomputed route to " << dests[i] << " should match the one on demand");
+        NS_TEST_ASSERT_MSG_EQ (precomputed[i], bfs[i],
+                               "precomputed route to " << dests[i] << " should match BFS");
+      }
+
+    rp->FlushGlobalNixRoutingCache ();
+    Simulator::Destroy ();
+  }
+};
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief With two paths per destination, TCP flows that differ only in
+ * their ports are spread over two disjoint paths, and every segment of
+ * one flow takes the same path
+ */
+class NixVectorRoutingMultipathTestCase : public TestCase
+{
+public:
+  NixVectorRoutingMultipathTestCase () : TestCase ("flows are hashed onto disjoint paths") {}
+  virtual ~NixVectorRoutingMultipathTestCase () {}
+private:
+  virtual void DoRun (void)
+  {
+    // n0 - n1 - n3
+    //  |         |
+    // n2 --------+
+    NodeContainer nodes (4);
+    Ipv4NixVectorHelper nixRouting;
+    nixRouting.Set ("MaxPaths", UintegerValue (2));
+    InternetStackHelper stack;
+    stack.SetRoutingHelper (nixRouting);
+    stack.Install (nodes);
+
+    Connect (nodes.Get (0), nodes.Get (1), "10.1.1.0");
+    Connect (nodes.Get (0), nodes.Get (2), "10.1.2.0");
+    Connect (nodes.Get (1), nodes.Get (3), "10.1.3.0");
+    Connect (nodes.Get (2), nodes.Get (3), "10.1.4.0");
+
+    Ptr<Node> node = nodes.Get (0);
+    Ptr<Ipv4NixVectorRouting> rp = node->GetObject<Ipv4NixVectorRouting> ();
+    rp->FlushGlobalNixRoutingCache ();
+
+    Ipv4Address source ("10.1.1.1");
+    Ipv4Address dest ("10.1.3.2");
+    Ipv4Address viaN1 ("10.1.1.2");
+    Ipv4Address viaN2 ("10.1.2.2");
+
+    // the hash decides which flows differ, so look for a port that
+    // takes the other path than the first flow
+    uint16_t firstPort = 49153;
+    Ipv4Address first = TcpGateway (node, source, dest, firstPort);
+    NS_TEST_ASSERT_MSG_EQ ((first == viaN1 || first == viaN2), true, "the first flow should leave over n1 or n2");
+    uint16_t otherPort = 0;
+    Ipv4Address other;
+    for (uint16_t port = firstPort + 1; port < firstPort + 64 && otherPort == 0; port++)
+      {
+        Ipv4Address gateway = TcpGateway (node, source, dest, port);
+        NS_TEST_ASSERT_MSG_EQ ((gateway == viaN1 || gateway == viaN2), true, "every flow should leave over n1 or n2");
+        if (gateway != first)
+          {
+            otherPort = port;
+            other = gateway;
+          }
+      }
+    NS_TEST_ASSERT_MSG_NE (otherPort, 0, "flows with different ports should take both paths");
+
+    // interleaved segments of both flows stay on their paths
+    for (uint32_t i = 0; i < 8; i++)
+      {
+        NS_TEST_ASSERT_MSG_EQ (TcpGateway (node, source, dest, firstPort), first, "the first flow should keep its path");
+        NS_TEST_ASSERT_MSG_EQ (TcpGateway (node, source, dest, otherPort), other, "the other flow should keep its path");
+      }
+
+    rp->FlushGlobalNixRoutingCache ();
+    Simulator::Destroy ();
+  }
+};
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Unit tests
+ */
+class NixVectorRoutingTestSuite : public TestSuite
+{
+public:
+  NixVectorRoutingTestSuite () : TestSuite ("nix-vector-routing", UNIT)
+  {
+    AddTestCase (new NixVectorRoutingCacheTestCase, TestCase::QUICK);
+    AddTestCase (new NixVectorRoutingPrecomputeTestCase, TestCase::QUICK);
+    AddTestCase (new NixVectorRoutingMultipathTestCase, TestCase::QUICK);
+  }
+};
+
+static NixVectorRoutingTestSuite nixVectorRoutingTestSuite;